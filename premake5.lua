@@ -327,6 +327,49 @@ end
 
 dependencies.imports()
 
+project "manifest-tool"
+kind "ConsoleApp"
+language "C++"
+
+files {"./src/manifest_tool/**.hpp", "./src/manifest_tool/**.cpp"}
+
+includedirs {"./src/manifest_tool", "./src/common", "%{prj.location}/src"}
+
+links {"common"}
+
+dependencies.imports()
+
+project "tests"
+kind "ConsoleApp"
+language "C++"
+
+-- client sources that don't call into the game, src/tests provides their std_include.hpp
+files {
+	"./src/tests/**.hpp",
+	"./src/tests/**.cpp",
+	"./src/client/component/gsc/script_profiler_report.cpp",
+	"./src/client/component/map_rotation_data.cpp",
+	"./src/client/game/asset_index.cpp",
+	"./src/client/game/demonware/bit_buffer.cpp",
+	"./src/client/game/demonware/byte_buffer.cpp",
+	"./src/client/game/demonware/keys.cpp",
+	"./src/client/game/demonware/reply.cpp",
+	"./src/client/game/demonware/task_dispatcher.cpp",
+	"./src/client/game/demonware/user_files.cpp",
+	"./src/client/game/scripting/token_cache.cpp",
+	"./src/client/updater/delta_update.cpp",
+	"./src/client/utils/display_name.cpp",
+	"./src/client/utils/gamertags.cpp",
+	"./src/client/utils/map_prefetch.cpp",
+	"./src/client/utils/packet_dispatch.cpp"
+}
+
+includedirs {"./src/tests", "./src/client", "./src/common", "%{prj.location}/src"}
+
+links {"common"}
+
+dependencies.imports()
+
 project "tlsdll"
 kind "SharedLib"
 language "C++"
@@ -7,8 +7,10 @@
 #include "console.hpp"
 #include "discord.hpp"
 #include "network.hpp"
+#include "scheduler.hpp"
 
 #include "game/game.hpp"
+#include "game/dvars.hpp"
 #include "steam/steam.hpp"
 
 #include <utils/hook.hpp>
@@ -19,6 +21,9 @@
 #include <utils/cryptography.hpp>
 #include <utils/http.hpp>
 #include <utils/obfus.hpp>
+#include <utils/concurrency.hpp>
+#include <utils/lru_cache.hpp>
+#include <utils/thread.hpp>
 
 namespace auth
 {
@@ -146,6 +151,322 @@ namespace auth
 			return true;
 		}
 
+		struct verification
+		{
+			bool valid_signature;
+			uint64_t key_hash;
+		};
+
+		struct connect_request
+		{
+			game::netadr_s from;
+			std::string infostring;
+			std::string public_key;
+			std::string challenge;
+			std::string signature;
+		};
+
+		struct rate_limit
+		{
+			int tokens;
+			std::chrono::steady_clock::time_point last_refill;
+			// connects dropped since the last one that got through, only the first one is logged
+			uint32_t throttled;
+		};
+
+		constexpr auto verify_worker_count = 2u;
+		// connects waiting for a worker, anything beyond that is turned away instead of piling up during a flood
+		constexpr auto max_queued_verifications = 64u;
+		constexpr auto verification_cache_size = 512u;
+		constexpr auto key_cache_size = 256u;
+
+		// connect attempts a single ip can make in a row, one more is granted every refill interval.
+		// Players behind the same NAT share a bucket, the defaults leave room for a whole lobby reconnecting.
+		game::dvar_t* sv_connect_burst;
+		game::dvar_t* sv_connect_refill_ms;
+
+		utils::concurrency::container<utils::lru_cache<std::string, verification>> verification_cache{verification_cache_size};
+		utils::concurrency::container<utils::lru_cache<std::string, std::shared_ptr<const utils::cryptography::ecc::key>>> key_cache{key_cache_size};
+
+		// only accessed from the server thread
+		std::unordered_map<uint32_t, rate_limit> rate_limits;
+		std::unordered_set<game::netadr_s> pending_connects;
+
+		struct
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::deque<connect_request> requests;
+			std::vector<std::thread> workers;
+			bool stopping = false;
+		} verifier;
+
+		// the signature is part of the key, a cached success must never validate a different signature
+		std::string get_verification_key(const connect_request& request)
+		{
+			std::string key{};
+			key.reserve(request.public_key.size() + request.challenge.size() + request.signature.size() + 2);
+			key.append(request.public_key);
+			key.push_back('\0');
+			key.append(request.challenge);
+			key.push_back('\0');
+			key.append(request.signature);
+			return key;
+		}
+
+		std::shared_ptr<const utils::cryptography::ecc::key> get_public_key(const std::string& public_key)
+		{
+			auto key = key_cache.access<std::shared_ptr<const utils::cryptography::ecc::key>>([&](auto& cache)
+			{
+				return cache.get(public_key).value_or(nullptr);
+			});
+
+			if (key)
+			{
+				return key;
+			}
+
+			auto parsed_key = std::make_shared<utils::cryptography::ecc::key>();
+			parsed_key->set(public_key);
+
+			key_cache.access([&](auto& cache)
+			{
+				cache.put(public_key, parsed_key);
+			});
+
+			return parsed_key;
+		}
+
+		verification verify_request(const connect_request& request)
+		{
+			const auto key = get_public_key(request.public_key);
+
+			verification result{};
+			result.key_hash = key->get_hash();
+			result.valid_signature = key->is_valid() && verify_message(*key, request.challenge, request.signature);
+
+			return result;
+		}
+
+		bool is_rate_limited(const game::netadr_s& from)
+		{
+			const auto now = std::chrono::steady_clock::now();
+			const auto ip = *reinterpret_cast<const uint32_t*>(&from.ip[0]);
+
+			const auto connect_burst = sv_connect_burst->current.integer;
+			const auto connect_refill_interval = std::chrono::milliseconds(sv_connect_refill_ms->current.integer);
+
+			auto [itr, inserted] = rate_limits.try_emplace(ip, rate_limit{connect_burst, now, 0});
+			auto& limit = itr->second;
+
+			const auto refills = (now - limit.last_refill) / connect_refill_interval;
+			if (refills > 0)
+			{
+				limit.tokens = static_cast<int>(std::min<int64_t>(connect_burst, limit.tokens + refills));
+				limit.last_refill += refills * connect_refill_interval;
+			}
+
+			if (limit.tokens <= 0)
+			{
+				if (limit.throttled++ == 0)
+				{
+					console::warn("Throttling connects from %s, more than %i attempts in a row\n",
+						network::net_adr_to_string(from), connect_burst);
+				}
+
+				return true;
+			}
+
+			--limit.tokens;
+
+			if (limit.throttled)
+			{
+				console::info("Dropped %u connects from %s while throttled\n", limit.throttled, network::net_adr_to_string(from));
+				limit.throttled = 0;
+			}
+
+			// forget addresses that have been quiet long enough to be back at a full bucket
+			if (rate_limits.size() > 1024)
+			{
+				std::erase_if(rate_limits, [&](const auto& entry)
+				{
+					return now - entry.second.last_refill > connect_refill_interval * connect_burst;
+				});
+			}
+
+			return false;
+		}
+
+		// expects the connect string to be tokenized, SV_DirectConnect reads its arguments from there
+		void finish_connect(game::netadr_s from, const utils::info_string& info_string, const verification& result)
+		{
+			const auto steam_id = info_string.get(hash_string("xuid"));
+			const auto xuid = strtoull(steam_id.data(), nullptr, 16);
+
+			if (xuid != result.key_hash)
+			{
+				CALL(&network::send, from, "error",
+					utils::string::va("XUID doesn't match the certificate: %llX != %llX", xuid, result.key_hash), '\n');
+				return;
+			}
+
+			if (!result.valid_signature)
+			{
+				CALL(&network::send, from, "error", "Challenge signature was invalid!", '\n');
+				return;
+			}
+
+			if (game::VirtualLobby_Loaded())
+			{
+				game::SV_DirectConnect(&from);
+				return;
+			}
+
+			const auto clantag = info_string.get(utils::string::va("0x%lX", 0x4D60A94B));
+			if (!clantag.empty())
+			{
+				const auto discord_id = info_string.get(hash_string("discord_id"));
+
+				switch (clantags::authorize_tag(clantag, discord_id))
+				{
+				case clantags::tag_authorization::unavailable:
+					CALL(&network::send, from, OBF("error"), OBF("Failed to authenticate tag"), '\n');
+					return;
+				case clantags::tag_authorization::denied:
+					CALL(&network::send, from, OBF("error"), OBF("Invalid clantag"), '\n');
+					return;
+				default:
+					break;
+				}
+			}
+
+			game::SV_DirectConnect(&from);
+		}
+
+		void complete_connect(const connect_request& request, const verification& result)
+		{
+			pending_connects.erase(request.from);
+
+			game::SV_Cmd_TokenizeString(request.infostring.data());
+			const auto _ = gsl::finally([]()
+			{
+				game::SV_Cmd_EndTokenizedString();
+			});
+
+			const command::params_sv params;
+			if (params.size() < 3)
+			{
+				return;
+			}
+
+			const utils::info_string info_string{std::string{params[2]}};
+			finish_connect(request.from, info_string, result);
+		}
+
+		void verifier_main()
+		{
+			while (true)
+			{
+				connect_request request{};
+
+				{
+					std::unique_lock<std::mutex> lock(verifier.mutex);
+					verifier.condition.wait(lock, []()
+					{
+						return verifier.stopping || !verifier.requests.empty();
+					});
+
+					if (verifier.stopping)
+					{
+						return;
+					}
+
+					request = std::move(verifier.requests.front());
+					verifier.requests.pop_front();
+				}
+
+				std::optional<verification> result{};
+
+				try
+				{
+					result = verify_request(request);
+				}
+				catch (const std::exception& e)
+				{
+					console::error("Failed to verify connect from %s: %s\n", network::net_adr_to_string(request.from), e.what());
+				}
+				catch (...)
+				{
+					console::error("Failed to verify connect from %s\n", network::net_adr_to_string(request.from));
+				}
+
+				if (!result.has_value())
+				{
+					// the request still has to leave pending_connects or the client can never connect again
+					scheduler::once([from = request.from]()
+					{
+						pending_connects.erase(from);
+						CALL(&network::send, from, "error", "Failed to verify the connect request", '\n');
+					}, scheduler::pipeline::server);
+
+					continue;
+				}
+
+				verification_cache.access([&](auto& cache)
+				{
+					cache.put(get_verification_key(request), *result);
+				});
+
+				scheduler::once([request = std::move(request), result = *result]()
+				{
+					complete_connect(request, result);
+				}, scheduler::pipeline::server);
+			}
+		}
+
+		bool queue_verification(connect_request request)
+		{
+			{
+				std::lock_guard<std::mutex> _(verifier.mutex);
+				if (verifier.requests.size() >= max_queued_verifications)
+				{
+					return false;
+				}
+
+				if (verifier.workers.empty())
+				{
+					for (auto i = 0u; i < verify_worker_count; ++i)
+					{
+						verifier.workers.emplace_back(utils::thread::create_named_thread("Connect Verifier", verifier_main));
+					}
+				}
+
+				verifier.requests.emplace_back(std::move(request));
+			}
+
+			verifier.condition.notify_one();
+			return true;
+		}
+
+		void stop_verification()
+		{
+			{
+				std::lock_guard<std::mutex> _(verifier.mutex);
+				verifier.stopping = true;
+				verifier.requests.clear();
+			}
+
+			verifier.condition.notify_all();
+
+			for (auto& worker : verifier.workers)
+			{
+				if (worker.joinable())
+				{
+					worker.join();
+				}
+			}
+		}
+
 		void direct_connect(game::netadr_s* from, game::msg_t* msg)
 		{
 			const auto offset = sizeof("connect") + 4;
@@ -178,96 +499,39 @@ namespace auth
 				return;
 			}
 
-			utils::cryptography::ecc::key key;
-			key.set(info.publickey());
-
-			const auto xuid = strtoull(steam_id.data(), nullptr, 16);
-
-			if (xuid != key.get_hash())
+			// clients resend their connect packet, they get picked up once the current one is verified
+			if (pending_connects.contains(*from) || is_rate_limited(*from))
 			{
-				CALL(&network::send, *from, "error",
-					utils::string::va("XUID doesn't match the certificate: %llX != %llX", xuid, key.get_hash()), '\n');
 				return;
 			}
 
-			if (!key.is_valid() || !verify_message(key, challenge, info.signature()))
-			{
-				CALL(&network::send, *from, "error", "Challenge signature was invalid!", '\n');
-				return;
-			}
+			connect_request request{};
+			request.from = *from;
+			request.infostring = info.infostring();
+			request.public_key = info.publickey();
+			request.challenge = challenge;
+			request.signature = info.signature();
 
-			auto discordid = info_string.get(hash_string("discord_id"));
+			const auto cached_result = verification_cache.access<std::optional<verification>>([&](auto& cache)
+			{
+				return cache.get(get_verification_key(request));
+			});
 
-			if (game::VirtualLobby_Loaded())
+			if (cached_result.has_value())
 			{
-				game::SV_DirectConnect(from);
+				finish_connect(*from, info_string, *cached_result);
 				return;
 			}
 
-			auto clantag = info_string.get(utils::string::va("0x%lX", 0x4D60A94B));
-			if (!clantag.empty())
+			// the ecc verification is too expensive to run on the server frame during reconnect bursts
+			if (!queue_verification(std::move(request)))
 			{
-				game::StringTable* gamertags_pc{};
-				game::StringTable_GetAsset(OBF("mp/activisiongamertags_pc.csv"), &gamertags_pc);
-
-				for (auto& tag_s : clantags::tags)
-				{
-					auto name_modified = utils::string::va("^%c%c%c%c%s", 1, tag_s.second.width, tag_s.second.height, 2, tag_s.second.short_name.data());
-					if (tag_s.first == clantag || !strcmp(clantag.data(), name_modified))
-					{
-						if (!gamertags_pc || !gamertags_pc->rowCount)
-						{
-							CALL(&network::send, *from, OBF("error"), OBF("Failed to authenticate tag"), '\n');
-							return;
-						}
-
-						if (!strcmp(clantag.data(), name_modified))
-						{
-							clantag = tag_s.first;
-						}
-
-						clantag = utils::string::to_upper(clantag);
-
-						auto discord_id = info_string.get(hash_string("discord_id"));
-
-						auto gamertags_row_count = game::StringTable_GetRowCount(gamertags_pc);
-						for (auto row_i = 0; row_i < gamertags_row_count; ++row_i)
-						{
-							auto tag = game::StringTable_GetColumnValueForRow(gamertags_pc, row_i, 0);
-							auto id = game::StringTable_GetColumnValueForRow(gamertags_pc, row_i, 1);
-
-							if (!strcmp(discord_id.c_str(), id))
-							{
-								if (!strcmp(tag, "HMW"))
-								{
-									game::SV_DirectConnect(from);
-									return;
-								}
-								if (!strcmp(tag, "H2M"))
-								{
-									
-									if (strcmp(clantag.c_str(), "HMW") != 0)
-									{
-										game::SV_DirectConnect(from);
-										return;
-									}
-								}
-								if (!strcmp(tag, clantag.c_str()))
-								{
-									game::SV_DirectConnect(from);
-									return;
-								}
-							}
-						}
-
-						CALL(&network::send, *from, OBF("error"), OBF("Invalid clantag"), '\n');
-						return;
-					}
-				}
+				CALL(&network::send, *from, "error", "Server is busy, try again later", '\n');
+				return;
 			}
 
-			game::SV_DirectConnect(from);
-
+			// completions are run on the server pipeline, so this is always inserted before it's erased again
+			pending_connects.insert(*from);
 		}
 
 		void* get_direct_connect_stub()
@@ -332,6 +596,16 @@ namespace auth
 
 			// Don't instantly timeout the connecting client ? not sure about this
 			utils::hook::set(0x12D93C_b, 0xC3);
+
+			sv_connect_burst = dvars::register_int("sv_connectBurst", 64, 1, 1024, game::DVAR_FLAG_NONE,
+				"Connect attempts a single IP can make in a row before being throttled");
+			sv_connect_refill_ms = dvars::register_int("sv_connectRefillMs", 100, 1, 10000, game::DVAR_FLAG_NONE,
+				"Milliseconds until a throttled IP may make another connect attempt");
+		}
+
+		void pre_destroy() override
+		{
+			stop_verification();
 		}
 	};
 }
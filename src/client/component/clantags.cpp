@@ -2,81 +2,168 @@
 #include "loader/component_loader.hpp"
 
 #include "clantags.hpp"
+#include "command.hpp"
+#include "console.hpp"
+#include "fastfiles.hpp"
 
 #include "game/game.hpp"
+#include "utils/display_name.hpp"
+#include "utils/gamertags.hpp"
 #include "utils/hook.hpp"
 #include "utils/string.hpp"
 
+#include <utils/concurrency.hpp>
+#include <utils/obfus.hpp>
+
 namespace clantags
 {
 	namespace
 	{
-		utils::hook::detour lui_pushplayername_hook;
-		utils::hook::detour gamerprofile_getclanname_hook;
-		utils::hook::detour cl_getclientstatefromcurrentsnapshot_hook;
+		struct authorization_index
+		{
+			const game::StringTable* table{};
+			const game::StringTableCell* values{};
+			int row_count{};
 
-		__int64 lui_pushplayername_stub(__int64 state, int localClientNumber, signed char entityNumber)
+			gamertags::index tags;
+		};
+
+		// clientState_s::clanAbbrev
+		constexpr auto snapshot_clan_tag_size = 8u;
+
+		utils::concurrency::container<authorization_index> authorization;
+
+		// only the first 18 entities are clients
+		constexpr auto max_display_name_clients = 18;
+
+		// only touched by the main thread
+		struct
 		{
-			if (entityNumber >= 18)
-			{
-				return lui_pushplayername_hook.invoke<__int64>(state, localClientNumber, entityNumber);
-			}
+			display_name::cache names{max_display_name_clients};
+			std::chrono::steady_clock::time_point last_report = std::chrono::steady_clock::now();
+		} display_names;
 
-			char* v7;
-			const char* v11;
-			DWORD* v12;
-			const char* a4;
+		// tag -> formatted icon name
+		const std::unordered_map<std::string, std::string>& get_tag_icons()
+		{
+			static const auto tag_icons = []()
+			{
+				std::unordered_map<std::string, std::string> result;
+				for (const auto& [tag, info] : tags)
+				{
+					result[tag] = utils::string::va("^%c%c%c%c%s", 1, info.width, info.height, 2, info.short_name.data());
+				}
 
-			auto* bgs_clientinfo_array = reinterpret_cast<game::clientInfo_t*>(reinterpret_cast<uintptr_t>(game::getCGArray()) + 0x174DA8);
-			auto* clientinfo = &bgs_clientinfo_array[entityNumber];
+				return result;
+			}();
 
-			v11 = clientinfo->clanAbbrev;
-			if (clientinfo->clanAbbrev[0] && !clientinfo->use_elite_clan_tag)
-				goto LABEL_12;
-			v11 = clientinfo->elite_clan_tag_text;
+			return tag_icons;
+		}
 
-			if (clientinfo->elite_clan_tag_text[0])
+		// formatted icon name -> tag
+		const std::unordered_map<std::string, std::string>& get_formatted_tags()
+		{
+			static const auto formatted_tags = []()
 			{
-				switch (clientinfo->use_elite_clan_tag)
+				std::unordered_map<std::string, std::string> result;
+				for (const auto& [tag, icon] : get_tag_icons())
 				{
-				case 1:
-				LABEL_12:
-					for (auto& tag : clantags::tags)
-					{
-						if (!strcmp(v11, tag.first.data()))
-						{
-							v11 = utils::string::va("^%c%c%c%c%s", 1, tag.second.width, tag.second.height, 2, tag.second.short_name.data());
-						}
-					}
-
-					a4 = utils::string::va("[%s]%s", v11, clientinfo->name);
-				LABEL_5:
-					v7 = (char*)a4;
-					goto LABEL_6;
-				case 2:
-					a4 = utils::string::va("[^3%s^7]%s", v11, clientinfo->name);
-					goto LABEL_5;
-				case 3:
-					a4 = utils::string::va("[^1%s^7]%s", v11, clientinfo->name);
-					goto LABEL_5;
+					result[icon] = tag;
 				}
+
+				return result;
+			}();
+
+			return formatted_tags;
+		}
+
+		template <size_t Size>
+		std::string_view get_field(const char (&field)[Size])
+		{
+			return {field, strnlen(field, Size)};
+		}
+
+		const std::string& get_display_name(const int client_num, const game::clientInfo_t& info)
+		{
+			const display_name::fields fields
+			{
+				get_field(info.name),
+				get_field(info.clanAbbrev),
+				get_field(info.elite_clan_tag_text),
+				info.use_elite_clan_tag,
+			};
+
+			return display_names.names.get(client_num, fields, get_tag_icons());
+		}
+
+		// built when the table gets linked, authorizing a tag still rebuilds it if the asset changed in between
+		void update_authorization_index(authorization_index& index, game::StringTable* table)
+		{
+			if (index.table == table && index.values == table->values && index.row_count == table->rowCount)
+			{
+				return;
 			}
-			v7 = clientinfo->name;
-			if (!v7)
+
+			index.table = table;
+			index.values = table->values;
+			index.row_count = table->rowCount;
+			index.tags.clear();
+
+			const auto row_count = game::StringTable_GetRowCount(table);
+			for (auto row_i = 0; row_i < row_count; ++row_i)
 			{
-				v12 = *(DWORD**)(state + 72);
-				*v12 = 0;
-				*(ULONGLONG*)(state + 72) = *(ULONGLONG*)(v12 + 4);
-				return 1;
+				const auto* tag = game::StringTable_GetColumnValueForRow(table, row_i, 0);
+				const auto* id = game::StringTable_GetColumnValueForRow(table, row_i, 1);
+
+				index.tags.add(tag, id);
+			}
+		}
+
+		bool is_gamertags_table(std::string_view name)
+		{
+			if (name.starts_with("override/"))
+			{
+				name.remove_prefix(9);
 			}
-		LABEL_6:
 
-			auto v8 = -1;
-			do
-				++v8;
-			while (v7[v8]);
+			return name == OBF("mp/activisiongamertags_pc.csv");
+		}
+
+		void on_asset_link(game::XAssetEntry* entry)
+		{
+			if (entry->asset.type != game::ASSET_TYPE_STRINGTABLE)
+			{
+				return;
+			}
 
-			game::hksi_lua_pushlstring(state, (const char*)v7, static_cast<unsigned int>(v8));
+			auto* table = entry->asset.header.stringTable;
+			if (!table || !table->name || !is_gamertags_table(table->name) || !table->rowCount)
+			{
+				return;
+			}
+
+			// runs on the loading thread, the first connect doesn't have to wait for the table to be indexed
+			authorization.access([&](authorization_index& index)
+			{
+				update_authorization_index(index, table);
+			});
+		}
+
+		utils::hook::detour lui_pushplayername_hook;
+		utils::hook::detour gamerprofile_getclanname_hook;
+		utils::hook::detour cl_getclientstatefromcurrentsnapshot_hook;
+
+		__int64 lui_pushplayername_stub(__int64 state, int localClientNumber, signed char entityNumber)
+		{
+			if (entityNumber >= max_display_name_clients)
+			{
+				return lui_pushplayername_hook.invoke<__int64>(state, localClientNumber, entityNumber);
+			}
+
+			auto* bgs_clientinfo_array = reinterpret_cast<game::clientInfo_t*>(reinterpret_cast<uintptr_t>(game::getCGArray()) + 0x174DA8);
+			const auto& name = get_display_name(entityNumber, bgs_clientinfo_array[entityNumber]);
+
+			game::hksi_lua_pushlstring(state, name.data(), static_cast<unsigned int>(name.size()));
 			return 1;
 		}
 
@@ -88,17 +175,12 @@ namespace clantags
 				return snapshot;
 			}
 
-			for (auto& tag : clantags::tags)
+			auto clantag = static_cast<char*>(snapshot) + 0x7C;
+
+			const auto& formatted_tags = get_formatted_tags();
+			if (const auto tag = formatted_tags.find(clantag); tag != formatted_tags.end())
 			{
-				auto clantag_va = utils::string::va("^%c%c%c%c%s", 1, tag.second.width, tag.second.height, 2, tag.second.short_name.data());
-				auto clantag = static_cast<char*>(snapshot) + 0x7C;
-				if (clantag != nullptr)
-				{
-					if (!strcmp(clantag, clantag_va))
-					{
-						strcpy_s(clantag, sizeof(clantag), tag.first.data());
-					}
-				}
+				strcpy_s(clantag, snapshot_clan_tag_size, tag->second.data());
 			}
 
 			return snapshot;
@@ -136,19 +218,53 @@ namespace clantags
 				copy(*game::clanName, "none");
 				return "";
 			}
-			for (auto& tag : clantags::tags)
+			const auto& icons = get_tag_icons();
+			if (const auto icon = icons.find(clantag); icon != icons.end() && game::UI_ActivisionClanTagAllowedForGamerTag(clantag, ""))
 			{
-				if (!strcmp(clantag, tag.first.data()) && game::UI_ActivisionClanTagAllowedForGamerTag(clantag, ""))
-				{
-					clantag = utils::string::va("^%c%c%c%c%s", 1, tag.second.width, tag.second.height, 2, tag.second.short_name.data());
-					break;
-				}
+				return icon->second.data();
 			}
+
 			return clantag;
 		}
 
 	}
 
+	tag_authorization authorize_tag(const std::string& clantag, const std::string& discord_id)
+	{
+		std::string tag{};
+		if (tags.contains(clantag))
+		{
+			tag = clantag;
+		}
+		else
+		{
+			const auto& formatted_tags = get_formatted_tags();
+			const auto itr = formatted_tags.find(clantag);
+			if (itr == formatted_tags.end())
+			{
+				return tag_authorization::unrestricted;
+			}
+
+			tag = itr->second;
+		}
+
+		game::StringTable* gamertags_pc{};
+		game::StringTable_GetAsset(OBF("mp/activisiongamertags_pc.csv"), &gamertags_pc);
+
+		if (!gamertags_pc || !gamertags_pc->rowCount)
+		{
+			return tag_authorization::unavailable;
+		}
+
+		tag = utils::string::to_upper(tag);
+
+		return authorization.access<tag_authorization>([&](authorization_index& index)
+		{
+			update_authorization_index(index, gamertags_pc);
+			return index.tags.is_allowed(tag, discord_id) ? tag_authorization::allowed : tag_authorization::denied;
+		});
+	}
+
 	class component final : public component_interface
 	{
 	public:
@@ -159,6 +275,22 @@ namespace clantags
 			cl_getclientstatefromcurrentsnapshot_hook.create(0x344320_b, cl_getclientstatefromcurrentsnapshot_stub);
 
 			utils::hook::set<byte>(0x28AE97_b, 0x85); // JNZ on membersclantag
+
+			fastfiles::on_asset_link(on_asset_link);
+
+			command::add("clantagStats", []()
+			{
+				const auto now = std::chrono::steady_clock::now();
+				const auto seconds = std::max(std::chrono::duration<double>(now - display_names.last_report).count(), 0.001);
+				const auto stats = display_names.names.get_stats();
+
+				// every push used to format the name, only changes format it now
+				console::info("%.1f name pushes/s, %.1f formats/s\n", static_cast<double>(stats.lookups) / seconds,
+					static_cast<double>(stats.builds) / seconds);
+
+				display_names.names.reset_stats();
+				display_names.last_report = now;
+			});
 		}
 	};
 }
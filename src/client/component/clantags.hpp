@@ -17,4 +17,17 @@ namespace clantags
 	//{"HMW",	{"hm", 77, 77}}
 	// Could add more tags here in the future
 	};
+
+	enum class tag_authorization
+	{
+		// not one of the custom tags above, anybody can use it
+		unrestricted,
+		allowed,
+		denied,
+		// the gamertag table isn't loaded
+		unavailable,
+	};
+
+	// clantag can either be the plain tag or its formatted icon name
+	tag_authorization authorize_tag(const std::string& clantag, const std::string& discord_id);
 }
@@ -25,17 +25,20 @@ namespace command
 	{
 		utils::hook::detour client_command_hook;
 
-		std::unordered_map<std::string, std::function<void(params&)>> handlers;
-		std::unordered_map<std::string, std::function<void(int, params_sv&)>> handlers_sv;
+		// commands are case-insensitive, lookups don't need a lowered copy of the name
+		template <typename T>
+		using command_map = std::unordered_map<std::string, T, utils::string::hash_case_insensitive, utils::string::equal_case_insensitive>;
+
+		command_map<std::function<void(params&)>> handlers;
+		command_map<std::function<void(int, params_sv&)>> handlers_sv;
 
 		void main_handler()
 		{
 			params params = {};
 
-			const auto command = utils::string::to_lower(params[0]);
-			if (handlers.find(command) != handlers.end())
+			if (const auto handler = handlers.find(std::string_view(params[0])); handler != handlers.end())
 			{
-				handlers[command](params);
+				handler->second(params);
 			}
 		}
 
@@ -54,10 +57,9 @@ namespace command
 
 			params_sv params = {};
 
-			const auto command = utils::string::to_lower(params[0]);
-			if (handlers_sv.find(command) != handlers_sv.end())
+			if (const auto handler = handlers_sv.find(std::string_view(params[0])); handler != handlers_sv.end())
 			{
-				handlers_sv[command](client_num, params);
+				handler->second(client_num, params);
 			}
 
 			client_command_hook.invoke<void>(client_num);
@@ -711,6 +713,13 @@ namespace command
 
 				execute(dvar->current.string);
 			});
+
+			add("vaStats", []
+			{
+				const auto stats = utils::string::get_va_stats();
+				console::info("va: %llu results outgrew their inline buffer, %llu were truncated to %zu bytes\n",
+					stats.grown, stats.truncated, utils::string::va_max_size - 1);
+			});
 		}
 
 		static void add_commands_mp()
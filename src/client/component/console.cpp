@@ -8,9 +8,15 @@
 #include "rcon.hpp"
 #include "version.hpp"
 
+#include <utils/concurrency.hpp>
+#include <utils/flags.hpp>
+#include <utils/string.hpp>
 #include <utils/thread.hpp>
 #include <utils/hook.hpp>
 
+#include <array>
+#include <bit>
+
 #define OUTPUT_HANDLE GetStdHandle(STD_OUTPUT_HANDLE)
 
 namespace game_console
@@ -23,8 +29,60 @@ namespace console
 	namespace
 	{
 		utils::hook::detour printf_hook;
+		// guards the terminal and the sinks, producers only take it for errors and once the output thread stopped
 		std::recursive_mutex print_mutex;
 
+		struct log_message
+		{
+			int type;
+			std::string text;
+			std::chrono::steady_clock::time_point queued_at;
+		};
+
+		// power of two buckets in nanoseconds, the last one collects everything above
+		class latency_histogram
+		{
+		public:
+			void record(const std::chrono::steady_clock::duration duration)
+			{
+				const auto ns = static_cast<uint64_t>(std::max<int64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 1));
+				const auto bucket = std::min<size_t>(std::bit_width(ns) - 1, this->counts_.size() - 1);
+				this->counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			std::vector<std::pair<uint64_t, uint64_t>> get_buckets() const
+			{
+				std::vector<std::pair<uint64_t, uint64_t>> buckets{};
+				for (size_t i = 0; i < this->counts_.size(); ++i)
+				{
+					if (const auto count = this->counts_[i].load(std::memory_order_relaxed))
+					{
+						buckets.emplace_back(1ull << i, count);
+					}
+				}
+
+				return buckets;
+			}
+
+		private:
+			std::array<std::atomic_uint64_t, 32> counts_{};
+		};
+
+		struct
+		{
+			utils::concurrency::mpsc_queue<log_message> queue{4096};
+			std::atomic_uint64_t pending{0};
+			std::atomic_uint64_t dropped{0};
+			std::atomic_bool stopped{false};
+			std::thread thread;
+
+			latency_histogram producer_latency;
+			latency_histogram delivery_latency;
+
+			std::ofstream file;
+		} output{};
+
 		struct
 		{
 			bool kill;
@@ -115,31 +173,162 @@ namespace console
 			show_cursor(true);
 		}
 
-		int dispatch_message(const int type, const std::string& message)
+		void write_terminal(const log_message& message)
 		{
-			if (rcon::message_redirect(message))
+			SetConsoleTextAttribute(OUTPUT_HANDLE, get_attribute(message.type));
+			invoke_printf("%s", message.text.data());
+			SetConsoleTextAttribute(OUTPUT_HANDLE, get_attribute(con_type_info));
+
+			if (message.text.empty() || message.text.back() != '\n')
 			{
-				return 0;
+				invoke_printf("\n");
 			}
+		}
 
+		void write_file(const log_message& message)
+		{
+			if (!output.file.is_open())
+			{
+				return;
+			}
+
+			output.file << message.text;
+
+			if (message.text.empty() || message.text.back() != '\n')
+			{
+				output.file << '\n';
+			}
+		}
+
+		// the input line is redrawn once per batch instead of once per message,
+		// print_mutex keeps batches from interleaving once producers deliver themselves after shutdown
+		void deliver_messages(const std::vector<log_message>& messages)
+		{
 			std::lock_guard _0(print_mutex);
 
 			clear_output();
 			set_cursor_pos(0);
 
-			SetConsoleTextAttribute(OUTPUT_HANDLE, get_attribute(type));
-			const auto res = invoke_printf("%s", message.data());
-			SetConsoleTextAttribute(OUTPUT_HANDLE, get_attribute(con_type_info));
+			for (const auto& message : messages)
+			{
+				write_terminal(message);
+			}
+
+			update();
 
-			game_console::print(type, message);
+			const auto now = std::chrono::steady_clock::now();
 
-			if (message.size() <= 0 || message[message.size() - 1] != '\n')
+			for (const auto& message : messages)
 			{
-				invoke_printf("\n");
+				game_console::print(message.type, message.text);
+				write_file(message);
+				output.delivery_latency.record(now - message.queued_at);
 			}
 
-			update();
-			return res;
+			output.file.flush();
+		}
+
+		std::vector<log_message> drain_messages()
+		{
+			std::vector<log_message> messages{};
+			while (auto message = output.queue.try_pop())
+			{
+				messages.emplace_back(std::move(*message));
+			}
+
+			return messages;
+		}
+
+		void output_thread()
+		{
+			while (!output.stopped)
+			{
+				const auto pending = output.pending.load();
+
+				{
+					// producers drain the queue as well once stopped is set
+					std::lock_guard _0(print_mutex);
+
+					const auto messages = drain_messages();
+					if (!messages.empty())
+					{
+						deliver_messages(messages);
+						continue;
+					}
+				}
+
+				output.pending.wait(pending);
+			}
+		}
+
+		int dispatch_message(const int type, const std::string& message)
+		{
+			const auto start = std::chrono::steady_clock::now();
+
+			if (rcon::message_redirect(message))
+			{
+				return 0;
+			}
+
+			// errors are often the last thing printed before the process goes down, and the output thread
+			// is gone once stopped. Whatever is still queued goes out first to keep the order
+			if (output.stopped || type == con_type_error)
+			{
+				std::lock_guard _0(print_mutex);
+
+				auto messages = drain_messages();
+				messages.push_back({type, message, start});
+				deliver_messages(messages);
+				return static_cast<int>(message.size());
+			}
+
+			if (!output.queue.try_push({type, message, start}))
+			{
+				output.dropped.fetch_add(1, std::memory_order_relaxed);
+				return 0;
+			}
+
+			output.pending.fetch_add(1);
+			output.pending.notify_one();
+
+			// shutdown started after the check above, the final drain might have missed it
+			if (output.stopped)
+			{
+				std::lock_guard _0(print_mutex);
+				if (const auto messages = drain_messages(); !messages.empty())
+				{
+					deliver_messages(messages);
+				}
+			}
+
+			output.producer_latency.record(std::chrono::steady_clock::now() - start);
+			return static_cast<int>(message.size());
+		}
+
+		std::string format_duration(const uint64_t ns)
+		{
+			if (ns < 1000)
+			{
+				return utils::string::va("%lluns", ns);
+			}
+
+			if (ns < 1000000)
+			{
+				return utils::string::va("%.1fus", static_cast<double>(ns) / 1000.0);
+			}
+
+			return utils::string::va("%.1fms", static_cast<double>(ns) / 1000000.0);
+		}
+
+		void print_histogram(const char* name, const latency_histogram& histogram)
+		{
+			print(con_type_info, "%s:\n", name);
+
+			for (const auto& [lower_bound, count] : histogram.get_buckets())
+			{
+				const auto lower = format_duration(lower_bound);
+				print(con_type_info, "  >= %8s: %llu\n", lower.data(), count);
+			}
 		}
 
 		void clear()
@@ -344,6 +533,21 @@ namespace console
 		dispatch_message(type, result);
 	}
 
+	void flush()
+	{
+		// might run on a crashed thread, don't wait for whoever holds the terminal
+		std::unique_lock lock(print_mutex, std::try_to_lock);
+		if (!lock.owns_lock())
+		{
+			return;
+		}
+
+		if (const auto messages = drain_messages(); !messages.empty())
+		{
+			deliver_messages(messages);
+		}
+	}
+
 	class component final : public component_interface
 	{
 	public:
@@ -352,10 +556,29 @@ namespace console
 			ShowWindow(GetConsoleWindow(), SW_HIDE);
 		}
 
+		void post_unpack() override
+		{
+			command::add("consoleStats", []()
+			{
+				print(con_type_info, "%llu console messages dropped\n", output.dropped.load());
+				print_histogram("Producer latency", output.producer_latency);
+				print_histogram("Delivery latency", output.delivery_latency);
+			});
+		}
+
 		void post_start() override
 		{
 			printf_hook.create(printf, printf_stub);
 
+			if (utils::flags::has_flag("consolelog"))
+			{
+				CreateDirectoryA("players2", nullptr);
+				output.file.open("players2/console.log", std::ios::binary | std::ios::app);
+			}
+
+			// anything printed before this point is delivered by the thread
+			output.thread = utils::thread::create_named_thread("Console Output", output_thread);
+
 			ShowWindow(GetConsoleWindow(), SW_SHOW);
 			SetConsoleTitle("HorizonMW: " VERSION);
 
@@ -421,6 +644,22 @@ namespace console
 			{
 				con.thread.join();
 			}
+
+			output.stopped = true;
+			output.pending.fetch_add(1);
+			output.pending.notify_one();
+
+			if (output.thread.joinable())
+			{
+				output.thread.join();
+			}
+
+			// producers may deliver on their own by now, print_mutex serializes both
+			std::lock_guard _0(print_mutex);
+			if (const auto messages = drain_messages(); !messages.empty())
+			{
+				deliver_messages(messages);
+			}
 		}
 	};
 }
@@ -11,6 +11,8 @@ namespace console
 	};
 
 	void print(int type, const char* fmt, ...);
+	// delivers queued output on the calling thread, for paths that are about to end the process
+	void flush();
 
 	template <typename... Args>
 	void error(const char* fmt, Args&&... args)
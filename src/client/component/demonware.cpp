@@ -7,6 +7,7 @@
 #include "game/demonware/servers/stun_server.hpp"
 #include "game/demonware/servers/umbrella_server.hpp"
 #include "game/demonware/server_registry.hpp"
+#include "game/demonware/user_files.hpp"
 #include "game/dvars.hpp"
 
 #include <utils/hook.hpp>
@@ -612,6 +613,8 @@ namespace demonware
 			{
 				server_thread.join();
 			}
+
+			user_files::shutdown();
 		}
 	};
 }
@@ -1,6 +1,7 @@
 #include <std_include.hpp>
 #include "loader/component_loader.hpp"
 
+#include "console.hpp"
 #include "scheduler.hpp"
 #include "system_check.hpp"
 #include "version.hpp"
@@ -106,6 +107,9 @@ namespace exception
 
 		void reset_state()
 		{
+			// the output thread might never get to what was printed right before the crash
+			console::flush();
+
 			if (dvars::cg_legacyCrashHandling && dvars::cg_legacyCrashHandling->current.enabled)
 			{
 				display_error_dialog();
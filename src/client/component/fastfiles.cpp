@@ -8,6 +8,7 @@
 #include "imagefiles.hpp"
 #include "weapon.hpp"
 
+#include "game/asset_index.hpp"
 #include "game/dvars.hpp"
 
 #include <utils/hook.hpp>
@@ -26,6 +27,21 @@ namespace fastfiles
 		utils::hook::detour db_try_load_x_file_internal_hook;
 		utils::hook::detour db_find_xasset_header_hook;
 
+		constexpr auto hash_table_size = 0x25D78;
+
+		std::vector<std::function<void(game::XAssetEntry*)>> asset_link_callbacks;
+
+		game::asset_index& get_asset_index()
+		{
+			static game::asset_index index(reinterpret_cast<const unsigned int*>(&game::db_hashTable[0]), hash_table_size,
+				&game::g_assetEntryPool[0], [](const game::XAsset* asset)
+			{
+				return game::DB_GetXAssetName(asset);
+			});
+
+			return index;
+		}
+
 		game::dvar_t* g_dump_scripts;
 		game::dvar_t* db_print_default_assets;
 
@@ -546,6 +562,9 @@ namespace fastfiles
 			}
 
 			db_unload_x_zones_hook.invoke<void>(unload_zones, unload_count, create_default);
+
+			// freed entries and restored overrides aren't tracked one by one
+			get_asset_index().invalidate();
 		}
 
 		constexpr unsigned int get_asset_type_size(const game::XAssetType type)
@@ -1086,19 +1105,21 @@ namespace fastfiles
 		utils::hook::detour db_link_x_asset_entry_hook;
 		game::XAssetEntry* db_link_x_asset_entry_stub(game::XAssetType type, game::XAssetHeader* header)
 		{
-			if (!is_mod_pre_gfx)
+			if (is_mod_pre_gfx && type != game::ASSET_TYPE_STRINGTABLE)
 			{
-				return db_link_x_asset_entry_hook.invoke<game::XAssetEntry*>(type, header);
+				static game::XAssetEntry entry{};
+				return &entry;
 			}
 
-			static game::XAssetEntry entry{};
+			const auto entry = db_link_x_asset_entry_hook.invoke<game::XAssetEntry*>(type, header);
+			get_asset_index().on_link(entry);
 
-			if (type != game::ASSET_TYPE_STRINGTABLE)
+			for (const auto& callback : asset_link_callbacks)
 			{
-				return &entry;
+				callback(entry);
 			}
 
-			return db_link_x_asset_entry_hook.invoke<game::XAssetEntry*>(type, header);
+			return entry;
 		}
 	}
 
@@ -1192,37 +1213,20 @@ namespace fastfiles
 		return fastfiles::exists(name, true);
 	}
 
-	void enum_asset_entries(const game::XAssetType type, const std::function<void(game::XAssetEntry*)>& callback, bool include_override)
+	void on_asset_link(const std::function<void(game::XAssetEntry*)>& callback)
 	{
-		constexpr auto max_asset_count = 0x25D78;
-		auto hash = &game::db_hashTable[0];
-		for (auto c = 0; c < max_asset_count; c++)
-		{
-			for (auto i = *hash; i; )
-			{
-				const auto entry = &game::g_assetEntryPool[i];
-
-				if (entry->asset.type == type)
-				{
-					callback(entry);
-
-					if (include_override && entry->nextOverride)
-					{
-						auto next_ovveride = entry->nextOverride;
-						while (next_ovveride)
-						{
-							const auto override = &game::g_assetEntryPool[next_ovveride];
-							callback(override);
-							next_ovveride = override->nextOverride;
-						}
-					}
-				}
+		asset_link_callbacks.emplace_back(callback);
+	}
 
-				i = entry->nextHash;
-			}
+	void enum_asset_entries(const game::XAssetType type, const std::function<void(game::XAssetEntry*)>& callback, bool include_override)
+	{
+		get_asset_index().enum_entries(type, callback, include_override);
+	}
 
-			++hash;
-		}
+	void enum_asset_entries(const game::XAssetType type, const std::string_view prefix,
+		const std::function<void(game::XAssetEntry*)>& callback, bool include_override)
+	{
+		get_asset_index().enum_entries(type, prefix, callback, include_override);
 	}
 
 	class component final : public component_interface
@@ -1383,6 +1387,19 @@ namespace fastfiles
 					}
 					console::info("---- %i Loaded Zones ----", count);
 				});
+
+			command::add("verifyAssetIndex", []()
+				{
+					std::vector<std::string> errors;
+					const auto mismatches = get_asset_index().verify(&errors);
+
+					for (const auto& error : errors)
+					{
+						console::warn("%s\n", error.data());
+					}
+
+					console::info("asset index: %zu mismatches\n", mismatches);
+				});
 #endif
 		}
 	};
@@ -21,5 +21,11 @@ namespace fastfiles
 	bool usermap_exists(const std::string& name);
 	bool is_stock_map(const std::string& name);
 
+	// called on the loading thread for every asset that gets linked, register callbacks before any zone loads
+	void on_asset_link(const std::function<void(game::XAssetEntry*)>& callback);
+
 	void enum_asset_entries(const game::XAssetType type, const std::function<void(game::XAssetEntry*)>& callback, bool include_override);
+	// only enumerates assets whose name starts with the given prefix
+	void enum_asset_entries(const game::XAssetType type, const std::string_view prefix,
+		const std::function<void(game::XAssetEntry*)>& callback, bool include_override);
 }
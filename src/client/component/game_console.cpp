@@ -181,9 +181,14 @@ namespace game_console
 		{
 			input = utils::string::to_lower(input);
 
+			// runs on every keystroke, the lowered names share one buffer
+			std::string name;
+
 			for (const auto& [hash, dvar] : dvars::dvar_map)
 			{
-				auto name = utils::string::to_lower(dvar.name);
+				name.assign(dvar.name);
+				utils::string::to_lower_inplace(name.data(), name.size());
+
 				if (game::Dvar_FindVar(name.data()) && utils::string::match_compare(input, name, exact))
 				{
 					suggestions.emplace_back(dvar);
@@ -205,7 +210,8 @@ namespace game_console
 			{
 				if (cmd->name)
 				{
-					std::string name = utils::string::to_lower(cmd->name);
+					name.assign(cmd->name);
+					utils::string::to_lower_inplace(name.data(), name.size());
 
 					if (utils::string::match_compare(input, name, exact))
 					{
@@ -435,12 +441,10 @@ namespace game_console
 		vsprintf_s(va_buffer, fmt, ap);
 		va_end(ap);
 
-		const auto formatted = std::string(va_buffer);
-		const auto lines = utils::string::split(formatted, '\n');
-
-		for (const auto& line : lines)
+		utils::string::tokenizer lines(va_buffer, '\n');
+		for (std::string_view line; lines.next(line);)
 		{
-			print_internal(line);
+			print_internal(std::string(line));
 		}
 	}
 
@@ -458,10 +462,10 @@ namespace game_console
 			return;
 		}
 
-		const auto lines = utils::string::split(data, '\n');
-		for (const auto& line : lines)
+		utils::string::tokenizer lines(data, '\n');
+		for (std::string_view line; lines.next(line);)
 		{
-			print_internal(type == console::con_type_info ? line : "^"s.append(std::to_string(type)).append(line));
+			print_internal(type == console::con_type_info ? std::string(line) : "^"s.append(std::to_string(type)).append(line));
 		}
 	}
 
@@ -462,12 +462,13 @@ namespace gsc
 				const auto filename = args[0].as<std::string>();
 				const auto function = args[1].as<std::string>();
 
-				if (!scripting::script_function_table[filename].contains(function))
+				const auto pos = scripting::find_script_function(filename, function);
+				if (!pos)
 				{
 					throw std::runtime_error("function not found");
 				}
 
-				return scripting::function{scripting::script_function_table[filename][function]};
+				return scripting::function{pos};
 			});
 
 			function::add("replacefunc", [](const function_args& args)
@@ -329,15 +329,14 @@ namespace gsc
 
 			if (root_dir.generic_string() == "zone"s)
 			{
-				fastfiles::enum_assets(game::ASSET_TYPE_RAWFILE, [&subfolder](game::XAssetHeader header)
+				const auto subfolder_name = subfolder.generic_string();
+				fastfiles::enum_asset_entries(game::ASSET_TYPE_RAWFILE, subfolder_name, [](game::XAssetEntry* entry)
 					{
-						const auto* rawfile = header.rawfile;
+						const auto* rawfile = entry->asset.header.rawfile;
 						if (rawfile)
 						{
 							std::string rawfile_name = rawfile->name;
-
-							const auto subfolder_name = subfolder.generic_string();
-							if (!rawfile_name.starts_with(subfolder_name) || !rawfile_name.ends_with(".gsc"))
+							if (!rawfile_name.ends_with(".gsc"))
 							{
 								return;
 							}
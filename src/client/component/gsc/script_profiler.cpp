@@ -0,0 +1,283 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "script_profiler.hpp"
+
+#include "component/command.hpp"
+#include "component/console.hpp"
+#include "component/scheduler.hpp"
+#include "component/scripting.hpp"
+
+#include <utils/concurrency.hpp>
+#include <utils/io.hpp>
+
+namespace gsc::profiler
+{
+	namespace
+	{
+		// must be a power of two
+		constexpr auto ring_size = 0x4000u;
+		// amount of opcodes executed between two clock reads
+		constexpr auto clock_check_period = 32u;
+		constexpr auto max_recorded_samples = 250'000u;
+
+		struct
+		{
+			std::array<sample_t, ring_size> samples;
+			std::atomic<std::uint64_t> head;
+			std::atomic<std::uint64_t> tail;
+		} ring{};
+
+		std::atomic_bool active = false;
+		std::atomic<std::uint64_t> dropped_samples = 0;
+
+		std::chrono::steady_clock::time_point start_time;
+		std::chrono::steady_clock::time_point next_sample_time;
+		std::chrono::microseconds sample_interval = 1000us;
+		std::uint32_t clock_check_countdown = 0;
+
+		utils::concurrency::container<std::vector<sample_t>> recorded_samples;
+
+		// single producer (the VM thread), the consumer side is serialized through the recorded_samples lock
+		void push_sample(const sample_t& sample)
+		{
+			const auto head = ring.head.load(std::memory_order_relaxed);
+			const auto tail = ring.tail.load(std::memory_order_acquire);
+			if (head - tail >= ring_size)
+			{
+				++dropped_samples;
+				return;
+			}
+
+			ring.samples[head & (ring_size - 1)] = sample;
+			ring.head.store(head + 1, std::memory_order_release);
+		}
+
+		void drain_ring()
+		{
+			recorded_samples.access([](std::vector<sample_t>& samples)
+			{
+				auto tail = ring.tail.load(std::memory_order_relaxed);
+				const auto head = ring.head.load(std::memory_order_acquire);
+
+				for (; tail != head; ++tail)
+				{
+					if (samples.size() >= max_recorded_samples)
+					{
+						++dropped_samples;
+						continue;
+					}
+
+					samples.push_back(ring.samples[tail & (ring_size - 1)]);
+				}
+
+				ring.tail.store(tail, std::memory_order_release);
+			});
+		}
+
+		void reset()
+		{
+			drain_ring();
+			recorded_samples.access([](std::vector<sample_t>& samples)
+			{
+				samples.clear();
+				samples.shrink_to_fit();
+			});
+
+			dropped_samples = 0;
+		}
+
+		void start(const std::chrono::microseconds interval)
+		{
+			if (active)
+			{
+				console::info("GSC profiler is already running\n");
+				return;
+			}
+
+			reset();
+
+			sample_interval = interval;
+			start_time = std::chrono::steady_clock::now();
+			next_sample_time = start_time;
+			clock_check_countdown = 0;
+			active = true;
+
+			console::info("GSC profiler started (%lld us interval)\n", interval.count());
+		}
+
+		void stop()
+		{
+			if (!active)
+			{
+				return;
+			}
+
+			active = false;
+			drain_ring();
+
+			const auto count = recorded_samples.access<std::size_t>([](const std::vector<sample_t>& samples)
+			{
+				return samples.size();
+			});
+
+			console::info("GSC profiler stopped, %zu samples recorded (%llu dropped)\n", count, dropped_samples.load());
+		}
+
+		void dump(const std::string& name)
+		{
+			drain_ring();
+
+			const auto samples = recorded_samples.access<std::vector<sample_t>>([](const std::vector<sample_t>& recorded)
+			{
+				return recorded;
+			});
+
+			if (samples.empty())
+			{
+				console::info("GSC profiler has no samples to dump\n");
+				return;
+			}
+
+			// positions are only valid while the scripts are loaded, this runs on the server thread
+			const auto resolver = create_resolver(scripting::script_function_table_sort);
+			const auto profile = aggregate(samples, resolver);
+
+			const auto collapsed_path = std::format("hmw-mod\\profiles\\{}.folded", name);
+			const auto trace_path = std::format("hmw-mod\\profiles\\{}.json", name);
+
+			utils::io::write_file(collapsed_path, export_collapsed(profile));
+			utils::io::write_file(trace_path, export_chrome_trace(samples, resolver));
+
+			std::vector<std::pair<std::string, function_stats_t>> functions(profile.functions.begin(), profile.functions.end());
+			std::sort(functions.begin(), functions.end(), [](const auto& a, const auto& b)
+			{
+				return a.second.self_samples > b.second.self_samples;
+			});
+
+			console::info("---- GSC profile (%llu samples) ----\n", profile.sample_count);
+			for (auto i = 0u; i < functions.size() && i < 10; ++i)
+			{
+				const auto& [function_name, stats] = functions[i];
+				console::info("%6.2f%% self %6.2f%% total  %s\n",
+					100.0 * static_cast<double>(stats.self_samples) / static_cast<double>(profile.sample_count),
+					100.0 * static_cast<double>(stats.total_samples) / static_cast<double>(profile.sample_count),
+					function_name.data());
+			}
+
+			console::info("Wrote '%s' and '%s'\n", collapsed_path.data(), trace_path.data());
+		}
+	}
+
+	bool is_active()
+	{
+		return active.load(std::memory_order_relaxed);
+	}
+
+	void sample(const char* pos)
+	{
+		if (!is_active())
+		{
+			return;
+		}
+
+		if (clock_check_countdown-- != 0)
+		{
+			return;
+		}
+
+		clock_check_countdown = clock_check_period;
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now < next_sample_time)
+		{
+			return;
+		}
+
+		next_sample_time = now + sample_interval;
+
+		sample_t sample{};
+		sample.time = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - start_time).count());
+
+		// the top frame keeps a stale position, the current one is passed in by the VM hook
+		const auto* last = game::scr_VmPub->function_frame;
+		const auto* first = game::scr_VmPub->function_frame_start + 1;
+		if (last - first > static_cast<std::ptrdiff_t>(max_depth - 1))
+		{
+			first = last - (max_depth - 1);
+		}
+
+		for (auto* frame = first; frame < last; ++frame)
+		{
+			sample.frames[sample.depth++] = frame->fs.pos;
+		}
+
+		sample.frames[sample.depth++] = pos;
+
+		push_sample(sample);
+	}
+
+	class component final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			command::add("gsc_profiler_start", [](const command::params& params)
+			{
+				const auto interval = params.size() >= 2 ? std::max(std::atoi(params.get(1)), 50) : 1000;
+				scheduler::once([interval]()
+				{
+					start(std::chrono::microseconds(interval));
+				}, scheduler::pipeline::server);
+			});
+
+			command::add("gsc_profiler_stop", []()
+			{
+				stop();
+			});
+
+			command::add("gsc_profiler_dump", [](const command::params& params)
+			{
+				const std::string name = params.size() >= 2 ? params.get(1) : "gsc_profile";
+				scheduler::once([name]()
+				{
+					dump(name);
+				}, scheduler::pipeline::server);
+			});
+
+			scheduler::loop([]()
+			{
+				if (is_active())
+				{
+					drain_ring();
+				}
+			}, scheduler::pipeline::async);
+
+			scripting::on_shutdown([](bool free_scripts, bool post_shutdown)
+			{
+				// recorded positions point into the freed bytecode and can't be resolved anymore
+				if (!free_scripts || post_shutdown)
+				{
+					return;
+				}
+
+				active = false;
+				drain_ring();
+
+				const auto has_samples = recorded_samples.access<bool>([](const std::vector<sample_t>& samples)
+				{
+					return !samples.empty();
+				});
+
+				if (has_samples)
+				{
+					reset();
+					console::warn("GSC profiler samples were discarded because the scripts were unloaded\n");
+				}
+			});
+		}
+	};
+}
+
+REGISTER_COMPONENT(gsc::profiler::component)
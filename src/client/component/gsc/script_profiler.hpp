@@ -0,0 +1,48 @@
+#pragma once
+
+namespace gsc::profiler
+{
+	constexpr auto max_depth = 16u;
+
+	struct sample_t
+	{
+		std::uint64_t time; // microseconds since the profiler was started
+		std::uint32_t depth;
+		const char* frames[max_depth]; // outermost caller first, current position last
+	};
+
+	struct frame_info_t
+	{
+		std::string file;
+		std::string function;
+	};
+
+	using resolver_t = std::function<std::optional<frame_info_t>(const char*)>;
+
+	// file -> (function, position) in the layout of scripting::script_function_table_sort,
+	// where an end_marker entry holds the end of the file's bytecode
+	using function_table_t = std::unordered_map<std::string, std::vector<std::pair<std::string, const char*>>>;
+	constexpr std::string_view end_marker = "__end__";
+
+	struct function_stats_t
+	{
+		std::uint64_t self_samples;
+		std::uint64_t total_samples;
+	};
+
+	struct profile_t
+	{
+		std::uint64_t sample_count;
+		std::map<std::string, std::uint64_t> stacks; // collapsed stack -> sample count
+		std::unordered_map<std::string, function_stats_t> functions; // file::function -> stats
+	};
+
+	bool is_active();
+	void sample(const char* pos);
+
+	// resolving, aggregation and export work on recorded sample streams only, nothing here touches the VM
+	resolver_t create_resolver(const function_table_t& functions);
+	profile_t aggregate(const std::vector<sample_t>& samples, const resolver_t& resolver);
+	std::string export_collapsed(const profile_t& profile);
+	std::string export_chrome_trace(const std::vector<sample_t>& samples, const resolver_t& resolver);
+}
@@ -0,0 +1,234 @@
+#include <std_include.hpp>
+
+#include "script_profiler.hpp"
+
+namespace gsc::profiler
+{
+	namespace
+	{
+		struct function_range_t
+		{
+			const char* start;
+			const char* end;
+			frame_info_t info;
+		};
+
+		std::string get_frame_name(const resolver_t& resolver, const char* pos)
+		{
+			const auto info = resolver(pos);
+			if (!info.has_value())
+			{
+				return "unknown";
+			}
+
+			return std::format("{}::{}", info->file, info->function);
+		}
+	}
+
+	resolver_t create_resolver(const function_table_t& functions)
+	{
+		auto ranges = std::make_shared<std::vector<function_range_t>>();
+
+		for (const auto& [file, entries] : functions)
+		{
+			const char* script_end = nullptr;
+			std::vector<std::pair<const char*, const std::string*>> starts;
+
+			for (const auto& [name, pos] : entries)
+			{
+				if (name == end_marker)
+				{
+					script_end = pos;
+					continue;
+				}
+
+				starts.emplace_back(pos, &name);
+			}
+
+			std::sort(starts.begin(), starts.end());
+
+			for (auto i = 0u; i < starts.size(); ++i)
+			{
+				// the last function runs up to the end of the bytecode
+				const auto* end = i + 1 < starts.size() ? starts[i + 1].first : script_end;
+				ranges->emplace_back(starts[i].first, end, frame_info_t{file, *starts[i].second});
+			}
+		}
+
+		std::sort(ranges->begin(), ranges->end(), [](const function_range_t& a, const function_range_t& b)
+		{
+			return a.start < b.start;
+		});
+
+		// without a known end the last function of a script is closed by whatever comes next
+		for (auto i = 0u; i < ranges->size(); ++i)
+		{
+			auto& range = (*ranges)[i];
+			if (!range.end && i + 1 < ranges->size())
+			{
+				range.end = (*ranges)[i + 1].start;
+			}
+		}
+
+		return [ranges](const char* pos) -> std::optional<frame_info_t>
+		{
+			auto itr = std::upper_bound(ranges->begin(), ranges->end(), pos, [](const char* value, const function_range_t& range)
+			{
+				return value < range.start;
+			});
+
+			if (itr == ranges->begin())
+			{
+				return {};
+			}
+
+			--itr;
+			if (pos >= itr->end)
+			{
+				return {};
+			}
+
+			return {itr->info};
+		};
+	}
+
+	profile_t aggregate(const std::vector<sample_t>& samples, const resolver_t& resolver)
+	{
+		profile_t profile{};
+		std::unordered_map<const char*, std::string> names;
+
+		const auto get_name = [&](const char* pos) -> const std::string&
+		{
+			auto itr = names.find(pos);
+			if (itr == names.end())
+			{
+				itr = names.emplace(pos, get_frame_name(resolver, pos)).first;
+			}
+
+			return itr->second;
+		};
+
+		std::vector<const std::string*> stack;
+		std::string collapsed;
+
+		for (const auto& sample : samples)
+		{
+			if (!sample.depth)
+			{
+				continue;
+			}
+
+			stack.clear();
+			collapsed.clear();
+
+			for (auto i = 0u; i < sample.depth && i < max_depth; ++i)
+			{
+				const auto& name = get_name(sample.frames[i]);
+				if (!collapsed.empty())
+				{
+					collapsed.push_back(';');
+				}
+
+				collapsed.append(name);
+
+				// recursive functions only count once towards their total, frames at different positions
+				// of the same function have their own copy of the name
+				if (std::none_of(stack.begin(), stack.end(), [&](const std::string* frame) { return *frame == name; }))
+				{
+					++profile.functions[name].total_samples;
+				}
+
+				stack.push_back(&name);
+			}
+
+			++profile.functions[*stack.back()].self_samples;
+			++profile.stacks[collapsed];
+			++profile.sample_count;
+		}
+
+		return profile;
+	}
+
+	std::string export_collapsed(const profile_t& profile)
+	{
+		std::string buffer;
+
+		for (const auto& [stack, count] : profile.stacks)
+		{
+			buffer.append(stack);
+			buffer.push_back(' ');
+			buffer.append(std::to_string(count));
+			buffer.push_back('\n');
+		}
+
+		return buffer;
+	}
+
+	std::string export_chrome_trace(const std::vector<sample_t>& samples, const resolver_t& resolver)
+	{
+		auto events = nlohmann::json::array();
+		std::unordered_map<const char*, std::string> names;
+		std::vector<std::string> open_frames;
+
+		const auto add_event = [&](const char* phase, const std::string& name, const std::uint64_t time)
+		{
+			nlohmann::json event;
+			event["name"] = name;
+			event["cat"] = "gsc";
+			event["ph"] = phase;
+			event["ts"] = time;
+			event["pid"] = 0;
+			event["tid"] = 0;
+			events.push_back(event);
+		};
+
+		// consecutive samples sharing a stack prefix are merged into one slice per frame
+		std::uint64_t last_time = 0;
+		for (const auto& sample : samples)
+		{
+			std::vector<std::string> frames;
+			for (auto i = 0u; i < sample.depth && i < max_depth; ++i)
+			{
+				auto itr = names.find(sample.frames[i]);
+				if (itr == names.end())
+				{
+					itr = names.emplace(sample.frames[i], get_frame_name(resolver, sample.frames[i])).first;
+				}
+
+				frames.push_back(itr->second);
+			}
+
+			auto common = 0u;
+			while (common < frames.size() && common < open_frames.size() && frames[common] == open_frames[common])
+			{
+				++common;
+			}
+
+			while (open_frames.size() > common)
+			{
+				add_event("E", open_frames.back(), sample.time);
+				open_frames.pop_back();
+			}
+
+			for (auto i = common; i < frames.size(); ++i)
+			{
+				add_event("B", frames[i], sample.time);
+				open_frames.push_back(frames[i]);
+			}
+
+			last_time = sample.time;
+		}
+
+		while (!open_frames.empty())
+		{
+			add_event("E", open_frames.back(), last_time);
+			open_frames.pop_back();
+		}
+
+		nlohmann::json trace;
+		trace["traceEvents"] = events;
+		trace["displayTimeUnit"] = "ms";
+
+		return trace.dump();
+	}
+}
@@ -15,6 +15,9 @@
 #include <utils/string.hpp>
 #include <utils/hook.hpp>
 #include <utils/concurrency.hpp>
+#include <utils/spatial_grid.hpp>
+
+#include <array>
 
 namespace gui::debug
 {
@@ -102,6 +105,24 @@ namespace gui::debug
 			bool valid;
 		};
 
+		// pathnodes don't move, the index is built once per map
+		struct
+		{
+			const game::pathnode_t* nodes;
+			unsigned int node_count;
+			std::vector<std::array<float, 3>> origins;
+			utils::spatial_grid grid;
+		} path_node_index{};
+
+		// entities are moved into their current cell every frame
+		struct
+		{
+			int entity_count;
+			utils::spatial_grid grid;
+		} entity_index{};
+
+		std::vector<uint32_t> query_results;
+
 		float vector_dot(float* a, float* b)
 		{
 			return (a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2]);
@@ -539,19 +560,104 @@ namespace gui::debug
 			game::WorldifyPosFromParent(node, out);
 		}
 
+		void update_path_node_index()
+		{
+			const auto& pathdata = *game::pathdata;
+			if (path_node_index.nodes == pathdata.nodes && path_node_index.node_count == pathdata.nodeCount)
+			{
+				return;
+			}
+
+			path_node_index.nodes = pathdata.nodes;
+			path_node_index.node_count = pathdata.nodeCount;
+			path_node_index.origins.resize(pathdata.nodeCount);
+			path_node_index.grid.clear();
+
+			for (unsigned int i = 0; i < pathdata.nodeCount; i++)
+			{
+				auto& origin = path_node_index.origins[i];
+				get_pathnode_origin(&pathdata.nodes[i], origin.data());
+				path_node_index.grid.update(i, origin.data());
+			}
+		}
+
+		void update_entity_index()
+		{
+			const auto entity_count = *game::num_entities;
+
+			for (auto i = 0; i < entity_count; i++)
+			{
+				entity_index.grid.update(i, game::g_entities[i].origin);
+			}
+
+			for (auto i = entity_count; i < entity_index.entity_count; i++)
+			{
+				entity_index.grid.remove(i);
+			}
+
+			entity_index.entity_count = entity_count;
+		}
+
+		utils::spatial_grid::plane make_view_plane(const float* normal)
+		{
+			utils::spatial_grid::plane plane{};
+
+			const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			for (auto i = 0; i < 3; i++)
+			{
+				plane.normal[i] = normal[i] / length;
+			}
+
+			plane.distance = -(plane.normal[0] * camera[0] + plane.normal[1] * camera[1] + plane.normal[2] * camera[2]);
+			return plane;
+		}
+
+		// same projection as world_pos_to_screen_pos, fovX and fovY are the tangents of the half angles
+		bool get_view_frustum(utils::spatial_grid::frustum& frustum)
+		{
+			const auto refdef = *game::refdef;
+			if (refdef == nullptr)
+			{
+				return false;
+			}
+
+			frustum.planes[0] = make_view_plane(axis[0]);
+			frustum.planes[0].distance -= 0.01f;
+
+			const float* side_axes[2] = {axis[1], axis[2]};
+			const float tangents[2] = {refdef->fovX, refdef->fovY};
+
+			for (auto i = 0; i < 2; i++)
+			{
+				for (auto sign = -1; sign <= 1; sign += 2)
+				{
+					float normal[3]{};
+					for (auto j = 0; j < 3; j++)
+					{
+						normal[j] = axis[0][j] * tangents[i] + side_axes[i][j] * static_cast<float>(sign);
+					}
+
+					frustum.planes[1 + i * 2 + (sign > 0)] = make_view_plane(normal);
+				}
+			}
+
+			return true;
+		}
+
 		void draw_node_links(game::pathnode_t* node, float* origin)
 		{
 			for (unsigned int i = 0; i < node->constant.totalLinkCount; i++)
 			{
-				float linked_origin[3] = {};
 				const auto num = node->constant.Links[i].nodeNum;
-				auto pathdata = *game::pathdata;
-				const auto linked = &pathdata.nodes[num];
+				if (num >= path_node_index.origins.size())
+				{
+					continue;
+				}
 
-				get_pathnode_origin(linked, linked_origin);
-				if (distance_2d(path_node_settings.camera, linked_origin) < path_node_settings.range)
+				auto& linked_origin = path_node_index.origins[num];
+				if (distance_2d(path_node_settings.camera, linked_origin.data()) < path_node_settings.range)
 				{
-					draw_line(origin, linked_origin, path_node_settings.color,
+					draw_line(origin, linked_origin.data(), path_node_settings.color,
 						path_node_settings.link_thickness);
 				}
 			}
@@ -587,17 +693,29 @@ namespace gui::debug
 				return;
 			}
 
+			update_path_node_index();
+
+			query_results.clear();
+
+			// links of nodes outside the view can still cross it, those need everything in range
+			utils::spatial_grid::frustum frustum{};
+			if (!path_node_settings.draw_node_links && get_view_frustum(frustum))
+			{
+				path_node_index.grid.query_frustum(frustum, path_node_settings.size * 2.f, path_node_settings.camera,
+					path_node_settings.range, query_results);
+			}
+			else
+			{
+				path_node_index.grid.query_radius(path_node_settings.camera, path_node_settings.range, query_results);
+			}
+
+			std::sort(query_results.begin(), query_results.end());
+
 			auto pathdata = *game::pathdata;
-			for (unsigned int i = 0; i < pathdata.nodeCount; i++)
+			for (const auto i : query_results)
 			{
-				float origin[3] = {};
 				const auto node = &pathdata.nodes[i];
-
-				get_pathnode_origin(node, origin);
-				if (distance_2d(path_node_settings.camera, origin) >= path_node_settings.range)
-				{
-					continue;
-				}
+				const auto origin = path_node_index.origins[i].data();
 
 				float screen_center[2]{};
 				ImGuiWindow* window = ImGui::GetCurrentWindow();
@@ -649,15 +767,19 @@ namespace gui::debug
 				return;
 			}
 
-			for (auto i = 0; i < *game::num_entities; i++)
+			update_entity_index();
+
+			query_results.clear();
+			entity_index.grid.query_radius(entity_bound_settings.camera, entity_bound_settings.range, query_results);
+			std::sort(query_results.begin(), query_results.end());
+
+			for (const auto i : query_results)
 			{
 				const auto entity = &game::g_entities[i];
 				const auto origin = entity->origin;
 
-				const auto distance = distance_2d(entity_bound_settings.camera, origin);
 				const auto* classname = game::SL_ConvertToString(entity->script_classname);
-
-				if (distance > entity_bound_settings.range || !classname)
+				if (!classname)
 				{
 					continue;
 				}
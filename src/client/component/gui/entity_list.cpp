@@ -351,6 +351,25 @@ namespace gui::entity_list
 			return {};
 		}
 
+		// plain entities are read from g_entities, everything else still goes through the vm
+		float get_distance(const scripting::entity& player, const scripting::entity& entity)
+		{
+			const auto entref = entity.get_entity_reference();
+			if (entref.classnum != 0 || entref.entnum >= *game::num_entities)
+			{
+				return scripting::call("distance", {player.get("origin"), entity.get("origin")}).as<float>();
+			}
+
+			const auto* a = game::g_entities[0].origin;
+			const auto* b = game::g_entities[entref.entnum].origin;
+
+			const auto x = a[0] - b[0];
+			const auto y = a[1] - b[1];
+			const auto z = a[2] - b[2];
+
+			return std::sqrt(x * x + y * y + z * z);
+		}
+
 		void update_entity_list()
 		{
 			data_.access([](data_t& data)
@@ -392,7 +411,7 @@ namespace gui::entity_list
 
 					if (data.filters.filter_by_range)
 					{
-						const auto distance = scripting::call("distance", {player.get("origin"), entity.get("origin")}).as<float>();
+						const auto distance = get_distance(player, entity);
 
 						if (distance > data.filters.range)
 						{
@@ -9,52 +9,59 @@
 
 #include <utils/hook.hpp>
 #include <utils/string.hpp>
-#include <utils/image.hpp>
-#include <utils/io.hpp>
-#include <utils/concurrency.hpp>
+#include <utils/texture_cache.hpp>
 
 namespace images
 {
 	namespace
 	{
+		constexpr auto max_cached_texture_bytes = 128ull * 1024 * 1024;
+		constexpr auto max_persistent_texture_dimension = 2048;
+		constexpr auto max_persistent_texture_bytes = 256ull * 1024 * 1024;
+
 		utils::hook::detour load_texture_hook;
 		utils::hook::detour setup_texture_hook;
-		utils::concurrency::container<std::unordered_map<std::string, std::string>> overriden_textures;
 
-		std::optional<std::string> load_image(game::GfxImage* image)
+		// intentionally leaked, the render thread can still load textures while components are destroyed
+		utils::texture_cache& get_texture_cache()
 		{
-			std::string data{};
-			overriden_textures.access([&](const std::unordered_map<std::string, std::string>& textures)
+			static auto* cache = new utils::texture_cache(max_cached_texture_bytes, 2, "players2/cache/images",
+				max_persistent_texture_dimension, max_persistent_texture_bytes);
+			return *cache;
+		}
+
+		utils::texture_cache::texture_ptr load_texture(game::GfxImage* image)
+		{
+			auto& cache = get_texture_cache();
+
+			utils::texture_cache::texture_ptr texture{};
+			if (cache.contains(image->name))
 			{
-				if (const auto i = textures.find(image->name); i != textures.end())
+				texture = cache.get(image->name);
+			}
+			else
+			{
+				std::string data{};
+				if (!filesystem::read_file(utils::string::va("images/%s.png", image->name), &data))
 				{
-					data = i->second;
+					return {};
 				}
-			});
 
-			if (data.empty() && !filesystem::read_file(utils::string::va("images/%s.png", image->name), &data))
-			{
-				return {};
+				texture = cache.get_or_decode(std::move(data));
 			}
 
-			return {std::move(data)};
-		}
-
-		std::optional<utils::image> load_raw_image_from_file(game::GfxImage* image)
-		{
-			const auto image_file = load_image(image);
-			if (!image_file)
+			if (!texture)
 			{
-				return {};
+				throw std::runtime_error("Unable to load image");
 			}
 
-			return utils::image(*image_file);
+			return texture;
 		}
 
 		bool load_custom_texture(game::GfxImage* image)
 		{
-			auto raw_image = load_raw_image_from_file(image);
-			if (!raw_image)
+			const auto texture = load_texture(image);
+			if (!texture)
 			{
 				return false;
 			}
@@ -65,11 +72,11 @@ namespace images
 			image->flags = 0;
 
 			D3D11_SUBRESOURCE_DATA data{};
-			data.SysMemPitch = raw_image->get_width() * 4;
-			data.SysMemSlicePitch = data.SysMemPitch * raw_image->get_height();
-			data.pSysMem = raw_image->get_buffer();
+			data.SysMemPitch = texture->width * 4;
+			data.SysMemSlicePitch = data.SysMemPitch * texture->height;
+			data.pSysMem = texture->pixels.data();
 
-			game::Image_Setup(image, raw_image->get_width(), raw_image->get_height(), image->depth, image->numElements,
+			game::Image_Setup(image, texture->width, texture->height, image->depth, image->numElements,
 				image->mapType, DXGI_FORMAT_R8G8B8A8_UNORM, image->name, &data);
 
 			return true;
@@ -106,12 +113,9 @@ namespace images
 		}
 	}
 
-	void override_texture(std::string name, std::string data)
+	void override_texture(const std::string& name, std::string data, const bool persistent)
 	{
-		overriden_textures.access([&](std::unordered_map<std::string, std::string>& textures)
-		{
-			textures[std::move(name)] = std::move(data);
-		});
+		get_texture_cache().submit(name, std::move(data), persistent);
 	}
 
 	class component final : public component_interface
@@ -127,6 +131,16 @@ namespace images
 			setup_texture_hook.create(0xA4AA0_b, setup_texture_stub);
 			load_texture_hook.create(0x6829C0_b, load_texture_stub);
 		}
+
+		void pre_destroy() override
+		{
+			if (game::environment::is_dedi())
+			{
+				return;
+			}
+
+			get_texture_cache().stop();
+		}
 	};
 }
 
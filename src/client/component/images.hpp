@@ -2,5 +2,6 @@
 
 namespace images
 {
-	void override_texture(std::string name, std::string data);
+	// decoded in the background, persistent textures are kept decoded on disk across launches
+	void override_texture(const std::string& name, std::string data, bool persistent = false);
 }
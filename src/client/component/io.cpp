@@ -5,6 +5,7 @@
 #include "component/console.hpp"
 #include "component/logfile.hpp"
 #include "component/scheduler.hpp"
+#include "component/scripting.hpp"
 #include "component/gsc/script_extension.hpp"
 
 #include "game/dvars.hpp"
@@ -12,10 +13,12 @@
 
 #include "game/scripting/execution.hpp"
 
+#include <utils/concurrency.hpp>
 #include <utils/hook.hpp>
 #include <utils/http.hpp>
 #include <utils/flags.hpp>
 #include <utils/io.hpp>
+#include <utils/io_queue.hpp>
 
 namespace io
 {
@@ -23,6 +26,93 @@ namespace io
 	{
 		//bool allow_root_io = false;
 
+		// async results delivered per frame, the rest waits for the next one
+		constexpr auto max_completions_per_frame = 16u;
+
+		struct async_state
+		{
+			std::unique_ptr<utils::io::async_queue> queue;
+			// set by pre_destroy, nothing is polled or submitted afterwards
+			bool stopped = false;
+		};
+
+		utils::concurrency::container<async_state> async_io;
+
+		// results of requests made before the last script restart are dropped
+		uint64_t discard_before = 0;
+
+		template <typename F>
+		uint64_t submit_async(F&& submit)
+		{
+			return async_io.access<uint64_t>([&](async_state& state)
+			{
+				if (state.stopped)
+				{
+					throw std::runtime_error("file io is shutting down");
+				}
+
+				if (!state.queue)
+				{
+					state.queue = std::make_unique<utils::io::async_queue>(2);
+				}
+
+				return submit(*state.queue);
+			});
+		}
+
+		void dispatch_async_results()
+		{
+			const auto results = async_io.access<std::vector<utils::io::async_queue::result>>([](async_state& state)
+			{
+				if (state.stopped || !state.queue)
+				{
+					return std::vector<utils::io::async_queue::result>{};
+				}
+
+				return state.queue->poll(max_completions_per_frame);
+			});
+
+			if (results.empty() || !game::SV_Loaded())
+			{
+				return;
+			}
+
+			for (const auto& result : results)
+			{
+				if (result.id < discard_before)
+				{
+					continue;
+				}
+
+				scripting::script_value value{};
+				switch (result.type)
+				{
+				case utils::io::async_queue::operation_type::read:
+					value = result.data;
+					break;
+				case utils::io::async_queue::operation_type::list:
+				{
+					scripting::array array{};
+					for (const auto& file : result.files)
+					{
+						array.push(file);
+					}
+
+					value = array;
+					break;
+				}
+				case utils::io::async_queue::operation_type::size:
+					value = static_cast<uint32_t>(result.size);
+					break;
+				default:
+					break;
+				}
+
+				scripting::notify(*game::levelEntityId, "io_complete",
+					{static_cast<int>(result.id), result.success, value});
+			}
+		}
+
 		void check_path(const std::filesystem::path& path)
 		{
 			if (path.generic_string().find("..") != std::string::npos)
@@ -79,6 +169,20 @@ namespace io
 	class component final : public component_interface
 	{
 	public:
+		void pre_destroy() override
+		{
+			// the server pipeline may still be polling, once stopped is set under the lock nothing touches the queue
+			std::unique_ptr<utils::io::async_queue> queue;
+			async_io.access([&](async_state& state)
+			{
+				state.stopped = true;
+				queue = std::move(state.queue);
+			});
+
+			// waits for queued writes to reach the disk
+			queue.reset();
+		}
+
 		void post_unpack() override
 		{
 			/*
@@ -168,6 +272,77 @@ namespace io
 				return utils::io::remove_file(path);
 			});
 
+			// the async variants return a request id, the result arrives as level notify "io_complete" (id, success, result)
+			gsc::function::add("readfileasync", [](const gsc::function_args& args)
+			{
+				const auto path = convert_path(args[0].as<std::string>());
+				return static_cast<int>(submit_async([&](utils::io::async_queue& queue)
+				{
+					return queue.read(path);
+				}));
+			});
+
+			gsc::function::add("writefileasync", [](const gsc::function_args& args)
+			{
+				const auto path = convert_path(args[0].as<std::string>());
+				auto data = args[1].as<std::string>();
+
+				auto append = false;
+				if (args.size() > 2u)
+				{
+					append = args[2].as<bool>();
+				}
+
+				return static_cast<int>(submit_async([&](utils::io::async_queue& queue)
+				{
+					return queue.write(path, std::move(data), append);
+				}));
+			});
+
+			gsc::function::add("listfilesasync", [](const gsc::function_args& args)
+			{
+				const auto path = convert_path(args[0].as<std::string>());
+				return static_cast<int>(submit_async([&](utils::io::async_queue& queue)
+				{
+					return queue.list(path);
+				}));
+			});
+
+			gsc::function::add("filesizeasync", [](const gsc::function_args& args)
+			{
+				const auto path = convert_path(args[0].as<std::string>());
+				return static_cast<int>(submit_async([&](utils::io::async_queue& queue)
+				{
+					return queue.size(path);
+				}));
+			});
+
+			gsc::function::add("copyfolderasync", [](const gsc::function_args& args)
+			{
+				const auto source = convert_path(args[0].as<std::string>());
+				const auto target = convert_path(args[1].as<std::string>());
+				return static_cast<int>(submit_async([&](utils::io::async_queue& queue)
+				{
+					return queue.copy(source, target);
+				}));
+			});
+
+			scheduler::loop(dispatch_async_results, scheduler::pipeline::server);
+
+			scripting::on_shutdown([](bool free_scripts, bool post_shutdown)
+			{
+				if (free_scripts && !post_shutdown)
+				{
+					async_io.access([](async_state& state)
+					{
+						if (state.queue)
+						{
+							discard_before = state.queue->get_next_id();
+						}
+					});
+				}
+			});
+
 			gsc::function::add("va", [](const gsc::function_args& args)
 			{
 				auto fmt = args[0].as<std::string>();
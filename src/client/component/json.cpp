@@ -8,140 +8,294 @@
 #include "game/scripting/execution.hpp"
 #include "game/scripting/function.hpp"
 
+#include <utils/json_stream.hpp>
+#include <utils/string.hpp>
+
 #include <json.hpp>
 
 namespace json
 {
 	namespace
 	{
-		nlohmann::json gsc_to_json(scripting::script_value _value);
+		// scripts feed these with downloaded or user provided data, a self referencing array used to overflow the stack
+		constexpr size_t max_depth = 64;
+		constexpr size_t max_json_size = 16ull * 1024ull * 1024ull;
+
+		// output of the last serialization, the capacity is reused
+		std::string serialize_buffer;
 
-		nlohmann::json entity_to_array(unsigned int id)
+		// builds script arrays while parsing instead of converting a nlohmann::json tree afterwards
+		struct script_values
 		{
-			scripting::array array(id);
-			nlohmann::json obj;
+			using value_type = scripting::script_value;
+			using container_type = scripting::array;
+
+			value_type null()
+			{
+				return {};
+			}
+
+			// booleans never had a script representation, they stay undefined like they used to
+			value_type boolean(bool /*value*/)
+			{
+				return {};
+			}
 
-			auto string_indexed = -1;
-			const auto keys = array.get_keys();
-			for (auto i = 0; i < keys.size(); i++)
+			value_type integer(const int64_t value)
 			{
-				const auto is_int = keys[i].is<int>();
-				const auto is_string = keys[i].is<std::string>();
+				return static_cast<int>(value);
+			}
+
+			value_type floating(const double value)
+			{
+				return static_cast<float>(value);
+			}
+
+			value_type string(const std::string& value)
+			{
+				return value;
+			}
+
+			container_type container(bool /*is_object*/)
+			{
+				return {};
+			}
+
+			void set(container_type& array, const std::string& key, const value_type& value)
+			{
+				array.set(key, value);
+			}
+
+			void push(container_type& array, const value_type& value)
+			{
+				array.push(value);
+			}
 
-				if (string_indexed == -1)
+			value_type finish(const container_type& array)
+			{
+				return array;
+			}
+		};
+
+		// Writes the exact output nlohmann::json::dump produced for the tree the values used to be converted into
+		class json_writer final
+		{
+		public:
+			json_writer(std::string& buffer, const int indent)
+				: buffer_(buffer)
+				, writer_(buffer, indent)
+			{
+			}
+
+			void write(const scripting::script_value& value)
+			{
+				this->write_value(value, 0);
+			}
+
+		private:
+			std::string& buffer_;
+			utils::json::writer writer_;
+
+			void check_size() const
+			{
+				if (this->buffer_.size() > max_json_size)
 				{
-					string_indexed = is_string;
+					throw std::runtime_error(utils::string::va("json exceeds %zu bytes", max_json_size));
 				}
+			}
+
+			void write_value(const scripting::script_value& value, const size_t depth)
+			{
+				const auto& variable = value.get_raw();
 
-				if (!string_indexed && is_int)
+				switch (variable.type)
 				{
-					const auto index = keys[i].as<int>();
-					obj[index] = gsc_to_json(array[index]);
-				}
-				else if (string_indexed && is_string)
+				case game::VAR_UNDEFINED:
+					this->writer_.null();
+					break;
+				case game::VAR_INTEGER:
+					this->writer_.integer(variable.u.intValue);
+					break;
+				case game::VAR_FLOAT:
+					this->writer_.floating(variable.u.floatValue);
+					break;
+				case game::VAR_STRING:
+				case game::VAR_ISTRING:
+					this->writer_.string(game::SL_ConvertToString(static_cast<game::scr_string_t>(variable.u.stringValue)));
+					break;
+				case game::VAR_VECTOR:
+					this->write_vector(variable.u.vectorValue);
+					break;
+				case game::VAR_POINTER:
 				{
-					const auto key = keys[i].as<std::string>();
-					obj.emplace(key, gsc_to_json(array[key]));
+					const auto object_type = game::scr_VarGlob->objectVariableValue[variable.u.uintValue].w.type;
+
+					switch (object_type)
+					{
+					case game::VAR_OBJECT:
+						this->writer_.string("[struct]");
+						break;
+					case game::VAR_ARRAY:
+						this->write_array(variable.u.uintValue, depth + 1);
+						break;
+					default:
+						this->writer_.string("[entity]");
+						break;
+					}
+
+					break;
+				}
+				case game::VAR_FUNCTION:
+					this->writer_.string(value.as<scripting::function>().get_name());
+					break;
+				default:
+					this->writer_.string(utils::string::va("[%s]", value.type_name().data()));
+					break;
 				}
+
+				this->check_size();
 			}
 
-			return obj;
-		}
+			void write_array(const unsigned int id, const size_t depth)
+			{
+				if (depth > max_depth)
+				{
+					throw std::runtime_error(utils::string::va("array is nested deeper than %zu levels", max_depth));
+				}
 
-		nlohmann::json vector_to_array(const float* value)
-		{
-			nlohmann::json obj;
-			obj.push_back(value[0]);
-			obj.push_back(value[1]);
-			obj.push_back(value[2]);
+				const scripting::array array(id);
+				const auto keys = array.get_keys();
 
-			return obj;
-		}
+				// the first key decides whether this becomes an object or an array, keys of the other kind are dropped
+				const auto string_indexed = !keys.empty() && keys.front().is<std::string>();
 
-		nlohmann::json gsc_to_json(scripting::script_value _value)
-		{
-			const auto variable = _value.get_raw();
-			const auto value = variable.u;
-			const auto type = variable.type;
+				if (string_indexed)
+				{
+					std::vector<std::pair<std::string, scripting::script_value>> members;
+					members.reserve(keys.size());
 
-			switch (type)
-			{
-			case (game::VAR_UNDEFINED):
-				return {};
-			case (game::VAR_INTEGER):
-				return value.intValue;
-			case (game::VAR_FLOAT):
-				return value.floatValue;
-			case (game::VAR_STRING):
-			case (game::VAR_ISTRING):
-				return game::SL_ConvertToString(static_cast<game::scr_string_t>(value.stringValue));
-			case (game::VAR_VECTOR):
-				return vector_to_array(value.vectorValue);
-			case (game::VAR_POINTER):
-			{
-				const auto object_type = game::scr_VarGlob->objectVariableValue[value.uintValue].w.type;
-
-				switch (object_type)
+					for (const auto& key : keys)
+					{
+						if (key.is<std::string>())
+						{
+							members.emplace_back(key.as<std::string>(), array.get(key));
+						}
+					}
+
+					// json objects are ordered by key
+					std::ranges::sort(members, {}, &std::pair<std::string, scripting::script_value>::first);
+					this->write_object(members, depth);
+					return;
+				}
+
+				std::vector<std::pair<int, scripting::script_value>> elements;
+				elements.reserve(keys.size());
+
+				for (const auto& key : keys)
 				{
-				case (game::VAR_OBJECT):
-					return "[struct]";
-				case (game::VAR_ARRAY):
-					return entity_to_array(value.uintValue);
-				default:
-					return "[entity]";
+					if (key.is<int>() && key.as<int>() >= 0)
+					{
+						elements.emplace_back(key.as<int>(), array.get(key));
+					}
 				}
-			}
-			case (game::VAR_FUNCTION):
-				return _value.as<scripting::function>().get_name();
-			default:
-				return utils::string::va("[%s]", _value.type_name().data());
-			};
-		}
 
-		scripting::script_value json_to_gsc(nlohmann::json obj)
-		{
-			const auto type = obj.type();
+				std::ranges::sort(elements, {}, &std::pair<int, scripting::script_value>::first);
+				this->write_elements(elements, depth);
+			}
 
-			switch (type)
+			void write_object(const std::vector<std::pair<std::string, scripting::script_value>>& members, const size_t depth)
 			{
-			case (nlohmann::detail::value_t::number_integer):
-			case (nlohmann::detail::value_t::number_unsigned):
-				return obj.get<int>();
-			case (nlohmann::detail::value_t::number_float):
-				return obj.get<float>();
-			case (nlohmann::detail::value_t::string):
-				return obj.get<std::string>();
-			case (nlohmann::detail::value_t::array):
+				// an array without any usable key never turned into a container
+				if (members.empty())
+				{
+					this->writer_.null();
+					return;
+				}
+
+				this->writer_.begin_object();
+
+				for (const auto& [key, value] : members)
+				{
+					this->writer_.key(key);
+					this->write_value(value, depth);
+				}
+
+				this->writer_.end_object();
+			}
+
+			void write_elements(const std::vector<std::pair<int, scripting::script_value>>& elements, const size_t depth)
 			{
-				scripting::array array;
+				if (elements.empty())
+				{
+					this->writer_.null();
+					return;
+				}
+
+				this->writer_.begin_array();
 
-				for (const auto& [key, value] : obj.items())
+				// indices that were never assigned are filled up with nulls
+				auto next_index = 0;
+				for (const auto& [index, value] : elements)
 				{
-					array.push(json_to_gsc(value));
+					// every gap costs at least "null,"
+					if (this->buffer_.size() + static_cast<size_t>(index - next_index) * 5 > max_json_size)
+					{
+						throw std::runtime_error(utils::string::va("json exceeds %zu bytes", max_json_size));
+					}
+
+					for (; next_index < index; ++next_index)
+					{
+						this->writer_.null();
+					}
+
+					this->write_value(value, depth);
+					next_index = index + 1;
 				}
 
-				return array.get_raw();
+				this->writer_.end_array();
 			}
-			case (nlohmann::detail::value_t::object):
+
+			void write_vector(const float* value)
 			{
-				scripting::array array;
+				this->writer_.begin_array();
 
-				for (const auto& [key, value] : obj.items())
+				for (auto i = 0; i < 3; ++i)
 				{
-					array[key] = json_to_gsc(value);
+					this->writer_.floating(value[i]);
 				}
 
-				return array.get_raw();
+				this->writer_.end_array();
 			}
+		};
+
+		scripting::script_value parse(const std::string& json)
+		{
+			if (json.size() > max_json_size)
+			{
+				throw std::runtime_error(utils::string::va("json exceeds %zu bytes", max_json_size));
 			}
 
-			return {};
+			script_values values;
+			utils::json::value_builder builder(values, max_depth);
+			nlohmann::json::sax_parse(json, &builder);
+
+			return builder.take_result();
+		}
+
+		const std::string& serialize(const scripting::script_value& value, const int indent)
+		{
+			serialize_buffer.clear();
+
+			json_writer writer(serialize_buffer, indent);
+			writer.write(value);
+
+			return serialize_buffer;
 		}
 	}
 
 	std::string gsc_to_string(const scripting::script_value& value)
 	{
-		return gsc_to_json(value).dump();
+		return serialize(value, -1);
 	}
 
 	class component final : public component_interface
@@ -176,8 +330,7 @@ namespace json
 			gsc::function::add("jsonparse", [](const gsc::function_args& args)
 			{
 				const auto json = args[0].as<std::string>();
-				const auto obj = nlohmann::json::parse(json);
-				return json_to_gsc(obj);
+				return parse(json);
 			});
 
 			gsc::function::add("jsonserialize", [](const gsc::function_args& args)
@@ -190,16 +343,17 @@ namespace json
 					indent = args[1].as<int>();
 				}
 
-				return gsc_to_json(value).dump(indent);
+				return serialize(value, indent);
 			});
 
 			gsc::function::add("jsonprint", [](const gsc::function_args& args) -> scripting::script_value
 			{
 				std::string buffer;
+				json_writer writer(buffer, -1);
 
 				for (const auto arg : args.get_raw())
 				{
-					buffer.append(gsc_to_string(arg));
+					writer.write(arg);
 					buffer.append("\t");
 				}
 
@@ -5,6 +5,7 @@
 #include "component/scripting.hpp"
 #include "component/scheduler.hpp"
 #include "component/gsc/script_extension.hpp"
+#include "component/gsc/script_profiler.hpp"
 
 #include "game/dvars.hpp"
 
@@ -104,6 +105,8 @@ namespace logfile
 
 		bool execute_vm_hook(const char* pos)
 		{
+			gsc::profiler::sample(pos);
+
 			if (vm_execute_hooks.find(pos) == vm_execute_hooks.end())
 			{
 				hook_enabled = true;
@@ -4,6 +4,7 @@
 #include "command.hpp"
 #include "console.hpp"
 #include "map_rotation.hpp"
+#include "party.hpp"
 #include "scheduler.hpp"
 
 #include "game/game.hpp"
@@ -22,6 +23,9 @@ namespace map_rotation
 		const game::dvar_t* sv_map_rotation_current;
 		const game::dvar_t* sv_random_map_rotation;
 
+		// set once the upcoming order got shuffled early so the prefetcher could see it
+		bool next_rotation_shuffled = false;
+
 		void set_gametype(const std::string& gametype)
 		{
 			assert(!gametype.empty());
@@ -143,10 +147,63 @@ namespace map_rotation
 
 		void randomize_map_rotation()
 		{
+			const auto shuffled = std::exchange(next_rotation_shuffled, false);
 			if (sv_random_map_rotation->current.enabled)
 			{
 				console::info("Randomizing map rotation\n");
+				if (!shuffled)
+				{
+					dedicated_rotation.randomize();
+				}
+			}
+		}
+
+		std::optional<std::string> predict_next_map()
+		{
+			// same priority as perform_map_rotation
+			const std::string map_rotation_current = sv_map_rotation_current->current.string;
+			if (!map_rotation_current.empty())
+			{
+				rotation_data rotation_current;
+
+				try
+				{
+					rotation_current.parse(map_rotation_current);
+				}
+				catch (const std::exception&)
+				{
+					return {};
+				}
+
+				return rotation_current.peek_next_map();
+			}
+
+			load_map_rotation();
+			if (dedicated_rotation.empty())
+			{
+				return {};
+			}
+
+			if (sv_random_map_rotation->current.enabled && !next_rotation_shuffled)
+			{
 				dedicated_rotation.randomize();
+				next_rotation_shuffled = true;
+			}
+
+			return dedicated_rotation.peek_next_map();
+		}
+
+		void prefetch_next_map()
+		{
+			if (!sv_map_rotation || !game::SV_Loaded())
+			{
+				return;
+			}
+
+			const auto mapname = predict_next_map();
+			if (mapname && party::prefetch_map_files(*mapname, party::get_dvar_string("fs_game")))
+			{
+				console::debug("Prefetching files of %s\n", mapname->data());
 			}
 		}
 
@@ -160,6 +217,9 @@ namespace map_rotation
 
 			console::info("Rotating map...\n");
 
+			// whatever was prefetched is being loaded now, the next check predicts the map after it
+			party::forget_prefetched_map();
+
 			// This takes priority because of backwards compatibility
 			const std::string map_rotation_current = sv_map_rotation_current->current.string;
 			if (!map_rotation_current.empty())
@@ -197,68 +257,6 @@ namespace map_rotation
 		}
 	}
 
-	rotation_data::rotation_data()
-		: index_(0)
-	{
-	}
-
-	void rotation_data::randomize()
-	{
-		std::random_device rd;
-		std::mt19937 gen(rd());
-
-		std::ranges::shuffle(this->rotation_entries_, gen);
-	}
-
-	void rotation_data::add_entry(const std::string& key, const std::string& value)
-	{
-		this->rotation_entries_.emplace_back(std::make_pair(key, value));
-	}
-
-	bool rotation_data::contains(const std::string& key, const std::string& value) const
-	{
-		return std::ranges::any_of(this->rotation_entries_, [&](const auto& entry)
-		{
-			return entry.first == key && entry.second == value;
-		});
-	}
-
-	bool rotation_data::empty() const noexcept
-	{
-		return this->rotation_entries_.empty();
-	}
-
-	std::size_t rotation_data::get_entries_size() const noexcept
-	{
-		return this->rotation_entries_.size();
-	}
-
-	rotation_data::rotation_entry& rotation_data::get_next_entry()
-	{
-		const auto index = this->index_;
-		++this->index_ %= this->rotation_entries_.size();
-		return this->rotation_entries_.at(index);
-	}
-
-	void rotation_data::parse(const std::string& data)
-	{
-		const auto tokens = utils::string::split(data, ' ');
-		for (std::size_t i = 0; !tokens.empty() && i < (tokens.size() - 1); i += 2)
-		{
-			const auto& key = tokens[i];
-			const auto& value = tokens[i + 1];
-
-			if (key == "map"s || key == "gametype"s)
-			{
-				this->add_entry(key, value);
-			}
-			else
-			{
-				throw parse_rotation_error();
-			}
-		}
-	}
-
 	class component final : public component_interface
 	{
 	public:
@@ -279,6 +277,9 @@ namespace map_rotation
 
 			command::add("map_rotate", perform_map_rotation);
 
+			// warms up the next map's files while the current one is being played
+			scheduler::loop(prefetch_next_map, scheduler::pipeline::main, 30s);
+
 			// Hook GScr_ExitLevel 
 			utils::hook::jump(0xE2670_b, trigger_map_rotation, true); // not sure if working
 		}
@@ -24,6 +24,8 @@ namespace map_rotation
 		[[nodiscard]] bool empty() const noexcept;
 		[[nodiscard]] std::size_t get_entries_size() const noexcept;
 		[[nodiscard]] rotation_entry& get_next_entry();
+		// the map get_next_entry would eventually land on, without advancing
+		[[nodiscard]] std::optional<std::string> peek_next_map() const;
 
 		void parse(const std::string& data);
 
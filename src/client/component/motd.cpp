@@ -12,7 +12,7 @@
 
 #include <utils/string.hpp>
 #include <utils/concurrency.hpp>
-#include <utils/http.hpp>
+#include <utils/http_cache.hpp>
 
 namespace motd
 {
@@ -23,101 +23,86 @@ namespace motd
 		utils::concurrency::container<links_map_t> links;
 		utils::concurrency::container<nlohmann::json, std::recursive_mutex> marketing;
 
-		std::atomic_bool killed;
+		constexpr auto max_parallel_downloads = 4;
 
-		std::optional<std::string> download_image(const std::string& url)
+		utils::http::cache& get_http_cache()
 		{
-			if (killed)
-			{
-				return {};
-			}
-
-			const auto res = utils::http::get_data_motd(url);
-			return res;
+			static utils::http::cache cache("players2/cache/http");
+			return cache;
 		}
 
-		void download_motd_image(nlohmann::json& data)
+		struct image_download
 		{
-			if (!data["motd"].is_object() || !data["motd"]["image_url"].is_string())
-			{
-				return;
-			}
+			std::string name;
+			std::string url;
+		};
 
-			const auto url = data["motd"]["image_url"].get<std::string>();
-			const auto image_data = download_image(url);
-			if (image_data.has_value())
+		void add_image_download(std::vector<image_download>& downloads, const nlohmann::json& object,
+			const std::string& field, const std::string& name)
+		{
+			if (object.contains(field) && object[field].is_string())
 			{
-				const auto& image = image_data.value();
-				images::override_texture("motd_image", image);
+				downloads.emplace_back(name, object[field].get<std::string>());
 			}
 		}
 
-		void download_featured_tabs_images(nlohmann::json& data)
+		void download_images(nlohmann::json& data)
 		{
-			if (!data["featured"].is_array())
+			if (!data.is_object())
 			{
 				return;
 			}
 
-			auto index = 0;
-			for (const auto& [key, tab] : data["featured"].items())
+			std::vector<image_download> downloads;
+
+			if (data["motd"].is_object())
 			{
-				index++;
-				if (index >= max_featured_tabs + 1)
-				{
-					return;
-				}
+				add_image_download(downloads, data["motd"], "image_url", "motd_image");
+			}
 
-				if (!tab.is_object() || !tab["image_url"].is_string())
+			if (data["featured"].is_array())
+			{
+				auto index = 0;
+				for (const auto& [key, tab] : data["featured"].items())
 				{
-					continue;
-				}
+					index++;
+					if (index >= max_featured_tabs + 1)
+					{
+						break;
+					}
 
-				const auto download_image_ = [&](const std::string& field, const std::string& image_name)
+					if (!tab.is_object() || !tab["image_url"].is_string())
 					{
-						const auto url = tab[field].get<std::string>();
-						const auto image_data = download_image(url);
-						if (image_data.has_value())
-						{
-							const auto& image = image_data.value();
-							images::override_texture(std::format("{}_{}", image_name, index), image);
-						}
-					};
+						continue;
+					}
 
-				download_image_("image_url", "featured_panel");
-				download_image_("thumbnail_url", "featured_panel_thumbnail");
+					add_image_download(downloads, tab, "image_url", std::format("featured_panel_{}", index));
+					add_image_download(downloads, tab, "thumbnail_url", std::format("featured_panel_thumbnail_{}", index));
+				}
 			}
-		}
 
-		void download_images(nlohmann::json& data)
-		{
-			if (!data.is_object())
+			std::vector<std::string> urls;
+			for (const auto& download : downloads)
 			{
-				return;
+				urls.emplace_back(download.url);
 			}
 
-			download_motd_image(data);
-			download_featured_tabs_images(data);
+			const auto results = get_http_cache().get_many(urls, max_parallel_downloads);
+			for (size_t i = 0; i < downloads.size(); ++i)
+			{
+				if (results[i].has_value())
+				{
+					images::override_texture(downloads[i].name, results[i].value(), true);
+				}
+			}
 		}
 
 		std::optional<std::string> get_server_file(const std::string& endpoint)
 		{
-			const auto try_url = [&](const std::string& base_url)
-			{
-				const auto url = base_url + endpoint;
-				printf("[HTTP] GET file \"%s\"\n", url.data());
-				const auto result = utils::http::get_data_motd(url);
-				return result;
-			};
-
-			const auto result = try_url("https://price.horizonmw.org/");
-
-			if (result.has_value())
-			{
-				return result;
-			}
+			const auto url = "https://price.horizonmw.org/"s + endpoint;
+			printf("[HTTP] GET file \"%s\"\n", url.data());
 
-			return {};
+			return get_http_cache().get(url);
 		}
 
 		void init_links(links_map_t& map)
@@ -158,29 +143,31 @@ namespace motd
 				init_links(map);
 			});
 
-			marketing.access([&](nlohmann::json& data)
-			{
-				data.clear();
+			nlohmann::json data{};
 
-				const auto marketing_data = get_server_file("marketing2.json");
-				if (marketing_data.has_value())
+			const auto marketing_data = get_server_file("marketing2.json");
+			if (marketing_data.has_value())
+			{
+				try
 				{
-					try
-					{
-						const auto& value = marketing_data.value();
-						data = nlohmann::json::parse(value);
+					data = nlohmann::json::parse(marketing_data.value());
 
-						add_links(data);
-						if (load_images)
-						{
-							download_images(data);
-						}
-					}
-					catch (const std::exception& e)
+					add_links(data);
+					if (load_images)
 					{
-						printf("Failed to load marketing.json: %s\n", e.what());
+						download_images(data);
 					}
 				}
+				catch (const std::exception& e)
+				{
+					printf("Failed to load marketing.json: %s\n", e.what());
+				}
+			}
+
+			// the getters aren't blocked while downloading
+			marketing.access([&](nlohmann::json& marketing_data_)
+			{
+				marketing_data_ = std::move(data);
 			});
 		}
 	}
@@ -297,7 +284,7 @@ namespace motd
 				return;
 			}
 
-			killed = true;
+			get_http_cache().cancel();
 			if (init_thread.joinable())
 			{
 				init_thread.join();
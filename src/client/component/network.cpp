@@ -17,41 +17,101 @@ namespace network
 {
 	namespace
 	{
-		std::unordered_map<std::string, raw_callback> raw_callbacks;
+		struct command_entry
+		{
+			callback handler;
+			raw_callback raw_handler;
+			rate_limit limit;
+			uint64_t handled;
+			uint64_t rate_limited;
+		};
+
+		// entries are stored at the index the table assigned to their command,
+		// a deque so registering a command from a handler doesn't move the entry being dispatched
+		struct dispatcher
+		{
+			packet_dispatch::command_table table;
+			std::deque<command_entry> commands;
+			packet_dispatch::rate_limiter limiter;
+			uint64_t unknown_commands = 0;
+		};
+
+		dispatcher& get_dispatcher()
+		{
+			static dispatcher dispatcher{};
+			return dispatcher;
+		}
 
-		std::unordered_map<std::string, callback>& get_callbacks()
+		size_t get_command_index(const std::string& command)
 		{
-			static std::unordered_map<std::string, callback> callbacks{};
-			return callbacks;
+			auto& dispatcher = get_dispatcher();
+			const auto index = dispatcher.table.add(command);
+			if (index >= dispatcher.commands.size())
+			{
+				dispatcher.commands.resize(index + 1);
+			}
+
+			return index;
+		}
+
+		bool is_rate_limited(const game::netadr_s& address, const size_t index)
+		{
+			if (address.type != game::NA_IP)
+			{
+				return false;
+			}
+
+			auto& dispatcher = get_dispatcher();
+			const auto ip = *reinterpret_cast<const uint32_t*>(&address.ip[0]);
+
+			return dispatcher.limiter.is_limited(ip, index, dispatcher.commands[index].limit);
 		}
 
 		bool handle_command(game::netadr_s* address, const char* command, game::msg_t* message)
 		{
-			const auto cmd_string = utils::string::to_lower(command);
-			auto& callbacks = get_callbacks();
-			const auto offset = cmd_string.size() + 5;
-			if (message->cursize < offset)
+			const std::string_view command_name(command);
+			const auto offset = command_name.size() + 5;
+			if (message->cursize < 0 || static_cast<size_t>(message->cursize) < offset)
+			{
+				return false;
+			}
+
+			auto& dispatcher = get_dispatcher();
+			const auto index = dispatcher.table.find(command_name);
+			if (!index)
 			{
+				++dispatcher.unknown_commands;
 				return false;
 			}
 
+			if (is_rate_limited(*address, *index))
+			{
+				// swallow it, the game must not handle it either
+				++dispatcher.commands[*index].rate_limited;
+				return true;
+			}
+
+			auto& entry = dispatcher.commands[*index];
+
 			// raw handler
-			if (const auto raw_handler = raw_callbacks.find(cmd_string); raw_handler != raw_callbacks.end())
+			if (entry.raw_handler)
 			{
-				raw_handler->second(address, message);
+				entry.raw_handler(address, message);
 			}
 
-			const auto handler = callbacks.find(cmd_string);
-			if (handler == callbacks.end())
+			if (!entry.handler)
 			{
 				return false;
 			}
 
-			const std::string data(message->data + offset, message->cursize - offset);
-			handler->second(*address, data);
+			++entry.handled;
+
 #ifdef DEBUG
-			console::info("[Network] Handling command %s\n", cmd_string.data());
+			console::info("[Network] Handling command %s\n", dispatcher.table.get_name(*index).data());
 #endif
+
+			const std::string_view data(message->data + offset, message->cursize - offset);
+			entry.handler(*address, data);
 			return true;
 		}
 
@@ -151,14 +211,30 @@ namespace network
 		return std::memmove(dst, src, std::min(size, 1262ull));
 	}
 
-	void on(const std::string& command, const callback& callback)
+	void on(const std::string& command, const callback& callback, const rate_limit& limit)
 	{
-		get_callbacks()[utils::string::to_lower(command)] = callback;
+		auto& entry = get_dispatcher().commands[get_command_index(command)];
+		entry.handler = callback;
+		entry.limit = limit;
 	}
 
 	void on_raw(const std::string& command, const raw_callback& callback)
 	{
-		raw_callbacks[utils::string::to_lower(command)] = callback;
+		get_dispatcher().commands[get_command_index(command)].raw_handler = callback;
+	}
+
+	std::vector<command_stats> get_command_stats()
+	{
+		std::vector<command_stats> stats;
+
+		const auto& dispatcher = get_dispatcher();
+		for (size_t i = 0; i < dispatcher.commands.size(); ++i)
+		{
+			const auto& entry = dispatcher.commands[i];
+			stats.emplace_back(dispatcher.table.get_name(i), entry.handled, entry.rate_limited);
+		}
+
+		return stats;
 	}
 
 	int dw_send_to_stub(const int size, const char* src, game::netadr_s* to)
@@ -323,14 +399,14 @@ namespace network
 				if (!game::environment::is_dedi())
 				{
 					// we need this on the client for RCon
-					on("print", [](const game::netadr_s& address, const std::string& message)
+					on("print", [](const game::netadr_s& address, const std::string_view message)
 					{
 						if (address != party::get_target())
 						{
 							return;
 						}
 
-						console::info("%s", message.data());
+						console::info("%.*s", static_cast<int>(message.size()), message.data());
 					});
 				}
 
@@ -343,6 +419,16 @@ namespace network
 				// patch buffer overflow
 				utils::hook::call(0x4F19A7_b, memmove_stub); // NET_DeferPacketToClient
 			}
+
+			command::add("netCommandStats", []()
+			{
+				for (const auto& stats : get_command_stats())
+				{
+					console::info("%-20s handled: %llu, rate limited: %llu\n", stats.command.data(), stats.handled, stats.rate_limited);
+				}
+
+				console::info("unknown: %llu\n", get_dispatcher().unknown_commands);
+			});
 		}
 	};
 }
@@ -1,13 +1,25 @@
 #pragma once
 #include "game/game.hpp"
 
+#include "utils/packet_dispatch.hpp"
+
 namespace network
 {
-	using callback = std::function<void(const game::netadr_s&, const std::string&)>;
+	using callback = std::function<void(const game::netadr_s&, std::string_view data)>;
 	using raw_callback = std::function<void(game::netadr_s*, game::msg_t* msg)>;
 
-	void on(const std::string& command, const callback& callback);
+	using rate_limit = packet_dispatch::rate_limit;
+
+	struct command_stats
+	{
+		std::string command;
+		uint64_t handled;
+		uint64_t rate_limited;
+	};
+
+	void on(const std::string& command, const callback& callback, const rate_limit& limit = {});
 	void on_raw(const std::string& command, const raw_callback& callback);
+	std::vector<command_stats> get_command_stats();
 	void send(const game::netadr_s& address, const std::string& command, const std::string& data = {}, char separator = ' ');
 	void send_data(const game::netadr_s& address, const std::string& data);
 
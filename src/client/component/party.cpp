@@ -19,6 +19,7 @@
 #include "steam/steam.hpp"
 
 #include "utils/hash.hpp"
+#include "utils/map_prefetch.hpp"
 
 #include <utils/properties.hpp>
 #include <utils/string.hpp>
@@ -146,6 +147,9 @@ namespace party
 
 		std::unordered_map<std::string, std::string> hash_cache;
 
+		// hashes the next rotation map's files in the background, see prefetch_map_files
+		map_prefetch::prefetcher next_map_prefetcher{utils::hash::get_file_hash};
+
 		std::string get_file_hash(const std::string& file)
 		{
 			const auto iter = hash_cache.find(file);
@@ -154,6 +158,11 @@ namespace party
 				return iter->second;
 			}
 
+			if (auto prefetched = next_map_prefetcher.take_hash(file))
+			{
+				return hash_cache.insert_or_assign(file, std::move(*prefetched)).first->second;
+			}
+
 			const auto hash = utils::hash::get_file_hash(file);
 			if (!hash.empty())
 			{
@@ -168,26 +177,45 @@ namespace party
 			return std::format("hmw-usermaps\\{}\\{}{}", mapname, mapname, extension);
 		}
 
-		// generate hashes so they are cached
-		void generate_hashes(const std::string& mapname)
+		std::vector<std::string> get_map_files(const std::string& mapname, const std::string& fs_game)
 		{
+			std::vector<std::string> files;
+
 			// usermap
 			for (const auto& file : usermap_files)
 			{
-				const auto path = get_usermap_file_path(mapname, file.extension);
-				get_file_hash(path);
+				files.emplace_back(get_usermap_file_path(mapname, file.extension));
 			}
 
 			// mod
-			const auto fs_game = get_dvar_string("fs_game");
 			if (!fs_game.empty())
 			{
 				for (const auto& file : mod_files)
 				{
-					const auto path = std::format("{}\\mod{}", fs_game, file.extension);
-					get_file_hash(path);
+					files.emplace_back(std::format("{}\\mod{}", fs_game, file.extension));
 				}
 			}
+
+			return files;
+		}
+
+		// generate hashes so they are cached
+		void generate_hashes(const std::string& mapname)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			next_map_prefetcher.take_saved_seconds();
+
+			for (const auto& file : get_map_files(mapname, get_dvar_string("fs_game")))
+			{
+				get_file_hash(file);
+			}
+
+			if (const auto saved_seconds = next_map_prefetcher.take_saved_seconds(); saved_seconds > 0.0)
+			{
+				const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+				console::info("Hashed files of %s in %.1f ms, prefetching saved %.1f ms\n", mapname.data(),
+					duration.count(), saved_seconds * 1000.0);
+			}
 		}
 
 		/*
@@ -749,6 +777,11 @@ namespace party
 			return iter->second;
 		}
 
+		if (auto prefetched = next_map_prefetcher.take_hash(file))
+		{
+			return hash_cache.insert_or_assign(file, std::move(*prefetched)).first->second;
+		}
+
 		const auto hash = utils::hash::get_file_hash(file);
 		if (!hash.empty())
 		{
@@ -763,6 +796,16 @@ namespace party
 		return std::format("hmw-usermaps\\{}\\{}{}", mapname, mapname, extension);
 	}
 
+	bool prefetch_map_files(const std::string& mapname, const std::string& fs_game)
+	{
+		return next_map_prefetcher.prefetch(mapname, get_map_files(mapname, fs_game));
+	}
+
+	void forget_prefetched_map()
+	{
+		next_map_prefetcher.forget_map();
+	}
+
 	std::string get_dvar_string(const std::string& dvar)
 	{
 		auto* dvar_value = game::Dvar_FindVar(dvar.data());
@@ -851,8 +894,8 @@ namespace party
 			}
 
 			auto* current_mapname = game::Dvar_FindVar("mapname");
-			if (current_mapname && utils::string::to_lower(current_mapname->current.string) ==
-				utils::string::to_lower(mapname) && (game::SV_Loaded() && !game::VirtualLobby_Loaded()))
+			if (current_mapname && utils::string::equals_ignore_case(current_mapname->current.string, mapname)
+				&& (game::SV_Loaded() && !game::VirtualLobby_Loaded()))
 			{
 				console::info("Restarting map: %s\n", mapname.data());
 				command::execute("map_restart", false);
@@ -1169,12 +1212,12 @@ namespace party
 				console::info("hash output: %s\n", hash.data());
 			});
 
-			network::on("getInfo", [](const game::netadr_s& target, const std::string& data)
+			network::on("getInfo", [](const game::netadr_s& target, const std::string_view data)
 				{
 					const auto mapname = get_dvar_string("mapname");
 
 					utils::info_string info;
-					info.set("challenge", data);
+					info.set("challenge", std::string{data});
 					info.set("gamename", "HMW");
 					info.set("hostname", get_dvar_string("sv_hostname"));
 					info.set("gametype", get_dvar_string("g_gametype"));
@@ -1217,7 +1260,12 @@ namespace party
 					}
 
 					network::send(target, "infoResponse", info.build(), '\n');
-				});
+				}, {20, 100ms});
+		}
+
+		void pre_destroy() override
+		{
+			next_map_prefetcher.wait();
 		}
 	};
 }
@@ -74,6 +74,13 @@ namespace party
 
 	std::string get_file_hash(const std::string& file);
 
+	// Hashes the usermap and mod files of a map in the background ahead of switching to it, unless a prefetch
+	// is still running or the map was the last one prefetched.
+	// get_file_hash picks the results up as long as the files didn't change in between.
+	bool prefetch_map_files(const std::string& mapname, const std::string& fs_game);
+	// the prefetched map is being loaded now, the next prefetch may pick the same map again
+	void forget_prefetched_map();
+
 	std::string get_usermap_file_path(const std::string& mapname, const std::string& extension);
 
 	std::string get_dvar_string(const std::string& dvar);
@@ -187,19 +187,18 @@ namespace rcon
 			}
 			else
 			{
-				network::on("rcon", [](const game::netadr_s& addr, const std::string_view& data)
+				network::on("rcon", [](const game::netadr_s& addr, const std::string_view data)
 				{
-					const auto message = std::string{data};
-					const auto pos = message.find_first_of(" ");
-					if (pos == std::string::npos)
+					const auto pos = data.find_first_of(' ');
+					if (pos == std::string_view::npos)
 					{
 						network::send(addr, "print", "Invalid RCon request", '\n');
 						console::info("Invalid RCon request from %s\n", network::net_adr_to_string(addr));
 						return;
 					}
 
-					const auto password = message.substr(0, pos);
-					const auto command = message.substr(pos + 1);
+					const auto password = data.substr(0, pos);
+					const auto command = std::string(data.substr(pos + 1));
 					const auto rcon_password = game::Dvar_FindVar("rcon_password");
 					if (command.empty() || !rcon_password || !rcon_password->current.string || !strlen(
 						rcon_password->current.string))
@@ -226,7 +225,7 @@ namespace rcon
 					}
 
 					clear_redirect();
-				});
+				}, {5, 500ms});
 			}
 		}
 	};
@@ -2,10 +2,14 @@
 #include "loader/component_loader.hpp"
 
 #include "scheduler.hpp"
+#include "command.hpp"
+#include "console.hpp"
 #include "game/game.hpp"
 
 #include <utils/hook.hpp>
 #include <utils/concurrency.hpp>
+#include <utils/histogram.hpp>
+#include <utils/io.hpp>
 #include <utils/string.hpp>
 #include <utils/thread.hpp>
 
@@ -13,20 +17,98 @@ namespace scheduler
 {
 	namespace
 	{
+		using clock = std::chrono::high_resolution_clock;
+
+		const char* pipeline_names[pipeline::count] =
+		{
+			"async",
+			"network",
+			"renderer",
+			"server",
+			"main",
+			"lui",
+		};
+
+		// durations of every task scheduled from the same place in the code
+		struct task_stats
+		{
+			std::string name;
+			utils::histogram durations;
+		};
+
 		struct task
 		{
 			std::function<bool()> handler{};
 			std::chrono::milliseconds interval{};
-			std::chrono::high_resolution_clock::time_point last_call{};
+			clock::time_point last_call{};
+			task_stats* stats{};
 		};
 
 		using task_list = std::vector<task>;
 
+		struct trace_event
+		{
+			// null for the pipeline tick itself
+			const task_stats* task;
+			pipeline type;
+			clock::time_point start;
+			clock::duration duration;
+		};
+
+		struct
+		{
+			// checked once per task, everything else is only touched while a capture runs
+			std::atomic_bool active{false};
+			std::atomic_int remaining_frames{0};
+			utils::concurrency::container<std::vector<trace_event>> events;
+		} trace;
+
+		void write_trace(std::vector<trace_event> events);
+
+		void record_trace_event(const task_stats* task, const pipeline type, const clock::time_point start,
+			const clock::duration duration)
+		{
+			trace.events.access([&](std::vector<trace_event>& events)
+			{
+				events.push_back({task, type, start, duration});
+			});
+		}
+
+		void end_trace_frame()
+		{
+			if (--trace.remaining_frames > 0 || !trace.active.exchange(false))
+			{
+				return;
+			}
+
+			auto events = trace.events.access<std::vector<trace_event>>([](std::vector<trace_event>& events)
+			{
+				return std::move(events);
+			});
+
+			once([events = std::move(events)]() mutable
+			{
+				write_trace(std::move(events));
+			}, pipeline::async);
+		}
+
+		uint64_t to_ns(const clock::duration duration)
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		}
+
 		class task_pipeline
 		{
 		public:
-			void add(task&& task)
+			explicit task_pipeline(const pipeline type)
+				: type_(type)
 			{
+			}
+
+			void add(task&& task, const std::source_location& location)
+			{
+				task.stats = this->get_task_stats(location);
+
 				new_callbacks_.access([&task](task_list& tasks)
 				{
 					tasks.emplace_back(std::move(task));
@@ -35,13 +117,16 @@ namespace scheduler
 
 			void execute()
 			{
+				const auto start = clock::now();
+
 				callbacks_.access([&](task_list& tasks)
 				{
 					this->merge_callbacks();
 
+					auto now = start;
+
 					for (auto i = tasks.begin(); i != tasks.end();)
 					{
-						const auto now = std::chrono::high_resolution_clock::now();
 						const auto diff = now - i->last_call;
 
 						if (diff < i->interval)
@@ -53,6 +138,18 @@ namespace scheduler
 						i->last_call = now;
 
 						const auto res = i->handler();
+
+						// the end of this task is the start of the next one, one clock read per task
+						const auto end = clock::now();
+						i->stats->durations.record(to_ns(end - now));
+
+						if (trace.active)
+						{
+							record_trace_event(i->stats, this->type_, now, end - now);
+						}
+
+						now = end;
+
 						if (res == cond_end)
 						{
 							i = tasks.erase(i);
@@ -63,12 +160,87 @@ namespace scheduler
 						}
 					}
 				});
+
+				const auto duration = clock::now() - start;
+				this->tick_durations_.record(to_ns(duration));
+
+				if (trace.active)
+				{
+					record_trace_event(nullptr, this->type_, start, duration);
+
+					if (this->type_ == pipeline::main)
+					{
+						end_trace_frame();
+					}
+				}
+			}
+
+			const utils::histogram& get_tick_durations() const
+			{
+				return this->tick_durations_;
+			}
+
+			std::vector<const task_stats*> get_task_stats() const
+			{
+				return stats_.access<std::vector<const task_stats*>>([](const stats_map& stats)
+				{
+					std::vector<const task_stats*> result{};
+					for (const auto& entry : stats)
+					{
+						result.emplace_back(entry.second.get());
+					}
+
+					return result;
+				});
+			}
+
+			void reset_stats()
+			{
+				this->tick_durations_.reset();
+
+				stats_.access([](stats_map& stats)
+				{
+					for (auto& entry : stats)
+					{
+						entry.second->durations.reset();
+					}
+				});
 			}
 
 		private:
+			using stats_map = std::unordered_map<std::string, std::unique_ptr<task_stats>>;
+
+			pipeline type_;
+			utils::histogram tick_durations_;
+			// entries are never removed, tasks keep raw pointers to them
+			utils::concurrency::container<stats_map> stats_;
+
 			utils::concurrency::container<task_list> new_callbacks_;
 			utils::concurrency::container<task_list, std::recursive_mutex> callbacks_;
 
+			task_stats* get_task_stats(const std::source_location& location)
+			{
+				std::string_view file = location.file_name();
+				if (const auto pos = file.find_last_of("/\\"); pos != std::string_view::npos)
+				{
+					file = file.substr(pos + 1);
+				}
+
+				std::string name = utils::string::va("%.*s:%u", static_cast<int>(file.size()), file.data(), location.line());
+
+				return stats_.access<task_stats*>([&](stats_map& stats)
+				{
+					auto& entry = stats[name];
+					if (!entry)
+					{
+						entry = std::make_unique<task_stats>();
+						entry->name = std::move(name);
+					}
+
+					return entry.get();
+				});
+			}
+
 			void merge_callbacks()
 			{
 				callbacks_.access([&](task_list& tasks)
@@ -86,7 +258,15 @@ namespace scheduler
 		volatile bool kill = false;
 		std::thread thread_async;
 		std::thread network_thread;
-		task_pipeline pipelines[pipeline::count];
+		task_pipeline pipelines[pipeline::count] =
+		{
+			task_pipeline{pipeline::async},
+			task_pipeline{pipeline::network},
+			task_pipeline{pipeline::renderer},
+			task_pipeline{pipeline::server},
+			task_pipeline{pipeline::main},
+			task_pipeline{pipeline::lui},
+		};
 		utils::hook::detour r_end_frame_hook;
 		utils::hook::detour g_run_frame_hook;
 		utils::hook::detour main_frame_hook;
@@ -128,55 +308,161 @@ namespace scheduler
 				execute(pipeline::lui);
 			}
 		}
+
+		void write_trace(std::vector<trace_event> events)
+		{
+			if (events.empty())
+			{
+				return;
+			}
+
+			const auto origin = events.front().start;
+
+			auto json = nlohmann::json::array();
+
+			for (auto i = 0; i < pipeline::count; ++i)
+			{
+				json.push_back({
+					{"name", "thread_name"},
+					{"ph", "M"},
+					{"pid", 0},
+					{"tid", i},
+					{"args", {{"name", pipeline_names[i]}}},
+				});
+			}
+
+			for (const auto& event : events)
+			{
+				const auto start = std::chrono::duration<double, std::micro>(event.start - origin).count();
+				const auto duration = std::chrono::duration<double, std::micro>(event.duration).count();
+
+				json.push_back({
+					{"name", event.task ? event.task->name : "tick"},
+					{"cat", pipeline_names[event.type]},
+					{"ph", "X"},
+					{"pid", 0},
+					{"tid", static_cast<int>(event.type)},
+					{"ts", start},
+					{"dur", duration},
+				});
+			}
+
+			const std::string path = utils::string::va("players2/traces/scheduler_%lld.json", static_cast<long long>(std::time(nullptr)));
+			if (utils::io::write_file(path, nlohmann::json{{"traceEvents", json}}.dump()))
+			{
+				console::info("Wrote %zu trace events to %s\n", events.size(), path.data());
+			}
+			else
+			{
+				console::error("Failed to write trace to %s\n", path.data());
+			}
+		}
+
+		std::string format_ns(const uint64_t ns)
+		{
+			if (ns < 1000)
+			{
+				return utils::string::va("%lluns", ns);
+			}
+
+			if (ns < 1000000)
+			{
+				return utils::string::va("%.1fus", static_cast<double>(ns) / 1000.0);
+			}
+
+			return utils::string::va("%.2fms", static_cast<double>(ns) / 1000000.0);
+		}
+
+		void print_histogram(const char* name, const utils::histogram& histogram)
+		{
+			const auto p50 = format_ns(histogram.get_percentile(50.0));
+			const auto p99 = format_ns(histogram.get_percentile(99.0));
+			const auto max = format_ns(histogram.get_max());
+			const auto total = format_ns(histogram.get_sum());
+
+			console::info("  %-32s %8llu calls  p50 %9s  p99 %9s  max %9s  total %9s\n", name,
+				histogram.get_count(), p50.data(), p99.data(), max.data(), total.data());
+		}
+
+		void print_stats(const size_t max_tasks)
+		{
+			for (auto i = 0; i < pipeline::count; ++i)
+			{
+				const auto& current = pipelines[i];
+				if (!current.get_tick_durations().get_count())
+				{
+					continue;
+				}
+
+				console::info("%s:\n", pipeline_names[i]);
+				print_histogram("tick", current.get_tick_durations());
+
+				auto tasks = current.get_task_stats();
+				std::erase_if(tasks, [](const task_stats* stats)
+				{
+					return !stats->durations.get_count();
+				});
+
+				std::sort(tasks.begin(), tasks.end(), [](const task_stats* a, const task_stats* b)
+				{
+					return a->durations.get_sum() > b->durations.get_sum();
+				});
+
+				for (size_t j = 0; j < tasks.size() && j < max_tasks; ++j)
+				{
+					print_histogram(tasks[j]->name.data(), tasks[j]->durations);
+				}
+			}
+		}
 	}
 
 	void schedule(const std::function<bool()>& callback, const pipeline type,
-	              const std::chrono::milliseconds delay)
+	              const std::chrono::milliseconds delay, const std::source_location location)
 	{
 		assert(type >= 0 && type < pipeline::count);
 
 		task task;
 		task.handler = callback;
 		task.interval = delay;
-		task.last_call = std::chrono::high_resolution_clock::now();
+		task.last_call = clock::now();
 
-		pipelines[type].add(std::move(task));
+		pipelines[type].add(std::move(task), location);
 	}
 
 	void loop(const std::function<void()>& callback, const pipeline type,
-	          const std::chrono::milliseconds delay)
+	          const std::chrono::milliseconds delay, const std::source_location location)
 	{
 		schedule([callback]()
 		{
 			callback();
 			return cond_continue;
-		}, type, delay);
+		}, type, delay, location);
 	}
 
 	void once(const std::function<void()>& callback, const pipeline type,
-	          const std::chrono::milliseconds delay)
+	          const std::chrono::milliseconds delay, const std::source_location location)
 	{
 		schedule([callback]()
 		{
 			callback();
 			return cond_end;
-		}, type, delay);
+		}, type, delay, location);
 	}
 
 	void on_game_initialized(const std::function<void()>& callback, const pipeline type,
-	                         const std::chrono::milliseconds delay)
+	                         const std::chrono::milliseconds delay, const std::source_location location)
 	{
 		schedule([=]()
 		{
 			const auto dw_init = game::Live_SyncOnlineDataFlags(0) == 0;
 			if (dw_init && game::Sys_IsDatabaseReady2())
 			{
-				once(callback, type, delay);
+				once(callback, type, delay, location);
 				return cond_end;
 			}
 
 			return cond_continue;
-		}, pipeline::main);
+		}, pipeline::main, 0ms, location);
 	}
 
 	class component final : public component_interface
@@ -221,6 +507,43 @@ namespace scheduler
 			g_run_frame_hook.create(0x417940_b, scheduler::server_frame_stub);
 			main_frame_hook.create(0x3438B0_b, scheduler::main_frame_stub);
 			hks_frame_hook.create(0x2792E0_b, scheduler::hks_frame_stub);
+
+			command::add("schedulerStats", [](const command::params& params)
+			{
+				if (params.size() >= 2 && params.get(1) == "reset"s)
+				{
+					for (auto& current : pipelines)
+					{
+						current.reset_stats();
+					}
+
+					return;
+				}
+
+				const auto max_tasks = params.size() >= 2 ? std::max(std::atoi(params.get(1)), 1) : 10;
+				print_stats(static_cast<size_t>(max_tasks));
+			});
+
+			command::add("schedulerTrace", [](const command::params& params)
+			{
+				if (trace.active)
+				{
+					console::warn("A scheduler trace is already being captured\n");
+					return;
+				}
+
+				const auto frames = params.size() >= 2 ? std::clamp(std::atoi(params.get(1)), 1, 10000) : 300;
+
+				trace.events.access([](std::vector<trace_event>& events)
+				{
+					events.clear();
+				});
+
+				trace.remaining_frames = frames;
+				trace.active = true;
+
+				console::info("Capturing %d frames of scheduler activity\n", frames);
+			});
 		}
 
 		void pre_destroy() override
@@ -22,6 +22,8 @@
 	4. For HMW internal dev's anticheat related pipelines do not use for anything else, timing matters alot there
 */
 
+#include <source_location>
+
 namespace scheduler
 {
 	enum pipeline
@@ -51,12 +53,13 @@ namespace scheduler
 	static const bool cond_continue = false;
 	static const bool cond_end = true;
 
+	// the location names the task in schedulerStats and schedulerTrace, leave it defaulted
 	void schedule(const std::function<bool()>& callback, pipeline type = pipeline::async,
-		std::chrono::milliseconds delay = 0ms);
+		std::chrono::milliseconds delay = 0ms, std::source_location location = std::source_location::current());
 	void loop(const std::function<void()>& callback, pipeline type = pipeline::async,
-		std::chrono::milliseconds delay = 0ms);
+		std::chrono::milliseconds delay = 0ms, std::source_location location = std::source_location::current());
 	void once(const std::function<void()>& callback, pipeline type = pipeline::async,
-		std::chrono::milliseconds delay = 0ms);
+		std::chrono::milliseconds delay = 0ms, std::source_location location = std::source_location::current());
 	void on_game_initialized(const std::function<void()>& callback, pipeline type = pipeline::async,
-		std::chrono::milliseconds delay = 0ms);
+		std::chrono::milliseconds delay = 0ms, std::source_location location = std::source_location::current());
 }
\ No newline at end of file
@@ -11,19 +11,15 @@
 
 #include "game/game.hpp"
 
-#include "game/scripting/event.hpp"
 #include "game/scripting/execution.hpp"
 #include "game/scripting/functions.hpp"
+#include "game/scripting/token_cache.hpp"
 
 #include <utils/hook.hpp>
 
 namespace scripting
 {
-	std::unordered_map<int, std::unordered_map<std::string, int>> fields_table;
-
-	std::unordered_map<std::string, std::unordered_map<std::string, const char*>> script_function_table;
 	std::unordered_map<std::string, std::vector<std::pair<std::string, const char*>>> script_function_table_sort;
-	std::unordered_map<const char*, std::pair<std::string, std::string>> script_function_table_rev;
 
 	utils::concurrency::container<shared_table_t> shared_table;
 
@@ -53,25 +49,74 @@ namespace scripting
 
 		std::vector<std::function<void(bool, bool)>> shutdown_callbacks;
 
-		std::unordered_map<unsigned int, std::string> canonical_string_table;
+		// names are interned once, the tables below only store their indices
+		string_interner interned_strings;
+
+		token_table canonical_string_table{interned_strings};
+		token_table gsc_token_table{interned_strings};
+
+		// classnum -> field name index -> offset
+		std::unordered_map<int, std::vector<int>> fields_table;
+
+		// file name index -> function name index -> code pos
+		std::unordered_map<uint32_t, std::unordered_map<uint32_t, const char*>> script_function_table;
+		std::unordered_map<const char*, std::pair<uint32_t, uint32_t>> script_function_table_rev;
+
+		notify_dispatcher<game::VariableValue> notify_listeners;
+		// set on the first level load, listeners are only touched from that thread
+		std::thread::id server_thread_id;
+
+		// notify names currently traced by notifyLog
+		std::unordered_map<std::string, uint64_t> logged_notifies;
+
+		// no reference is taken, 0 never names a notify
+		unsigned int resolve_notify_name(const std::string& name)
+		{
+			return game::SL_FindString(name.data());
+		}
+
+		[[maybe_unused]] bool is_server_thread()
+		{
+			return server_thread_id == std::thread::id{} || server_thread_id == std::this_thread::get_id();
+		}
+
+		void toggle_notify_log(const std::string& name)
+		{
+			if (const auto itr = logged_notifies.find(name); itr != logged_notifies.end())
+			{
+				remove_notify_listener(itr->second);
+				logged_notifies.erase(itr);
+				console::info("No longer logging notify '%s'\n", name.data());
+				return;
+			}
+
+			logged_notifies[name] = on_notify(name, [name](const notify_event& event)
+			{
+				console::info("notify '%s' on entity %u with %zu arguments%s\n", name.data(), event.entity_id,
+					event.arguments.size(), event.truncated ? " (truncated)" : "");
+			});
+
+			console::info("Logging notify '%s'\n", name.data());
+		}
 
 		void vm_notify_stub(const unsigned int notify_list_owner_id, const game::scr_string_t string_value,
 			game::VariableValue* top)
 		{
 			if (!game::VirtualLobby_Loaded())
 			{
-				const auto* string = game::SL_ConvertToString(string_value);
-				if (string)
+				notify_listeners.dispatch(notify_list_owner_id, string_value, [&](game::VariableValue* arguments, const size_t capacity)
 				{
-					event e {};
-					e.name = string;
-					e.entity = notify_list_owner_id;
-
-					for (auto* value = top; value->type != game::VAR_PRECODEPOS; --value)
+					size_t count = 0;
+					for (auto* value = top; value->type != game::VAR_PRECODEPOS; --value, ++count)
 					{
-						e.arguments.emplace_back(*value);
+						if (count < capacity)
+						{
+							arguments[count] = *value;
+						}
 					}
-				}
+
+					return count;
+				});
 			}
 
 			vm_notify_hook.invoke<void>(notify_list_owner_id, string_value, top);
@@ -92,6 +137,9 @@ namespace scripting
 
 		void scr_load_level_stub()
 		{
+			server_thread_id = std::this_thread::get_id();
+			notify_listeners.rebind(resolve_notify_name);
+
 			gsc::load_init_handles();
 			scr_load_level_hook.invoke<void>();
 		}
@@ -126,11 +174,17 @@ namespace scripting
 
 		void scr_add_class_field_stub(unsigned int classnum, game::scr_string_t name, unsigned int canonical_string, unsigned int offset)
 		{
-			const auto name_str = game::SL_ConvertToString(name);
+			const auto name_index = interned_strings.intern(game::SL_ConvertToString(name));
 
-			if (fields_table[classnum].find(name_str) == fields_table[classnum].end())
+			auto& fields = fields_table[classnum];
+			if (name_index >= fields.size())
 			{
-				fields_table[classnum][name_str] = offset;
+				fields.resize(name_index + 1, -1);
+			}
+
+			if (fields[name_index] == -1)
+			{
+				fields[name_index] = offset;
 			}
 
 			scr_add_class_field_hook.invoke<void>(classnum, name, canonical_string, offset);
@@ -169,16 +223,18 @@ namespace scripting
 				}
 			}
 
-			const auto name = scripting::get_token(id);
+			const auto name = get_token_view(id);
 			auto& itr = script_function_table_sort[filename];
-			itr.insert(itr.end() - 1, { name, pos });
+			itr.insert(itr.end() - 1, { std::string(name), pos });
 		}
 
 		void add_function(const std::string& file, unsigned int id, const char* pos)
 		{
-			const auto name = get_token(id);
-			script_function_table[file][name] = pos;
-			script_function_table_rev[pos] = { file, name };
+			const auto file_index = interned_strings.intern(file);
+			const auto name_index = interned_strings.intern(get_token_view(id));
+
+			script_function_table[file_index][name_index] = pos;
+			script_function_table_rev[pos] = {file_index, name_index};
 		}
 
 		void scr_set_thread_position_stub(unsigned int thread_name, const char* code_pos)
@@ -193,19 +249,90 @@ namespace scripting
 		unsigned int sl_get_canonical_string_stub(const char* str)
 		{
 			const auto result = sl_get_canonical_string_hook.invoke<unsigned int>(str);
-			canonical_string_table[result] = str;
+			canonical_string_table.set(result, str);
 			return result;
 		}
+
+		void print_lookup_stats(const char* name, const lookup_stats& stats)
+		{
+			const auto total = std::max(stats.hits + stats.misses, 1ull);
+			console::info("%s: %llu hits, %llu misses (%.1f%% hit rate)\n", name, stats.hits, stats.misses,
+				100.0 * static_cast<double>(stats.hits) / static_cast<double>(total));
+		}
 	}
 
-	std::string get_token(unsigned int id)
+	std::string_view get_token_view(const unsigned int id)
 	{
-		if (canonical_string_table.find(id) != canonical_string_table.end())
+		if (const auto name = canonical_string_table.find(id))
+		{
+			return *name;
+		}
+
+		if (const auto name = gsc_token_table.find(id))
 		{
-			return canonical_string_table[id];
+			return *name;
 		}
 
-		return scripting::find_token(id);
+		// the gsc-tool tables never change, ask them once per id
+		return gsc_token_table.set(id, scripting::find_token(id));
+	}
+
+	std::string get_token(const unsigned int id)
+	{
+		return std::string(get_token_view(id));
+	}
+
+	int find_field(const int classnum, const std::string_view field)
+	{
+		const auto fields = fields_table.find(classnum);
+		if (fields == fields_table.end())
+		{
+			return -1;
+		}
+
+		const auto index = interned_strings.find(field);
+		if (index == string_interner::invalid_index || index >= fields->second.size())
+		{
+			return -1;
+		}
+
+		return fields->second[index];
+	}
+
+	bool has_script_functions(const std::string_view file)
+	{
+		const auto file_index = interned_strings.find(file);
+		return file_index != string_interner::invalid_index && script_function_table.contains(file_index);
+	}
+
+	const char* find_script_function(const std::string_view file, const std::string_view function)
+	{
+		const auto file_index = interned_strings.find(file);
+		const auto functions = script_function_table.find(file_index);
+		if (functions == script_function_table.end())
+		{
+			return nullptr;
+		}
+
+		const auto function_index = interned_strings.find(function);
+		const auto pos = functions->second.find(function_index);
+		if (pos == functions->second.end())
+		{
+			return nullptr;
+		}
+
+		return pos->second;
+	}
+
+	std::optional<script_function_name> find_script_function_name(const char* pos)
+	{
+		const auto itr = script_function_table_rev.find(pos);
+		if (itr == script_function_table_rev.end())
+		{
+			return {};
+		}
+
+		return {{interned_strings.get(itr->second.first), interned_strings.get(itr->second.second)}};
 	}
 
 	void on_shutdown(const std::function<void(bool, bool)>& callback)
@@ -213,14 +340,27 @@ namespace scripting
 		shutdown_callbacks.push_back(callback);
 	}
 
+	uint64_t on_notify(const std::string& name, const notify_listener& callback)
+	{
+		assert(is_server_thread());
+		return notify_listeners.add(name, resolve_notify_name(name), callback);
+	}
+
+	void remove_notify_listener(const uint64_t handle)
+	{
+		assert(is_server_thread());
+		notify_listeners.remove(handle);
+	}
+
 	std::optional<std::string> get_canonical_string(const unsigned int id)
 	{
-		if (canonical_string_table.find(id) == canonical_string_table.end())
+		const auto name = canonical_string_table.find(id);
+		if (!name)
 		{
 			return {};
 		}
 
-		return { canonical_string_table[id] };
+		return {std::string(*name)};
 	}
 
 	class component final : public component_interface
@@ -241,7 +381,30 @@ namespace scripting
 
 			g_shutdown_game_hook.create(0x422F30_b, g_shutdown_game_stub);
 
+			command::add("notifyLog", [](const command::params& params)
+			{
+				if (params.size() < 2)
+				{
+					console::info("usage: notifyLog <notify>, run again to stop logging it\n");
+					return;
+				}
+
+				const std::string name = params.get(1);
+				scheduler::once([name]
+				{
+					toggle_notify_log(name);
+				}, scheduler::pipeline::server);
+			});
+
 #ifdef DEBUG
+			command::add("tokenCacheStats", []()
+			{
+				print_lookup_stats("Interned strings", interned_strings.get_stats());
+				print_lookup_stats("Canonical strings", canonical_string_table.get_stats());
+				print_lookup_stats("GSC tokens", gsc_token_table.get_stats());
+				console::info("%zu strings interned\n", interned_strings.size());
+			});
+
 			scheduler::once([]()
 			{
 				command::add("vl_command", [](const command::params& params)
@@ -1,21 +1,46 @@
 #pragma once
 #include <utils/concurrency.hpp>
 
+#include "game/game.hpp"
+#include "game/scripting/notify_dispatcher.hpp"
+
 namespace scripting
 {
 	using shared_table_t = std::unordered_map<std::string, std::string>;
 
-	extern std::unordered_map<int, std::unordered_map<std::string, int>> fields_table;
-	extern std::unordered_map<std::string, std::unordered_map<std::string, const char*>> script_function_table;
 	extern std::unordered_map<std::string, std::vector<std::pair<std::string, const char*>>> script_function_table_sort;
-	extern std::unordered_map<const char*, std::pair<std::string, std::string>> script_function_table_rev;
 
 	extern utils::concurrency::container<shared_table_t> shared_table;
 
 	extern std::string current_file;
 	extern unsigned int current_file_id;
 
+	using notify_event = notify_dispatcher<game::VariableValue>::event;
+	using notify_listener = notify_dispatcher<game::VariableValue>::listener;
+
 	void on_shutdown(const std::function<void(bool, bool)>& callback);
+
+	// Called from the server thread for every notify of that name, the arguments are only valid during the call.
+	// Listeners may only be added and removed on the server thread, the tables aren't locked.
+	// Names that aren't script strings yet are picked up on the next level load.
+	uint64_t on_notify(const std::string& name, const notify_listener& callback);
+	void remove_notify_listener(uint64_t handle);
 	std::optional<std::string> get_canonical_string(const unsigned int id);
+
+	// views stay valid for the lifetime of the process
+	std::string_view get_token_view(unsigned int id);
 	std::string get_token(unsigned int id);
+
+	struct script_function_name
+	{
+		std::string_view file;
+		std::string_view function;
+	};
+
+	// -1 if the class has no such field
+	int find_field(int classnum, std::string_view field);
+
+	bool has_script_functions(std::string_view file);
+	const char* find_script_function(std::string_view file, std::string_view function);
+	std::optional<script_function_name> find_script_function_name(const char* pos);
 }
\ No newline at end of file
@@ -67,11 +67,11 @@ namespace server_info
 	public:
 		void post_unpack() override
 		{
-			network::on("getStatus", [](const game::netadr_s& target, [[maybe_unused]] const std::string& data)
+			network::on("getStatus", [](const game::netadr_s& target, const std::string_view data)
 			{
 				std::string playerList;
 				utils::info_string info;
-				info.set("challenge", data);
+				info.set("challenge", std::string{data});
 
 				for (int i = 0; i < 18; ++i)
 				{
@@ -102,10 +102,10 @@ namespace server_info
 				}
 
 				network::send(target, "statusResponse", info.build() + "\n"s + playerList + "\n"s);
-			});
+			}, {20, 100ms});
 
 #ifdef DEBUG
-			network::on("statusResponse", [](const game::netadr_s& target, [[maybe_unused]] const std::string& data)
+			network::on("statusResponse", [](const game::netadr_s& target, [[maybe_unused]] const std::string_view data)
 			{
 				const auto pos = data.find_first_of('\n');
 				if (pos == std::string::npos)
@@ -115,7 +115,7 @@ namespace server_info
 
 				const utils::info_string info(data.substr(0, pos));
 
-				console::debug("%s", data.c_str());
+				console::debug("%.*s", static_cast<int>(data.size()), data.data());
 			});
 #endif // DEBUG
 		}
@@ -3,67 +3,74 @@
 
 #include "system_check.hpp"
 
+#include "console.hpp"
+
 #include "game/game.hpp"
 
 #include <utils/nt.hpp>
 #include <utils/io.hpp>
-#include <utils/cryptography.hpp>
+#include <utils/file_hash.hpp>
 
 namespace system_check
 {
 	namespace
 	{
-		std::string read_zone(const std::string& name)
+		std::string get_zone_path(const std::string& name)
 		{
-			std::string data{};
-			if (utils::io::read_file(name, &data))
-			{
-				return data;
-			}
-
-			if (utils::io::read_file("zone/" + name, &data))
+			if (utils::io::file_exists(name))
 			{
-				return data;
+				return name;
 			}
 
-			return {};
+			return "zone/" + name;
 		}
 
-		std::string hash_zone(const std::string& name)
+		bool verify_hashes(const std::vector<std::pair<std::string, std::string>>& zone_hashes)
 		{
-			const auto data = read_zone(name);
-			return utils::cryptography::sha256::compute(data, true);
-		}
+			// unchanged installs skip rehashing, the zones are only read when their size or timestamp changed
+			utils::file_hash::hasher hasher("players2/cache/zone_hashes.json");
 
-		bool verify_hashes(const std::unordered_map<std::string, std::string>& zone_hashes)
-		{
+			std::vector<std::string> files{};
 			for (const auto& zone_hash : zone_hashes)
 			{
-				const auto hash = hash_zone(zone_hash.first);
-				if (hash != zone_hash.second)
+				files.emplace_back(get_zone_path(zone_hash.first));
+			}
+
+			const auto results = hasher.compute_many(files, files.size());
+			hasher.save_cache();
+
+			auto valid = true;
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				const auto& result = results[i];
+				if (result.success && !result.cached)
+				{
+					console::info("Verified %s in %.2fs (%.1f MB/s)\n", files[i].data(), result.seconds, result.get_throughput());
+				}
+
+				if (!result.success || result.hash != zone_hashes[i].second)
 				{
-					return false;
+					valid = false;
 				}
 			}
 
-			return true;
+			return valid;
 		}
 
 		bool is_system_valid()
 		{
-			static std::unordered_map<std::string, std::string> mp_zone_hashes =
+			std::vector<std::pair<std::string, std::string>> zone_hashes =
 			{
 				{"patch_common_mp.ff", "E45EF5F29D12A5A47F405F89FBBEE479C0A90D02141ABF852D481689514134A1"},
 			};
 
-			static std::unordered_map<std::string, std::string> sp_zone_hashes =
+			if (!game::environment::is_dedi())
 			{
 				// Steam doesn't necessarily deliver this file :(
-				{"patch_common.ff", "1D32A9770F90ED022AA76F4859B4AB178E194A703383E61AC2CE83B1E828B18F"},
-			};
-
+				zone_hashes.emplace_back("patch_common.ff", "1D32A9770F90ED022AA76F4859B4AB178E194A703383E61AC2CE83B1E828B18F");
+			}
 
-			return verify_hashes(mp_zone_hashes) && (game::environment::is_dedi() || verify_hashes(sp_zone_hashes));
+			return verify_hashes(zone_hashes);
 		}
 
 		void verify_binary_version()
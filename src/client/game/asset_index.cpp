@@ -0,0 +1,302 @@
+#include <std_include.hpp>
+#include "asset_index.hpp"
+
+namespace game
+{
+	asset_index::asset_index(const unsigned int* hash_table, const std::size_t bucket_count, XAssetEntry* entry_pool, const name_getter get_name)
+		: hash_table_(hash_table), bucket_count_(bucket_count), entry_pool_(entry_pool), get_name_(get_name)
+	{
+	}
+
+	void asset_index::on_link(const XAssetEntry* entry)
+	{
+		// entries that don't live in the pool (e.g. dummies handed out by hooks) can't be enumerated
+		if (entry < this->entry_pool_)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> _(this->mutex_);
+		if (this->stale_)
+		{
+			return;
+		}
+
+		// the linked entry is always the one in the hash chain, overrides hang off of it
+		const auto index = static_cast<unsigned int>(entry - this->entry_pool_);
+		this->add_entry(index);
+
+		// overriding an asset moves the previous head behind the linked entry, it's not part of the hash chain anymore
+		for (auto i = this->entry_pool_[index].nextOverride; i; i = this->entry_pool_[i].nextOverride)
+		{
+			this->remove_entry(i);
+		}
+	}
+
+	void asset_index::invalidate()
+	{
+		std::lock_guard<std::mutex> _(this->mutex_);
+		this->stale_ = true;
+	}
+
+	void asset_index::enum_entries(const XAssetType type, const entry_callback& callback, const bool include_override)
+	{
+		if (type < 0 || type >= ASSET_TYPE_COUNT)
+		{
+			return;
+		}
+
+		std::vector<unsigned int> entries;
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			entries = this->get_type_index(type).entries;
+		}
+
+		// callbacks run without the lock, they might end up linking assets themselves
+		for (const auto index : entries)
+		{
+			this->enum_entry(index, type, callback, include_override);
+		}
+	}
+
+	void asset_index::enum_entries(const XAssetType type, const std::string_view prefix, const entry_callback& callback, const bool include_override)
+	{
+		if (type < 0 || type >= ASSET_TYPE_COUNT)
+		{
+			return;
+		}
+
+		std::vector<unsigned int> entries;
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+
+			auto& index = this->get_type_index(type);
+			if (index.names_dirty)
+			{
+				this->sort_names(index);
+			}
+
+			auto itr = std::lower_bound(index.sorted_names.begin(), index.sorted_names.end(), prefix, [](const auto& entry, const std::string_view value)
+			{
+				return entry.first < value;
+			});
+
+			for (; itr != index.sorted_names.end() && itr->first.starts_with(prefix); ++itr)
+			{
+				entries.push_back(itr->second);
+			}
+		}
+
+		for (const auto index : entries)
+		{
+			this->enum_entry(index, type, callback, include_override);
+		}
+	}
+
+	std::size_t asset_index::count(const XAssetType type)
+	{
+		if (type < 0 || type >= ASSET_TYPE_COUNT)
+		{
+			return 0;
+		}
+
+		std::lock_guard<std::mutex> _(this->mutex_);
+		return this->get_type_index(type).entries.size();
+	}
+
+	std::size_t asset_index::verify(std::vector<std::string>* errors)
+	{
+		std::lock_guard<std::mutex> _(this->mutex_);
+		if (this->stale_)
+		{
+			this->rebuild();
+		}
+
+		std::size_t mismatches = 0;
+		const auto report = [&](const std::string& error)
+		{
+			++mismatches;
+			if (errors)
+			{
+				errors->emplace_back(error);
+			}
+		};
+
+		std::vector<bool> seen(this->indexed_entries_.size());
+
+		for (auto bucket = 0u; bucket < this->bucket_count_; ++bucket)
+		{
+			for (auto i = this->hash_table_[bucket]; i; i = this->entry_pool_[i].nextHash)
+			{
+				const auto type = this->entry_pool_[i].asset.type;
+				if (i >= this->indexed_entries_.size() || !this->indexed_entries_[i])
+				{
+					report(std::format("entry {} (type {}) is linked but not indexed", i, static_cast<int>(type)));
+					continue;
+				}
+
+				seen[i] = true;
+			}
+		}
+
+		std::vector<bool> listed(this->indexed_entries_.size());
+
+		for (auto type = 0; type < ASSET_TYPE_COUNT; ++type)
+		{
+			for (const auto i : this->get_type_index(static_cast<XAssetType>(type)).entries)
+			{
+				if (listed[i])
+				{
+					report(std::format("entry {} (type {}) is indexed more than once", i, type));
+					continue;
+				}
+
+				listed[i] = true;
+
+				if (!seen[i])
+				{
+					report(std::format("entry {} (type {}) is indexed but not linked", i, type));
+				}
+				else if (this->entry_pool_[i].asset.type != type)
+				{
+					report(std::format("entry {} is indexed as type {} but has type {}", i, type,
+						static_cast<int>(this->entry_pool_[i].asset.type)));
+				}
+			}
+		}
+
+		return mismatches;
+	}
+
+	void asset_index::add_entry(const unsigned int index)
+	{
+		if (index >= this->indexed_entries_.size())
+		{
+			this->indexed_entries_.resize(std::max<std::size_t>(index + 1, this->indexed_entries_.size() * 2));
+		}
+
+		if (this->indexed_entries_[index])
+		{
+			return;
+		}
+
+		const auto type = this->entry_pool_[index].asset.type;
+		if (type < 0 || type >= ASSET_TYPE_COUNT)
+		{
+			return;
+		}
+
+		this->indexed_entries_[index] = true;
+
+		auto& type_index = this->types_[type];
+		type_index.entries.push_back(index);
+		type_index.names_dirty = true;
+	}
+
+	void asset_index::remove_entry(const unsigned int index)
+	{
+		if (index >= this->indexed_entries_.size() || !this->indexed_entries_[index])
+		{
+			return;
+		}
+
+		this->indexed_entries_[index] = false;
+
+		// dropped from the list the next time the type is read
+		auto& type_index = this->types_[this->entry_pool_[index].asset.type];
+		type_index.has_removed = true;
+		type_index.names_dirty = true;
+	}
+
+	asset_index::type_index& asset_index::get_type_index(const XAssetType type)
+	{
+		if (this->stale_)
+		{
+			this->rebuild();
+		}
+
+		auto& index = this->types_[type];
+		if (!index.has_removed)
+		{
+			return index;
+		}
+
+		// an entry that was re-added before its old slot was dropped is listed twice
+		std::sort(index.entries.begin(), index.entries.end());
+		index.entries.erase(std::unique(index.entries.begin(), index.entries.end()), index.entries.end());
+
+		std::erase_if(index.entries, [this](const unsigned int i)
+		{
+			return !this->indexed_entries_[i];
+		});
+
+		index.has_removed = false;
+		return index;
+	}
+
+	void asset_index::rebuild()
+	{
+		for (auto& index : this->types_)
+		{
+			index.entries.clear();
+			index.sorted_names.clear();
+			index.names_dirty = true;
+			index.has_removed = false;
+		}
+
+		this->indexed_entries_.assign(this->indexed_entries_.size(), false);
+
+		for (auto bucket = 0u; bucket < this->bucket_count_; ++bucket)
+		{
+			for (auto i = this->hash_table_[bucket]; i; i = this->entry_pool_[i].nextHash)
+			{
+				this->add_entry(i);
+			}
+		}
+
+		this->stale_ = false;
+	}
+
+	void asset_index::sort_names(type_index& index)
+	{
+		index.sorted_names.clear();
+		index.sorted_names.reserve(index.entries.size());
+
+		for (const auto i : index.entries)
+		{
+			const auto* name = this->get_name_(&this->entry_pool_[i].asset);
+			if (name)
+			{
+				index.sorted_names.emplace_back(name, i);
+			}
+		}
+
+		std::sort(index.sorted_names.begin(), index.sorted_names.end());
+		index.names_dirty = false;
+	}
+
+	void asset_index::enum_entry(const unsigned int index, const XAssetType type, const entry_callback& callback, const bool include_override) const
+	{
+		auto* entry = &this->entry_pool_[index];
+		if (entry->asset.type != type)
+		{
+			return;
+		}
+
+		callback(entry);
+
+		if (!include_override)
+		{
+			return;
+		}
+
+		for (auto next_override = entry->nextOverride; next_override; )
+		{
+			auto* override = &this->entry_pool_[next_override];
+			callback(override);
+			next_override = override->nextOverride;
+		}
+	}
+}
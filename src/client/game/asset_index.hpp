@@ -0,0 +1,55 @@
+#pragma once
+
+#include "game.hpp"
+
+namespace game
+{
+	// Per-type index over the hash table of linked asset entries, so enumerating one type
+	// doesn't have to walk every bucket. Entries are added as they get linked and the whole
+	// index is rebuilt lazily after zones were unloaded.
+	class asset_index final
+	{
+	public:
+		using name_getter = const char* (*)(const XAsset* asset);
+		using entry_callback = std::function<void(XAssetEntry*)>;
+
+		asset_index(const unsigned int* hash_table, std::size_t bucket_count, XAssetEntry* entry_pool, name_getter get_name);
+
+		void on_link(const XAssetEntry* entry);
+		void invalidate();
+
+		void enum_entries(XAssetType type, const entry_callback& callback, bool include_override);
+		void enum_entries(XAssetType type, std::string_view prefix, const entry_callback& callback, bool include_override);
+		std::size_t count(XAssetType type);
+
+		// compares the index against a full scan of the hash table, returns the amount of mismatches
+		std::size_t verify(std::vector<std::string>* errors = nullptr);
+
+	private:
+		struct type_index
+		{
+			std::vector<unsigned int> entries;
+			std::vector<std::pair<std::string_view, unsigned int>> sorted_names;
+			bool names_dirty = true;
+			// entries were unindexed but are still in the list
+			bool has_removed = false;
+		};
+
+		const unsigned int* hash_table_;
+		std::size_t bucket_count_;
+		XAssetEntry* entry_pool_;
+		name_getter get_name_;
+
+		std::mutex mutex_;
+		std::array<type_index, ASSET_TYPE_COUNT> types_{};
+		std::vector<bool> indexed_entries_;
+		bool stale_ = true;
+
+		void add_entry(unsigned int index);
+		void remove_entry(unsigned int index);
+		type_index& get_type_index(XAssetType type);
+		void rebuild();
+		void sort_names(type_index& index);
+		void enum_entry(unsigned int index, XAssetType type, const entry_callback& callback, bool include_override) const;
+	};
+}
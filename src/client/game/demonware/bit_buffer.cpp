@@ -91,76 +91,138 @@ namespace demonware
 		return this->write(5, &data);
 	}
 
-	bool bit_buffer::read(unsigned int bits, void* output)
+	namespace
 	{
-		if (bits == 0) return false;
-		if ((this->current_bit_ + bits) > (this->buffer_.size() * 8)) return false;
+		// bits are stored lsb first, which is the byte order of a little endian word.
+		// Chunks of up to 56 bits always fit into one unaligned 8 byte word
+		constexpr auto max_chunk_bits = 56u;
 
-		int cur_byte = this->current_bit_ >> 3;
-		auto cur_out = 0;
+		std::uint64_t load_word(const unsigned char* data, const size_t available)
+		{
+			std::uint64_t value = 0;
 
-		const char* bytes = this->buffer_.data();
-		const auto output_bytes = static_cast<unsigned char*>(output);
+			// only the last few bytes of a buffer take the short copy
+			if (available >= sizeof(value))
+			{
+				std::memcpy(&value, data, sizeof(value));
+			}
+			else
+			{
+				std::memcpy(&value, data, available);
+			}
 
-		while (bits > 0)
-		{
-			const int min_bit = (bits < 8) ? bits : 8;
-			const auto this_byte = bytes[cur_byte++] & 0xFF;
-			const int remain = this->current_bit_ & 7;
+			return value;
+		}
 
-			if ((min_bit + remain) <= 8)
+		void store_word(unsigned char* data, const std::uint64_t value, const size_t available)
+		{
+			if (available >= sizeof(value))
 			{
-				output_bytes[cur_out] = BYTE((0xFF >> (8 - min_bit)) & (this_byte >> remain));
+				std::memcpy(data, &value, sizeof(value));
 			}
 			else
 			{
-				output_bytes[cur_out] = BYTE(
-					(0xFF >> (8 - min_bit)) & (bytes[cur_byte] << (8 - remain)) | (this_byte >> remain));
+				std::memcpy(data, &value, available);
 			}
+		}
 
-			cur_out++;
-			this->current_bit_ += min_bit;
-			bits -= min_bit;
+		std::uint64_t get_mask(const unsigned int bits)
+		{
+			return (1ull << bits) - 1;
 		}
 
-		return true;
+		std::uint64_t read_chunk(const unsigned char* data, const size_t size, const unsigned int offset, const unsigned int bits)
+		{
+			const auto index = offset >> 3;
+			return (load_word(data + index, size - index) >> (offset & 7)) & get_mask(bits);
+		}
+
+		// the bytes around the chunk are written back unchanged
+		void write_chunk(unsigned char* data, const size_t size, const unsigned int offset, const std::uint64_t value, const unsigned int bits)
+		{
+			const auto index = offset >> 3;
+			const auto shift = offset & 7;
+			auto* target = data + index;
+
+			const auto mask = get_mask(bits) << shift;
+			const auto word = (load_word(target, size - index) & ~mask) | (value << shift);
+			store_word(target, word, size - index);
+		}
 	}
 
-	bool bit_buffer::write(const unsigned int bits, const void* data)
+	bool bit_buffer::read(unsigned int bits, void* output)
 	{
 		if (bits == 0) return false;
-		this->buffer_.resize(this->buffer_.size() + (bits >> 3) + 1);
+		if ((this->current_bit_ + bits) > (this->buffer_.size() * 8)) return false;
 
-		int bit = bits;
-		const auto bytes = const_cast<char*>(this->buffer_.data());
-		const auto* input_bytes = static_cast<const unsigned char*>(data);
+		const auto* bytes = reinterpret_cast<const unsigned char*>(this->buffer_.data());
+		const auto size = this->buffer_.size();
+		auto* output_bytes = static_cast<unsigned char*>(output);
+		const auto output_size = (bits + 7) >> 3;
 
-		while (bit > 0)
+		// output bytes past the last read bit are cleared
+		std::memset(output_bytes, 0, output_size);
+
+		if ((this->current_bit_ & 7) == 0)
 		{
-			const int bit_pos = this->current_bit_ & 7;
-			auto rem_bit = 8 - bit_pos;
-			const auto this_write = (bit < rem_bit) ? bit : rem_bit;
+			std::memcpy(output_bytes, bytes + (this->current_bit_ >> 3), bits >> 3);
+			const auto done = bits & ~7u;
 
-			const BYTE mask = ((0xFF >> rem_bit) | (0xFF << (bit_pos + this_write)));
-			const int byte_pos = this->current_bit_ >> 3;
+			if (bits & 7)
+			{
+				output_bytes[done >> 3] = static_cast<unsigned char>(read_chunk(bytes, size, this->current_bit_ + done, bits & 7));
+			}
 
-			const BYTE temp_byte = (mask & bytes[byte_pos]);
-			const BYTE this_bit = ((bits - bit) & 7);
-			const auto this_byte = (bits - bit) >> 3;
+			this->current_bit_ += bits;
+			return true;
+		}
 
-			auto this_data = input_bytes[this_byte];
+		for (auto offset = 0u; offset < bits; offset += max_chunk_bits)
+		{
+			const auto count = std::min(bits - offset, max_chunk_bits);
+			write_chunk(output_bytes, output_size, offset, read_chunk(bytes, size, this->current_bit_ + offset, count), count);
+		}
 
-			const auto next_byte = (((bits - 1) >> 3) > this_byte) ? input_bytes[this_byte + 1] : 0;
+		this->current_bit_ += bits;
+		return true;
+	}
 
-			this_data = BYTE((next_byte << (8 - this_bit)) | (this_data >> this_bit));
+	bool bit_buffer::write(const unsigned int bits, const void* data)
+	{
+		if (bits == 0) return false;
 
-			const BYTE out_byte = (~mask & (this_data << bit_pos) | temp_byte);
-			bytes[byte_pos] = out_byte;
+		const auto required_size = ((this->current_bit_ + bits) >> 3) + 1;
+		if (this->buffer_.size() < required_size)
+		{
+			this->buffer_.resize(required_size);
+		}
+
+		auto* bytes = reinterpret_cast<unsigned char*>(this->buffer_.data());
+		const auto size = this->buffer_.size();
+		const auto* input_bytes = static_cast<const unsigned char*>(data);
+		const auto input_size = (bits + 7) >> 3;
+
+		if ((this->current_bit_ & 7) == 0)
+		{
+			std::memcpy(bytes + (this->current_bit_ >> 3), input_bytes, bits >> 3);
+			const auto done = bits & ~7u;
+
+			if (bits & 7)
+			{
+				write_chunk(bytes, size, this->current_bit_ + done, input_bytes[done >> 3] & get_mask(bits & 7), bits & 7);
+			}
+
+			this->current_bit_ += bits;
+			return true;
+		}
 
-			this->current_bit_ += this_write;
-			bit -= this_write;
+		for (auto offset = 0u; offset < bits; offset += max_chunk_bits)
+		{
+			const auto count = std::min(bits - offset, max_chunk_bits);
+			write_chunk(bytes, size, this->current_bit_ + offset, read_chunk(input_bytes, input_size, offset, count), count);
 		}
 
+		this->current_bit_ += bits;
 		return true;
 	}
 
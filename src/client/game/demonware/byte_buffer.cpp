@@ -3,6 +3,51 @@
 
 namespace demonware
 {
+	namespace
+	{
+		// buffers are recycled per thread, most replies fit without growing
+		constexpr auto pooled_buffer_size = 0x800u;
+		constexpr auto max_pooled_buffer_size = 0x10000u;
+		constexpr auto max_pooled_buffers = 32u;
+
+		thread_local std::vector<std::string> buffer_pool;
+
+		std::string acquire_buffer()
+		{
+			if (buffer_pool.empty())
+			{
+				std::string buffer;
+				buffer.reserve(pooled_buffer_size);
+				return buffer;
+			}
+
+			auto buffer = std::move(buffer_pool.back());
+			buffer_pool.pop_back();
+			return buffer;
+		}
+
+		void release_buffer(std::string& buffer)
+		{
+			if (buffer.capacity() < pooled_buffer_size || buffer.capacity() > max_pooled_buffer_size
+				|| buffer_pool.size() >= max_pooled_buffers)
+			{
+				return;
+			}
+
+			buffer.clear();
+			buffer_pool.emplace_back(std::move(buffer));
+		}
+	}
+
+	byte_buffer::byte_buffer() : buffer_(acquire_buffer())
+	{
+	}
+
+	byte_buffer::~byte_buffer()
+	{
+		release_buffer(this->buffer_);
+	}
+
 	bool byte_buffer::read_bool(bool* output)
 	{
 		if (!this->read_data_type(1)) return false;
@@ -65,17 +110,31 @@ namespace demonware
 
 	bool byte_buffer::read_string(std::string* output)
 	{
-		char* out_data;
+		std::string_view out_data;
 		if (this->read_string(&out_data))
 		{
-			output->clear();
-			output->append(out_data);
+			output->assign(out_data);
 			return true;
 		}
 
 		return false;
 	}
 
+	bool byte_buffer::read_string(std::string_view* output)
+	{
+		if (!this->read_data_type(16)) return false;
+		if (this->current_byte_ >= this->buffer_.size()) return false;
+
+		const auto* start = this->buffer_.data() + this->current_byte_;
+		const auto* end = static_cast<const char*>(std::memchr(start, 0, this->buffer_.size() - this->current_byte_));
+		if (!end) return false;
+
+		*output = std::string_view(start, end - start);
+		this->current_byte_ += output->size() + 1;
+
+		return true;
+	}
+
 	bool byte_buffer::read_string(char** output)
 	{
 		if (!this->read_data_type(16)) return false;
@@ -98,18 +157,30 @@ namespace demonware
 
 	bool byte_buffer::read_blob(std::string* output)
 	{
-		char* out_data;
-		int length;
-		if (this->read_blob(&out_data, &length))
+		std::string_view out_data;
+		if (this->read_blob(&out_data))
 		{
-			output->clear();
-			output->append(out_data, length);
+			output->assign(out_data);
 			return true;
 		}
 
 		return false;
 	}
 
+	bool byte_buffer::read_blob(std::string_view* output)
+	{
+		if (!this->read_data_type(0x13)) return false;
+
+		unsigned int size;
+		if (!this->read_uint32(&size)) return false;
+		if (size > this->buffer_.size() - this->current_byte_) return false;
+
+		*output = std::string_view(this->buffer_.data() + this->current_byte_, size);
+		this->current_byte_ += size;
+
+		return true;
+	}
+
 	bool byte_buffer::read_blob(char** output, int* length)
 	{
 		if (!this->read_data_type(0x13))
@@ -237,7 +308,7 @@ namespace demonware
 
 	bool byte_buffer::write_blob(const std::string& data)
 	{
-		return this->write_blob(data.data(), INT(data.size()));
+		return this->write_blob(data.data(), static_cast<int>(data.size()));
 	}
 
 	bool byte_buffer::write_blob(const char* data, const int length)
@@ -293,6 +364,11 @@ namespace demonware
 		this->use_data_types_ = use_data_types;
 	}
 
+	void byte_buffer::reserve(const size_t size)
+	{
+		this->buffer_.reserve(size);
+	}
+
 	size_t byte_buffer::size() const
 	{
 		return this->buffer_.size();
@@ -313,6 +389,11 @@ namespace demonware
 		return std::string(this->buffer_.begin() + this->current_byte_, this->buffer_.end());
 	}
 
+	std::string_view byte_buffer::get_remaining_view() const
+	{
+		return std::string_view(this->buffer_).substr(std::min(this->current_byte_, this->buffer_.size()));
+	}
+
 	bool byte_buffer::has_more_data() const
 	{
 		return this->buffer_.size() > this->current_byte_;
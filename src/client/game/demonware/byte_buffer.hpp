@@ -5,12 +5,19 @@ namespace demonware
 	class byte_buffer final
 	{
 	public:
-		byte_buffer() = default;
+		byte_buffer();
 
 		explicit byte_buffer(std::string buffer) : buffer_(std::move(buffer))
 		{
 		}
 
+		~byte_buffer();
+
+		byte_buffer(byte_buffer&&) noexcept = default;
+		byte_buffer(const byte_buffer&) = default;
+		byte_buffer& operator=(byte_buffer&&) noexcept = default;
+		byte_buffer& operator=(const byte_buffer&) = default;
+
 		bool read_bool(bool* output);
 		bool read_byte(char* output);
 		bool read_ubyte(unsigned char* output);
@@ -24,8 +31,10 @@ namespace demonware
 		bool read_string(char** output);
 		bool read_string(char* output, int length);
 		bool read_string(std::string* output);
+		bool read_string(std::string_view* output);
 		bool read_blob(char** output, int* length);
 		bool read_blob(std::string* output);
+		bool read_blob(std::string_view* output);
 		bool read_data_type(char expected);
 
 		bool read_array_header(unsigned char expected, unsigned int* element_count,
@@ -54,12 +63,14 @@ namespace demonware
 		bool write(const std::string& data);
 
 		void set_use_data_types(bool use_data_types);
+		void reserve(size_t size);
 		size_t size() const;
 
 		bool is_using_data_types() const;
 
 		std::string& get_buffer();
 		std::string get_remaining();
+		std::string_view get_remaining_view() const;
 
 		bool has_more_data() const;
 
@@ -18,6 +18,22 @@ namespace demonware
 		}
 	};
 
+	// result that was serialized ahead of time, used for memoized replies
+	class bdSerializedResult final : public bdTaskResult
+	{
+	public:
+		std::shared_ptr<const std::string> data;
+
+		explicit bdSerializedResult(std::shared_ptr<const std::string> buffer) : data(std::move(buffer))
+		{
+		}
+
+		void serialize(byte_buffer* buffer) override
+		{
+			buffer->write(*this->data);
+		}
+	};
+
 	class bdFileData final : public bdTaskResult
 	{
 	public:
@@ -15,6 +15,9 @@ namespace demonware
 		char m_dec_key[16];
 	} data{};
 
+	// keys are derived on the demonware server thread and read by the dispatcher workers when replies are emitted
+	std::mutex data_mutex;
+
 	std::string packet_buffer;
 
 	void calculate_hmacs_s1(const char* data_, const unsigned int data_size, const char* key,
@@ -76,7 +79,13 @@ namespace demonware
 	{
 		const auto out_1 = utils::cryptography::sha1::compute(packet_buffer); // out_1 size 20
 
-		auto data_3 = utils::cryptography::hmac_sha1::compute(data.m_session_key, out_1);
+		std::string session_key;
+		{
+			std::lock_guard<std::mutex> _(data_mutex);
+			session_key = data.m_session_key;
+		}
+
+		auto data_3 = utils::cryptography::hmac_sha1::compute(session_key, out_1);
 
 		char out_2[16];
 		calculate_hmacs_s1(data_3.data(), 20, "CLIENTCHAL", 10, out_2, 16);
@@ -84,6 +93,7 @@ namespace demonware
 		char out_3[72];
 		calculate_hmacs_s1(data_3.data(), 20, "BDDATA", 6, out_3, 72);
 
+		std::lock_guard<std::mutex> _(data_mutex);
 		std::memcpy(data.m_response, &out_2[8], 8);
 		std::memcpy(data.m_hmac_key, &out_3[20], 20);
 		std::memcpy(data.m_dec_key, &out_3[40], 16);
@@ -105,26 +115,31 @@ namespace demonware
 
 	void set_session_key(const std::string& key)
 	{
+		std::lock_guard<std::mutex> _(data_mutex);
 		std::memcpy(data.m_session_key, key.data(), 24);
 	}
 
 	std::string get_decrypt_key()
 	{
+		std::lock_guard<std::mutex> _(data_mutex);
 		return std::string(data.m_dec_key, 16);
 	}
 
 	std::string get_encrypt_key()
 	{
+		std::lock_guard<std::mutex> _(data_mutex);
 		return std::string(data.m_enc_key, 16);
 	}
 
 	std::string get_hmac_key()
 	{
+		std::lock_guard<std::mutex> _(data_mutex);
 		return std::string(data.m_hmac_key, 20);
 	}
 
 	std::string get_response_id()
 	{
+		std::lock_guard<std::mutex> _(data_mutex);
 		return std::string(data.m_response, 8);
 	}
 }
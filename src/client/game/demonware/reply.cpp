@@ -11,6 +11,7 @@ namespace demonware
 	{
 		byte_buffer result;
 		result.set_use_data_types(false);
+		result.reserve(this->buffer_.size() + 6);
 
 		result.write_int32(static_cast<int>(this->buffer_.size()) + 2);
 		result.write_bool(false);
@@ -22,66 +23,68 @@ namespace demonware
 
 	std::string encrypted_reply::data()
 	{
-		byte_buffer result;
-		result.set_use_data_types(false);
-
-		byte_buffer enc_buffer;
-		enc_buffer.set_use_data_types(false);
+		// size : 0xAB 0x85 : message count : seed
+		constexpr auto header_size = 26u;
+		constexpr auto hash_size = 8u;
 
-		enc_buffer.write_uint32(static_cast<unsigned int>(this->buffer_.size())); // service data size CHECKTHIS!!
-		enc_buffer.write_ubyte(this->type()); // TASK_REPLY type
-		enc_buffer.write(this->buffer_); // service data
-
-		auto aligned_data = enc_buffer.get_buffer();
-		auto size = aligned_data.size();
-		size = ~15 & (size + 15); // 16 byte align
-		aligned_data.resize(size);
+		const auto enc_size = ~15 & (this->buffer_.size() + 5 + 15); // 16 byte align
 
 		// seed
-		std::string seed("\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED", 16);
-
-		// encrypt
-		const auto enc_data = utils::cryptography::aes::encrypt(aligned_data, seed, demonware::get_encrypt_key());
+		const std::string seed("\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED", 16);
 
-		// header : encrypted service data : hash
 		static auto msg_count = 0;
 		msg_count++;
 
+		// header : encrypted service data : hash, the service data is encrypted right where it ends up in the packet
 		byte_buffer response;
 		response.set_use_data_types(false);
+		response.reserve(header_size + enc_size + hash_size);
 
-		response.write_int32(30 + static_cast<int>(enc_data.size()));
+		response.write_int32(0); // patched once the packet is complete
 		response.write_ubyte(static_cast<unsigned char>(0xAB));
 		response.write_ubyte(static_cast<unsigned char>(0x85));
 		response.write_int32(msg_count);
 		response.write(16, seed.data());
-		response.write(enc_data);
+
+		response.write_uint32(static_cast<unsigned int>(this->buffer_.size())); // service data size CHECKTHIS!!
+		response.write_ubyte(this->type()); // TASK_REPLY type
+		response.write(this->buffer_); // service data
+
+		auto& packet = response.get_buffer();
+		packet.resize(header_size + enc_size);
+
+		// encrypt
+		auto* enc_data = reinterpret_cast<uint8_t*>(packet.data() + header_size);
+		utils::cryptography::aes::encrypt(enc_data, enc_size, seed, demonware::get_encrypt_key());
+
+		// the size doesn't count itself but includes the hash
+		const auto packet_size = static_cast<int>(packet.size() - sizeof(int) + hash_size);
+		std::memcpy(packet.data(), &packet_size, sizeof(packet_size));
 
 		// hash entire packet and append end
-		auto hash_data = utils::cryptography::hmac_sha1::compute(response.get_buffer(), demonware::get_hmac_key());
-		hash_data.resize(8);
-		response.write(8, hash_data.data());
+		const auto hash_data = utils::cryptography::hmac_sha1::compute(reinterpret_cast<const uint8_t*>(packet.data()), packet.size(), demonware::get_hmac_key());
+		packet.append(hash_data.data(), hash_size);
 
-		return response.get_buffer();
+		return std::move(packet);
 	}
 
 	void remote_reply::send(bit_buffer* buffer, const bool encrypted)
 	{
-		std::unique_ptr<typed_reply> reply;
+		std::unique_ptr<reply> reply;
 
 		if (encrypted) reply = std::make_unique<encrypted_reply>(this->type_, buffer);
 		else reply = std::make_unique<unencrypted_reply>(this->type_, buffer);
 
-		this->server_->send_reply(reply.get());
+		this->server_->send_reply(std::move(reply));
 	}
 
 	void remote_reply::send(byte_buffer* buffer, const bool encrypted)
 	{
-		std::unique_ptr<typed_reply> reply;
+		std::unique_ptr<reply> reply;
 
 		if (encrypted) reply = std::make_unique<encrypted_reply>(this->type_, buffer);
 		else reply = std::make_unique<unencrypted_reply>(this->type_, buffer);
 
-		this->server_->send_reply(reply.get());
+		this->server_->send_reply(std::move(reply));
 	}
 }
@@ -113,7 +113,7 @@ namespace demonware
 
 		uint64_t send()
 		{
-			static uint64_t id = 0x0000000000000000;
+			static std::atomic<uint64_t> id = 0x0000000000000000;
 			const auto transaction_id = ++id;
 
 			byte_buffer buffer;
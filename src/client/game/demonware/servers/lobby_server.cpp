@@ -8,7 +8,12 @@
 
 namespace demonware
 {
-	lobby_server::lobby_server(std::string name) : tcp_server(std::move(name))
+	lobby_server::lobby_server(std::string name)
+		: tcp_server(std::move(name))
+		, dispatcher_(3, [this](reply* data)
+		{
+			this->send_reply(data);
+		})
 	{
 		this->register_service<bdAnticheat>();
 		this->register_service<bdBandwidthTest>();
@@ -44,6 +49,14 @@ namespace demonware
 		this->send(data->data());
 	}
 
+	void lobby_server::send_reply(std::unique_ptr<reply> data)
+	{
+		if (!task_dispatcher::capture(data))
+		{
+			this->dispatcher_.post(std::move(data));
+		}
+	}
+
 	void lobby_server::handle(const std::string& packet)
 	{
 		byte_buffer buffer(packet);
@@ -126,7 +139,11 @@ namespace demonware
 						char seed[16];
 						buffer.read(16, &seed);
 
-						std::string enc = buffer.get_remaining();
+						const auto enc = buffer.get_remaining_view();
+						if (enc.size() < 8)
+						{
+							return;
+						}
 
 						char hash[8];
 						std::memcpy(hash, &(enc.data()[enc.size() - 8]), 8);
@@ -164,11 +181,11 @@ namespace demonware
 
 	void lobby_server::call_service(const uint8_t id, const std::string& data)
 	{
-		const auto& it = this->services_.find(id);
+		const auto& service = this->services_[id];
 
-		if (it != this->services_.end())
+		if (service)
 		{
-			it->second->exec_task(this, data);
+			this->dispatcher_.dispatch(service.get(), this, data);
 		}
 		else
 		{
@@ -3,6 +3,7 @@
 #include "tcp_server.hpp"
 #include "service_server.hpp"
 #include "../service.hpp"
+#include "../task_dispatcher.hpp"
 
 namespace demonware
 {
@@ -23,9 +24,11 @@ namespace demonware
 		}
 
 		void send_reply(reply* data) override;
+		void send_reply(std::unique_ptr<reply> data) override;
 
 	private:
-		std::unordered_map<uint8_t, std::unique_ptr<service>> services_;
+		std::array<std::unique_ptr<service>, 256> services_{};
+		task_dispatcher dispatcher_;
 
 		void handle(const std::string& packet) override;
 		void call_service(uint8_t id, const std::string& data);
@@ -23,5 +23,10 @@ namespace demonware
 		}
 
 		virtual void send_reply(reply* data) = 0;
+
+		virtual void send_reply(std::unique_ptr<reply> data)
+		{
+			this->send_reply(data.get());
+		}
 	};
 }
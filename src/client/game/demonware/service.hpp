@@ -6,13 +6,27 @@ namespace demonware
 {
 	class service
 	{
-		using callback_t = std::function<void(service_server*, byte_buffer*)>;
+		using task_t = void(*)(service*, service_server*, byte_buffer*);
+
+		template <typename T>
+		struct task_traits;
+
+		template <typename Class, typename T, typename... Args>
+		struct task_traits<T(Class::*)(Args...)>
+		{
+			using class_t = Class;
+		};
+
+		template <typename Class, typename T, typename... Args>
+		struct task_traits<T(Class::*)(Args...) const>
+		{
+			using class_t = const Class;
+		};
 
 		uint8_t id_;
 		std::string name_;
-		std::mutex mutex_;
 		uint8_t task_id_;
-		std::map<uint8_t, callback_t> tasks_;
+		std::array<task_t, 256> tasks_{};
 
 	public:
 		virtual ~service() = default;
@@ -39,23 +53,22 @@ namespace demonware
 			return this->task_id_;
 		}
 
+		// tasks of a single service are never executed concurrently, the task_dispatcher serializes them
 		virtual void exec_task(service_server* server, const std::string& data)
 		{
-			std::lock_guard<std::mutex> _(this->mutex_);
-
 			byte_buffer buffer(data);
 
 			buffer.read_ubyte(&this->task_id_);
 
-			const auto& it = this->tasks_.find(this->task_id_);
+			const auto task = this->tasks_[this->task_id_];
 
-			if (it != this->tasks_.end())
+			if (task)
 			{
 #ifdef DW_DEBUG
 				printf("[DW] %s: executing task '%d'\n", name_.data(), this->task_id_);
 #endif
 
-				it->second(server, &buffer);
+				task(this, server, &buffer);
 			}
 			else
 			{
@@ -69,22 +82,13 @@ namespace demonware
 		}
 
 	protected:
-
-		template <typename Class, typename T, typename... Args>
-		void register_task(const uint8_t id, T (Class::* callback)(Args ...) const)
-		{
-			this->tasks_[id] = [this, callback](Args ... args) -> T
-			{
-				return (reinterpret_cast<Class*>(this)->*callback)(args...);
-			};
-		}
-
-		template <typename Class, typename T, typename... Args>
-		void register_task(const uint8_t id, T (Class::* callback)(Args ...))
+		template <auto Callback>
+		void register_task(const uint8_t id)
 		{
-			this->tasks_[id] = [this, callback](Args ... args) -> T
+			this->tasks_[id] = [](service* self, service_server* server, byte_buffer* buffer)
 			{
-				return (reinterpret_cast<Class*>(this)->*callback)(args...);
+				using class_t = typename task_traits<decltype(Callback)>::class_t;
+				(static_cast<class_t*>(self)->*Callback)(server, buffer);
 			};
 		}
 	};
@@ -5,10 +5,10 @@ namespace demonware
 {
 	bdAnticheat::bdAnticheat() : service(38, "bdAnticheat")
 	{
-		this->register_task(2, &bdAnticheat::answerChallenges);
-		this->register_task(3, &bdAnticheat::reportConsoleID);
-		this->register_task(4, &bdAnticheat::reportConsoleDetails);
-		this->register_task(5, &bdAnticheat::answerTOTPChallenge);
+		this->register_task<&bdAnticheat::answerChallenges>(2);
+		this->register_task<&bdAnticheat::reportConsoleID>(3);
+		this->register_task<&bdAnticheat::reportConsoleDetails>(4);
+		this->register_task<&bdAnticheat::answerTOTPChallenge>(5);
 	}
 
 	void bdAnticheat::answerChallenges(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,8 +5,8 @@ namespace demonware
 {
 	bdContentStreaming::bdContentStreaming() : service(50, "bdContentStreaming")
 	{
-		this->register_task(2, &bdContentStreaming::unk2);
-		this->register_task(3, &bdContentStreaming::unk3);
+		this->register_task<&bdContentStreaming::unk2>(2);
+		this->register_task<&bdContentStreaming::unk3>(3);
 	}
 
 	void bdContentStreaming::unk2(service_server* server, byte_buffer* /*buffer*/) const
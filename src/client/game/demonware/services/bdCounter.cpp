@@ -5,8 +5,8 @@ namespace demonware
 {
 	bdCounter::bdCounter() : service(23, "bdCounter")
 	{
-		this->register_task(1, &bdCounter::incrementCounters);
-		this->register_task(2, &bdCounter::getCounterTotals);
+		this->register_task<&bdCounter::incrementCounters>(1);
+		this->register_task<&bdCounter::getCounterTotals>(2);
 	}
 
 	void bdCounter::incrementCounters(service_server* server, byte_buffer* /*buffer*/) const
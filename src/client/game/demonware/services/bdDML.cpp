@@ -5,10 +5,10 @@ namespace demonware
 {
 	bdDML::bdDML() : service(27, "bdDML")
 	{
-		this->register_task(1, &bdDML::recordIP);
-		this->register_task(2, &bdDML::getUserData);
-		this->register_task(3, &bdDML::getUserHierarchicalData);
-		this->register_task(4, &bdDML::getUsersLastLogonData);
+		this->register_task<&bdDML::recordIP>(1);
+		this->register_task<&bdDML::getUserData>(2);
+		this->register_task<&bdDML::getUserHierarchicalData>(3);
+		this->register_task<&bdDML::getUsersLastLogonData>(4);
 	}
 
 	void bdDML::recordIP(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,11 +5,11 @@ namespace demonware
 {
 	bdEventLog::bdEventLog() : service(67, "bdEventLog")
 	{
-		this->register_task(1, &bdEventLog::recordEvent);
-		this->register_task(2, &bdEventLog::recordEventBin);
-		this->register_task(3, &bdEventLog::recordEvents);
-		this->register_task(4, &bdEventLog::recordEventsBin);
-		this->register_task(6, &bdEventLog::initializeFiltering);
+		this->register_task<&bdEventLog::recordEvent>(1);
+		this->register_task<&bdEventLog::recordEventBin>(2);
+		this->register_task<&bdEventLog::recordEvents>(3);
+		this->register_task<&bdEventLog::recordEventsBin>(4);
+		this->register_task<&bdEventLog::initializeFiltering>(6);
 	}
 
 	void bdEventLog::recordEvent(service_server* server, byte_buffer* /*buffer*/) const
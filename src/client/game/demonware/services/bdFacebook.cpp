@@ -5,19 +5,19 @@ namespace demonware
 {
 	bdFacebook::bdFacebook() : service(36, "bdFacebook")
 	{
-		this->register_task(1, &bdFacebook::registerAccount);
-		this->register_task(2, &bdFacebook::post);
-		this->register_task(3, &bdFacebook::unregisterAccount);
-		this->register_task(5, &bdFacebook::isRegistered);
-		this->register_task(6, &bdFacebook::getInfo);
-		this->register_task(7, &bdFacebook::getRegisteredAccounts);
-		this->register_task(8, &bdFacebook::getFriends);
-		this->register_task(9, &bdFacebook::getProfilePictures);
-		this->register_task(10, &bdFacebook::uploadPhoto);
-		this->register_task(11, &bdFacebook::registerToken);
-		this->register_task(12, &bdFacebook::uploadVideo);
-		this->register_task(13, &bdFacebook::getFriendsByID);
-		this->register_task(14, &bdFacebook::setLikeStatus);
+		this->register_task<&bdFacebook::registerAccount>(1);
+		this->register_task<&bdFacebook::post>(2);
+		this->register_task<&bdFacebook::unregisterAccount>(3);
+		this->register_task<&bdFacebook::isRegistered>(5);
+		this->register_task<&bdFacebook::getInfo>(6);
+		this->register_task<&bdFacebook::getRegisteredAccounts>(7);
+		this->register_task<&bdFacebook::getFriends>(8);
+		this->register_task<&bdFacebook::getProfilePictures>(9);
+		this->register_task<&bdFacebook::uploadPhoto>(10);
+		this->register_task<&bdFacebook::registerToken>(11);
+		this->register_task<&bdFacebook::uploadVideo>(12);
+		this->register_task<&bdFacebook::getFriendsByID>(13);
+		this->register_task<&bdFacebook::setLikeStatus>(14);
 	}
 
 	void bdFacebook::registerAccount(service_server* server, byte_buffer* /*buffer*/) const
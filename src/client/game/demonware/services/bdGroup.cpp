@@ -5,10 +5,10 @@ namespace demonware
 {
 	bdGroup::bdGroup() : service(28, "bdGroup")
 	{
-		this->register_task(1, &bdGroup::setGroups);
-		this->register_task(2, &bdGroup::setGroupsForEntity);
-		this->register_task(3, &bdGroup::getEntityGroups);
-		this->register_task(4, &bdGroup::getGroupCounts);
+		this->register_task<&bdGroup::setGroups>(1);
+		this->register_task<&bdGroup::setGroupsForEntity>(2);
+		this->register_task<&bdGroup::getEntityGroups>(3);
+		this->register_task<&bdGroup::getGroupCounts>(4);
 	}
 
 	void bdGroup::setGroups(service_server* server, byte_buffer* /*buffer*/) const
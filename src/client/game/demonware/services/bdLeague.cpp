@@ -5,17 +5,17 @@ namespace demonware
 {
 	bdLeague::bdLeague() : service(81, "bdLeague")
 	{
-		this->register_task(1, &bdLeague::getTeamID);
-		this->register_task(2, &bdLeague::getTeamIDsForUser);
-		this->register_task(3, &bdLeague::getTeamSubdivisions);
-		this->register_task(4, &bdLeague::setTeamName);
-		this->register_task(5, &bdLeague::setTeamIcon);
-		this->register_task(6, &bdLeague::getTeamInfos);
-		this->register_task(7, &bdLeague::getTeamLeaguesAndSubdivisions);
-		this->register_task(8, &bdLeague::getTeamMemberInfos);
-		this->register_task(10, &bdLeague::incrementGamesPlayedCount);
-		this->register_task(20, &bdLeague::getSubdivisionInfos);
-		this->register_task(21, &bdLeague::getTeamSubdivisionHistory);
+		this->register_task<&bdLeague::getTeamID>(1);
+		this->register_task<&bdLeague::getTeamIDsForUser>(2);
+		this->register_task<&bdLeague::getTeamSubdivisions>(3);
+		this->register_task<&bdLeague::setTeamName>(4);
+		this->register_task<&bdLeague::setTeamIcon>(5);
+		this->register_task<&bdLeague::getTeamInfos>(6);
+		this->register_task<&bdLeague::getTeamLeaguesAndSubdivisions>(7);
+		this->register_task<&bdLeague::getTeamMemberInfos>(8);
+		this->register_task<&bdLeague::incrementGamesPlayedCount>(10);
+		this->register_task<&bdLeague::getSubdivisionInfos>(20);
+		this->register_task<&bdLeague::getTeamSubdivisionHistory>(21);
 	}
 
 	void bdLeague::getTeamID(service_server* server, byte_buffer* /*buffer*/) const
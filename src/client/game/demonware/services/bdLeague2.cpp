@@ -5,10 +5,10 @@ namespace demonware
 {
 	bdLeague2::bdLeague2() : service(82, "bdLeague")
 	{
-		this->register_task(1, &bdLeague2::writeStats);
-		this->register_task(2, &bdLeague2::readStatsByTeamID);
-		this->register_task(3, &bdLeague2::readStatsByRank);
-		this->register_task(4, &bdLeague2::readStatsByPivot);
+		this->register_task<&bdLeague2::writeStats>(1);
+		this->register_task<&bdLeague2::readStatsByTeamID>(2);
+		this->register_task<&bdLeague2::readStatsByRank>(3);
+		this->register_task<&bdLeague2::readStatsByPivot>(4);
 	}
 
 	void bdLeague2::writeStats(service_server* server, byte_buffer* /*buffer*/) const
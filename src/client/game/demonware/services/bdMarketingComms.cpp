@@ -10,9 +10,9 @@ namespace demonware
 {
 	bdMarketingComms::bdMarketingComms() : service(104, "bdMarketingComms")
 	{
-		this->register_task(1, &bdMarketingComms::getMessages);
-		this->register_task(4, &bdMarketingComms::reportFullMessagesViewed);
-		this->register_task(5, &bdMarketingComms::getMessages_);
+		this->register_task<&bdMarketingComms::getMessages>(1);
+		this->register_task<&bdMarketingComms::reportFullMessagesViewed>(4);
+		this->register_task<&bdMarketingComms::getMessages_>(5);
 	}
 
 	void bdMarketingComms::getMessages(service_server* server, byte_buffer* /*buffer*/) const
@@ -7,15 +7,15 @@ namespace demonware
 {
 	bdMarketplace::bdMarketplace() : service(80, "bdMarketplace")
 	{
-		this->register_task(42, &bdMarketplace::startExchangeTransaction); // COD POINTS purchase ?
-		//this->register_task(43, &bdMarketplace::purchaseOnSteamInitialize); // COD POINTS purchase ?
-		this->register_task(49, &bdMarketplace::getExpiredInventoryItems);
-		this->register_task(60, &bdMarketplace::steamProcessDurable);
-		this->register_task(122, &bdMarketplace::purchaseSkus);
-		this->register_task(130, &bdMarketplace::getBalance);
-		this->register_task(165, &bdMarketplace::getInventoryPaginated);
-		this->register_task(193, &bdMarketplace::putPlayersInventoryItems);
-		this->register_task(232, &bdMarketplace::getEntitlements);
+		this->register_task<&bdMarketplace::startExchangeTransaction>(42); // COD POINTS purchase ?
+		//this->register_task<&bdMarketplace::purchaseOnSteamInitialize>(43); // COD POINTS purchase ?
+		this->register_task<&bdMarketplace::getExpiredInventoryItems>(49);
+		this->register_task<&bdMarketplace::steamProcessDurable>(60);
+		this->register_task<&bdMarketplace::purchaseSkus>(122);
+		this->register_task<&bdMarketplace::getBalance>(130);
+		this->register_task<&bdMarketplace::getInventoryPaginated>(165);
+		this->register_task<&bdMarketplace::putPlayersInventoryItems>(193);
+		this->register_task<&bdMarketplace::getEntitlements>(232);
 	}
 
 	void bdMarketplace::startExchangeTransaction(service_server* server, byte_buffer* buffer) const
@@ -5,21 +5,21 @@ namespace demonware
 {
 	bdMatchMaking::bdMatchMaking() : service(138, "bdMatchMaking")
 	{
-		this->register_task(1, &bdMatchMaking::createSession);
-		this->register_task(2, &bdMatchMaking::updateSession);
-		this->register_task(3, &bdMatchMaking::deleteSession);
-		this->register_task(4, &bdMatchMaking::findSessionFromID);
-		this->register_task(5, &bdMatchMaking::findSessions);
-		this->register_task(6, &bdMatchMaking::notifyJoin);
-		this->register_task(8, &bdMatchMaking::inviteToSession);
-		this->register_task(9, &bdMatchMaking::submitPerformance);
-		this->register_task(10, &bdMatchMaking::getPerformanceValues);
-		this->register_task(11, &bdMatchMaking::getSessionInvites);
-		this->register_task(12, &bdMatchMaking::updateSessionPlayers);
-		this->register_task(13, &bdMatchMaking::findSessionsPaged);
-		this->register_task(14, &bdMatchMaking::findSessionsByEntityIDs);
-		this->register_task(15, &bdMatchMaking::findSessionsFromIDs);
-		this->register_task(16, &bdMatchMaking::findSessionsTwoPass);
+		this->register_task<&bdMatchMaking::createSession>(1);
+		this->register_task<&bdMatchMaking::updateSession>(2);
+		this->register_task<&bdMatchMaking::deleteSession>(3);
+		this->register_task<&bdMatchMaking::findSessionFromID>(4);
+		this->register_task<&bdMatchMaking::findSessions>(5);
+		this->register_task<&bdMatchMaking::notifyJoin>(6);
+		this->register_task<&bdMatchMaking::inviteToSession>(8);
+		this->register_task<&bdMatchMaking::submitPerformance>(9);
+		this->register_task<&bdMatchMaking::getPerformanceValues>(10);
+		this->register_task<&bdMatchMaking::getSessionInvites>(11);
+		this->register_task<&bdMatchMaking::updateSessionPlayers>(12);
+		this->register_task<&bdMatchMaking::findSessionsPaged>(13);
+		this->register_task<&bdMatchMaking::findSessionsByEntityIDs>(14);
+		this->register_task<&bdMatchMaking::findSessionsFromIDs>(15);
+		this->register_task<&bdMatchMaking::findSessionsTwoPass>(16);
 	}
 
 	void bdMatchMaking::createSession(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,8 +5,8 @@ namespace demonware
 {
 	bdPresence::bdPresence() : service(103, "bdPresence")
 	{
-		this->register_task(1, &bdPresence::unk1);
-		this->register_task(3, &bdPresence::unk3);
+		this->register_task<&bdPresence::unk1>(1);
+		this->register_task<&bdPresence::unk3>(3);
 	}
 
 	void bdPresence::unk1(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,14 +5,14 @@ namespace demonware
 {
 	bdProfiles::bdProfiles() : service(8, "bdProfiles")
 	{
-		this->register_task(1, &bdProfiles::getPublicInfos);
-		this->register_task(2, &bdProfiles::getPrivateInfo);
-		this->register_task(3, &bdProfiles::setPublicInfo);
-		this->register_task(4, &bdProfiles::setPrivateInfo);
-		this->register_task(5, &bdProfiles::deleteProfile);
-		this->register_task(6, &bdProfiles::setPrivateInfoByUserID);
-		this->register_task(7, &bdProfiles::getPrivateInfoByUserID);
-		this->register_task(8, &bdProfiles::setPublicInfoByUserID);
+		this->register_task<&bdProfiles::getPublicInfos>(1);
+		this->register_task<&bdProfiles::getPrivateInfo>(2);
+		this->register_task<&bdProfiles::setPublicInfo>(3);
+		this->register_task<&bdProfiles::setPrivateInfo>(4);
+		this->register_task<&bdProfiles::deleteProfile>(5);
+		this->register_task<&bdProfiles::setPrivateInfoByUserID>(6);
+		this->register_task<&bdProfiles::getPrivateInfoByUserID>(7);
+		this->register_task<&bdProfiles::setPublicInfoByUserID>(8);
 	}
 
 	void bdProfiles::getPublicInfos(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,7 +5,7 @@ namespace demonware
 {
 	bdPublisherVariables::bdPublisherVariables() : service(95, "bdPublisherVariables")
 	{
-		this->register_task(1, &bdPublisherVariables::retrievePublisherVariables);
+		this->register_task<&bdPublisherVariables::retrievePublisherVariables>(1);
 	}
 
 	void bdPublisherVariables::retrievePublisherVariables(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,10 +5,10 @@ namespace demonware
 {
 	bdReward::bdReward() : service(139, "bdReward")
 	{
-		this->register_task(1, &bdReward::incrementTime);
-		this->register_task(2, &bdReward::claimRewardRoll);
-		this->register_task(3, &bdReward::claimClientAchievements);
-		this->register_task(4, &bdReward::reportRewardEvents);
+		this->register_task<&bdReward::incrementTime>(1);
+		this->register_task<&bdReward::claimRewardRoll>(2);
+		this->register_task<&bdReward::claimClientAchievements>(3);
+		this->register_task<&bdReward::reportRewardEvents>(4);
 	}
 
 	void bdReward::incrementTime(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,8 +5,8 @@ namespace demonware
 {
 	bdRichPresence::bdRichPresence() : service(68, "bdRichPresence")
 	{
-		this->register_task(1, &bdRichPresence::setInfo);
-		this->register_task(2, &bdRichPresence::getInfo);
+		this->register_task<&bdRichPresence::setInfo>(1);
+		this->register_task<&bdRichPresence::getInfo>(2);
 	}
 
 	void bdRichPresence::setInfo(service_server* server, byte_buffer* /*buffer*/) const
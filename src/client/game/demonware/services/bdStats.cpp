@@ -8,19 +8,19 @@ namespace demonware
 {
 	bdStats::bdStats() : service(4, "bdStats")
 	{
-		this->register_task(1, &bdStats::writeStats);
-		this->register_task(2, &bdStats::deleteStats);
-		this->register_task(3, &bdStats::unk3); // leaderboards
-		this->register_task(4, &bdStats::readStatsByRank);
-		this->register_task(5, &bdStats::readStatsByPivot);
-		this->register_task(6, &bdStats::readStatsByRating);
-		this->register_task(7, &bdStats::readStatsByMultipleRanks);
-		this->register_task(8, &bdStats::readExternalTitleStats);
-		this->register_task(10, &bdStats::readExternalTitleNamedStats);
-		this->register_task(11, &bdStats::readStatsByLeaderboardIDsAndEntityIDs);
-		this->register_task(12, &bdStats::readStatsByMultipleRatings);
-		this->register_task(13, &bdStats::readStatsByEntityID);
-		this->register_task(14, &bdStats::writeServerValidatedStats);
+		this->register_task<&bdStats::writeStats>(1);
+		this->register_task<&bdStats::deleteStats>(2);
+		this->register_task<&bdStats::unk3>(3); // leaderboards
+		this->register_task<&bdStats::readStatsByRank>(4);
+		this->register_task<&bdStats::readStatsByPivot>(5);
+		this->register_task<&bdStats::readStatsByRating>(6);
+		this->register_task<&bdStats::readStatsByMultipleRanks>(7);
+		this->register_task<&bdStats::readExternalTitleStats>(8);
+		this->register_task<&bdStats::readExternalTitleNamedStats>(10);
+		this->register_task<&bdStats::readStatsByLeaderboardIDsAndEntityIDs>(11);
+		this->register_task<&bdStats::readStatsByMultipleRatings>(12);
+		this->register_task<&bdStats::readStatsByEntityID>(13);
+		this->register_task<&bdStats::writeServerValidatedStats>(14);
 	}
 
 	void bdStats::writeStats(service_server* server, byte_buffer* buffer) const
@@ -5,8 +5,8 @@ namespace demonware
 {
 	bdStats2::bdStats2() : service(19, "bdStats")
 	{
-		this->register_task(1, &bdStats2::startArbitratedSession);
-		this->register_task(2, &bdStats2::writeArbitratedStats);
+		this->register_task<&bdStats2::startArbitratedSession>(1);
+		this->register_task<&bdStats2::writeArbitratedStats>(2);
 	}
 
 	void bdStats2::startArbitratedSession(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,13 +5,13 @@ namespace demonware
 {
 	bdStats3::bdStats3() : service(91, "bdStats")
 	{
-		this->register_task(1, &bdStats3::deleteCSFileStats);
-		this->register_task(3, &bdStats3::readStatsByEntityID);
-		this->register_task(4, &bdStats3::readStatsByRank);
-		this->register_task(5, &bdStats3::readStatsByPivot);
-		this->register_task(6, &bdStats3::readStatsByRating);
-		this->register_task(7, &bdStats3::readStatsByMultipleRanks);
-		this->register_task(11, &bdStats3::readStatsByLeaderboardIDsAndEntityIDs);
+		this->register_task<&bdStats3::deleteCSFileStats>(1);
+		this->register_task<&bdStats3::readStatsByEntityID>(3);
+		this->register_task<&bdStats3::readStatsByRank>(4);
+		this->register_task<&bdStats3::readStatsByPivot>(5);
+		this->register_task<&bdStats3::readStatsByRating>(6);
+		this->register_task<&bdStats3::readStatsByMultipleRanks>(7);
+		this->register_task<&bdStats3::readStatsByLeaderboardIDsAndEntityIDs>(11);
 	}
 
 	void bdStats3::deleteCSFileStats(service_server* server, byte_buffer* /*buffer*/) const
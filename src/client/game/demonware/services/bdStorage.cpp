@@ -1,5 +1,6 @@
 #include <std_include.hpp>
 #include "../services.hpp"
+#include "../user_files.hpp"
 
 #include <utils/nt.hpp>
 #include <utils/io.hpp>
@@ -15,15 +16,94 @@ namespace demonware
 		storage_path = path;
 	}
 
+	namespace
+	{
+		constexpr auto max_cached_publisher_files = 256u;
+
+		std::atomic<std::uint32_t> publisher_generation = 1;
+
+		bool has_top_level_alternation(const std::string& expression)
+		{
+			auto depth = 0;
+			auto in_class = false;
+
+			for (size_t i = 0; i < expression.size(); ++i)
+			{
+				const auto chr = expression[i];
+				if (chr == '\\')
+				{
+					++i;
+				}
+				else if (in_class)
+				{
+					in_class = chr != ']';
+				}
+				else if (chr == '[')
+				{
+					in_class = true;
+				}
+				else if (chr == '(')
+				{
+					++depth;
+				}
+				else if (chr == ')')
+				{
+					--depth;
+				}
+				else if (chr == '|' && depth == 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// literal part of the expression every match has to start with
+		std::string get_expression_prefix(const std::string& expression)
+		{
+			std::string prefix;
+
+			// every alternative has its own prefix
+			if (has_top_level_alternation(expression))
+			{
+				return prefix;
+			}
+
+			for (const auto chr : expression)
+			{
+				if (std::strchr(".[]()*+?{}|^$\\", chr))
+				{
+					// the previous character is optional or repeated
+					if (!prefix.empty() && (chr == '*' || chr == '?' || chr == '{'))
+					{
+						prefix.pop_back();
+					}
+
+					break;
+				}
+
+				prefix.push_back(chr);
+			}
+
+			return prefix;
+		}
+	}
+
+	void invalidate_publisher_files()
+	{
+		++publisher_generation;
+	}
+
 	bdStorage::bdStorage() : service(10, "bdStorage")
 	{
-		this->register_task(20, &bdStorage::list_publisher_files);
-		this->register_task(21, &bdStorage::get_publisher_file);
-		this->register_task(24, &bdStorage::upload_and_validate_files);
-		this->register_task(18, &bdStorage::upload_files);
-		this->register_task(16, &bdStorage::get_user_files);
-		this->register_task(12, &bdStorage::get_user_file);
-		this->register_task(10, &bdStorage::set_user_file);
+		this->register_task<&bdStorage::list_publisher_files>(20);
+		this->register_task<&bdStorage::get_publisher_file>(21);
+		this->register_task<&bdStorage::upload_and_validate_files>(24);
+		this->register_task<&bdStorage::upload_files>(18);
+		this->register_task<&bdStorage::get_user_files>(16);
+		this->register_task<&bdStorage::get_user_file>(12);
+		this->register_task<&bdStorage::set_user_file>(10);
 
 		this->map_publisher_resource("motd-.*\\.txt", DW_MOTD);
 		// this->map_publisher_resource("ffotd-.*\\.ff", DW_FASTFILE);
@@ -43,26 +123,29 @@ namespace demonware
 			throw std::runtime_error("Publisher resource variant is empty!");
 		}
 
-		this->publisher_resources_.emplace_back(std::regex{expression}, std::move(resource));
+		this->publisher_resources_.emplace_back(get_expression_prefix(expression), std::regex{expression}, std::move(resource));
+		this->publisher_files_.clear();
 	}
 
 	bool bdStorage::load_publisher_resource(const std::string& name, std::string& buffer)
 	{
 		for (const auto& resource : this->publisher_resources_)
 		{
-			if (std::regex_match(name, resource.first))
+			if (!name.starts_with(resource.prefix) || !std::regex_match(name, resource.expression))
 			{
-				if (std::holds_alternative<std::string>(resource.second))
-				{
-					buffer = std::get<std::string>(resource.second);
-				}
-				else
-				{
-					buffer = std::get<callback>(resource.second)();
-				}
+				continue;
+			}
 
-				return true;
+			if (std::holds_alternative<std::string>(resource.resource))
+			{
+				buffer = std::get<std::string>(resource.resource);
+			}
+			else
+			{
+				buffer = std::get<callback>(resource.resource)();
 			}
+
+			return true;
 		}
 
 #ifdef DW_DEBUG
@@ -72,11 +155,60 @@ namespace demonware
 		return false;
 	}
 
+	const bdStorage::publisher_file& bdStorage::find_publisher_file(const std::string& name)
+	{
+		const auto generation = publisher_generation.load();
+
+		const auto itr = this->publisher_files_.find(name);
+		if (itr != this->publisher_files_.end() && itr->second.generation == generation)
+		{
+			return itr->second;
+		}
+
+		if (this->publisher_files_.size() >= max_cached_publisher_files)
+		{
+			this->publisher_files_.clear();
+		}
+
+		auto& entry = this->publisher_files_[name];
+		entry = {};
+		entry.generation = generation;
+
+		std::string data;
+		if (!this->load_publisher_resource(name, data))
+		{
+			return entry;
+		}
+
+		entry.exists = true;
+
+		bdFileInfo info{};
+		info.file_id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(name).data());
+		info.filename = name;
+		info.create_time = 0;
+		info.modified_time = info.create_time;
+		info.file_size = uint32_t(data.size());
+		info.owner_id = 0;
+		info.priv = false;
+
+		byte_buffer info_buffer;
+		info.serialize(&info_buffer);
+		entry.file_info = std::make_shared<const std::string>(std::move(info_buffer.get_buffer()));
+
+		bdFileData file_data(std::move(data));
+
+		byte_buffer data_buffer;
+		file_data.serialize(&data_buffer);
+		entry.file_data = std::make_shared<const std::string>(std::move(data_buffer.get_buffer()));
+
+		return entry;
+	}
+
 	void bdStorage::list_publisher_files(service_server* server, byte_buffer* buffer)
 	{
 		uint32_t date;
 		uint16_t num_results, offset;
-		std::string unk, filename, data;
+		std::string unk, filename;
 
 		buffer->read_string(&unk);
 		buffer->read_uint32(&date);
@@ -90,19 +222,10 @@ namespace demonware
 
 		auto reply = server->create_reply(this->task_id());
 
-		if (this->load_publisher_resource(filename, data))
+		const auto& file = this->find_publisher_file(filename);
+		if (file.exists)
 		{
-			auto* info = new bdFileInfo;
-
-			info->file_id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
-			info->filename = filename;
-			info->create_time = 0;
-			info->modified_time = info->create_time;
-			info->file_size = uint32_t(data.size());
-			info->owner_id = 0;
-			info->priv = false;
-
-			reply->add(info);
+			reply->add(new bdSerializedResult(file.file_info));
 		}
 
 		reply->send();
@@ -118,16 +241,16 @@ namespace demonware
 		printf("[DW]: [bdStorage]: loading publisher file: %s\n", filename.data());
 #endif
 
-		std::string data;
+		const auto& file = this->find_publisher_file(filename);
 
-		if (this->load_publisher_resource(filename, data))
+		if (file.exists)
 		{
 #ifdef DW_DEBUG
-			printf("[DW]: [bdStorage]: sending publisher file: %s, size: %lld\n", filename.data(), data.size());
+			printf("[DW]: [bdStorage]: sending publisher file: %s, size: %lld\n", filename.data(), file.file_data->size());
 #endif
 
 			auto reply = server->create_reply(this->task_id());
-			reply->add(new bdFileData(data));
+			reply->add(new bdSerializedResult(file.file_data));
 			reply->send();
 		}
 		else
@@ -166,7 +289,7 @@ namespace demonware
 		buffer->read_uint64(&owner);
 
 		const auto path = get_user_file_path(filename);
-		utils::io::write_file(path, data);
+		user_files::write(path, data);
 
 		auto* info = new bdFileInfo;
 
@@ -198,11 +321,10 @@ namespace demonware
 			utils::io::create_directory(custom_path);
 			const auto copy_file = [&](const std::string& name)
 			{
-				const auto file_path = regular_path + name;
-				if (utils::io::file_exists(file_path))
+				std::string data;
+				if (user_files::read(regular_path + name, &data))
 				{
-					const auto data = utils::io::read_file(file_path);
-					utils::io::write_file(custom_path + name, data, false);
+					user_files::write(custom_path + name, std::move(data));
 				}
 			};
 
@@ -238,7 +360,7 @@ namespace demonware
 			buffer->read_bool(&priv);
 
 			const auto path = get_user_file_path(filename);
-			utils::io::write_file(path, data);
+			user_files::write(path, data);
 
 			auto* info = new bdFile2;
 
@@ -302,7 +424,7 @@ namespace demonware
 
 			auto& name = filenames.at(i);
 			std::string filedata;
-			if (utils::io::read_file(get_user_file_path(name), &filedata))
+			if (user_files::read(get_user_file_path(name), &filedata))
 			{
 				entry->filedata = filedata;
 #ifdef DW_DEBUG
@@ -348,7 +470,7 @@ namespace demonware
 			buffer->read_bool(&priv);
 
 			const auto path = get_user_file_path(filename);
-			utils::io::write_file(path, data);
+			user_files::write(path, data);
 
 			auto* info = new bdContextUserStorageFileInfo;
 
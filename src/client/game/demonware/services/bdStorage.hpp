@@ -4,6 +4,9 @@ namespace demonware
 {
 	void set_storage_path(const std::string& path);
 
+	// rebuilds every publisher file on its next request, call it once the data behind a callback resource changed
+	void invalidate_publisher_files();
+
 	class bdStorage final : public service
 	{
 	public:
@@ -12,11 +15,31 @@ namespace demonware
 	private:
 		using callback = std::function<std::string()>;
 		using resource_variant = std::variant<std::string, callback>;
-		std::vector<std::pair<std::regex, resource_variant>> publisher_resources_;
+
+		struct publisher_resource
+		{
+			std::string prefix;
+			std::regex expression;
+			resource_variant resource;
+		};
+
+		// built once per file name and kept until invalidate_publisher_files is called,
+		// mapping another resource drops all of them
+		struct publisher_file
+		{
+			std::uint32_t generation;
+			bool exists;
+			std::shared_ptr<const std::string> file_info; // serialized bdFileInfo
+			std::shared_ptr<const std::string> file_data; // serialized bdFileData
+		};
+
+		std::vector<publisher_resource> publisher_resources_;
+		std::unordered_map<std::string, publisher_file> publisher_files_;
 
 		void map_publisher_resource(const std::string& expression, INT id);
 		void map_publisher_resource_variant(const std::string& expression, resource_variant resource);
 		bool load_publisher_resource(const std::string& name, std::string& buffer);
+		const publisher_file& find_publisher_file(const std::string& name);
 
 		void list_publisher_files(service_server* server, byte_buffer* buffer);
 		void get_publisher_file(service_server* server, byte_buffer* buffer);
@@ -5,56 +5,56 @@ namespace demonware
 {
 	bdTeams::bdTeams() : service(3, "bdTeams")
 	{
-		this->register_task(30, &bdTeams::createTeam);
-		this->register_task(31, &bdTeams::updateTeamName);
-		this->register_task(32, &bdTeams::promoteMember);
-		this->register_task(33, &bdTeams::kickMember);
-		this->register_task(34, &bdTeams::leaveTeam);
-		this->register_task(35, &bdTeams::proposeMembership);
-		this->register_task(36, &bdTeams::rejectMembership);
-		this->register_task(37, &bdTeams::acceptMembership);
-		this->register_task(38, &bdTeams::getPublicProfiles);
-		this->register_task(39, &bdTeams::getPrivateProfile);
-		this->register_task(40, &bdTeams::getPublicMemberProfiles);
-		this->register_task(41, &bdTeams::getPrivateMemberProfiles);
-		this->register_task(42, &bdTeams::setPublicProfile);
-		this->register_task(43, &bdTeams::setPrivateProfile);
-		this->register_task(44, &bdTeams::setPublicMemberProfile);
-		this->register_task(45, &bdTeams::setPrivateMemberProfile);
-		this->register_task(46, &bdTeams::getMemberships);
-		this->register_task(47, &bdTeams::getMembers);
-		this->register_task(48, &bdTeams::getOutgoingProposals);
-		this->register_task(49, &bdTeams::withdrawProposal);
-		this->register_task(50, &bdTeams::demoteMember);
-		this->register_task(51, &bdTeams::promoteMemberToOwner);
-		this->register_task(52, &bdTeams::getTeamInfo);
-		this->register_task(53, &bdTeams::getIncomingProposals);
-		this->register_task(54, &bdTeams::sendInstantMessage);
-		this->register_task(56, &bdTeams::getMembershipsUser);
-		this->register_task(57, &bdTeams::sendInstantMessageToTeam);
-		this->register_task(58, &bdTeams::searchPublicTeamProfiles);
-		this->register_task(63, &bdTeams::addApplication);
-		this->register_task(64, &bdTeams::getApplicationsByTeam);
-		this->register_task(65, &bdTeams::acceptApplication);
-		this->register_task(66, &bdTeams::rejectApplication);
-		this->register_task(68, &bdTeams::autoJoinTeam);
-		this->register_task(70, &bdTeams::createTeamWithProfiles);
-		this->register_task(73, &bdTeams::banMember);
-		this->register_task(74, &bdTeams::unbanMember);
-		this->register_task(76, &bdTeams::blockApplication);
-		this->register_task(78, &bdTeams::unblockApplication);
-		this->register_task(80, &bdTeams::updateTeamType);
-		this->register_task(82, &bdTeams::setOnline);
-		this->register_task(83, &bdTeams::getMembershipsWithCounts);
-		this->register_task(84, &bdTeams::getMembershipsWithCountsUser);
-		this->register_task(85, &bdTeams::searchTeams);
-		this->register_task(86, &bdTeams::createTeamWithProfilesAndTeamType);
-		this->register_task(87, &bdTeams::getMembershipsWithCountsAndTeamTypeUser);
-		this->register_task(88, &bdTeams::getMembershipsWithCountsAndTeamType);
-		this->register_task(89, &bdTeams::getTeamInfoWithTeamType);
-		this->register_task(91, &bdTeams::setTeamAutoJoin);
-		this->register_task(92, &bdTeams::getTeamAutoJoin);
-		this->register_task(94, &bdTeams::getMembersAndPrivileges);
+		this->register_task<&bdTeams::createTeam>(30);
+		this->register_task<&bdTeams::updateTeamName>(31);
+		this->register_task<&bdTeams::promoteMember>(32);
+		this->register_task<&bdTeams::kickMember>(33);
+		this->register_task<&bdTeams::leaveTeam>(34);
+		this->register_task<&bdTeams::proposeMembership>(35);
+		this->register_task<&bdTeams::rejectMembership>(36);
+		this->register_task<&bdTeams::acceptMembership>(37);
+		this->register_task<&bdTeams::getPublicProfiles>(38);
+		this->register_task<&bdTeams::getPrivateProfile>(39);
+		this->register_task<&bdTeams::getPublicMemberProfiles>(40);
+		this->register_task<&bdTeams::getPrivateMemberProfiles>(41);
+		this->register_task<&bdTeams::setPublicProfile>(42);
+		this->register_task<&bdTeams::setPrivateProfile>(43);
+		this->register_task<&bdTeams::setPublicMemberProfile>(44);
+		this->register_task<&bdTeams::setPrivateMemberProfile>(45);
+		this->register_task<&bdTeams::getMemberships>(46);
+		this->register_task<&bdTeams::getMembers>(47);
+		this->register_task<&bdTeams::getOutgoingProposals>(48);
+		this->register_task<&bdTeams::withdrawProposal>(49);
+		this->register_task<&bdTeams::demoteMember>(50);
+		this->register_task<&bdTeams::promoteMemberToOwner>(51);
+		this->register_task<&bdTeams::getTeamInfo>(52);
+		this->register_task<&bdTeams::getIncomingProposals>(53);
+		this->register_task<&bdTeams::sendInstantMessage>(54);
+		this->register_task<&bdTeams::getMembershipsUser>(56);
+		this->register_task<&bdTeams::sendInstantMessageToTeam>(57);
+		this->register_task<&bdTeams::searchPublicTeamProfiles>(58);
+		this->register_task<&bdTeams::addApplication>(63);
+		this->register_task<&bdTeams::getApplicationsByTeam>(64);
+		this->register_task<&bdTeams::acceptApplication>(65);
+		this->register_task<&bdTeams::rejectApplication>(66);
+		this->register_task<&bdTeams::autoJoinTeam>(68);
+		this->register_task<&bdTeams::createTeamWithProfiles>(70);
+		this->register_task<&bdTeams::banMember>(73);
+		this->register_task<&bdTeams::unbanMember>(74);
+		this->register_task<&bdTeams::blockApplication>(76);
+		this->register_task<&bdTeams::unblockApplication>(78);
+		this->register_task<&bdTeams::updateTeamType>(80);
+		this->register_task<&bdTeams::setOnline>(82);
+		this->register_task<&bdTeams::getMembershipsWithCounts>(83);
+		this->register_task<&bdTeams::getMembershipsWithCountsUser>(84);
+		this->register_task<&bdTeams::searchTeams>(85);
+		this->register_task<&bdTeams::createTeamWithProfilesAndTeamType>(86);
+		this->register_task<&bdTeams::getMembershipsWithCountsAndTeamTypeUser>(87);
+		this->register_task<&bdTeams::getMembershipsWithCountsAndTeamType>(88);
+		this->register_task<&bdTeams::getTeamInfoWithTeamType>(89);
+		this->register_task<&bdTeams::setTeamAutoJoin>(91);
+		this->register_task<&bdTeams::getTeamAutoJoin>(92);
+		this->register_task<&bdTeams::getMembersAndPrivileges>(94);
 	}
 
 	void bdTeams::createTeam(service_server* server, byte_buffer* /*buffer*/) const
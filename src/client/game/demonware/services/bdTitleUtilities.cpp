@@ -5,7 +5,7 @@ namespace demonware
 {
 	bdTitleUtilities::bdTitleUtilities() : service(12, "bdTitleUtilities")
 	{
-		this->register_task(6, &bdTitleUtilities::get_server_time);
+		this->register_task<&bdTitleUtilities::get_server_time>(6);
 	}
 
 	void bdTitleUtilities::get_server_time(service_server* server, byte_buffer* /*buffer*/) const
@@ -5,17 +5,17 @@ namespace demonware
 {
 	bdUserGroups::bdUserGroups() : service(65, "bdUserGroups")
 	{
-		this->register_task(1, &bdUserGroups::createGroup);
-		this->register_task(2, &bdUserGroups::deleteGroup);
-		this->register_task(3, &bdUserGroups::joinGroup);
-		this->register_task(4, &bdUserGroups::leaveGroup);
-		this->register_task(5, &bdUserGroups::getMembershipInfo);
-		this->register_task(6, &bdUserGroups::changeMemberType);
-		this->register_task(7, &bdUserGroups::getNumMembers);
-		this->register_task(8, &bdUserGroups::getMembers);
-		this->register_task(9, &bdUserGroups::getMemberships);
-		this->register_task(10, &bdUserGroups::readStatsByRank);
-		this->register_task(11, &bdUserGroups::getGroupLists);
+		this->register_task<&bdUserGroups::createGroup>(1);
+		this->register_task<&bdUserGroups::deleteGroup>(2);
+		this->register_task<&bdUserGroups::joinGroup>(3);
+		this->register_task<&bdUserGroups::leaveGroup>(4);
+		this->register_task<&bdUserGroups::getMembershipInfo>(5);
+		this->register_task<&bdUserGroups::changeMemberType>(6);
+		this->register_task<&bdUserGroups::getNumMembers>(7);
+		this->register_task<&bdUserGroups::getMembers>(8);
+		this->register_task<&bdUserGroups::getMemberships>(9);
+		this->register_task<&bdUserGroups::readStatsByRank>(10);
+		this->register_task<&bdUserGroups::getGroupLists>(11);
 	}
 
 	void bdUserGroups::createGroup(service_server* server, byte_buffer* /*buffer*/) const
@@ -0,0 +1,244 @@
+#include <std_include.hpp>
+#include "task_dispatcher.hpp"
+#include "service.hpp"
+
+#include <utils/thread.hpp>
+
+namespace demonware
+{
+	namespace
+	{
+		thread_local std::vector<std::unique_ptr<reply>>* current_replies = nullptr;
+	}
+
+	task_dispatcher::service_queue::service_queue(demonware::service* service)
+		: service(service), head_(&stub_), tail_(&stub_)
+	{
+	}
+
+	void task_dispatcher::service_queue::push(job* node)
+	{
+		node->next.store(nullptr, std::memory_order_relaxed);
+		// seq_cst pairs with the scheduled flag, see run
+		const auto prev = this->head_.exchange(node, std::memory_order_seq_cst);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	task_dispatcher::job* task_dispatcher::service_queue::pop()
+	{
+		auto* tail = this->tail_;
+		auto* next = tail->next.load(std::memory_order_acquire);
+
+		if (tail == &this->stub_)
+		{
+			if (!next)
+			{
+				return nullptr;
+			}
+
+			this->tail_ = next;
+			tail = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+
+		if (next)
+		{
+			this->tail_ = next;
+			return tail;
+		}
+
+		// a producer is in the middle of linking a new node
+		if (tail != this->head_.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+
+		this->push(&this->stub_);
+
+		next = tail->next.load(std::memory_order_acquire);
+		if (next)
+		{
+			this->tail_ = next;
+			return tail;
+		}
+
+		return nullptr;
+	}
+
+	bool task_dispatcher::service_queue::empty() const
+	{
+		// only looks at head_, another worker may already own the queue and be moving tail_.
+		// A drained queue always ends with the stub pushed back in, any later push replaces it
+		return this->head_.load(std::memory_order_seq_cst) == &this->stub_;
+	}
+
+	task_dispatcher::task_dispatcher(const std::size_t worker_count, emit_callback emit)
+		: emit_(std::move(emit))
+	{
+		for (std::size_t i = 0; i < worker_count; ++i)
+		{
+			this->workers_.emplace_back(utils::thread::create_named_thread("Demonware Worker", [this]()
+			{
+				this->work();
+			}));
+		}
+	}
+
+	task_dispatcher::~task_dispatcher()
+	{
+		{
+			std::lock_guard<std::mutex> _(this->ready_mutex_);
+			this->stopping_ = true;
+		}
+
+		this->ready_condition_.notify_all();
+
+		for (auto& worker : this->workers_)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+
+		for (auto& queue : this->queues_)
+		{
+			if (!queue)
+			{
+				continue;
+			}
+
+			while (auto* node = queue->pop())
+			{
+				delete node;
+			}
+		}
+	}
+
+	void task_dispatcher::dispatch(service* service, service_server* server, std::string data)
+	{
+		auto& queue = this->queues_[service->id()];
+		if (!queue)
+		{
+			queue = std::make_unique<service_queue>(service);
+		}
+
+		auto* node = new job;
+		node->sequence = this->next_sequence_++;
+		node->server = server;
+		node->data = std::move(data);
+
+		queue->push(node);
+
+		if (!queue->scheduled.exchange(true))
+		{
+			this->schedule(queue.get());
+		}
+	}
+
+	void task_dispatcher::post(std::unique_ptr<reply> reply)
+	{
+		// emitted under emit_mutex_ like task replies, the encrypted framing isn't thread safe
+		std::vector<std::unique_ptr<demonware::reply>> replies;
+		replies.emplace_back(std::move(reply));
+
+		this->complete(this->next_sequence_++, std::move(replies));
+	}
+
+	bool task_dispatcher::capture(std::unique_ptr<reply>& reply)
+	{
+		if (!current_replies)
+		{
+			return false;
+		}
+
+		current_replies->emplace_back(std::move(reply));
+		return true;
+	}
+
+	void task_dispatcher::schedule(service_queue* queue)
+	{
+		{
+			std::lock_guard<std::mutex> _(this->ready_mutex_);
+			this->ready_queues_.push_back(queue);
+		}
+
+		this->ready_condition_.notify_one();
+	}
+
+	void task_dispatcher::work()
+	{
+		while (true)
+		{
+			service_queue* queue = nullptr;
+
+			{
+				std::unique_lock<std::mutex> lock(this->ready_mutex_);
+				this->ready_condition_.wait(lock, [this]()
+				{
+					return this->stopping_ || !this->ready_queues_.empty();
+				});
+
+				if (this->stopping_)
+				{
+					return;
+				}
+
+				queue = this->ready_queues_.front();
+				this->ready_queues_.pop_front();
+			}
+
+			this->run(queue);
+		}
+	}
+
+	void task_dispatcher::run(service_queue* queue)
+	{
+		while (true)
+		{
+			while (auto* node = queue->pop())
+			{
+				std::vector<std::unique_ptr<reply>> replies;
+				current_replies = &replies;
+
+				try
+				{
+					queue->service->exec_task(node->server, node->data);
+				}
+				catch (...)
+				{
+				}
+
+				current_replies = nullptr;
+
+				this->complete(node->sequence, std::move(replies));
+				delete node;
+			}
+
+			queue->scheduled = false;
+
+			// the server thread might have pushed after our last pop but before we released the queue,
+			// either we see its push here or it sees the cleared flag and schedules the queue itself
+			if (queue->empty() || queue->scheduled.exchange(true))
+			{
+				return;
+			}
+		}
+	}
+
+	void task_dispatcher::complete(const std::uint64_t sequence, std::vector<std::unique_ptr<reply>> replies)
+	{
+		std::lock_guard<std::mutex> _(this->emit_mutex_);
+		this->completed_[sequence] = std::move(replies);
+
+		for (auto entry = this->completed_.begin();
+			entry != this->completed_.end() && entry->first == this->next_emit_;
+			entry = this->completed_.erase(entry), ++this->next_emit_)
+		{
+			for (const auto& reply : entry->second)
+			{
+				this->emit_(reply.get());
+			}
+		}
+	}
+}
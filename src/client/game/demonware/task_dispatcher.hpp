@@ -0,0 +1,83 @@
+#pragma once
+
+#include "reply.hpp"
+
+namespace demonware
+{
+	class service;
+	class service_server;
+
+	// Executes service tasks on a small worker pool.
+	// Tasks of the same service run one after another, different services run concurrently.
+	// Replies are released in the order the tasks were dispatched.
+	class task_dispatcher final
+	{
+	public:
+		using emit_callback = std::function<void(reply*)>;
+
+		task_dispatcher(std::size_t worker_count, emit_callback emit);
+		~task_dispatcher();
+
+		task_dispatcher(task_dispatcher&&) = delete;
+		task_dispatcher(const task_dispatcher&) = delete;
+		task_dispatcher& operator=(task_dispatcher&&) = delete;
+		task_dispatcher& operator=(const task_dispatcher&) = delete;
+
+		// must only be called from a single thread (the demonware server thread)
+		void dispatch(service* service, service_server* server, std::string data);
+
+		// queues a reply that wasn't produced by a task behind everything dispatched so far, same thread as dispatch
+		void post(std::unique_ptr<reply> reply);
+
+		// keeps the reply if the calling thread is currently executing a task
+		static bool capture(std::unique_ptr<reply>& reply);
+
+	private:
+		struct job
+		{
+			std::atomic<job*> next{};
+			std::uint64_t sequence{};
+			service_server* server{};
+			std::string data{};
+		};
+
+		// intrusive multi-producer single-consumer queue, the consumer is whichever worker owns the service
+		struct service_queue
+		{
+			explicit service_queue(demonware::service* service);
+
+			void push(job* node);
+			job* pop();
+			// safe to call from any thread
+			bool empty() const;
+
+			demonware::service* service;
+			std::atomic_bool scheduled{};
+
+		private:
+			job stub_{};
+			std::atomic<job*> head_;
+			job* tail_;
+		};
+
+		emit_callback emit_;
+
+		std::array<std::unique_ptr<service_queue>, 256> queues_{};
+		std::uint64_t next_sequence_ = 0;
+
+		std::mutex ready_mutex_;
+		std::condition_variable ready_condition_;
+		std::deque<service_queue*> ready_queues_;
+		bool stopping_ = false;
+		std::vector<std::thread> workers_;
+
+		std::mutex emit_mutex_;
+		std::uint64_t next_emit_ = 0;
+		std::map<std::uint64_t, std::vector<std::unique_ptr<reply>>> completed_;
+
+		void schedule(service_queue* queue);
+		void work();
+		void run(service_queue* queue);
+		void complete(std::uint64_t sequence, std::vector<std::unique_ptr<reply>> replies);
+	};
+}
@@ -0,0 +1,263 @@
+#include <std_include.hpp>
+#include "user_files.hpp"
+
+#include <utils/io.hpp>
+#include <utils/thread.hpp>
+
+namespace demonware::user_files
+{
+	namespace
+	{
+		// repeated uploads of the same file within this window end up as a single write
+		constexpr auto coalesce_delay = 2s;
+		// files already on disk are dropped from memory beyond this, least recently used first
+		constexpr auto max_cached_bytes = 16u * 1024 * 1024;
+
+		struct file_entry
+		{
+			std::shared_ptr<const std::string> data;
+			std::uint64_t version;
+			bool dirty;
+			std::uint64_t last_use;
+		};
+
+		struct pending_write
+		{
+			std::string path;
+			std::shared_ptr<const std::string> data;
+			std::uint64_t version;
+		};
+
+		struct store
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::unordered_map<std::string, file_entry> files;
+			std::size_t cached_bytes = 0;
+			std::uint64_t next_version = 0;
+			std::uint64_t next_use = 0;
+			bool pending_writes = false;
+			bool stopping = false;
+			std::thread flusher;
+
+			// serializes disk writes between the flusher and explicit flushes
+			std::mutex write_mutex;
+		};
+
+		// intentionally leaked, the flusher must outlive every static that might still write on exit
+		store& get_store()
+		{
+			static auto* instance = new store;
+			return *instance;
+		}
+
+		// store.mutex must be held
+		void trim_cache(store& store)
+		{
+			while (store.cached_bytes > max_cached_bytes)
+			{
+				auto oldest = store.files.end();
+				for (auto itr = store.files.begin(); itr != store.files.end(); ++itr)
+				{
+					if (!itr->second.dirty && (oldest == store.files.end() || itr->second.last_use < oldest->second.last_use))
+					{
+						oldest = itr;
+					}
+				}
+
+				// everything left still has to reach the disk
+				if (oldest == store.files.end())
+				{
+					return;
+				}
+
+				store.cached_bytes -= oldest->second.data->size();
+				store.files.erase(oldest);
+			}
+		}
+
+		// store.mutex must be held
+		void set_entry(store& store, const std::string& path, std::string data, const bool dirty)
+		{
+			auto& entry = store.files[path];
+			if (entry.data)
+			{
+				store.cached_bytes -= entry.data->size();
+			}
+
+			store.cached_bytes += data.size();
+			entry = {std::make_shared<const std::string>(std::move(data)), store.next_version++, dirty, store.next_use++};
+
+			trim_cache(store);
+		}
+
+		bool write_to_disk(const pending_write& write)
+		{
+			// creating the directory throws if something is in the way, that must not end the flusher
+			try
+			{
+				return utils::io::write_file_atomic(write.path, *write.data);
+			}
+			catch (const std::exception&)
+			{
+				return false;
+			}
+		}
+
+		void write_dirty_files()
+		{
+			auto& store = get_store();
+			std::lock_guard<std::mutex> _(store.write_mutex);
+
+			std::vector<pending_write> writes;
+
+			{
+				std::lock_guard<std::mutex> __(store.mutex);
+				store.pending_writes = false;
+
+				for (auto& [path, entry] : store.files)
+				{
+					if (entry.dirty)
+					{
+						entry.dirty = false;
+						writes.emplace_back(path, entry.data, entry.version);
+					}
+				}
+			}
+
+			for (const auto& write : writes)
+			{
+				if (write_to_disk(write))
+				{
+					continue;
+				}
+
+				// retry on the next flush unless a newer version replaced it in the meantime
+				std::lock_guard<std::mutex> __(store.mutex);
+				const auto entry = store.files.find(write.path);
+				if (entry != store.files.end() && entry->second.version == write.version)
+				{
+					entry->second.dirty = true;
+					store.pending_writes = true;
+				}
+			}
+
+			if (!writes.empty())
+			{
+				std::lock_guard<std::mutex> __(store.mutex);
+				trim_cache(store);
+			}
+		}
+
+		void flusher_main()
+		{
+			auto& store = get_store();
+			std::unique_lock<std::mutex> lock(store.mutex);
+
+			while (!store.stopping)
+			{
+				store.condition.wait(lock, [&]()
+				{
+					return store.stopping || store.pending_writes;
+				});
+
+				if (store.stopping)
+				{
+					break;
+				}
+
+				store.condition.wait_for(lock, coalesce_delay, [&]()
+				{
+					return store.stopping;
+				});
+
+				lock.unlock();
+				write_dirty_files();
+				lock.lock();
+			}
+		}
+	}
+
+	bool read(const std::string& path, std::string* data)
+	{
+		auto& store = get_store();
+
+		{
+			std::lock_guard<std::mutex> _(store.mutex);
+			const auto itr = store.files.find(path);
+			if (itr != store.files.end())
+			{
+				itr->second.last_use = store.next_use++;
+				*data = *itr->second.data;
+				return true;
+			}
+		}
+
+		if (!utils::io::read_file(path, data))
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> _(store.mutex);
+		const auto itr = store.files.find(path);
+		if (itr != store.files.end())
+		{
+			// written while we were reading from disk, the cached version is newer
+			*data = *itr->second.data;
+			return true;
+		}
+
+		set_entry(store, path, *data, false);
+		return true;
+	}
+
+	void write(const std::string& path, std::string data)
+	{
+		auto& store = get_store();
+
+		{
+			std::lock_guard<std::mutex> _(store.mutex);
+
+			if (store.stopping)
+			{
+				utils::io::write_file_atomic(path, data);
+				set_entry(store, path, std::move(data), false);
+				return;
+			}
+
+			set_entry(store, path, std::move(data), true);
+			store.pending_writes = true;
+
+			if (!store.flusher.joinable())
+			{
+				store.flusher = utils::thread::create_named_thread("User File Flusher", flusher_main);
+			}
+		}
+
+		store.condition.notify_one();
+	}
+
+	void flush()
+	{
+		write_dirty_files();
+	}
+
+	void shutdown()
+	{
+		auto& store = get_store();
+
+		{
+			std::lock_guard<std::mutex> _(store.mutex);
+			store.stopping = true;
+		}
+
+		store.condition.notify_all();
+
+		if (store.flusher.joinable())
+		{
+			store.flusher.join();
+		}
+
+		flush();
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace demonware::user_files
+{
+	// reads are served from memory once a file was seen, writes are flushed to disk in the background.
+	// Files that reached the disk are dropped from memory once the cache grows too large
+	bool read(const std::string& path, std::string* data);
+	void write(const std::string& path, std::string data);
+
+	// blocks until every pending write reached the disk
+	void flush();
+	void shutdown();
+}
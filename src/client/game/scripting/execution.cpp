@@ -18,12 +18,7 @@ namespace scripting
 
 		int get_field_id(const int classnum, const std::string& field)
 		{
-			if (scripting::fields_table[classnum].find(field) != scripting::fields_table[classnum].end())
-			{
-				return scripting::fields_table[classnum][field];
-			}
-
-			return -1;
+			return scripting::find_field(classnum, field);
 		}
 
 		script_value get_return_value()
@@ -124,18 +119,18 @@ namespace scripting
 
 	const char* get_function_pos(const std::string& filename, const std::string& function)
 	{
-		if (!script_function_table.contains(filename))
+		const auto pos = find_script_function(filename, function);
+		if (pos)
 		{
-			throw std::runtime_error("File '" + filename + "' not found");
+			return pos;
 		}
 
-		const auto& functions = script_function_table[filename];
-		if (!functions.contains(function))
+		if (!has_script_functions(filename))
 		{
-			throw std::runtime_error("Function '" + function + "' in file '" + filename + "' not found");
+			throw std::runtime_error("File '" + filename + "' not found");
 		}
 
-		return functions.at(function);
+		throw std::runtime_error("Function '" + function + "' in file '" + filename + "' not found");
 	}
 
 	script_value call_script_function(const entity& entity, const std::string& filename,
@@ -28,10 +28,10 @@ namespace scripting
 
 	std::string function::get_name() const
 	{
-		if (scripting::script_function_table_rev.contains(this->pos_))
+		if (const auto func = scripting::find_script_function_name(this->pos_))
 		{
-			const auto& func = scripting::script_function_table_rev[this->pos_];
-			return utils::string::va("%s::%s", func.first.data(), func.second.data());
+			return utils::string::va("%.*s::%.*s", static_cast<int>(func->file.size()), func->file.data(),
+				static_cast<int>(func->function.size()), func->function.data());
 		}
 
 		return "unknown function";
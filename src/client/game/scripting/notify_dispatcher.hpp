@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scripting
+{
+	// Hands notifies to the listeners registered for their string id.
+	// Notifies nobody listens to only cost a bit lookup, arguments are captured into a fixed buffer on the stack.
+	template <typename Value, size_t MaxArguments = 32>
+	class notify_dispatcher
+	{
+	public:
+		struct event
+		{
+			unsigned int entity_id;
+			unsigned int name;
+			// top of the stack first, like they were passed to notify
+			std::span<const Value> arguments;
+			bool truncated;
+		};
+
+		using listener = std::function<void(const event&)>;
+		using resolver = std::function<unsigned int(const std::string& name)>;
+
+		uint64_t add(const std::string& name, const unsigned int id, listener callback)
+		{
+			const auto handle = ++this->last_handle_;
+			this->listeners_[id].emplace_back(handle, name, std::make_shared<const listener>(std::move(callback)));
+			this->set_bit(id, true);
+
+			return handle;
+		}
+
+		bool remove(const uint64_t handle)
+		{
+			for (auto& [id, entries] : this->listeners_)
+			{
+				for (auto& entry : entries)
+				{
+					if (entry.handle == handle)
+					{
+						// dispatch might be iterating over this list, it's compacted afterwards
+						entry.handle = 0;
+						entry.callback = {};
+						this->needs_compaction_ = true;
+						this->compact();
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		// string ids can change between levels, resolves the names of all listeners again
+		void rebind(const resolver& resolve)
+		{
+			std::unordered_map<unsigned int, std::vector<entry>> listeners;
+			for (auto& [id, entries] : this->listeners_)
+			{
+				for (auto& entry : entries)
+				{
+					if (entry.handle)
+					{
+						listeners[resolve(entry.name)].emplace_back(std::move(entry));
+					}
+				}
+			}
+
+			this->listeners_ = std::move(listeners);
+
+			std::fill(this->bits_.begin(), this->bits_.end(), 0);
+			for (const auto& [id, entries] : this->listeners_)
+			{
+				this->set_bit(id, true);
+			}
+		}
+
+		bool has_listeners(const unsigned int id) const
+		{
+			const auto index = id / 64;
+			return index < this->bits_.size() && (this->bits_[index] & (1ull << (id % 64)));
+		}
+
+		// capture writes at most capacity values and returns how many were available
+		template <typename Capture>
+		void dispatch(const unsigned int entity_id, const unsigned int id, Capture&& capture)
+		{
+			if (!this->has_listeners(id))
+			{
+				return;
+			}
+
+			std::array<Value, MaxArguments> arguments;
+			const size_t count = capture(arguments.data(), arguments.size());
+
+			event notify{};
+			notify.entity_id = entity_id;
+			notify.name = id;
+			notify.arguments = std::span<const Value>(arguments.data(), std::min(count, arguments.size()));
+			notify.truncated = count > arguments.size();
+
+			++this->dispatch_depth_;
+
+			// listeners added while dispatching only see the next notify
+			const auto itr = this->listeners_.find(id);
+			const auto size = itr != this->listeners_.end() ? itr->second.size() : 0;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				// the list can grow or the listener can remove itself while it runs
+				const auto callback = this->listeners_[id][i].callback;
+				if (callback)
+				{
+					(*callback)(notify);
+				}
+			}
+
+			--this->dispatch_depth_;
+			this->compact();
+		}
+
+	private:
+		struct entry
+		{
+			uint64_t handle;
+			std::string name;
+			std::shared_ptr<const listener> callback;
+		};
+
+		uint64_t last_handle_ = 0;
+		size_t dispatch_depth_ = 0;
+		bool needs_compaction_ = false;
+
+		std::unordered_map<unsigned int, std::vector<entry>> listeners_;
+		std::vector<uint64_t> bits_;
+
+		void set_bit(const unsigned int id, const bool value)
+		{
+			const auto index = id / 64;
+			if (index >= this->bits_.size())
+			{
+				this->bits_.resize(index + 1);
+			}
+
+			if (value)
+			{
+				this->bits_[index] |= 1ull << (id % 64);
+			}
+			else
+			{
+				this->bits_[index] &= ~(1ull << (id % 64));
+			}
+		}
+
+		void compact()
+		{
+			if (this->dispatch_depth_ || !this->needs_compaction_)
+			{
+				return;
+			}
+
+			this->needs_compaction_ = false;
+
+			for (auto itr = this->listeners_.begin(); itr != this->listeners_.end();)
+			{
+				std::erase_if(itr->second, [](const entry& entry)
+				{
+					return !entry.handle;
+				});
+
+				if (!itr->second.empty())
+				{
+					++itr;
+					continue;
+				}
+
+				this->set_bit(itr->first, false);
+				itr = this->listeners_.erase(itr);
+			}
+		}
+	};
+}
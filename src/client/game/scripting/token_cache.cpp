@@ -0,0 +1,119 @@
+#include <std_include.hpp>
+#include "token_cache.hpp"
+
+namespace scripting
+{
+	uint32_t string_interner::intern(const std::string_view string)
+	{
+		if (const auto itr = this->indices_.find(string); itr != this->indices_.end())
+		{
+			return itr->second;
+		}
+
+		// the deque never moves its strings, the views in the index stay valid
+		const auto index = static_cast<uint32_t>(this->strings_.size());
+		const auto& stored = this->strings_.emplace_back(string);
+		this->indices_.emplace(stored, index);
+
+		return index;
+	}
+
+	uint32_t string_interner::find(const std::string_view string)
+	{
+		const auto itr = this->indices_.find(string);
+		if (itr == this->indices_.end())
+		{
+			++this->stats_.misses;
+			return invalid_index;
+		}
+
+		++this->stats_.hits;
+		return itr->second;
+	}
+
+	std::string_view string_interner::get(const uint32_t index) const
+	{
+		if (index >= this->strings_.size())
+		{
+			return {};
+		}
+
+		return this->strings_[index];
+	}
+
+	size_t string_interner::size() const
+	{
+		return this->strings_.size();
+	}
+
+	lookup_stats string_interner::get_stats() const
+	{
+		return this->stats_;
+	}
+
+	token_table::token_table(string_interner& strings)
+		: strings_(strings)
+	{
+	}
+
+	std::string_view token_table::set(const uint32_t id, const std::string_view name)
+	{
+		const auto index = this->strings_.intern(name);
+
+		if (id >= max_flat_id)
+		{
+			this->sparse_[id] = index;
+			return this->strings_.get(index);
+		}
+
+		if (id >= this->flat_.size())
+		{
+			// never past max_flat_id, find relies on larger ids being sparse
+			const auto size = std::min<size_t>(std::max<size_t>(id + 1, this->flat_.size() * 2), max_flat_id);
+			this->flat_.resize(size, string_interner::invalid_index);
+		}
+
+		this->flat_[id] = index;
+		return this->strings_.get(index);
+	}
+
+	std::optional<std::string_view> token_table::find(const uint32_t id)
+	{
+		auto index = string_interner::invalid_index;
+
+		if (id < max_flat_id)
+		{
+			if (id < this->flat_.size())
+			{
+				index = this->flat_[id];
+			}
+		}
+		else
+		{
+			if (const auto itr = this->sparse_.find(id); itr != this->sparse_.end())
+			{
+				index = itr->second;
+			}
+		}
+
+		if (index == string_interner::invalid_index)
+		{
+			++this->stats_.misses;
+			return {};
+		}
+
+		++this->stats_.hits;
+		return {this->strings_.get(index)};
+	}
+
+	void token_table::clear()
+	{
+		this->flat_.clear();
+		this->sparse_.clear();
+	}
+
+	lookup_stats token_table::get_stats() const
+	{
+		return this->stats_;
+	}
+}
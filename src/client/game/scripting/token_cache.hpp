@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace scripting
+{
+	struct lookup_stats
+	{
+		uint64_t hits;
+		uint64_t misses;
+	};
+
+	// Stores every string once and hands out small indices, nothing is ever removed
+	class string_interner final
+	{
+	public:
+		static constexpr uint32_t invalid_index = 0xFFFFFFFF;
+
+		uint32_t intern(std::string_view string);
+		uint32_t find(std::string_view string);
+		std::string_view get(uint32_t index) const;
+
+		size_t size() const;
+		lookup_stats get_stats() const;
+
+	private:
+		std::deque<std::string> strings_;
+		std::unordered_map<std::string_view, uint32_t> indices_;
+		lookup_stats stats_{};
+	};
+
+	// Canonical string ids to interned names, small ids live in a flat array
+	class token_table final
+	{
+	public:
+		explicit token_table(string_interner& strings);
+
+		// returns the interned copy of name
+		std::string_view set(uint32_t id, std::string_view name);
+		std::optional<std::string_view> find(uint32_t id);
+		void clear();
+
+		lookup_stats get_stats() const;
+
+	private:
+		static constexpr uint32_t max_flat_id = 0x40000;
+
+		string_interner& strings_;
+		std::vector<uint32_t> flat_;
+		std::unordered_map<uint32_t, uint32_t> sparse_;
+		lookup_stats stats_{};
+	};
+}
@@ -78,6 +78,8 @@
 #include <vector>
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <condition_variable>
 #include <regex>
 #include <chrono>
 #include <thread>
@@ -0,0 +1,51 @@
+#include <std_include.hpp>
+
+#include "delta_update.hpp"
+
+#include <utils/delta.hpp>
+#include <utils/http.hpp>
+#include <utils/io.hpp>
+#include <utils/io_native.hpp>
+
+namespace updater
+{
+	delta_result apply_delta(const std::string& file, const std::string& url, const size_t delta_size,
+		const std::function<bool(const std::string& patched_file)>& verify)
+	{
+		const auto data = utils::http::get_data(url);
+		if (!data || data->code != CURLE_OK || data->response_code != 200 || data->buffer.size() != delta_size)
+		{
+			return delta_result::download_failed;
+		}
+
+		const auto temp_file = file + ".delta";
+		auto applied = false;
+
+		{
+			const utils::io::mapped_file source(file);
+			const auto handle = utils::io::native::open_for_writing(temp_file);
+
+			if (source.is_open() && handle != utils::io::native::invalid_handle)
+			{
+				applied = utils::delta::apply(source.view(), data->buffer, [&](const std::string_view chunk)
+				{
+					return utils::io::native::write_all(handle, chunk.data(), chunk.size());
+				}) && utils::io::native::flush(handle);
+			}
+
+			if (handle != utils::io::native::invalid_handle)
+			{
+				utils::io::native::close(handle);
+			}
+		}
+
+		// the source mapping is gone, the original file can be replaced now
+		if (!applied || !verify(temp_file) || !utils::io::native::replace_file(temp_file, file))
+		{
+			utils::io::native::remove_file(temp_file);
+			return delta_result::apply_failed;
+		}
+
+		return delta_result::applied;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace updater
+{
+	enum class delta_result
+	{
+		applied,
+		download_failed,
+		apply_failed,
+	};
+
+	// Downloads the delta at url and applies it to file. verify checks the patched copy before it replaces file,
+	// file is left untouched unless the delta was applied.
+	delta_result apply_delta(const std::string& file, const std::string& url, size_t delta_size,
+		const std::function<bool(const std::string& patched_file)>& verify);
+}
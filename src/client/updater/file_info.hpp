@@ -4,11 +4,22 @@
 
 namespace updater
 {
+	// patches a local file with the given hash to the current version
+	struct file_delta
+	{
+		std::string from_hash;
+		std::size_t size;
+	};
+
 	struct file_info
 	{
 		std::string name;
 		std::size_t size;
 		std::string hash;
+		std::vector<file_delta> deltas;
+
+		// hash of the file on disk, only set for outdated files
+		std::string local_hash;
 	};
 
 	struct update_manifest
@@ -1,6 +1,7 @@
 #include <std_include.hpp>
 
 #include "updater.hpp"
+#include "delta_update.hpp"
 #include "file_updater.hpp"
 #include "component/console.hpp"
 
@@ -123,6 +124,18 @@ namespace updater
 					info.size = fileEntry[1].GetUint64();
 					info.hash = fileEntry[2].GetString();
 
+					// optional list of [from_hash, size] deltas
+					if (fileEntry.Size() > 3 && fileEntry[3].IsArray())
+					{
+						for (const auto& delta : fileEntry[3].GetArray())
+						{
+							if (delta.IsArray() && delta.Size() >= 2 && delta[0].IsString() && delta[1].IsUint64())
+							{
+								info.deltas.emplace_back(delta[0].GetString(), delta[1].GetUint64());
+							}
+						}
+					}
+
 					manifest.files.push_back(info);
 				}
 			}
@@ -187,6 +200,12 @@ namespace updater
 			return std::max(1ull, std::min(cores, file_count));
 		}
 
+		// mirrored by the manifest tool, deltas are stored next to the files they patch
+		std::string get_delta_name(const file_info& file, const file_delta& delta)
+		{
+			return "deltas/" + file.name + "." + delta.from_hash + "." + file.hash + ".delta";
+		}
+
 		bool is_inside_folder(const std::filesystem::path& file, const std::filesystem::path& folder)
 		{
 			const auto relative = std::filesystem::relative(file, folder);
@@ -263,6 +282,11 @@ namespace updater
 
 	void file_updater::update_file(const file_info& file) const
 	{
+		if (this->update_file_from_delta(file))
+		{
+			return;
+		}
+
 		const auto url = get_update_folder() + file.name + "?" + file.hash;
 		const auto out_file = this->get_drive_filename(file);
 
@@ -323,6 +347,43 @@ namespace updater
 
 	}
 
+	bool file_updater::update_file_from_delta(const file_info& file) const
+	{
+		const auto delta = std::find_if(file.deltas.begin(), file.deltas.end(), [&](const file_delta& entry)
+		{
+			return !file.local_hash.empty() && entry.from_hash == file.local_hash;
+		});
+
+		if (delta == file.deltas.end())
+		{
+			return false;
+		}
+
+		const auto url = get_update_folder() + get_delta_name(file, *delta) + "?" + file.hash;
+		const auto out_file = this->get_drive_filename(file);
+
+		console::info("Updating: %s (delta)", get_filename(file.name).data());
+
+		const auto result = apply_delta(out_file, url, delta->size, [&](const std::string& patched_file)
+		{
+			return utils::io::file_size(patched_file) == file.size && utils::hash::get_file_hash(patched_file) == file.hash;
+		});
+
+		if (result == delta_result::download_failed)
+		{
+			console::warn("Failed to download delta for %s, downloading the whole file", get_filename(file.name).data());
+			return false;
+		}
+
+		if (result == delta_result::apply_failed)
+		{
+			console::warn("Failed to apply delta for %s, downloading the whole file", get_filename(file.name).data());
+			return false;
+		}
+
+		return true;
+	}
+
 	void file_updater::update_host_file(const file_info& file) const
 	{
 		const auto url = get_update_folder_host() + file.name + "?" + file.hash;
@@ -387,10 +448,13 @@ namespace updater
 					try
 					{
 						const auto& info = files[index];
-						if (this->is_outdated_file(info))
+
+						std::string local_hash{};
+						if (this->is_outdated_file(info, &local_hash))
 						{
 							console::error("Verification failed: %s", get_filename(info.name).data());
-							local_outdated_files.emplace_back(info);
+							auto& outdated_file = local_outdated_files.emplace_back(info);
+							outdated_file.local_hash = std::move(local_hash);
 						}
 					}
 					catch (...)
@@ -447,9 +511,9 @@ namespace updater
 				continue;
 			}
 
-			std::string data{};
 			const auto drive_name = this->get_drive_filename(file);
-			if (!utils::io::read_file(drive_name, &data))
+			const utils::io::mapped_file data(drive_name);
+			if (!data.is_open())
 			{
 				return &file;
 			}
@@ -459,7 +523,7 @@ namespace updater
 				return &file;
 			}
 
-			if (get_hash(data) != file.hash)
+			if (utils::cryptography::sha1::compute(data.data(), data.size(), true) != file.hash)
 			{
 				return &file;
 			}
@@ -597,7 +661,7 @@ namespace updater
 		console::info("Finished downloading/updating files");
 	}
 
-	bool file_updater::is_outdated_file(const file_info& file) const
+	bool file_updater::is_outdated_file(const file_info& file, std::string* local_hash) const
 	{
 		console::info("Verifying: %s\n", get_filename(file.name).data());
 		const auto drive_name = this->get_drive_filename(file);
@@ -606,13 +670,15 @@ namespace updater
 			return true;
 		}
 
-		if (utils::io::file_size(drive_name) != file.size)
+		const auto size_matches = utils::io::file_size(drive_name) == file.size;
+		if (!size_matches && file.deltas.empty())
 		{
 			return true;
 		}
 
-		const auto hash = utils::hash::get_file_hash(drive_name);
-		return hash != file.hash;
+		// deltas are picked by the hash of the local file, it's needed even if the size already differs
+		*local_hash = utils::hash::get_file_hash(drive_name);
+		return !size_matches || *local_hash != file.hash;
 	}
 
 	std::string file_updater::get_drive_filename(const file_info& file) const
@@ -25,13 +25,14 @@ namespace updater
 		std::filesystem::path dead_process_file_;
 
 		void update_file(const file_info& file) const;
+		bool update_file_from_delta(const file_info& file) const;
 		void update_host_file(const file_info& file) const;
 
 		std::size_t get_update_size(const std::vector<file_info>& files) const;
 		std::size_t get_available_drive_space() const;
 
 		
-		[[nodiscard]] bool is_outdated_file(const file_info& file) const;
+		[[nodiscard]] bool is_outdated_file(const file_info& file, std::string* local_hash) const;
 		[[nodiscard]] std::string get_drive_filename(const file_info& file) const;
 		[[nodiscard]] std::string get_manifest_file_path() const;
 
@@ -0,0 +1,97 @@
+#include <std_include.hpp>
+
+#include "display_name.hpp"
+
+namespace display_name
+{
+	namespace
+	{
+		bool update_field(std::string& cached, const std::string_view field)
+		{
+			if (cached == field)
+			{
+				return false;
+			}
+
+			cached.assign(field);
+			return true;
+		}
+	}
+
+	std::string build(const fields& fields, const tag_icons& icons)
+	{
+		auto tag = fields.clan_abbrev;
+		auto style = 1;
+
+		if (tag.empty() || fields.use_elite_clan_tag)
+		{
+			tag = fields.elite_clan_tag_text;
+			style = fields.use_elite_clan_tag;
+
+			if (tag.empty())
+			{
+				return std::string(fields.name);
+			}
+		}
+
+		switch (style)
+		{
+		case 1:
+		{
+			if (const auto icon = icons.find(std::string(tag)); icon != icons.end())
+			{
+				tag = icon->second;
+			}
+
+			return std::string("[").append(tag).append("]").append(fields.name);
+		}
+		case 2:
+			return std::string("[^3").append(tag).append("^7]").append(fields.name);
+		case 3:
+			return std::string("[^1").append(tag).append("^7]").append(fields.name);
+		default:
+			return std::string(fields.name);
+		}
+	}
+
+	cache::cache(const size_t client_count)
+		: entries_(client_count)
+	{
+	}
+
+	const std::string& cache::get(const size_t client_num, const fields& fields, const tag_icons& icons)
+	{
+		auto& cached = this->entries_.at(client_num);
+		++this->stats_.lookups;
+
+		auto changed = !cached.valid;
+		changed |= update_field(cached.name, fields.name);
+		changed |= update_field(cached.clan_abbrev, fields.clan_abbrev);
+		changed |= update_field(cached.elite_clan_tag_text, fields.elite_clan_tag_text);
+
+		if (cached.use_elite_clan_tag != fields.use_elite_clan_tag)
+		{
+			cached.use_elite_clan_tag = fields.use_elite_clan_tag;
+			changed = true;
+		}
+
+		if (changed)
+		{
+			cached.value = build(fields, icons);
+			cached.valid = true;
+			++this->stats_.builds;
+		}
+
+		return cached.value;
+	}
+
+	cache_stats cache::get_stats() const
+	{
+		return this->stats_;
+	}
+
+	void cache::reset_stats()
+	{
+		this->stats_ = {};
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+namespace display_name
+{
+	// the clientInfo_t fields a display name is built from
+	struct fields
+	{
+		std::string_view name;
+		std::string_view clan_abbrev;
+		std::string_view elite_clan_tag_text;
+		unsigned char use_elite_clan_tag;
+	};
+
+	// tag -> formatted icon name
+	using tag_icons = std::unordered_map<std::string, std::string>;
+
+	// same layout the game builds, with the icons of our custom tags swapped in
+	std::string build(const fields& fields, const tag_icons& icons);
+
+	struct cache_stats
+	{
+		uint64_t lookups;
+		uint64_t builds;
+	};
+
+	// One display name per client, it's only rebuilt once one of its fields differs from the previous lookup
+	class cache final
+	{
+	public:
+		explicit cache(size_t client_count);
+
+		const std::string& get(size_t client_num, const fields& fields, const tag_icons& icons);
+
+		cache_stats get_stats() const;
+		void reset_stats();
+
+	private:
+		struct entry
+		{
+			std::string name;
+			std::string clan_abbrev;
+			std::string elite_clan_tag_text;
+			unsigned char use_elite_clan_tag;
+
+			bool valid;
+			std::string value;
+		};
+
+		std::vector<entry> entries_;
+		cache_stats stats_{};
+	};
+}
@@ -0,0 +1,34 @@
+#include <std_include.hpp>
+
+#include "gamertags.hpp"
+
+namespace gamertags
+{
+	void index::clear()
+	{
+		this->allowed_tags_.clear();
+	}
+
+	void index::add(const std::string_view tag, const std::string_view discord_id)
+	{
+		this->allowed_tags_[std::string(discord_id)].emplace(tag);
+	}
+
+	bool index::is_allowed(const std::string& tag, const std::string& discord_id) const
+	{
+		const auto itr = this->allowed_tags_.find(discord_id);
+		if (itr == this->allowed_tags_.end())
+		{
+			return false;
+		}
+
+		// HMW members may use every tag, H2M members every tag but HMW
+		const auto& allowed = itr->second;
+		return allowed.contains("HMW") || (allowed.contains("H2M") && tag != "HMW") || allowed.contains(tag);
+	}
+
+	size_t index::size() const
+	{
+		return this->allowed_tags_.size();
+	}
+}
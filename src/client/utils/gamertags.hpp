@@ -0,0 +1,22 @@
+#pragma once
+
+namespace gamertags
+{
+	// The rows of mp/activisiongamertags_pc.csv (tag, discord id) grouped by discord id,
+	// so authorizing a tag doesn't have to walk the whole table
+	class index final
+	{
+	public:
+		void clear();
+		void add(std::string_view tag, std::string_view discord_id);
+
+		// tag has to be upper case
+		bool is_allowed(const std::string& tag, const std::string& discord_id) const;
+
+		size_t size() const;
+
+	private:
+		// discord id -> tags the id is allowed to use
+		std::unordered_map<std::string, std::unordered_set<std::string>> allowed_tags_;
+	};
+}
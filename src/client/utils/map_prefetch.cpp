@@ -0,0 +1,123 @@
+#include <std_include.hpp>
+
+#include "map_prefetch.hpp"
+
+#include <utils/io_native.hpp>
+
+namespace map_prefetch
+{
+	prefetcher::prefetcher(hash_function hash)
+		: hash_(std::move(hash))
+	{
+	}
+
+	prefetcher::~prefetcher()
+	{
+		this->wait();
+	}
+
+	bool prefetcher::prefetch(const std::string& mapname, std::vector<std::string> files)
+	{
+		if (this->running_ || mapname == this->mapname_)
+		{
+			return false;
+		}
+
+		this->wait();
+
+		this->mapname_ = mapname;
+		this->running_ = true;
+
+		this->thread_ = std::thread([this, files = std::move(files)]()
+		{
+			this->run(files);
+			this->running_ = false;
+		});
+
+		return true;
+	}
+
+	void prefetcher::forget_map()
+	{
+		this->mapname_.clear();
+	}
+
+	void prefetcher::wait()
+	{
+		if (this->thread_.joinable())
+		{
+			this->thread_.join();
+		}
+	}
+
+	std::optional<std::string> prefetcher::take_hash(const std::string& file)
+	{
+		std::optional<prefetched_hash> entry;
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			const auto iter = this->hashes_.find(file);
+			if (iter == this->hashes_.end())
+			{
+				return {};
+			}
+
+			entry = std::move(iter->second);
+			this->hashes_.erase(iter);
+		}
+
+		// the file was replaced after it got prefetched
+		const auto attributes = utils::io::native::get_attributes(file);
+		if (!attributes.exists || attributes.size != entry->size || attributes.modified_time != entry->modified_time)
+		{
+			return {};
+		}
+
+		this->saved_seconds_ += entry->seconds;
+		return {std::move(entry->hash)};
+	}
+
+	double prefetcher::take_saved_seconds()
+	{
+		return std::exchange(this->saved_seconds_, 0.0);
+	}
+
+	void prefetcher::run(const std::vector<std::string>& files)
+	{
+		std::unordered_map<std::string, prefetched_hash> hashes;
+
+		for (const auto& file : files)
+		{
+			const auto attributes = utils::io::native::get_attributes(file);
+			if (!attributes.exists || attributes.is_directory)
+			{
+				continue;
+			}
+
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			// hashing reads every other file completely, which pulls it into the page cache anyway
+			if (file.ends_with(".pak"))
+			{
+				const auto handle = utils::io::native::open_for_reading(file, true);
+				if (handle != utils::io::native::invalid_handle)
+				{
+					utils::io::native::prefetch(handle, 0, std::min(attributes.size, pak_prefetch_size));
+					utils::io::native::close(handle);
+				}
+			}
+
+			auto hash = this->hash_(file);
+			if (hash.empty())
+			{
+				continue;
+			}
+
+			const std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+			hashes[file] = {attributes.size, attributes.modified_time, std::move(hash), duration.count()};
+		}
+
+		std::lock_guard<std::mutex> _(this->mutex_);
+		this->hashes_ = std::move(hashes);
+	}
+}
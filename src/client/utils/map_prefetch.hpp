@@ -0,0 +1,56 @@
+#pragma once
+
+namespace map_prefetch
+{
+	// Hashes the files of the upcoming map on a background thread while the current one is still being played,
+	// which also pulls them into the OS page cache before the switch.
+	// A prefetched hash is handed out once, and only while the file's size and modification time are unchanged
+	class prefetcher final
+	{
+	public:
+		using hash_function = std::function<std::string(const std::string& file)>;
+
+		// pak files can be huge and are streamed later on, only their start is worth warming up
+		static constexpr size_t pak_prefetch_size = 64ull * 1024ull * 1024ull;
+
+		explicit prefetcher(hash_function hash);
+		~prefetcher();
+
+		prefetcher(prefetcher&&) = delete;
+		prefetcher(const prefetcher&) = delete;
+		prefetcher& operator=(prefetcher&&) = delete;
+		prefetcher& operator=(const prefetcher&) = delete;
+
+		// does nothing while a prefetch is running or if the map is the one prefetched last
+		bool prefetch(const std::string& mapname, std::vector<std::string> files);
+		// the prefetched map is being loaded, the next prefetch may pick the same name again
+		void forget_map();
+		void wait();
+
+		std::optional<std::string> take_hash(const std::string& file);
+		// hashing time spared by take_hash since the last call
+		double take_saved_seconds();
+
+	private:
+		struct prefetched_hash
+		{
+			size_t size;
+			uint64_t modified_time;
+			std::string hash;
+			double seconds;
+		};
+
+		hash_function hash_;
+
+		std::thread thread_;
+		std::atomic_bool running_{false};
+		std::string mapname_;
+
+		// only the upcoming map is kept, replaced as a whole once its files are hashed
+		std::mutex mutex_;
+		std::unordered_map<std::string, prefetched_hash> hashes_;
+		double saved_seconds_ = 0.0;
+
+		void run(const std::vector<std::string>& files);
+	};
+}
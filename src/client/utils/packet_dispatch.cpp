@@ -0,0 +1,177 @@
+#include <std_include.hpp>
+
+#include "packet_dispatch.hpp"
+
+namespace packet_dispatch
+{
+	namespace
+	{
+		// addresses that haven't sent anything for this long are forgotten
+		constexpr auto rate_limit_expiry = 10s;
+		constexpr auto max_rate_limit_entries = 4096u;
+		// a flood of new addresses would otherwise walk every bucket for each packet
+		constexpr auto rate_limit_sweep_interval = 1s;
+
+		char to_lower_ascii(const char c)
+		{
+			return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+		}
+
+		uint32_t hash_command(const std::string_view command, const uint32_t seed)
+		{
+			auto hash = 0x811C9DC5u ^ seed;
+			for (const auto c : command)
+			{
+				hash ^= static_cast<uint8_t>(to_lower_ascii(c));
+				hash *= 0x01000193u;
+			}
+
+			return hash ^ (hash >> 15);
+		}
+
+		bool are_commands_equal(const std::string_view command, const std::string_view lowercase_name)
+		{
+			if (command.size() != lowercase_name.size())
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < command.size(); ++i)
+			{
+				if (to_lower_ascii(command[i]) != lowercase_name[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	size_t command_table::add(const std::string_view command)
+	{
+		std::string name(command);
+		std::transform(name.begin(), name.end(), name.begin(), to_lower_ascii);
+
+		for (size_t i = 0; i < this->names_.size(); ++i)
+		{
+			if (this->names_[i] == name)
+			{
+				return i;
+			}
+		}
+
+		this->names_.emplace_back(std::move(name));
+		this->rebuild_slots();
+
+		return this->names_.size() - 1;
+	}
+
+	std::optional<size_t> command_table::find(const std::string_view command) const
+	{
+		if (this->slots_.empty())
+		{
+			return {};
+		}
+
+		const auto index = this->slots_[hash_command(command, this->seed_) & this->mask_];
+		if (index == -1 || !are_commands_equal(command, this->names_[index]))
+		{
+			return {};
+		}
+
+		return {static_cast<size_t>(index)};
+	}
+
+	const std::string& command_table::get_name(const size_t index) const
+	{
+		return this->names_.at(index);
+	}
+
+	size_t command_table::size() const
+	{
+		return this->names_.size();
+	}
+
+	bool command_table::try_build_slots(const size_t size, const uint32_t seed)
+	{
+		this->slots_.assign(size, -1);
+		this->mask_ = static_cast<uint32_t>(size - 1);
+		this->seed_ = seed;
+
+		for (size_t i = 0; i < this->names_.size(); ++i)
+		{
+			auto& slot = this->slots_[hash_command(this->names_[i], seed) & this->mask_];
+			if (slot != -1)
+			{
+				return false;
+			}
+
+			slot = static_cast<int>(i);
+		}
+
+		return true;
+	}
+
+	void command_table::rebuild_slots()
+	{
+		size_t size = 4;
+		while (size < this->names_.size() * 2)
+		{
+			size <<= 1;
+		}
+
+		for (;; size <<= 1)
+		{
+			for (uint32_t seed = 0; seed < 0x1000; ++seed)
+			{
+				if (this->try_build_slots(size, seed))
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	bool rate_limiter::is_limited(const uint32_t ip, const size_t command, const rate_limit& limit, const clock::time_point now)
+	{
+		if (limit.burst <= 0 || limit.refill_interval.count() <= 0)
+		{
+			return false;
+		}
+
+		const auto key = (static_cast<uint64_t>(ip) << 32) | static_cast<uint32_t>(command);
+
+		auto [itr, inserted] = this->buckets_.try_emplace(key, token_bucket{limit.burst, now});
+		auto& bucket = itr->second;
+
+		const auto refills = (now - bucket.last_refill) / limit.refill_interval;
+		if (refills > 0)
+		{
+			bucket.tokens = static_cast<int>(std::min<int64_t>(limit.burst, bucket.tokens + refills));
+			bucket.last_refill += refills * limit.refill_interval;
+		}
+
+		if (inserted && this->buckets_.size() > max_rate_limit_entries && now - this->last_sweep_ >= rate_limit_sweep_interval)
+		{
+			this->last_sweep_ = now;
+			std::erase_if(this->buckets_, [&](const auto& entry)
+			{
+				return now - entry.second.last_refill > rate_limit_expiry;
+			});
+		}
+
+		if (bucket.tokens <= 0)
+		{
+			return true;
+		}
+
+		--bucket.tokens;
+		return false;
+	}
+
+	size_t rate_limiter::size() const
+	{
+		return this->buckets_.size();
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+namespace packet_dispatch
+{
+	// packets above the limit are dropped per source ip, a burst of 0 disables the limit
+	struct rate_limit
+	{
+		int burst = 0;
+		std::chrono::milliseconds refill_interval{};
+	};
+
+	// Case insensitive command names, looked up through a perfect hash that is rebuilt whenever a command is added,
+	// so a lookup takes one hash over the name and a single comparison.
+	// Commands are referred to by index, an index stays valid for the lifetime of the table
+	class command_table final
+	{
+	public:
+		// returns the index of the existing command if it was added before
+		size_t add(std::string_view command);
+		std::optional<size_t> find(std::string_view command) const;
+
+		const std::string& get_name(size_t index) const;
+		size_t size() const;
+
+	private:
+		std::vector<std::string> names_;
+		std::vector<int> slots_;
+		uint32_t seed_ = 0;
+		uint32_t mask_ = 0;
+
+		bool try_build_slots(size_t size, uint32_t seed);
+		void rebuild_slots();
+	};
+
+	// One token bucket per source ip and command, addresses that stay quiet are forgotten once there are too many,
+	// at most once per second
+	class rate_limiter final
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		bool is_limited(uint32_t ip, size_t command, const rate_limit& limit, clock::time_point now = clock::now());
+		size_t size() const;
+
+	private:
+		struct token_bucket
+		{
+			int tokens;
+			clock::time_point last_refill;
+		};
+
+		std::unordered_map<uint64_t, token_bucket> buckets_;
+		clock::time_point last_sweep_{};
+	};
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <optional>
 
 namespace utils::concurrency
 {
@@ -43,4 +46,89 @@ namespace utils::concurrency
 		mutable MutexType mutex_{};
 		T object_{};
 	};
+
+	// Bounded queue for many producers and a single consumer, neither side takes a lock.
+	// Pushing into a full queue fails instead of blocking the producer.
+	template <typename T>
+	class mpsc_queue
+	{
+	public:
+		// rounded up to a power of two
+		explicit mpsc_queue(const size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+
+			this->mask_ = size - 1;
+			this->slots_ = std::make_unique<slot[]>(size);
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				this->slots_[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		bool try_push(T&& value)
+		{
+			auto position = this->write_position_.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				auto& slot = this->slots_[position & this->mask_];
+				const auto sequence = slot.sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if (difference == 0)
+				{
+					if (this->write_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						slot.value = std::move(value);
+						slot.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					// the consumer hasn't freed this slot yet
+					return false;
+				}
+				else
+				{
+					position = this->write_position_.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// consumer only
+		std::optional<T> try_pop()
+		{
+			auto& slot = this->slots_[this->read_position_ & this->mask_];
+			if (slot.sequence.load(std::memory_order_acquire) != this->read_position_ + 1)
+			{
+				return {};
+			}
+
+			std::optional<T> value{std::move(slot.value)};
+			slot.sequence.store(this->read_position_ + this->mask_ + 1, std::memory_order_release);
+			++this->read_position_;
+
+			return value;
+		}
+
+	private:
+		struct slot
+		{
+			std::atomic<size_t> sequence{};
+			T value{};
+		};
+
+		size_t mask_{};
+		std::unique_ptr<slot[]> slots_{};
+
+		alignas(64) std::atomic<size_t> write_position_{0};
+		alignas(64) size_t read_position_{0};
+	};
 }
@@ -1,7 +1,9 @@
 #include "string.hpp"
 #include "cryptography.hpp"
+#include "lru_cache.hpp"
 #include "nt.hpp"
 #include <gsl/gsl>
+#include <intrin.h>
 
 #undef max
 using namespace std::string_literals;
@@ -125,6 +127,424 @@ namespace utils::cryptography
 		};
 
 		const prng prng_(fortuna_desc);
+
+		struct cpu_features
+		{
+			bool aes;
+			bool sha;
+		};
+
+		constexpr auto aes_block_size = 16u;
+		constexpr auto aes_128_rounds = 10;
+
+		__m128i aes_128_expand(__m128i key, __m128i assist)
+		{
+			assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+			key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+			key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+			key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+			return _mm_xor_si128(key, assist);
+		}
+
+		void aes_128_expand_keys(const uint8_t* key, uint8_t* encrypt_keys, uint8_t* decrypt_keys)
+		{
+			__m128i keys[aes_128_rounds + 1];
+
+			keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+			keys[1] = aes_128_expand(keys[0], _mm_aeskeygenassist_si128(keys[0], 0x01));
+			keys[2] = aes_128_expand(keys[1], _mm_aeskeygenassist_si128(keys[1], 0x02));
+			keys[3] = aes_128_expand(keys[2], _mm_aeskeygenassist_si128(keys[2], 0x04));
+			keys[4] = aes_128_expand(keys[3], _mm_aeskeygenassist_si128(keys[3], 0x08));
+			keys[5] = aes_128_expand(keys[4], _mm_aeskeygenassist_si128(keys[4], 0x10));
+			keys[6] = aes_128_expand(keys[5], _mm_aeskeygenassist_si128(keys[5], 0x20));
+			keys[7] = aes_128_expand(keys[6], _mm_aeskeygenassist_si128(keys[6], 0x40));
+			keys[8] = aes_128_expand(keys[7], _mm_aeskeygenassist_si128(keys[7], 0x80));
+			keys[9] = aes_128_expand(keys[8], _mm_aeskeygenassist_si128(keys[8], 0x1B));
+			keys[10] = aes_128_expand(keys[9], _mm_aeskeygenassist_si128(keys[9], 0x36));
+
+			// the decryption schedule is the reversed encryption schedule run through InvMixColumns
+			for (auto i = 0; i <= aes_128_rounds; ++i)
+			{
+				auto decrypt_key = keys[aes_128_rounds - i];
+				if (i != 0 && i != aes_128_rounds)
+				{
+					decrypt_key = _mm_aesimc_si128(decrypt_key);
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(encrypt_keys + i * aes_block_size), keys[i]);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(decrypt_keys + i * aes_block_size), decrypt_key);
+			}
+		}
+
+		void aes_128_cbc_encrypt(const uint8_t* round_keys, const uint8_t* iv, const uint8_t* in, uint8_t* out, const size_t length)
+		{
+			__m128i keys[aes_128_rounds + 1];
+			for (auto i = 0; i <= aes_128_rounds; ++i)
+			{
+				keys[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(round_keys + i * aes_block_size));
+			}
+
+			auto feedback = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+
+			for (size_t offset = 0; offset < length; offset += aes_block_size)
+			{
+				auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+				block = _mm_xor_si128(_mm_xor_si128(block, feedback), keys[0]);
+
+				for (auto round = 1; round < aes_128_rounds; ++round)
+				{
+					block = _mm_aesenc_si128(block, keys[round]);
+				}
+
+				feedback = _mm_aesenclast_si128(block, keys[aes_128_rounds]);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), feedback);
+			}
+		}
+
+		void aes_128_cbc_decrypt(const uint8_t* round_keys, const uint8_t* iv, const uint8_t* in, uint8_t* out, const size_t length)
+		{
+			__m128i keys[aes_128_rounds + 1];
+			for (auto i = 0; i <= aes_128_rounds; ++i)
+			{
+				keys[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(round_keys + i * aes_block_size));
+			}
+
+			auto feedback = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+			size_t offset = 0;
+
+			// blocks don't depend on each other when decrypting, interleave four to keep the pipeline busy
+			for (; offset + 4 * aes_block_size <= length; offset += 4 * aes_block_size)
+			{
+				__m128i cipher_blocks[4];
+				__m128i blocks[4];
+
+				for (auto i = 0; i < 4; ++i)
+				{
+					cipher_blocks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset + i * aes_block_size));
+					blocks[i] = _mm_xor_si128(cipher_blocks[i], keys[0]);
+				}
+
+				for (auto round = 1; round < aes_128_rounds; ++round)
+				{
+					for (auto& block : blocks)
+					{
+						block = _mm_aesdec_si128(block, keys[round]);
+					}
+				}
+
+				for (auto i = 0; i < 4; ++i)
+				{
+					blocks[i] = _mm_aesdeclast_si128(blocks[i], keys[aes_128_rounds]);
+					blocks[i] = _mm_xor_si128(blocks[i], i == 0 ? feedback : cipher_blocks[i - 1]);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset + i * aes_block_size), blocks[i]);
+				}
+
+				feedback = cipher_blocks[3];
+			}
+
+			for (; offset < length; offset += aes_block_size)
+			{
+				const auto cipher_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+				auto block = _mm_xor_si128(cipher_block, keys[0]);
+
+				for (auto round = 1; round < aes_128_rounds; ++round)
+				{
+					block = _mm_aesdec_si128(block, keys[round]);
+				}
+
+				block = _mm_xor_si128(_mm_aesdeclast_si128(block, keys[aes_128_rounds]), feedback);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), block);
+
+				feedback = cipher_block;
+			}
+		}
+
+		constexpr auto sha1_block_size = 64u;
+		constexpr auto sha1_digest_size = 20u;
+		constexpr uint32_t sha1_initial_state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+		// four rounds of SHA-1 per group, the message schedule runs three groups ahead
+		template <int Group>
+		void sha1_rounds(__m128i& abcd, __m128i (&e)[2], __m128i (&msg)[4], const uint8_t* data, const __m128i mask)
+		{
+			constexpr auto current = Group & 1;
+			constexpr auto next = current ^ 1;
+
+			if constexpr (Group < 4)
+			{
+				msg[Group] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + Group * 16)), mask);
+			}
+
+			if constexpr (Group == 0)
+			{
+				e[current] = _mm_add_epi32(e[current], msg[0]);
+			}
+			else
+			{
+				e[current] = _mm_sha1nexte_epu32(e[current], msg[Group & 3]);
+			}
+
+			e[next] = abcd;
+
+			if constexpr (Group >= 3 && Group <= 18)
+			{
+				msg[(Group - 3) & 3] = _mm_sha1msg2_epu32(msg[(Group - 3) & 3], msg[Group & 3]);
+			}
+
+			abcd = _mm_sha1rnds4_epu32(abcd, e[current], Group / 5);
+
+			if constexpr (Group >= 1 && Group <= 16)
+			{
+				msg[(Group - 1) & 3] = _mm_sha1msg1_epu32(msg[(Group - 1) & 3], msg[Group & 3]);
+			}
+
+			if constexpr (Group >= 2 && Group <= 17)
+			{
+				msg[(Group - 2) & 3] = _mm_xor_si128(msg[(Group - 2) & 3], msg[Group & 3]);
+			}
+
+			if constexpr (Group < 19)
+			{
+				sha1_rounds<Group + 1>(abcd, e, msg, data, mask);
+			}
+		}
+
+		void sha1_compress(uint32_t* state, const uint8_t* data, const size_t length)
+		{
+			const auto mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+
+			auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+			auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+			for (size_t offset = 0; offset < length; offset += sha1_block_size)
+			{
+				const auto abcd_save = abcd;
+				const auto e0_save = e0;
+
+				__m128i e[2] = {e0, {}};
+				__m128i msg[4];
+				sha1_rounds<0>(abcd, e, msg, data + offset, mask);
+
+				e0 = _mm_sha1nexte_epu32(e[0], e0_save);
+				abcd = _mm_add_epi32(abcd, abcd_save);
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+			state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+		}
+
+		// prefix_length is the amount of bytes the state already absorbed
+		void sha1_finish(uint32_t* state, const uint64_t prefix_length, const uint8_t* data, const size_t length, uint8_t* digest)
+		{
+			const auto full_length = length & ~static_cast<size_t>(sha1_block_size - 1);
+			sha1_compress(state, data, full_length);
+
+			uint8_t tail[sha1_block_size * 2]{};
+			const auto rest = length - full_length;
+			std::memcpy(tail, data + full_length, rest);
+			tail[rest] = 0x80;
+
+			const auto tail_length = rest + 9 > sha1_block_size ? sha1_block_size * 2 : sha1_block_size;
+			const auto bit_length = (prefix_length + length) * 8;
+			for (auto i = 0u; i < 8; ++i)
+			{
+				tail[tail_length - 1 - i] = static_cast<uint8_t>(bit_length >> (i * 8));
+			}
+
+			sha1_compress(state, tail, tail_length);
+
+			for (auto i = 0u; i < 5; ++i)
+			{
+				digest[i * 4 + 0] = static_cast<uint8_t>(state[i] >> 24);
+				digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+				digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+				digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+			}
+		}
+
+		// known answer tests from FIPS-197, SP 800-38A and FIPS-180, a mismatch keeps the libtomcrypt implementation in use
+		bool test_aes_hardware()
+		{
+			struct known_answer
+			{
+				uint8_t key[16];
+				uint8_t iv[16];
+				uint8_t plain[64];
+				uint8_t cipher[64];
+				size_t length;
+			};
+
+			// the four block vector runs through the interleaved decryption
+			static constexpr known_answer tests[] =
+			{
+				{
+					{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F},
+					{},
+					{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF},
+					{0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A},
+					16,
+				},
+				{
+					{0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C},
+					{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F},
+					{
+						0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+						0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+						0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+						0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10,
+					},
+					{
+						0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46, 0xCE, 0xE9, 0x8E, 0x9B, 0x12, 0xE9, 0x19, 0x7D,
+						0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE, 0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2,
+						0x73, 0xBE, 0xD6, 0xB8, 0xE3, 0xC1, 0x74, 0x3B, 0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+						0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09, 0x12, 0x0E, 0xCA, 0x30, 0x75, 0x86, 0xE1, 0xA7,
+					},
+					64,
+				},
+			};
+
+			for (const auto& test : tests)
+			{
+				alignas(16) uint8_t encrypt_keys[11 * 16];
+				alignas(16) uint8_t decrypt_keys[11 * 16];
+				aes_128_expand_keys(test.key, encrypt_keys, decrypt_keys);
+
+				uint8_t encrypted[64];
+				uint8_t decrypted[64];
+				aes_128_cbc_encrypt(encrypt_keys, test.iv, test.plain, encrypted, test.length);
+				aes_128_cbc_decrypt(decrypt_keys, test.iv, test.cipher, decrypted, test.length);
+
+				if (std::memcmp(encrypted, test.cipher, test.length) || std::memcmp(decrypted, test.plain, test.length))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool test_sha_hardware()
+		{
+			constexpr uint8_t expected[20] = {0xA9, 0x99, 0x3E, 0x36, 0x47, 0x06, 0x81, 0x6A, 0xBA, 0x3E,
+				0x25, 0x71, 0x78, 0x50, 0xC2, 0x6C, 0x9C, 0xD0, 0xD8, 0x9D};
+
+			uint32_t state[5];
+			std::memcpy(state, sha1_initial_state, sizeof(state));
+
+			uint8_t digest[20];
+			sha1_finish(state, 0, reinterpret_cast<const uint8_t*>("abc"), 3, digest);
+
+			return !std::memcmp(digest, expected, sizeof(expected));
+		}
+
+		const cpu_features& get_cpu_features()
+		{
+			static const auto features = []()
+			{
+				cpu_features result{};
+
+				int regs[4]{};
+				__cpuid(regs, 0);
+				const auto max_leaf = regs[0];
+
+				__cpuid(regs, 1);
+				const auto ssse3 = (regs[2] & (1 << 9)) != 0;
+				const auto sse41 = (regs[2] & (1 << 19)) != 0;
+				result.aes = sse41 && (regs[2] & (1 << 25)) != 0;
+
+				if (max_leaf >= 7)
+				{
+					__cpuidex(regs, 7, 0);
+					result.sha = ssse3 && sse41 && (regs[1] & (1 << 29)) != 0;
+				}
+
+				result.aes = result.aes && test_aes_hardware();
+				result.sha = result.sha && test_sha_hardware();
+
+				return result;
+			}();
+
+			return features;
+		}
+
+		template <typename T>
+		const T& get_cached_context(const std::string& key)
+		{
+			// dw alternates between its encryption and decryption keys, keep a few around
+			thread_local lru_cache<std::string, std::unique_ptr<T>> contexts(4);
+
+			if (auto* context = contexts.find(key))
+			{
+				return **context;
+			}
+
+			return *contexts.put(key, std::make_unique<T>(key));
+		}
+
+		// in and out may be the same buffer
+		bool cbc_encrypt(const int cipher, symmetric_key* key, const uint8_t* in, uint8_t* out, const size_t length, const std::string& iv)
+		{
+			const auto block_size = static_cast<size_t>(cipher_descriptor[cipher].block_length);
+			if (length % block_size)
+			{
+				return false;
+			}
+
+			uint8_t feedback[MAXBLOCKSIZE]{};
+			std::memcpy(feedback, iv.data(), std::min(iv.size(), block_size));
+
+			for (size_t offset = 0; offset < length; offset += block_size)
+			{
+				for (size_t i = 0; i < block_size; ++i)
+				{
+					feedback[i] ^= in[offset + i];
+				}
+
+				cipher_descriptor[cipher].ecb_encrypt(feedback, feedback, key);
+				std::memcpy(out + offset, feedback, block_size);
+			}
+
+			return true;
+		}
+
+		std::string cbc_encrypt(const int cipher, symmetric_key* key, const std::string& data, const std::string& iv)
+		{
+			std::string enc_data;
+			enc_data.resize(data.size());
+
+			cbc_encrypt(cipher, key, cs(data.data()), cs(enc_data.data()), data.size(), iv);
+			return enc_data;
+		}
+
+		std::string cbc_decrypt(const int cipher, symmetric_key* key, const std::string& data, const std::string& iv)
+		{
+			std::string dec_data;
+			dec_data.resize(data.size());
+
+			const auto block_size = static_cast<size_t>(cipher_descriptor[cipher].block_length);
+			if (data.size() % block_size)
+			{
+				return dec_data;
+			}
+
+			uint8_t feedback[MAXBLOCKSIZE]{};
+			std::memcpy(feedback, iv.data(), std::min(iv.size(), block_size));
+
+			uint8_t block[MAXBLOCKSIZE]{};
+			for (size_t offset = 0; offset < data.size(); offset += block_size)
+			{
+				cipher_descriptor[cipher].ecb_decrypt(cs(&data[offset]), block, key);
+
+				for (size_t i = 0; i < block_size; ++i)
+				{
+					dec_data[offset + i] = static_cast<char>(block[i] ^ feedback[i]);
+				}
+
+				std::memcpy(feedback, &data[offset], block_size);
+			}
+
+			return dec_data;
+		}
 	}
 
 	ecc::key::key()
@@ -401,34 +821,56 @@ namespace utils::cryptography
 		return {};
 	}
 
-	std::string des3::encrypt(const std::string& data, const std::string& iv, const std::string& key)
+	des3::context::context(const std::string& key)
 	{
-		std::string enc_data;
-		enc_data.resize(data.size());
+		const auto cipher = find_cipher("3des");
+		if (cipher != -1 && cipher_descriptor[cipher].setup(cs(key.data()), static_cast<int>(key.size()), 0, &this->key_) == CRYPT_OK)
+		{
+			this->cipher_ = cipher;
+		}
+	}
+
+	des3::context::~context()
+	{
+		if (this->is_valid())
+		{
+			cipher_descriptor[this->cipher_].done(&this->key_);
+		}
+	}
 
-		symmetric_CBC cbc;
-		const auto des3 = find_cipher("3des");
+	bool des3::context::is_valid() const
+	{
+		return this->cipher_ != -1;
+	}
 
-		cbc_start(des3, cs(iv.data()), cs(key.data()), static_cast<int>(key.size()), 0, &cbc);
-		cbc_encrypt(cs(data.data()), cs(enc_data.data()), ul(data.size()), &cbc);
-		cbc_done(&cbc);
+	std::string des3::context::encrypt(const std::string& data, const std::string& iv) const
+	{
+		if (!this->is_valid())
+		{
+			return std::string(data.size(), '\0');
+		}
 
-		return enc_data;
+		return cbc_encrypt(this->cipher_, &this->key_, data, iv);
 	}
 
-	std::string des3::decrypt(const std::string& data, const std::string& iv, const std::string& key)
+	std::string des3::context::decrypt(const std::string& data, const std::string& iv) const
 	{
-		std::string dec_data;
-		dec_data.resize(data.size());
+		if (!this->is_valid())
+		{
+			return std::string(data.size(), '\0');
+		}
 
-		symmetric_CBC cbc;
-		const auto des3 = find_cipher("3des");
+		return cbc_decrypt(this->cipher_, &this->key_, data, iv);
+	}
 
-		cbc_start(des3, cs(iv.data()), cs(key.data()), static_cast<int>(key.size()), 0, &cbc);
-		cbc_decrypt(cs(data.data()), cs(dec_data.data()), ul(data.size()), &cbc);
-		cbc_done(&cbc);
+	std::string des3::encrypt(const std::string& data, const std::string& iv, const std::string& key)
+	{
+		return get_cached_context<context>(key).encrypt(data, iv);
+	}
 
-		return dec_data;
+	std::string des3::decrypt(const std::string& data, const std::string& iv, const std::string& key)
+	{
+		return get_cached_context<context>(key).decrypt(data, iv);
 	}
 
 	std::string tiger::compute(const std::string& data, const bool hex)
@@ -451,58 +893,214 @@ namespace utils::cryptography
 		return string::dump_hex(hash, "");
 	}
 
-	std::string aes::encrypt(const std::string& data, const std::string& iv, const std::string& key)
+	aes::context::context(const std::string& key)
+	{
+		const auto cipher = find_cipher("aes");
+		if (cipher != -1 && cipher_descriptor[cipher].setup(cs(key.data()), static_cast<int>(key.size()), 0, &this->key_) == CRYPT_OK)
+		{
+			this->cipher_ = cipher;
+		}
+
+		if (this->is_valid() && key.size() == 16 && get_cpu_features().aes)
+		{
+			aes_128_expand_keys(cs(key.data()), this->encrypt_keys_, this->decrypt_keys_);
+			this->hardware_ = true;
+		}
+	}
+
+	aes::context::~context()
+	{
+		if (this->is_valid())
+		{
+			cipher_descriptor[this->cipher_].done(&this->key_);
+		}
+	}
+
+	bool aes::context::is_valid() const
+	{
+		return this->cipher_ != -1;
+	}
+
+	std::string aes::context::encrypt(const std::string& data, const std::string& iv) const
 	{
+		if (!this->is_valid())
+		{
+			return std::string(data.size(), '\0');
+		}
+
+		if (!this->hardware_)
+		{
+			return cbc_encrypt(this->cipher_, &this->key_, data, iv);
+		}
+
 		std::string enc_data;
 		enc_data.resize(data.size());
 
-		symmetric_CBC cbc;
-		const auto aes = find_cipher("aes");
+		if (data.size() % aes_block_size)
+		{
+			return enc_data;
+		}
 
-		cbc_start(aes, cs(iv.data()), cs(key.data()),
-		          static_cast<int>(key.size()), 0, &cbc);
-		cbc_encrypt(cs(data.data()),
-		            cs(enc_data.data()),
-		            ul(data.size()), &cbc);
-		cbc_done(&cbc);
+		uint8_t feedback[aes_block_size]{};
+		std::memcpy(feedback, iv.data(), std::min(iv.size(), sizeof(feedback)));
 
+		aes_128_cbc_encrypt(this->encrypt_keys_, feedback, cs(data.data()), cs(enc_data.data()), data.size());
 		return enc_data;
 	}
 
-	std::string aes::decrypt(const std::string& data, const std::string& iv, const std::string& key)
+	bool aes::context::encrypt(uint8_t* data, const size_t length, const std::string& iv) const
+	{
+		if (!this->is_valid())
+		{
+			return false;
+		}
+
+		if (!this->hardware_)
+		{
+			return cbc_encrypt(this->cipher_, &this->key_, data, data, length, iv);
+		}
+
+		if (length % aes_block_size)
+		{
+			return false;
+		}
+
+		uint8_t feedback[aes_block_size]{};
+		std::memcpy(feedback, iv.data(), std::min(iv.size(), sizeof(feedback)));
+
+		// every block is read before its ciphertext is stored
+		aes_128_cbc_encrypt(this->encrypt_keys_, feedback, data, data, length);
+		return true;
+	}
+
+	std::string aes::context::decrypt(const std::string& data, const std::string& iv) const
 	{
+		if (!this->is_valid())
+		{
+			return std::string(data.size(), '\0');
+		}
+
+		if (!this->hardware_)
+		{
+			return cbc_decrypt(this->cipher_, &this->key_, data, iv);
+		}
+
 		std::string dec_data;
 		dec_data.resize(data.size());
 
-		symmetric_CBC cbc;
-		const auto aes = find_cipher("aes");
+		if (data.size() % aes_block_size)
+		{
+			return dec_data;
+		}
 
-		cbc_start(aes, cs(iv.data()), cs(key.data()),
-		          static_cast<int>(key.size()), 0, &cbc);
-		cbc_decrypt(cs(data.data()),
-		            cs(dec_data.data()),
-		            ul(data.size()), &cbc);
-		cbc_done(&cbc);
+		uint8_t feedback[aes_block_size]{};
+		std::memcpy(feedback, iv.data(), std::min(iv.size(), sizeof(feedback)));
 
+		aes_128_cbc_decrypt(this->decrypt_keys_, feedback, cs(data.data()), cs(dec_data.data()), data.size());
 		return dec_data;
 	}
 
-	std::string hmac_sha1::compute(const std::string& data, const std::string& key)
+	std::string aes::encrypt(const std::string& data, const std::string& iv, const std::string& key)
+	{
+		return get_cached_context<context>(key).encrypt(data, iv);
+	}
+
+	std::string aes::decrypt(const std::string& data, const std::string& iv, const std::string& key)
+	{
+		return get_cached_context<context>(key).decrypt(data, iv);
+	}
+
+	bool aes::encrypt(uint8_t* data, const size_t length, const std::string& iv, const std::string& key)
+	{
+		return get_cached_context<context>(key).encrypt(data, length, iv);
+	}
+
+	hmac_sha1::context::context(const std::string& key)
+	{
+		uint8_t padded_key[sha1_block_size]{};
+
+		if (key.size() > sha1_block_size)
+		{
+			const auto hashed_key = sha1::compute(key);
+			std::memcpy(padded_key, hashed_key.data(), hashed_key.size());
+		}
+		else
+		{
+			std::memcpy(padded_key, key.data(), key.size());
+		}
+
+		uint8_t inner_pad[sha1_block_size];
+		uint8_t outer_pad[sha1_block_size];
+
+		for (auto i = 0u; i < sha1_block_size; ++i)
+		{
+			inner_pad[i] = padded_key[i] ^ 0x36;
+			outer_pad[i] = padded_key[i] ^ 0x5C;
+		}
+
+		sha1_init(&this->inner_);
+		sha1_process(&this->inner_, inner_pad, sizeof(inner_pad));
+
+		sha1_init(&this->outer_);
+		sha1_process(&this->outer_, outer_pad, sizeof(outer_pad));
+
+		if (get_cpu_features().sha)
+		{
+			std::memcpy(this->inner_state_, sha1_initial_state, sizeof(this->inner_state_));
+			std::memcpy(this->outer_state_, sha1_initial_state, sizeof(this->outer_state_));
+
+			sha1_compress(this->inner_state_, inner_pad, sizeof(inner_pad));
+			sha1_compress(this->outer_state_, outer_pad, sizeof(outer_pad));
+
+			this->hardware_ = true;
+		}
+	}
+
+	std::string hmac_sha1::context::compute(const std::string& data) const
 	{
+		return this->compute(cs(data.data()), data.size());
+	}
+
+	std::string hmac_sha1::context::compute(const uint8_t* data, const size_t length) const
+	{
+		uint8_t inner_digest[sha1_digest_size];
 		std::string buffer;
-		buffer.resize(20);
+		buffer.resize(sha1_digest_size);
+
+		if (this->hardware_)
+		{
+			uint32_t inner_state[5];
+			uint32_t outer_state[5];
+			std::memcpy(inner_state, this->inner_state_, sizeof(inner_state));
+			std::memcpy(outer_state, this->outer_state_, sizeof(outer_state));
 
-		hmac_state state;
-		hmac_init(&state, find_hash("sha1"), cs(key.data()), ul(key.size()));
-		hmac_process(&state, cs(data.data()), static_cast<int>(data.size()));
+			sha1_finish(inner_state, sha1_block_size, data, length, inner_digest);
+			sha1_finish(outer_state, sha1_block_size, inner_digest, sizeof(inner_digest), cs(buffer.data()));
 
-		auto out_len = ul(buffer.size());
-		hmac_done(&state, cs(buffer.data()), &out_len);
+			return buffer;
+		}
+
+		auto inner = this->inner_;
+		sha1_process(&inner, data, ul(length));
+		sha1_done(&inner, inner_digest);
+
+		auto outer = this->outer_;
+		sha1_process(&outer, inner_digest, sizeof(inner_digest));
+		sha1_done(&outer, cs(buffer.data()));
 
-		buffer.resize(out_len);
 		return buffer;
 	}
 
+	std::string hmac_sha1::compute(const std::string& data, const std::string& key)
+	{
+		return get_cached_context<context>(key).compute(data);
+	}
+
+	std::string hmac_sha1::compute(const uint8_t* data, const size_t length, const std::string& key)
+	{
+		return get_cached_context<context>(key).compute(data, length);
+	}
+
 	std::string sha1::compute(const std::string& data, const bool hex)
 	{
 		return compute(cs(data.data()), data.size(), hex);
@@ -512,10 +1110,40 @@ namespace utils::cryptography
 	{
 		uint8_t buffer[20] = {0};
 
-		hash_state state;
-		sha1_init(&state);
-		sha1_process(&state, data, ul(length));
-		sha1_done(&state, buffer);
+		if (get_cpu_features().sha)
+		{
+			uint32_t state[5];
+			std::memcpy(state, sha1_initial_state, sizeof(state));
+			sha1_finish(state, 0, data, length, buffer);
+		}
+		else
+		{
+			hash_state state;
+			sha1_init(&state);
+			sha1_process(&state, data, ul(length));
+			sha1_done(&state, buffer);
+		}
+
+		std::string hash(cs(buffer), sizeof(buffer));
+		if (!hex) return hash;
+
+		return string::dump_hex(hash, "");
+	}
+
+	sha256::context::context()
+	{
+		sha256_init(&this->state_);
+	}
+
+	void sha256::context::update(const uint8_t* data, const size_t length)
+	{
+		sha256_process(&this->state_, data, ul(length));
+	}
+
+	std::string sha256::context::finish(const bool hex)
+	{
+		uint8_t buffer[32] = {0};
+		sha256_done(&this->state_, buffer);
 
 		std::string hash(cs(buffer), sizeof(buffer));
 		if (!hex) return hash;
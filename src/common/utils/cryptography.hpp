@@ -57,6 +57,28 @@ namespace utils::cryptography
 
 	namespace des3
 	{
+		// keeps the key schedule around for repeated use of the same key
+		class context final
+		{
+		public:
+			explicit context(const std::string& key);
+			~context();
+
+			context(context&&) = delete;
+			context(const context&) = delete;
+			context& operator=(context&&) = delete;
+			context& operator=(const context&) = delete;
+
+			bool is_valid() const;
+
+			std::string encrypt(const std::string& data, const std::string& iv) const;
+			std::string decrypt(const std::string& data, const std::string& iv) const;
+
+		private:
+			int cipher_ = -1;
+			mutable symmetric_key key_{};
+		};
+
 		std::string encrypt(const std::string& data, const std::string& iv, const std::string& key);
 		std::string decrypt(const std::string& data, const std::string& iv, const std::string& key);
 	}
@@ -69,13 +91,62 @@ namespace utils::cryptography
 
 	namespace aes
 	{
+		// keeps the expanded key around for repeated use of the same key, AES-128 runs on AES-NI if available
+		class context final
+		{
+		public:
+			explicit context(const std::string& key);
+			~context();
+
+			context(context&&) = delete;
+			context(const context&) = delete;
+			context& operator=(context&&) = delete;
+			context& operator=(const context&) = delete;
+
+			bool is_valid() const;
+
+			std::string encrypt(const std::string& data, const std::string& iv) const;
+			std::string decrypt(const std::string& data, const std::string& iv) const;
+
+			// encrypts in place, the length has to be a multiple of the block size
+			bool encrypt(uint8_t* data, size_t length, const std::string& iv) const;
+
+		private:
+			int cipher_ = -1;
+			mutable symmetric_key key_{};
+
+			bool hardware_ = false;
+			alignas(16) uint8_t encrypt_keys_[11 * 16]{};
+			alignas(16) uint8_t decrypt_keys_[11 * 16]{};
+		};
+
 		std::string encrypt(const std::string& data, const std::string& iv, const std::string& key);
 		std::string decrypt(const std::string& data, const std::string& iv, const std::string& key);
+		bool encrypt(uint8_t* data, size_t length, const std::string& iv, const std::string& key);
 	}
 
 	namespace hmac_sha1
 	{
+		// hashes the padded key once, every compute only processes the message itself
+		class context final
+		{
+		public:
+			explicit context(const std::string& key);
+
+			std::string compute(const std::string& data) const;
+			std::string compute(const uint8_t* data, size_t length) const;
+
+		private:
+			hash_state inner_{};
+			hash_state outer_{};
+
+			bool hardware_ = false;
+			uint32_t inner_state_[5]{};
+			uint32_t outer_state_[5]{};
+		};
+
 		std::string compute(const std::string& data, const std::string& key);
+		std::string compute(const uint8_t* data, size_t length, const std::string& key);
 	}
 
 	namespace sha1
@@ -86,6 +157,19 @@ namespace utils::cryptography
 
 	namespace sha256
 	{
+		// incremental hashing for data that doesn't fit into memory at once
+		class context final
+		{
+		public:
+			context();
+
+			void update(const uint8_t* data, size_t length);
+			std::string finish(bool hex = false);
+
+		private:
+			hash_state state_{};
+		};
+
 		std::string compute(const std::string& data, bool hex = false);
 		std::string compute(const uint8_t* data, size_t length, bool hex = false);
 	}
@@ -0,0 +1,340 @@
+#include "delta.hpp"
+
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+#include <tomcrypt.h>
+
+namespace utils::delta
+{
+	namespace
+	{
+		constexpr uint32_t delta_magic = 0x44574D48; // HMWD
+		constexpr uint32_t delta_version = 1;
+
+		constexpr size_t min_chunk_size = 2 * 1024;
+		constexpr size_t max_chunk_size = 64 * 1024;
+		constexpr uint64_t chunk_mask = (8 * 1024) - 1; // ~8 KB average past the minimum
+
+		enum class operation : uint8_t
+		{
+			end,
+			copy,
+			insert,
+		};
+
+#pragma pack(push, 1)
+		struct header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t source_size;
+			uint64_t target_size;
+			uint8_t source_hash[20];
+			uint8_t target_hash[20];
+		};
+#pragma pack(pop)
+
+		constexpr std::array<uint64_t, 256> generate_gear_table()
+		{
+			std::array<uint64_t, 256> table{};
+
+			uint64_t state = 0x9E3779B97F4A7C15;
+			for (auto& value : table)
+			{
+				// splitmix64
+				state += 0x9E3779B97F4A7C15;
+				auto z = state;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+				value = z ^ (z >> 31);
+			}
+
+			return table;
+		}
+
+		constexpr auto gear_table = generate_gear_table();
+
+		size_t find_chunk_end(const std::string_view data, const size_t start)
+		{
+			const auto remaining = data.size() - start;
+			if (remaining <= min_chunk_size)
+			{
+				return data.size();
+			}
+
+			const auto end = start + std::min(remaining, max_chunk_size);
+
+			uint64_t hash = 0;
+			for (auto i = start + min_chunk_size; i < end; ++i)
+			{
+				hash = (hash << 1) + gear_table[static_cast<uint8_t>(data[i])];
+				if (!(hash & chunk_mask))
+				{
+					return i + 1;
+				}
+			}
+
+			return end;
+		}
+
+		// sha1_process takes 32 bit lengths
+		constexpr size_t max_hash_block = 0x4000000;
+
+		void update_sha1(hash_state* state, const std::string_view data)
+		{
+			for (size_t offset = 0; offset < data.size(); offset += max_hash_block)
+			{
+				const auto block = data.substr(offset, max_hash_block);
+				sha1_process(state, reinterpret_cast<const uint8_t*>(block.data()), static_cast<unsigned long>(block.size()));
+			}
+		}
+
+		void compute_sha1(const std::string_view data, uint8_t* hash)
+		{
+			hash_state state{};
+			sha1_init(&state);
+			update_sha1(&state, data);
+			sha1_done(&state, hash);
+		}
+
+		template <typename T>
+		void write(std::string& buffer, const T& value)
+		{
+			buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		template <typename T>
+		bool read(const std::string_view buffer, size_t& offset, T* value)
+		{
+			if (buffer.size() - offset < sizeof(T))
+			{
+				return false;
+			}
+
+			std::memcpy(value, buffer.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+
+		class delta_writer
+		{
+		public:
+			explicit delta_writer(const std::string_view target)
+				: target_(target)
+			{
+			}
+
+			void copy(const uint64_t source_offset, const size_t length)
+			{
+				// continues the previous copy, common for unchanged runs of chunks
+				if (this->copy_length_ && this->copy_offset_ + this->copy_length_ == source_offset)
+				{
+					this->copy_length_ += length;
+					return;
+				}
+
+				this->flush_insert();
+				this->flush_copy();
+
+				this->copy_offset_ = source_offset;
+				this->copy_length_ = length;
+			}
+
+			void insert(const size_t target_offset, const size_t length)
+			{
+				this->flush_copy();
+
+				if (!this->insert_length_)
+				{
+					this->insert_offset_ = target_offset;
+				}
+
+				this->insert_length_ += length;
+			}
+
+			std::string finish(header header)
+			{
+				this->flush_copy();
+				this->flush_insert();
+				write(this->buffer_, operation::end);
+
+				std::string result;
+				result.reserve(sizeof(header) + this->buffer_.size());
+				write(result, header);
+				result.append(this->buffer_);
+
+				return result;
+			}
+
+		private:
+			std::string_view target_;
+			std::string buffer_;
+
+			uint64_t copy_offset_ = 0;
+			uint64_t copy_length_ = 0;
+
+			size_t insert_offset_ = 0;
+			size_t insert_length_ = 0;
+
+			void flush_copy()
+			{
+				if (!this->copy_length_)
+				{
+					return;
+				}
+
+				write(this->buffer_, operation::copy);
+				write(this->buffer_, this->copy_offset_);
+				write(this->buffer_, this->copy_length_);
+
+				this->copy_length_ = 0;
+			}
+
+			void flush_insert()
+			{
+				if (!this->insert_length_)
+				{
+					return;
+				}
+
+				write(this->buffer_, operation::insert);
+				write(this->buffer_, static_cast<uint64_t>(this->insert_length_));
+				this->buffer_.append(this->target_.substr(this->insert_offset_, this->insert_length_));
+
+				this->insert_length_ = 0;
+			}
+		};
+	}
+
+	std::string create(const std::string_view source, const std::string_view target)
+	{
+		header header{};
+		header.magic = delta_magic;
+		header.version = delta_version;
+		header.source_size = source.size();
+		header.target_size = target.size();
+		compute_sha1(source, header.source_hash);
+		compute_sha1(target, header.target_hash);
+
+		std::unordered_map<std::string_view, uint64_t> source_chunks;
+		for (size_t offset = 0; offset < source.size();)
+		{
+			const auto end = find_chunk_end(source, offset);
+			source_chunks.try_emplace(source.substr(offset, end - offset), offset);
+			offset = end;
+		}
+
+		delta_writer writer(target);
+		for (size_t offset = 0; offset < target.size();)
+		{
+			const auto end = find_chunk_end(target, offset);
+			const auto chunk = target.substr(offset, end - offset);
+
+			if (const auto itr = source_chunks.find(chunk); itr != source_chunks.end())
+			{
+				writer.copy(itr->second, chunk.size());
+			}
+			else
+			{
+				writer.insert(offset, chunk.size());
+			}
+
+			offset = end;
+		}
+
+		return writer.finish(header);
+	}
+
+	bool apply(const std::string_view source, const std::string_view delta, const std::function<bool(std::string_view data)>& writer)
+	{
+		size_t offset = 0;
+
+		header header{};
+		if (!read(delta, offset, &header) || header.magic != delta_magic || header.version != delta_version
+			|| header.source_size != source.size())
+		{
+			return false;
+		}
+
+		uint8_t source_hash[20]{};
+		compute_sha1(source, source_hash);
+		if (std::memcmp(source_hash, header.source_hash, sizeof(source_hash)))
+		{
+			return false;
+		}
+
+		hash_state target_state{};
+		sha1_init(&target_state);
+
+		uint64_t written = 0;
+
+		const auto emit = [&](const std::string_view data)
+		{
+			if (header.target_size - written < data.size())
+			{
+				return false;
+			}
+
+			update_sha1(&target_state, data);
+			written += data.size();
+
+			return writer(data);
+		};
+
+		while (true)
+		{
+			operation type{};
+			if (!read(delta, offset, &type))
+			{
+				return false;
+			}
+
+			if (type == operation::end)
+			{
+				break;
+			}
+
+			if (type == operation::copy)
+			{
+				uint64_t source_offset{};
+				uint64_t length{};
+				if (!read(delta, offset, &source_offset) || !read(delta, offset, &length)
+					|| source_offset > source.size() || length > source.size() - source_offset)
+				{
+					return false;
+				}
+
+				if (!emit(source.substr(source_offset, length)))
+				{
+					return false;
+				}
+			}
+			else if (type == operation::insert)
+			{
+				uint64_t length{};
+				if (!read(delta, offset, &length) || length > delta.size() - offset)
+				{
+					return false;
+				}
+
+				if (!emit(delta.substr(offset, length)))
+				{
+					return false;
+				}
+
+				offset += length;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		uint8_t target_hash[20]{};
+		sha1_done(&target_state, target_hash);
+
+		return written == header.target_size && !std::memcmp(target_hash, header.target_hash, sizeof(target_hash));
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace utils::delta
+{
+	// Binary delta between two versions of a file. Both versions are split into content defined chunks,
+	// chunks of the target that exist anywhere in the source are copied, everything else is stored.
+	std::string create(std::string_view source, std::string_view target);
+
+	// streams the target to the writer, fails on malformed deltas, a different source or a writer error
+	// the target is checked against the hash stored in the delta before returning true
+	bool apply(std::string_view source, std::string_view delta, const std::function<bool(std::string_view data)>& writer);
+}
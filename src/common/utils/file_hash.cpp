@@ -0,0 +1,293 @@
+#include "file_hash.hpp"
+#include "cryptography.hpp"
+#include "io.hpp"
+#include "io_native.hpp"
+#include "thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+namespace utils::file_hash
+{
+	namespace
+	{
+		// two buffers handed back and forth between the reading and the hashing thread
+		class chunk_pipeline final
+		{
+		public:
+			explicit chunk_pipeline(const size_t chunk_size)
+			{
+				for (auto& buffer : this->buffers_)
+				{
+					buffer.data.resize(chunk_size);
+				}
+			}
+
+			std::string& acquire_for_reading(const size_t index)
+			{
+				auto& buffer = this->buffers_[index & 1];
+
+				std::unique_lock<std::mutex> lock(this->mutex_);
+				this->condition_.wait(lock, [&]()
+				{
+					return !buffer.full;
+				});
+
+				return buffer.data;
+			}
+
+			// a size of 0 marks the end of the file
+			void publish(const size_t index, const size_t size)
+			{
+				auto& buffer = this->buffers_[index & 1];
+
+				{
+					std::lock_guard<std::mutex> _(this->mutex_);
+					buffer.size = size;
+					buffer.full = true;
+				}
+
+				this->condition_.notify_all();
+			}
+
+			std::string_view acquire_for_hashing(const size_t index)
+			{
+				auto& buffer = this->buffers_[index & 1];
+
+				std::unique_lock<std::mutex> lock(this->mutex_);
+				this->condition_.wait(lock, [&]()
+				{
+					return buffer.full;
+				});
+
+				return {buffer.data.data(), buffer.size};
+			}
+
+			void release(const size_t index)
+			{
+				{
+					std::lock_guard<std::mutex> _(this->mutex_);
+					this->buffers_[index & 1].full = false;
+				}
+
+				this->condition_.notify_all();
+			}
+
+		private:
+			struct buffer
+			{
+				std::string data;
+				size_t size = 0;
+				bool full = false;
+			};
+
+			std::mutex mutex_;
+			std::condition_variable condition_;
+			buffer buffers_[2];
+		};
+	}
+
+	double result::get_throughput() const
+	{
+		if (this->cached || this->seconds <= 0.0)
+		{
+			return 0.0;
+		}
+
+		return static_cast<double>(this->size) / (1024.0 * 1024.0) / this->seconds;
+	}
+
+	hasher::hasher(std::string cache_file, const size_t chunk_size)
+		: cache_file_(std::move(cache_file))
+		, chunk_size_(std::max<size_t>(chunk_size, 0x1000))
+	{
+		this->load_cache();
+	}
+
+	result hasher::compute(const std::string& file)
+	{
+		const auto attributes = io::native::get_attributes(file);
+		if (!attributes.exists || attributes.is_directory)
+		{
+			return {};
+		}
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			const auto itr = this->cache_.find(file);
+			if (itr != this->cache_.end() && itr->second.size == attributes.size
+				&& itr->second.modified_time == attributes.modified_time)
+			{
+				return {true, true, itr->second.hash, attributes.size, 0.0};
+			}
+		}
+
+		auto result = this->hash_file(file);
+
+		// stored with the attributes from before hashing, a file changed in the meantime gets hashed again next time
+		if (result.success && !this->cache_file_.empty())
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->cache_[file] = {attributes.size, attributes.modified_time, result.hash};
+			this->cache_dirty_ = true;
+		}
+
+		return result;
+	}
+
+	std::vector<result> hasher::compute_many(const std::vector<std::string>& files, const size_t max_parallel)
+	{
+		std::vector<result> results(files.size());
+		std::atomic_size_t next_index = 0;
+
+		const auto compute = [&]()
+		{
+			for (auto i = next_index++; i < files.size(); i = next_index++)
+			{
+				results[i] = this->compute(files[i]);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		const auto thread_count = std::min(std::max<size_t>(max_parallel, 1), files.size());
+
+		for (size_t i = 1; i < thread_count; ++i)
+		{
+			threads.emplace_back(thread::create_named_thread("File Hasher", compute));
+		}
+
+		compute();
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		return results;
+	}
+
+	void hasher::save_cache()
+	{
+		nlohmann::json cache = nlohmann::json::object();
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			if (this->cache_file_.empty() || !this->cache_dirty_)
+			{
+				return;
+			}
+
+			for (const auto& [file, entry] : this->cache_)
+			{
+				cache[file] = {
+					{"size", entry.size},
+					{"modified_time", entry.modified_time},
+					{"hash", entry.hash},
+				};
+			}
+
+			this->cache_dirty_ = false;
+		}
+
+		io::write_file_atomic(this->cache_file_, cache.dump());
+	}
+
+	void hasher::load_cache()
+	{
+		std::string data{};
+		if (this->cache_file_.empty() || !io::read_file(this->cache_file_, &data))
+		{
+			return;
+		}
+
+		try
+		{
+			const auto cache = nlohmann::json::parse(data);
+			for (const auto& [file, entry] : cache.items())
+			{
+				this->cache_[file] = {
+					entry.at("size").get<size_t>(),
+					entry.at("modified_time").get<uint64_t>(),
+					entry.at("hash").get<std::string>(),
+				};
+			}
+		}
+		catch (...)
+		{
+			// a broken cache only costs a rehash
+			this->cache_.clear();
+		}
+	}
+
+	result hasher::hash_file(const std::string& file) const
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const auto handle = io::native::open_for_reading(file, true);
+		if (handle == io::native::invalid_handle)
+		{
+			return {};
+		}
+
+		chunk_pipeline pipeline(this->chunk_size_);
+		cryptography::sha256::context context{};
+
+		auto hash_thread = std::thread([&]()
+		{
+			for (size_t index = 0;; ++index)
+			{
+				const auto chunk = pipeline.acquire_for_hashing(index);
+				if (chunk.empty())
+				{
+					break;
+				}
+
+				context.update(reinterpret_cast<const uint8_t*>(chunk.data()), chunk.size());
+				pipeline.release(index);
+			}
+		});
+
+		auto success = true;
+		size_t total_size{};
+
+		for (size_t index = 0;; ++index)
+		{
+			auto& buffer = pipeline.acquire_for_reading(index);
+
+			size_t read{};
+			if (!io::native::read_at(handle, total_size, buffer.data(), buffer.size(), &read))
+			{
+				success = false;
+				read = 0;
+			}
+
+			pipeline.publish(index, read);
+			total_size += read;
+
+			if (read < buffer.size())
+			{
+				// a short read ends the file, the empty chunk stops the hashing thread
+				if (read)
+				{
+					pipeline.acquire_for_reading(index + 1);
+					pipeline.publish(index + 1, 0);
+				}
+
+				break;
+			}
+		}
+
+		hash_thread.join();
+		io::native::close(handle);
+
+		if (!success)
+		{
+			return {};
+		}
+
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		return {true, false, context.finish(true), total_size, duration.count()};
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils::file_hash
+{
+	struct result
+	{
+		bool success;
+		// taken from the cache, size and modification time didn't change
+		bool cached;
+		// hex encoded SHA-256
+		std::string hash;
+		size_t size;
+		double seconds;
+
+		// MB/s, 0 for cached results
+		double get_throughput() const;
+	};
+
+	// SHA-256 of whole files without holding them in memory. The next chunk is read while the
+	// previous one is hashed, so a file costs max(read, hash) instead of their sum.
+	// Hashes are remembered by size and modification time if a cache file is given.
+	class hasher final
+	{
+	public:
+		explicit hasher(std::string cache_file = {}, size_t chunk_size = 0x400000);
+
+		result compute(const std::string& file);
+		// results are in the order of the files, the calling thread hashes as well
+		std::vector<result> compute_many(const std::vector<std::string>& files, size_t max_parallel);
+
+		// persists hashes computed since the last save
+		void save_cache();
+
+	private:
+		struct cache_entry
+		{
+			size_t size;
+			uint64_t modified_time;
+			std::string hash;
+		};
+
+		std::string cache_file_;
+		size_t chunk_size_;
+
+		std::mutex mutex_;
+		std::unordered_map<std::string, cache_entry> cache_;
+		bool cache_dirty_ = false;
+
+		void load_cache();
+		result hash_file(const std::string& file) const;
+	};
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace utils
+{
+	// Log-linear buckets in the spirit of HdrHistogram, every power of two is split into 8 buckets.
+	// Percentiles are at most 12.5% above the recorded value, exact below 8.
+	// Only one thread may record, any thread may read.
+	class histogram
+	{
+	public:
+		static constexpr uint32_t sub_bucket_bits = 3;
+		static constexpr uint32_t sub_bucket_count = 1u << sub_bucket_bits;
+		static constexpr uint32_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+		void record(const uint64_t value)
+		{
+			increment(this->buckets_[get_bucket(value)], 1);
+			increment(this->count_, 1);
+			increment(this->sum_, value);
+
+			if (value > this->max_.load(std::memory_order_relaxed))
+			{
+				this->max_.store(value, std::memory_order_relaxed);
+			}
+		}
+
+		uint64_t get_count() const
+		{
+			return this->count_.load(std::memory_order_relaxed);
+		}
+
+		uint64_t get_sum() const
+		{
+			return this->sum_.load(std::memory_order_relaxed);
+		}
+
+		uint64_t get_max() const
+		{
+			return this->max_.load(std::memory_order_relaxed);
+		}
+
+		// percentile in [0, 100], reports the upper bound of the bucket it falls into
+		uint64_t get_percentile(const double percentile) const
+		{
+			const auto total = this->get_count();
+			if (!total)
+			{
+				return 0;
+			}
+
+			const auto rank = static_cast<uint64_t>(static_cast<double>(total) * percentile / 100.0 + 0.5);
+			const auto target = rank ? rank : 1;
+
+			uint64_t seen = 0;
+			for (uint32_t i = 0; i < bucket_count; ++i)
+			{
+				seen += this->buckets_[i].load(std::memory_order_relaxed);
+				if (seen >= target)
+				{
+					return std::min(get_upper_bound(i), this->get_max());
+				}
+			}
+
+			return this->get_max();
+		}
+
+		// racing with record only loses the samples of that moment
+		void reset()
+		{
+			for (auto& bucket : this->buckets_)
+			{
+				bucket.store(0, std::memory_order_relaxed);
+			}
+
+			this->count_.store(0, std::memory_order_relaxed);
+			this->sum_.store(0, std::memory_order_relaxed);
+			this->max_.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		std::array<std::atomic_uint64_t, bucket_count> buckets_{};
+		std::atomic_uint64_t count_{0};
+		std::atomic_uint64_t sum_{0};
+		std::atomic_uint64_t max_{0};
+
+		// single writer, a plain load and store avoids a locked instruction per sample
+		static void increment(std::atomic_uint64_t& value, const uint64_t amount)
+		{
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		static uint32_t get_bucket(const uint64_t value)
+		{
+			if (value < sub_bucket_count)
+			{
+				return static_cast<uint32_t>(value);
+			}
+
+			const auto shift = static_cast<uint32_t>(std::bit_width(value)) - 1 - sub_bucket_bits;
+			const auto mantissa = static_cast<uint32_t>(value >> shift) & (sub_bucket_count - 1);
+
+			return (shift + 1) * sub_bucket_count + mantissa;
+		}
+
+		static uint64_t get_upper_bound(const uint32_t bucket)
+		{
+			if (bucket < sub_bucket_count)
+			{
+				return bucket;
+			}
+
+			const auto shift = bucket / sub_bucket_count - 1;
+			const auto mantissa = static_cast<uint64_t>(bucket % sub_bucket_count);
+			const auto lower = (sub_bucket_count + mantissa) << shift;
+
+			return lower + ((1ull << shift) - 1);
+		}
+	};
+}
@@ -1,5 +1,6 @@
 #include "http.hpp"
 #include <algorithm>
+#include <cctype>
 #include <curl/curl.h>
 #include <gsl/gsl>
 
@@ -56,6 +57,51 @@ namespace utils::http
 			return total_size;
 		}
 
+		std::string_view trim(std::string_view text)
+		{
+			while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+			{
+				text.remove_prefix(1);
+			}
+
+			while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+			{
+				text.remove_suffix(1);
+			}
+
+			return text;
+		}
+
+		size_t header_callback(char* contents, const size_t size, const size_t nmemb, void* userp)
+		{
+			auto* response_headers = static_cast<headers*>(userp);
+
+			const auto total_size = size * nmemb;
+			const std::string_view line(contents, total_size);
+
+			// every response starts with its status line, drop headers of redirects
+			if (line.starts_with("HTTP/"))
+			{
+				response_headers->clear();
+				return total_size;
+			}
+
+			const auto pos = line.find(':');
+			if (pos == std::string_view::npos)
+			{
+				return total_size;
+			}
+
+			std::string name(trim(line.substr(0, pos)));
+			std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c)
+			{
+				return static_cast<char>(std::tolower(c));
+			});
+
+			(*response_headers)[std::move(name)] = trim(line.substr(pos + 1));
+			return total_size;
+		}
+
 		size_t write_callback_stream(void* contents, const size_t size, const size_t nmemb, void* userp)
 		{
 			const auto total_size = size * nmemb;
@@ -78,56 +124,9 @@ namespace utils::http
 		}
 	}
 
-	std::optional<std::string> get_data_motd(const std::string& url, const headers& headers,
-		const std::function<void(size_t, size_t, size_t)>& callback)
-	{
-		curl_slist* header_list = nullptr;
-		auto* curl = curl_easy_init();
-		if (!curl)
-		{
-			return {};
-		}
-
-		auto _ = gsl::finally([&]()
-		{
-			curl_slist_free_all(header_list);
-			curl_easy_cleanup(curl);
-		});
-
-		for (const auto& header : headers)
-		{
-			auto data = header.first + ": " + header.second;
-			header_list = curl_slist_append(header_list, data.data());
-		}
-
-		std::string buffer{};
-		progress_helper helper{};
-		helper.callback = &callback;
-		helper.start = std::chrono::high_resolution_clock::now();
-
-		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
-		curl_easy_setopt(curl, CURLOPT_URL, url.data());
-		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-		curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
-		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &helper);
-		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
-
-		if (curl_easy_perform(curl) == CURLE_OK)
-		{
-			return { std::move(buffer) };
-		}
-
-		if (helper.exception)
-		{
-			std::rethrow_exception(helper.exception);
-		}
-
-		return {};
-	}
-
 	std::optional<result> get_data(const std::string& url, const std::string& fields,
-		const headers& headers, const std::function<void(size_t, size_t, size_t)>& callback, int timeout)
+		const headers& headers, const std::function<void(size_t, size_t, size_t)>& callback, int timeout,
+		const int stall_timeout)
 	{
 		curl_slist* header_list = nullptr;
 		auto* curl = curl_easy_init();
@@ -149,6 +148,7 @@ namespace utils::http
 		}
 
 		std::string buffer{};
+		http::headers response_headers{};
 		progress_helper helper{};
 		helper.callback = &callback;
 
@@ -156,6 +156,8 @@ namespace utils::http
 		curl_easy_setopt(curl, CURLOPT_URL, url.data());
 		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
 		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
+		curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
+		curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response_headers);
 		curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
 		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &helper);
 		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
@@ -163,6 +165,14 @@ namespace utils::http
 
 		curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
 
+		if (stall_timeout > 0)
+		{
+			// large downloads on slow connections are fine as long as data keeps coming
+			curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, stall_timeout);
+			curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+			curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, static_cast<long>(stall_timeout));
+		}
+
 		if (!fields.empty())
 		{
 			curl_easy_setopt(curl, CURLOPT_POSTFIELDS, fields.data());
@@ -178,6 +188,7 @@ namespace utils::http
 			result.code = code;
 			result.response_code = response_code;
 			result.buffer = std::move(buffer);
+			result.response_headers = std::move(response_headers);
 
 			return result;
 		}
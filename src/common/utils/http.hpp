@@ -2,29 +2,33 @@
 
 #include <string>
 #include <optional>
+#include <functional>
 #include <future>
+#include <unordered_map>
 #include <curl/curl.h>
 
 namespace utils::http
 {
+	using headers = std::unordered_map<std::string, std::string>;
+
 	struct result
 	{
 		CURLcode code{};
 		unsigned int response_code{};
 		std::string buffer{};
+		// names are lowercase, only the headers of the final response after redirects
+		headers response_headers{};
 	};
 
-	using headers = std::unordered_map<std::string, std::string>;
-
+	// timeout bounds the whole transfer, stall_timeout only aborts once nothing arrived for that many seconds
 	std::optional<result> get_data(const std::string& url, const std::string& fields = {},
-		const headers& headers = {}, const std::function<void(size_t, size_t, size_t)>& callback = {}, int timeout = 0);
+		const headers& headers = {}, const std::function<void(size_t, size_t, size_t)>& callback = {}, int timeout = 0,
+		int stall_timeout = 0);
 
 	std::optional<result> get_data_stream(const std::string& url, const headers& headers = {},
 		const std::string& fields = {}, const std::function<void(size_t, size_t, size_t)>& progress_callback_ = {},
 		const std::function<void(const char*, size_t)>& stream_callback = {}, int timeout = 0);
 
-	std::optional<std::string> get_data_motd(const std::string& url, const headers& headers = {},
-		const std::function<void(size_t, size_t, size_t)>& callback = {});
 	std::future<std::optional<result>> get_data_async(const std::string& url, const std::string& fields = {},
 		const headers& headers = {}, const std::function<int(size_t, size_t)>& callback = {});
 }
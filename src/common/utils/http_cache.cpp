@@ -0,0 +1,192 @@
+#include "http_cache.hpp"
+#include "cryptography.hpp"
+#include "io.hpp"
+
+#include <thread>
+
+namespace utils::http
+{
+	cache::cache(std::string directory, const int stall_timeout, const size_t max_bytes, const std::chrono::seconds max_age)
+		: directory_(std::move(directory))
+		, stall_timeout_(stall_timeout)
+	{
+		if (io::directory_exists(this->directory_))
+		{
+			io::prune_directory(this->directory_, max_bytes, max_age);
+		}
+	}
+
+	std::optional<std::string> cache::get(const std::string& url)
+	{
+		entry cached_entry{};
+		std::string cached_data{};
+		const auto is_cached = this->read_entry(url, &cached_entry, &cached_data);
+
+		if (this->cancelled_)
+		{
+			return is_cached ? std::optional{std::move(cached_data)} : std::nullopt;
+		}
+
+		headers request_headers{};
+		if (is_cached && !cached_entry.etag.empty())
+		{
+			request_headers["If-None-Match"] = cached_entry.etag;
+		}
+
+		if (is_cached && !cached_entry.last_modified.empty())
+		{
+			request_headers["If-Modified-Since"] = cached_entry.last_modified;
+		}
+
+		std::optional<result> response{};
+
+		try
+		{
+			response = get_data(url, {}, request_headers, [this](size_t, size_t, size_t)
+			{
+				if (this->cancelled_)
+				{
+					throw std::runtime_error("request cancelled");
+				}
+			}, 0, this->stall_timeout_);
+		}
+		catch (...)
+		{
+		}
+
+		if (response && response->code == CURLE_OK)
+		{
+			if (response->response_code == 304 && is_cached)
+			{
+				this->touch_entry(url);
+				return {std::move(cached_data)};
+			}
+
+			if (response->response_code == 200)
+			{
+				entry new_entry{};
+
+				if (const auto etag = response->response_headers.find("etag"); etag != response->response_headers.end())
+				{
+					new_entry.etag = etag->second;
+				}
+
+				if (const auto last_modified = response->response_headers.find("last-modified"); last_modified != response->response_headers.end())
+				{
+					new_entry.last_modified = last_modified->second;
+				}
+
+				// nothing to revalidate with, it would be downloaded again anyway
+				if (!new_entry.etag.empty() || !new_entry.last_modified.empty())
+				{
+					this->write_entry(url, new_entry, response->buffer);
+				}
+
+				return {std::move(response->buffer)};
+			}
+		}
+
+		if (is_cached)
+		{
+			return {std::move(cached_data)};
+		}
+
+		return {};
+	}
+
+	std::vector<std::optional<std::string>> cache::get_many(const std::vector<std::string>& urls, const size_t max_parallel)
+	{
+		std::vector<std::optional<std::string>> results(urls.size());
+		std::atomic_size_t next_index = 0;
+
+		const auto fetch = [&]()
+		{
+			for (auto i = next_index++; i < urls.size(); i = next_index++)
+			{
+				results[i] = this->get(urls[i]);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		const auto thread_count = std::min(std::max<size_t>(max_parallel, 1), urls.size());
+
+		// the calling thread fetches as well
+		for (size_t i = 1; i < thread_count; ++i)
+		{
+			threads.emplace_back(fetch);
+		}
+
+		fetch();
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		return results;
+	}
+
+	void cache::cancel()
+	{
+		this->cancelled_ = true;
+	}
+
+	std::string cache::get_path(const std::string& url) const
+	{
+		return this->directory_ + "/" + cryptography::sha1::compute(url, true);
+	}
+
+	bool cache::read_entry(const std::string& url, entry* entry, std::string* data) const
+	{
+		const auto path = this->get_path(url);
+
+		std::string meta_data{};
+		if (!io::read_file(path + ".meta", &meta_data) || !io::read_file(path + ".data", data))
+		{
+			return false;
+		}
+
+		try
+		{
+			const auto meta = nlohmann::json::parse(meta_data);
+
+			// the sha1 of the url could collide, unlikely but cheap to rule out
+			if (meta.value("url", "") != url || meta.value("sha1", "") != cryptography::sha1::compute(*data, true))
+			{
+				return false;
+			}
+
+			entry->etag = meta.value("etag", "");
+			entry->last_modified = meta.value("last_modified", "");
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	void cache::touch_entry(const std::string& url) const
+	{
+		const auto path = this->get_path(url);
+		io::touch_file(path + ".data");
+		io::touch_file(path + ".meta");
+	}
+
+	void cache::write_entry(const std::string& url, const entry& entry, const std::string& data) const
+	{
+		const auto path = this->get_path(url);
+
+		nlohmann::json meta{};
+		meta["url"] = url;
+		meta["sha1"] = cryptography::sha1::compute(data, true);
+		meta["etag"] = entry.etag;
+		meta["last_modified"] = entry.last_modified;
+
+		// a crash between both writes leaves a hash that doesn't match, the entry is ignored then
+		if (io::write_file_atomic(path + ".data", data))
+		{
+			io::write_file_atomic(path + ".meta", meta.dump());
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "http.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace utils::http
+{
+	// Keeps responses on disk and revalidates them with If-None-Match/If-Modified-Since,
+	// unchanged resources cost a 304 round trip. The cached copy is served if the server can't be reached.
+	class cache final
+	{
+	public:
+		// requests are aborted once no data arrived for stall_timeout seconds, slow but steady downloads finish.
+		// Entries not used for max_age are deleted on construction, then the least recently used ones
+		// until the directory holds at most max_bytes
+		explicit cache(std::string directory, int stall_timeout = 10, size_t max_bytes = 64 * 1024 * 1024,
+			std::chrono::seconds max_age = std::chrono::hours(24 * 30));
+
+		std::optional<std::string> get(const std::string& url);
+		// fetches with at most max_parallel requests in flight, results are in the order of the urls
+		std::vector<std::optional<std::string>> get_many(const std::vector<std::string>& urls, size_t max_parallel);
+
+		// aborts running and future requests, cached copies are still served
+		void cancel();
+
+	private:
+		struct entry
+		{
+			std::string etag;
+			std::string last_modified;
+		};
+
+		std::string directory_;
+		int stall_timeout_;
+		std::atomic_bool cancelled_ = false;
+
+		std::string get_path(const std::string& url) const;
+		bool read_entry(const std::string& url, entry* entry, std::string* data) const;
+		void touch_entry(const std::string& url) const;
+		void write_entry(const std::string& url, const entry& entry, const std::string& data) const;
+	};
+}
@@ -1,43 +1,144 @@
 #include "io.hpp"
-#include "nt.hpp"
+#include "io_native.hpp"
 #include <fstream>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace utils::io
 {
+	namespace
+	{
+		// directories we created or saw, saves a create_directories call on every write
+		std::mutex known_directories_mutex;
+		std::unordered_set<std::string> known_directories;
+
+		void forget_directories()
+		{
+			std::lock_guard<std::mutex> _(known_directories_mutex);
+			known_directories.clear();
+		}
+
+		void forget_parent_directory(const std::string& file)
+		{
+			const auto pos = file.find_last_of("/\\");
+			if (pos == std::string::npos)
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> _(known_directories_mutex);
+			known_directories.erase(file.substr(0, pos));
+		}
+
+		void create_parent_directory(const std::string& file)
+		{
+			const auto pos = file.find_last_of("/\\");
+			if (pos == std::string::npos)
+			{
+				return;
+			}
+
+			auto directory = file.substr(0, pos);
+
+			{
+				std::lock_guard<std::mutex> _(known_directories_mutex);
+				if (known_directories.contains(directory))
+				{
+					return;
+				}
+			}
+
+			create_directory(directory);
+
+			std::lock_guard<std::mutex> _(known_directories_mutex);
+			known_directories.emplace(std::move(directory));
+		}
+
+		bool write_stream(const std::string& file, const std::string& data, const bool append)
+		{
+			std::ios::openmode mode = std::ios::binary | std::ofstream::out;
+			if (append)
+			{
+				mode |= std::ofstream::app;
+			}
+
+			std::ofstream stream(file, mode);
+
+			if (stream.is_open())
+			{
+				stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+				stream.close();
+				return true;
+			}
+
+			return false;
+		}
+	}
+
 	bool remove_file(const std::string& file)
 	{
-		return DeleteFileA(file.data()) == TRUE;
+		return native::remove_file(file);
 	}
 
 	bool move_file(const std::string& src, const std::string& target)
 	{
-		return MoveFileA(src.data(), target.data()) == TRUE;
+		return native::move_file(src, target);
 	}
 
 	bool file_exists(const std::string& file)
 	{
-		return std::ifstream(file).good();
+		const auto attributes = native::get_attributes(file);
+		return attributes.exists && !attributes.is_directory;
 	}
 
 	bool write_file(const std::string& file, const std::string& data, const bool append)
 	{
-		const auto pos = file.find_last_of("/\\");
-		if (pos != std::string::npos)
+		create_parent_directory(file);
+
+		if (write_stream(file, data, append))
 		{
-			create_directory(file.substr(0, pos));
+			return true;
 		}
 
-		std::ofstream stream(
-			file, std::ios::binary | std::ofstream::out | (append ? std::ofstream::app : 0));
+		// the directory might have been removed behind our back
+		forget_parent_directory(file);
+		create_parent_directory(file);
 
-		if (stream.is_open())
+		return write_stream(file, data, append);
+	}
+
+	bool write_file_atomic(const std::string& file, const std::string& data)
+	{
+		create_parent_directory(file);
+
+		// write next to the target and swap it in, the target is either the old or the new file after a crash
+		const auto temp_file = file + ".tmp";
+		auto handle = native::open_for_writing(temp_file);
+		if (handle == native::invalid_handle)
 		{
-			stream.write(data.data(), static_cast<std::streamsize>(data.size()));
-			stream.close();
-			return true;
+			// the directory might have been removed behind our back
+			forget_parent_directory(file);
+			create_parent_directory(file);
+
+			handle = native::open_for_writing(temp_file);
+			if (handle == native::invalid_handle)
+			{
+				return false;
+			}
 		}
 
-		return false;
+		const auto result = native::write_all(handle, data.data(), data.size()) && native::flush(handle);
+		native::close(handle);
+
+		if (!result || !native::replace_file(temp_file, file))
+		{
+			native::remove_file(temp_file);
+			return false;
+		}
+
+		return true;
 	}
 
 	std::string read_file(const std::string& file)
@@ -52,41 +153,30 @@ namespace utils::io
 		if (!data) return false;
 		data->clear();
 
-		if (file_exists(file))
+		const auto handle = native::open_for_reading(file, true);
+		if (handle == native::invalid_handle)
 		{
-			std::ifstream stream(file, std::ios::binary);
-			if (!stream.is_open()) return false;
+			return false;
+		}
 
-			stream.seekg(0, std::ios::end);
-			const std::streamsize size = stream.tellg();
-			stream.seekg(0, std::ios::beg);
+		size_t size{};
+		size_t read{};
 
-			if (size > -1)
-			{
-				data->resize(static_cast<uint32_t>(size));
-				stream.read(const_cast<char*>(data->data()), size);
-				stream.close();
-				return true;
-			}
+		auto result = native::get_size(handle, &size);
+		if (result)
+		{
+			data->resize(size);
+			result = native::read_at(handle, 0, data->data(), size, &read);
+			data->resize(read);
 		}
 
-		return false;
+		native::close(handle);
+		return result;
 	}
 
 	size_t file_size(const std::string& file)
 	{
-		if (file_exists(file))
-		{
-			std::ifstream stream(file, std::ios::binary);
-
-			if (stream.good())
-			{
-				stream.seekg(0, std::ios::end);
-				return static_cast<size_t>(stream.tellg());
-			}
-		}
-
-		return 0;
+		return native::get_attributes(file).size;
 	}
 
 	bool create_directory(const std::string& directory)
@@ -96,7 +186,7 @@ namespace utils::io
 
 	bool directory_exists(const std::string& directory)
 	{
-		return std::filesystem::is_directory(directory);
+		return native::get_attributes(directory).is_directory;
 	}
 
 	bool directory_is_empty(const std::string& directory)
@@ -106,6 +196,7 @@ namespace utils::io
 
 	bool remove_directory(const std::string& directory)
 	{
+		forget_directories();
 		return std::filesystem::remove_all(directory);
 	}
 
@@ -133,10 +224,225 @@ namespace utils::io
 		return files;
 	}
 
+	bool touch_file(const std::string& file)
+	{
+		std::error_code ec{};
+		std::filesystem::last_write_time(file, std::filesystem::file_time_type::clock::now(), ec);
+		return !ec;
+	}
+
+	size_t prune_directory(const std::string& directory, const size_t max_bytes, const std::chrono::seconds max_age)
+	{
+		struct entry
+		{
+			std::vector<std::filesystem::path> files;
+			uintmax_t size{};
+			std::filesystem::file_time_type time = std::filesystem::file_time_type::min();
+		};
+
+		std::unordered_map<std::string, entry> entries;
+		uintmax_t total_size = 0;
+
+		std::error_code ec{};
+		for (const auto& file : std::filesystem::directory_iterator(directory, ec))
+		{
+			if (!file.is_regular_file(ec))
+			{
+				continue;
+			}
+
+			const auto name = file.path().filename().string();
+			const auto size = file.file_size(ec);
+			const auto time = file.last_write_time(ec);
+			if (ec)
+			{
+				continue;
+			}
+
+			auto& current = entries[name.substr(0, name.find('.'))];
+			current.files.emplace_back(file.path());
+			current.size += size;
+			current.time = std::max(current.time, time);
+
+			total_size += size;
+		}
+
+		std::vector<entry*> oldest_first;
+		oldest_first.reserve(entries.size());
+
+		for (auto& [name, current] : entries)
+		{
+			oldest_first.emplace_back(&current);
+		}
+
+		std::ranges::sort(oldest_first, {}, &entry::time);
+
+		const auto now = std::filesystem::file_time_type::clock::now();
+		size_t removed = 0;
+
+		for (const auto* current : oldest_first)
+		{
+			const auto expired = max_age.count() > 0 && now - current->time > max_age;
+			if (!expired && total_size <= max_bytes)
+			{
+				break;
+			}
+
+			for (const auto& file : current->files)
+			{
+				std::filesystem::remove(file, ec);
+			}
+
+			total_size -= current->size;
+			++removed;
+		}
+
+		return removed;
+	}
+
 	void copy_folder(const std::filesystem::path& src, const std::filesystem::path& target)
 	{
 		std::filesystem::copy(src, target,
 		                      std::filesystem::copy_options::overwrite_existing |
 		                      std::filesystem::copy_options::recursive);
 	}
+
+	bool read_file_range(const std::string& file, const size_t offset, const size_t size, std::string* data)
+	{
+		if (!data) return false;
+		data->clear();
+
+		const auto handle = native::open_for_reading(file, false);
+		if (handle == native::invalid_handle)
+		{
+			return false;
+		}
+
+		size_t read{};
+		data->resize(size);
+
+		const auto result = native::read_at(handle, offset, data->data(), size, &read);
+		data->resize(read);
+
+		native::close(handle);
+		return result;
+	}
+
+	bool read_file_chunked(const std::string& file, const std::function<bool(std::string_view chunk)>& callback, const size_t chunk_size)
+	{
+		const auto handle = native::open_for_reading(file, true);
+		if (handle == native::invalid_handle)
+		{
+			return false;
+		}
+
+		std::string buffer;
+		buffer.resize(std::max<size_t>(chunk_size, 1));
+
+		auto result = true;
+		for (uint64_t offset = 0;; offset += buffer.size())
+		{
+			size_t read{};
+			if (!native::read_at(handle, offset, buffer.data(), buffer.size(), &read))
+			{
+				result = false;
+				break;
+			}
+
+			if (read && !callback(std::string_view(buffer.data(), read)))
+			{
+				break;
+			}
+
+			if (read < buffer.size())
+			{
+				break;
+			}
+		}
+
+		native::close(handle);
+		return result;
+	}
+
+	mapped_file::mapped_file(const std::string& file)
+	{
+		const auto handle = native::open_for_reading(file, true);
+		if (handle == native::invalid_handle)
+		{
+			return;
+		}
+
+		size_t size{};
+		if (native::get_size(handle, &size))
+		{
+			this->data_ = native::map(handle, size);
+			this->size_ = this->data_ ? size : 0;
+			this->open_ = this->data_ || !size;
+		}
+
+		// the mapping stays valid without the file handle
+		native::close(handle);
+	}
+
+	mapped_file::~mapped_file()
+	{
+		this->release();
+	}
+
+	mapped_file::mapped_file(mapped_file&& obj) noexcept
+	{
+		this->operator=(std::move(obj));
+	}
+
+	mapped_file& mapped_file::operator=(mapped_file&& obj) noexcept
+	{
+		if (this != &obj)
+		{
+			this->release();
+
+			this->open_ = obj.open_;
+			this->data_ = obj.data_;
+			this->size_ = obj.size_;
+
+			obj.open_ = false;
+			obj.data_ = nullptr;
+			obj.size_ = 0;
+		}
+
+		return *this;
+	}
+
+	bool mapped_file::is_open() const
+	{
+		return this->open_;
+	}
+
+	const uint8_t* mapped_file::data() const
+	{
+		return this->data_;
+	}
+
+	size_t mapped_file::size() const
+	{
+		return this->size_;
+	}
+
+	std::string_view mapped_file::view() const
+	{
+		if (!this->data_)
+		{
+			return {};
+		}
+
+		return {reinterpret_cast<const char*>(this->data_), this->size_};
+	}
+
+	void mapped_file::release()
+	{
+		native::unmap(this->data_, this->size_);
+
+		this->open_ = false;
+		this->data_ = nullptr;
+		this->size_ = 0;
+	}
 }
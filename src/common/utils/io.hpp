@@ -1,8 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <functional>
+#include <string_view>
 #include <json.hpp>
 
 namespace utils::io
@@ -11,6 +14,7 @@ namespace utils::io
 	bool move_file(const std::string& src, const std::string& target);
 	bool file_exists(const std::string& file);
 	bool write_file(const std::string& file, const std::string& data, bool append = false);
+	bool write_file_atomic(const std::string& file, const std::string& data);
 	bool read_file(const std::string& file, std::string* data);
 	std::string read_file(const std::string& file);
 	size_t file_size(const std::string& file);
@@ -21,4 +25,42 @@ namespace utils::io
 	std::vector<std::string> list_files(const std::string& directory);
 	std::vector<std::string> list_files_recursively(const std::string& directory);
 	void copy_folder(const std::filesystem::path& src, const std::filesystem::path& target);
+
+	// marks the file as recently used for prune_directory
+	bool touch_file(const std::string& file);
+	// Deletes the least recently written files until the directory holds at most max_bytes and nothing is older
+	// than max_age (0 disables it). Files sharing a name up to the first dot are treated as one entry.
+	// Returns the number of removed entries.
+	size_t prune_directory(const std::string& directory, size_t max_bytes, std::chrono::seconds max_age = {});
+
+	// reads size bytes starting at offset, data is shorter if the file ends earlier
+	bool read_file_range(const std::string& file, size_t offset, size_t size, std::string* data);
+	// streams the file in chunks, the callback can stop reading by returning false
+	bool read_file_chunked(const std::string& file, const std::function<bool(std::string_view chunk)>& callback, size_t chunk_size = 0x100000);
+
+	// read-only view of a whole file, valid until the object is destroyed
+	class mapped_file final
+	{
+	public:
+		mapped_file() = default;
+		explicit mapped_file(const std::string& file);
+		~mapped_file();
+
+		mapped_file(mapped_file&& obj) noexcept;
+		mapped_file& operator=(mapped_file&& obj) noexcept;
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		bool is_open() const;
+		const uint8_t* data() const;
+		size_t size() const;
+		std::string_view view() const;
+
+	private:
+		bool open_ = false;
+		const uint8_t* data_ = nullptr;
+		size_t size_ = 0;
+
+		void release();
+	};
 }
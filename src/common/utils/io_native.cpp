@@ -0,0 +1,419 @@
+#include "io_native.hpp"
+
+#ifdef _WIN32
+#include "nt.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+
+namespace utils::io::native
+{
+#ifdef _WIN32
+	namespace
+	{
+		HANDLE to_handle(const file_handle handle)
+		{
+			return reinterpret_cast<HANDLE>(handle);
+		}
+	}
+
+	attributes get_attributes(const std::string& path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data{};
+		if (!GetFileAttributesExA(path.data(), GetFileExInfoStandard, &data))
+		{
+			return {};
+		}
+
+		attributes result{};
+		result.exists = true;
+		result.is_directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+		result.size = result.is_directory ? 0 : static_cast<size_t>((static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow);
+		result.modified_time = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+		return result;
+	}
+
+	file_handle open_for_reading(const std::string& file, const bool sequential)
+	{
+		// share everything like the crt streams do, the logger might still be appending to the file
+		const auto handle = CreateFileA(file.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0), nullptr);
+
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			return invalid_handle;
+		}
+
+		return reinterpret_cast<file_handle>(handle);
+	}
+
+	void close(const file_handle handle)
+	{
+		if (handle != invalid_handle)
+		{
+			CloseHandle(to_handle(handle));
+		}
+	}
+
+	bool get_size(const file_handle handle, size_t* size)
+	{
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(to_handle(handle), &file_size))
+		{
+			return false;
+		}
+
+		*size = static_cast<size_t>(file_size.QuadPart);
+		return true;
+	}
+
+	bool read_at(const file_handle handle, const uint64_t offset, void* buffer, const size_t size, size_t* read)
+	{
+		*read = 0;
+
+		while (*read < size)
+		{
+			const auto position = offset + *read;
+
+			OVERLAPPED overlapped{};
+			overlapped.Offset = static_cast<DWORD>(position);
+			overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+			DWORD chunk_read{};
+			const auto chunk_size = static_cast<DWORD>(std::min<size_t>(size - *read, 0x40000000));
+			if (!ReadFile(to_handle(handle), static_cast<char*>(buffer) + *read, chunk_size, &chunk_read, &overlapped))
+			{
+				return GetLastError() == ERROR_HANDLE_EOF;
+			}
+
+			if (!chunk_read)
+			{
+				break;
+			}
+
+			*read += chunk_read;
+		}
+
+		return true;
+	}
+
+	bool prefetch(const file_handle handle, const uint64_t offset, const size_t size)
+	{
+		// reads go through the system cache, the data itself is thrown away
+		constexpr size_t chunk_size = 0x100000;
+		const auto buffer = std::make_unique<char[]>(chunk_size);
+
+		size_t total = 0;
+		while (total < size)
+		{
+			size_t read{};
+			if (!read_at(handle, offset + total, buffer.get(), std::min(size - total, chunk_size), &read))
+			{
+				return false;
+			}
+
+			if (!read)
+			{
+				break;
+			}
+
+			total += read;
+		}
+
+		return true;
+	}
+
+	const uint8_t* map(const file_handle handle, const size_t size)
+	{
+		if (!size)
+		{
+			return nullptr;
+		}
+
+		const auto mapping = CreateFileMappingA(to_handle(handle), nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			return nullptr;
+		}
+
+		// the view keeps the mapping object alive
+		const auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+		CloseHandle(mapping);
+
+		return static_cast<const uint8_t*>(data);
+	}
+
+	void unmap(const uint8_t* data, const size_t /*size*/)
+	{
+		if (data)
+		{
+			UnmapViewOfFile(data);
+		}
+	}
+
+	bool remove_file(const std::string& file)
+	{
+		return DeleteFileA(file.data()) == TRUE;
+	}
+
+	bool move_file(const std::string& src, const std::string& target)
+	{
+		return MoveFileA(src.data(), target.data()) == TRUE;
+	}
+
+	bool replace_file(const std::string& src, const std::string& target)
+	{
+		return MoveFileExA(src.data(), target.data(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == TRUE;
+	}
+
+	file_handle open_for_writing(const std::string& file)
+	{
+		const auto handle = CreateFileA(file.data(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			return invalid_handle;
+		}
+
+		return reinterpret_cast<file_handle>(handle);
+	}
+
+	bool write_all(const file_handle handle, const void* buffer, const size_t size)
+	{
+		size_t total = 0;
+		while (total < size)
+		{
+			DWORD written{};
+			const auto chunk_size = static_cast<DWORD>(std::min<size_t>(size - total, 0x40000000));
+			if (!WriteFile(to_handle(handle), static_cast<const char*>(buffer) + total, chunk_size, &written, nullptr) || !written)
+			{
+				return false;
+			}
+
+			total += written;
+		}
+
+		return true;
+	}
+
+	bool flush(const file_handle handle)
+	{
+		return FlushFileBuffers(to_handle(handle)) == TRUE;
+	}
+#else
+	attributes get_attributes(const std::string& path)
+	{
+		struct stat info{};
+		if (stat(path.data(), &info) != 0)
+		{
+			return {};
+		}
+
+		attributes result{};
+		result.exists = true;
+		result.is_directory = S_ISDIR(info.st_mode);
+		result.size = result.is_directory ? 0 : static_cast<size_t>(info.st_size);
+		result.modified_time = static_cast<uint64_t>(info.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(info.st_mtim.tv_nsec);
+
+		return result;
+	}
+
+	file_handle open_for_reading(const std::string& file, const bool sequential)
+	{
+		const auto fd = open(file.data(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			return invalid_handle;
+		}
+
+		struct stat info{};
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+		{
+			::close(fd);
+			return invalid_handle;
+		}
+
+#ifdef POSIX_FADV_SEQUENTIAL
+		if (sequential)
+		{
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+#else
+		(void)sequential;
+#endif
+
+		return fd;
+	}
+
+	void close(const file_handle handle)
+	{
+		if (handle != invalid_handle)
+		{
+			::close(static_cast<int>(handle));
+		}
+	}
+
+	bool get_size(const file_handle handle, size_t* size)
+	{
+		struct stat info{};
+		if (fstat(static_cast<int>(handle), &info) != 0)
+		{
+			return false;
+		}
+
+		*size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+	bool read_at(const file_handle handle, const uint64_t offset, void* buffer, const size_t size, size_t* read)
+	{
+		*read = 0;
+
+		while (*read < size)
+		{
+			const auto result = pread(static_cast<int>(handle), static_cast<char*>(buffer) + *read, size - *read,
+				static_cast<off_t>(offset + *read));
+
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				return false;
+			}
+
+			if (!result)
+			{
+				break;
+			}
+
+			*read += static_cast<size_t>(result);
+		}
+
+		return true;
+	}
+
+	bool prefetch(const file_handle handle, const uint64_t offset, const size_t size)
+	{
+#ifdef POSIX_FADV_WILLNEED
+		return posix_fadvise(static_cast<int>(handle), static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_WILLNEED) == 0;
+#else
+		(void)handle;
+		(void)offset;
+		(void)size;
+		return false;
+#endif
+	}
+
+	const uint8_t* map(const file_handle handle, const size_t size)
+	{
+		if (!size)
+		{
+			return nullptr;
+		}
+
+		auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, static_cast<int>(handle), 0);
+		if (data == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+		return static_cast<const uint8_t*>(data);
+	}
+
+	void unmap(const uint8_t* data, const size_t size)
+	{
+		if (data)
+		{
+			munmap(const_cast<uint8_t*>(data), size);
+		}
+	}
+
+	bool remove_file(const std::string& file)
+	{
+		return unlink(file.data()) == 0;
+	}
+
+	bool move_file(const std::string& src, const std::string& target)
+	{
+		// rename would silently replace the target, MoveFile doesn't
+		struct stat info{};
+		if (lstat(target.data(), &info) == 0)
+		{
+			errno = EEXIST;
+			return false;
+		}
+
+		return rename(src.data(), target.data()) == 0;
+	}
+
+	bool replace_file(const std::string& src, const std::string& target)
+	{
+		if (rename(src.data(), target.data()) != 0)
+		{
+			return false;
+		}
+
+		// the rename is part of the directory, it only survives a crash once that is synced
+		const auto pos = target.find_last_of('/');
+		const auto directory = pos == std::string::npos ? std::string(".") : target.substr(0, std::max<size_t>(pos, 1));
+
+		const auto fd = open(directory.data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			return true;
+		}
+
+		fsync(fd);
+		::close(fd);
+		return true;
+	}
+
+	file_handle open_for_writing(const std::string& file)
+	{
+		const auto fd = open(file.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0)
+		{
+			return invalid_handle;
+		}
+
+		return fd;
+	}
+
+	bool write_all(const file_handle handle, const void* buffer, const size_t size)
+	{
+		size_t total = 0;
+		while (total < size)
+		{
+			const auto result = write(static_cast<int>(handle), static_cast<const char*>(buffer) + total, size - total);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				return false;
+			}
+
+			total += static_cast<size_t>(result);
+		}
+
+		return true;
+	}
+
+	bool flush(const file_handle handle)
+	{
+		return fsync(static_cast<int>(handle)) == 0;
+	}
+#endif
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Platform layer below utils::io, implemented on top of win32 and posix
+namespace utils::io::native
+{
+	using file_handle = intptr_t;
+	constexpr file_handle invalid_handle = -1;
+
+	struct attributes
+	{
+		bool exists;
+		bool is_directory;
+		size_t size;
+		// platform specific resolution, only meaningful for comparisons
+		uint64_t modified_time;
+	};
+
+	// metadata only, the file isn't opened
+	attributes get_attributes(const std::string& path);
+
+	// only opens regular files, directories are rejected on every platform
+	file_handle open_for_reading(const std::string& file, bool sequential);
+	void close(file_handle handle);
+
+	bool get_size(file_handle handle, size_t* size);
+
+	// positional read, doesn't depend on or move a shared file position
+	bool read_at(file_handle handle, uint64_t offset, void* buffer, size_t size, size_t* read);
+
+	// pulls the range into the OS page cache, asynchronous readahead on posix, a blocking read-through on windows
+	bool prefetch(file_handle handle, uint64_t offset, size_t size);
+
+	const uint8_t* map(file_handle handle, size_t size);
+	void unmap(const uint8_t* data, size_t size);
+
+	bool remove_file(const std::string& file);
+	// fails if the target exists
+	bool move_file(const std::string& src, const std::string& target);
+	// swaps src in for an existing target, the rename is flushed to disk before returning
+	bool replace_file(const std::string& src, const std::string& target);
+
+	// creates or truncates the file, opened exclusively on windows
+	file_handle open_for_writing(const std::string& file);
+	bool write_all(file_handle handle, const void* buffer, size_t size);
+	// returns once the data reached the disk
+	bool flush(file_handle handle);
+}
@@ -0,0 +1,270 @@
+#include "io_queue.hpp"
+#include "io.hpp"
+#include "thread.hpp"
+
+namespace utils::io
+{
+	async_queue::backend async_queue::get_default_backend()
+	{
+		backend backend{};
+
+		backend.read = [](const std::string& path, std::string* data)
+		{
+			return read_file(path, data);
+		};
+
+		backend.write = [](const std::string& path, const std::string& data, const bool append)
+		{
+			return write_file(path, data, append);
+		};
+
+		backend.list = [](const std::string& path, std::vector<std::string>* files)
+		{
+			if (!directory_exists(path))
+			{
+				return false;
+			}
+
+			*files = list_files(path);
+			return true;
+		};
+
+		backend.size = [](const std::string& path, size_t* size)
+		{
+			if (!file_exists(path))
+			{
+				return false;
+			}
+
+			*size = file_size(path);
+			return true;
+		};
+
+		backend.copy = [](const std::string& source, const std::string& target)
+		{
+			if (!directory_exists(source))
+			{
+				return false;
+			}
+
+			copy_folder(source, target);
+			return true;
+		};
+
+		return backend;
+	}
+
+	async_queue::async_queue(const size_t worker_count, backend backend)
+		: backend_(std::move(backend))
+	{
+		for (size_t i = 0; i < std::max<size_t>(worker_count, 1); ++i)
+		{
+			this->workers_.emplace_back(thread::create_named_thread("IO Worker", [this]()
+			{
+				this->work();
+			}));
+		}
+	}
+
+	async_queue::~async_queue()
+	{
+		// queued writes still make it to disk
+		this->wait_idle();
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->stopping_ = true;
+		}
+
+		this->work_condition_.notify_all();
+
+		for (auto& worker : this->workers_)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+	}
+
+	uint64_t async_queue::read(const std::string& path)
+	{
+		return this->enqueue(path, operation_type::read, {}, false);
+	}
+
+	uint64_t async_queue::write(const std::string& path, std::string data, const bool append)
+	{
+		return this->enqueue(path, operation_type::write, std::move(data), append);
+	}
+
+	uint64_t async_queue::list(const std::string& path)
+	{
+		return this->enqueue(path, operation_type::list, {}, false);
+	}
+
+	uint64_t async_queue::size(const std::string& path)
+	{
+		return this->enqueue(path, operation_type::size, {}, false);
+	}
+
+	uint64_t async_queue::copy(const std::string& source, const std::string& target)
+	{
+		return this->enqueue(target, operation_type::copy, source, false);
+	}
+
+	std::vector<async_queue::result> async_queue::poll(const size_t max_count)
+	{
+		std::vector<result> results;
+
+		std::lock_guard<std::mutex> _(this->results_mutex_);
+		while (!this->results_.empty() && results.size() < max_count)
+		{
+			results.emplace_back(std::move(this->results_.front()));
+			this->results_.pop_front();
+		}
+
+		return results;
+	}
+
+	void async_queue::wait_idle()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->idle_condition_.wait(lock, [this]()
+		{
+			return this->pending_operations_ == 0;
+		});
+	}
+
+	uint64_t async_queue::get_next_id()
+	{
+		std::lock_guard<std::mutex> _(this->mutex_);
+		return this->next_id_;
+	}
+
+	uint64_t async_queue::enqueue(const std::string& path, const operation_type type, std::string data, const bool append)
+	{
+		uint64_t id{};
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			id = this->next_id_++;
+
+			auto& queue = this->paths_[path];
+
+			// the front operation might already be executing, anything behind it can still be changed
+			if (type == operation_type::write && queue.operations.size() > 1 && queue.operations.back().type == operation_type::write)
+			{
+				auto& last = queue.operations.back();
+				if (append)
+				{
+					last.data.append(data);
+				}
+				else
+				{
+					last.data = std::move(data);
+					last.append = false;
+				}
+
+				last.ids.emplace_back(id);
+				return id;
+			}
+
+			queue.operations.emplace_back(operation{type, std::move(data), append, {id}});
+			++this->pending_operations_;
+
+			if (queue.running || queue.operations.size() > 1)
+			{
+				return id;
+			}
+
+			queue.running = true;
+			this->ready_paths_.emplace_back(path);
+		}
+
+		this->work_condition_.notify_one();
+		return id;
+	}
+
+	void async_queue::work()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+
+		while (true)
+		{
+			this->work_condition_.wait(lock, [this]()
+			{
+				return this->stopping_ || !this->ready_paths_.empty();
+			});
+
+			if (this->ready_paths_.empty())
+			{
+				return;
+			}
+
+			const auto path = std::move(this->ready_paths_.front());
+			this->ready_paths_.pop_front();
+
+			// operations only get appended while running, the front stays where it is
+			auto* queue = &this->paths_[path];
+			while (!queue->operations.empty())
+			{
+				const auto& operation = queue->operations.front();
+
+				lock.unlock();
+				this->execute(path, operation);
+				lock.lock();
+
+				queue = &this->paths_[path];
+				queue->operations.pop_front();
+
+				--this->pending_operations_;
+			}
+
+			this->paths_.erase(path);
+
+			if (!this->pending_operations_)
+			{
+				this->idle_condition_.notify_all();
+			}
+		}
+	}
+
+	void async_queue::execute(const std::string& path, const operation& operation)
+	{
+		result result{};
+		result.type = operation.type;
+
+		try
+		{
+			switch (operation.type)
+			{
+			case operation_type::read:
+				result.success = this->backend_.read(path, &result.data);
+				break;
+			case operation_type::write:
+				result.success = this->backend_.write(path, operation.data, operation.append);
+				break;
+			case operation_type::list:
+				result.success = this->backend_.list(path, &result.files);
+				break;
+			case operation_type::size:
+				result.success = this->backend_.size(path, &result.size);
+				break;
+			case operation_type::copy:
+				result.success = this->backend_.copy(operation.data, path);
+				break;
+			}
+		}
+		catch (...)
+		{
+			result.success = false;
+		}
+
+		std::lock_guard<std::mutex> _(this->results_mutex_);
+		for (const auto id : operation.ids)
+		{
+			auto& entry = this->results_.emplace_back(result);
+			entry.id = id;
+		}
+	}
+}
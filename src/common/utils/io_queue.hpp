@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace utils::io
+{
+	// Runs file operations on worker threads and hands the results back in batches.
+	// Operations on the same path run in the order they were queued, a copy is ordered by its target.
+	// A write to a path whose previous write hasn't started yet is merged into it, each request still completes.
+	class async_queue final
+	{
+	public:
+		enum class operation_type
+		{
+			read,
+			write,
+			list,
+			size,
+			copy,
+		};
+
+		struct backend
+		{
+			std::function<bool(const std::string& path, std::string* data)> read;
+			std::function<bool(const std::string& path, const std::string& data, bool append)> write;
+			std::function<bool(const std::string& path, std::vector<std::string>* files)> list;
+			std::function<bool(const std::string& path, size_t* size)> size;
+			std::function<bool(const std::string& source, const std::string& target)> copy;
+		};
+
+		struct result
+		{
+			uint64_t id;
+			operation_type type;
+			bool success;
+			std::string data;
+			std::vector<std::string> files;
+			size_t size;
+		};
+
+		// the default backend uses utils::io
+		static backend get_default_backend();
+
+		explicit async_queue(size_t worker_count, backend backend = get_default_backend());
+		~async_queue();
+
+		async_queue(async_queue&&) = delete;
+		async_queue(const async_queue&) = delete;
+		async_queue& operator=(async_queue&&) = delete;
+		async_queue& operator=(const async_queue&) = delete;
+
+		uint64_t read(const std::string& path);
+		uint64_t write(const std::string& path, std::string data, bool append);
+		uint64_t list(const std::string& path);
+		uint64_t size(const std::string& path);
+		// copies a directory recursively, existing files are overwritten
+		uint64_t copy(const std::string& source, const std::string& target);
+
+		// at most max_count results, in the order they completed
+		std::vector<result> poll(size_t max_count);
+
+		// blocks until every queued operation ran
+		void wait_idle();
+
+		uint64_t get_next_id();
+
+	private:
+		struct operation
+		{
+			operation_type type;
+			// written data or the source of a copy
+			std::string data;
+			bool append;
+			std::vector<uint64_t> ids;
+		};
+
+		struct path_queue
+		{
+			std::deque<operation> operations;
+			bool running = false;
+		};
+
+		backend backend_;
+
+		std::mutex mutex_;
+		std::condition_variable work_condition_;
+		std::condition_variable idle_condition_;
+		std::unordered_map<std::string, path_queue> paths_;
+		std::deque<std::string> ready_paths_;
+		size_t pending_operations_ = 0;
+		uint64_t next_id_ = 1;
+		bool stopping_ = false;
+
+		std::mutex results_mutex_;
+		std::deque<result> results_;
+
+		std::vector<std::thread> workers_;
+
+		uint64_t enqueue(const std::string& path, operation_type type, std::string data, bool append);
+		void work();
+		void execute(const std::string& path, const operation& operation);
+	};
+}
@@ -0,0 +1,235 @@
+#include "json_stream.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace utils::json
+{
+	namespace
+	{
+		// length of the utf-8 sequence starting at text, 0 if it is malformed
+		size_t get_sequence_length(const std::string_view text)
+		{
+			const auto byte = [&](const size_t index)
+			{
+				return index < text.size() ? static_cast<uint8_t>(text[index]) : 0;
+			};
+
+			const auto in_range = [&](const size_t index, const uint8_t min, const uint8_t max)
+			{
+				return byte(index) >= min && byte(index) <= max;
+			};
+
+			const auto lead = byte(0);
+			if (lead >= 0xC2 && lead <= 0xDF)
+			{
+				return in_range(1, 0x80, 0xBF) ? 2 : 0;
+			}
+
+			if (lead >= 0xE0 && lead <= 0xEF)
+			{
+				const auto min = lead == 0xE0 ? 0xA0 : 0x80;
+				const auto max = lead == 0xED ? 0x9F : 0xBF;
+				return in_range(1, min, max) && in_range(2, 0x80, 0xBF) ? 3 : 0;
+			}
+
+			if (lead >= 0xF0 && lead <= 0xF4)
+			{
+				const auto min = lead == 0xF0 ? 0x90 : 0x80;
+				const auto max = lead == 0xF4 ? 0x8F : 0xBF;
+				return in_range(1, min, max) && in_range(2, 0x80, 0xBF) && in_range(3, 0x80, 0xBF) ? 4 : 0;
+			}
+
+			return 0;
+		}
+	}
+
+	writer::writer(std::string& buffer, const int indent)
+		: buffer_(buffer)
+		, indent_(indent)
+	{
+	}
+
+	void writer::null()
+	{
+		this->begin_value();
+		this->buffer_.append("null");
+	}
+
+	void writer::integer(const int64_t value)
+	{
+		this->begin_value();
+
+		char buffer[24];
+		const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+		this->buffer_.append(buffer, result.ptr);
+	}
+
+	void writer::floating(const double value)
+	{
+		this->begin_value();
+
+		if (!std::isfinite(value))
+		{
+			this->buffer_.append("null");
+			return;
+		}
+
+		// nlohmann's own grisu2, std::to_chars rounds ties differently in the last digit
+		char buffer[64];
+		const auto end = nlohmann::detail::to_chars(std::begin(buffer), std::end(buffer), value);
+		this->buffer_.append(buffer, end);
+	}
+
+	void writer::string(const std::string_view text)
+	{
+		this->begin_value();
+		this->write_escaped(text);
+	}
+
+	void writer::begin_object()
+	{
+		this->begin_value();
+		this->buffer_.push_back('{');
+		this->empty_.push_back(true);
+	}
+
+	void writer::key(const std::string_view key)
+	{
+		this->separate();
+		this->write_escaped(key);
+		this->buffer_.append(this->indent_ >= 0 ? ": " : ":");
+		this->after_key_ = true;
+	}
+
+	void writer::end_object()
+	{
+		this->close('}');
+	}
+
+	void writer::begin_array()
+	{
+		this->begin_value();
+		this->buffer_.push_back('[');
+		this->empty_.push_back(true);
+	}
+
+	void writer::end_array()
+	{
+		this->close(']');
+	}
+
+	void writer::begin_value()
+	{
+		// object members are separated by their key
+		if (std::exchange(this->after_key_, false) || this->empty_.empty())
+		{
+			return;
+		}
+
+		this->separate();
+	}
+
+	void writer::separate()
+	{
+		if (!this->empty_.back())
+		{
+			this->buffer_.push_back(',');
+		}
+
+		this->empty_.back() = false;
+
+		if (this->indent_ >= 0)
+		{
+			this->buffer_.push_back('\n');
+			this->buffer_.append(this->empty_.size() * this->indent_, ' ');
+		}
+	}
+
+	void writer::close(const char bracket)
+	{
+		const auto empty = this->empty_.back();
+		this->empty_.pop_back();
+
+		// empty containers stay on one line
+		if (!empty && this->indent_ >= 0)
+		{
+			this->buffer_.push_back('\n');
+			this->buffer_.append(this->empty_.size() * this->indent_, ' ');
+		}
+
+		this->buffer_.push_back(bracket);
+	}
+
+	void writer::write_escaped(const std::string_view text)
+	{
+		this->buffer_.push_back('"');
+
+		size_t run_start = 0;
+		size_t i = 0;
+
+		const auto flush = [&]
+		{
+			this->buffer_.append(text.data() + run_start, i - run_start);
+		};
+
+		while (i < text.size())
+		{
+			const auto c = static_cast<uint8_t>(text[i]);
+			if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80)
+			{
+				++i;
+				continue;
+			}
+
+			if (c >= 0x80)
+			{
+				const auto length = get_sequence_length(text.substr(i));
+				if (!length)
+				{
+					throw std::runtime_error(utils::string::va("invalid UTF-8 byte at index %zu: 0x%02X", i, c));
+				}
+
+				i += length;
+				continue;
+			}
+
+			flush();
+
+			switch (c)
+			{
+			case '"':
+				this->buffer_.append("\\\"");
+				break;
+			case '\\':
+				this->buffer_.append("\\\\");
+				break;
+			case '\b':
+				this->buffer_.append("\\b");
+				break;
+			case '\f':
+				this->buffer_.append("\\f");
+				break;
+			case '\n':
+				this->buffer_.append("\\n");
+				break;
+			case '\r':
+				this->buffer_.append("\\r");
+				break;
+			case '\t':
+				this->buffer_.append("\\t");
+				break;
+			default:
+				this->buffer_.append(utils::string::va("\\u%04x", c));
+				break;
+			}
+
+			run_start = ++i;
+		}
+
+		flush();
+		this->buffer_.push_back('"');
+	}
+}
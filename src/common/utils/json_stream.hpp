@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <json.hpp>
+
+#include "string.hpp"
+
+namespace utils::json
+{
+	// Writes json token by token, byte for byte what nlohmann::json::dump produces for the same document.
+	// Keys are written in the order they are given, dump sorts them. Invalid UTF-8 throws like dump does
+	class writer final
+	{
+	public:
+		// a negative indent writes everything on one line
+		explicit writer(std::string& buffer, int indent = -1);
+
+		void null();
+		void integer(int64_t value);
+		// non-finite values become null
+		void floating(double value);
+		void string(std::string_view text);
+
+		void begin_object();
+		void key(std::string_view key);
+		void end_object();
+
+		void begin_array();
+		void end_array();
+
+	private:
+		std::string& buffer_;
+		int indent_;
+		// one entry per open container, set until something was written into it
+		std::vector<bool> empty_;
+		bool after_key_ = false;
+
+		void begin_value();
+		void separate();
+		void close(char bracket);
+		void write_escaped(std::string_view text);
+	};
+
+	// Builds the caller's values straight from the parser's events instead of converting a nlohmann::json tree.
+	// Policy::value_type and Policy::container_type are the caller's types, every event goes through the policy:
+	// null, boolean, integer, floating, string, container(is_object), set(container, key, value),
+	// push(container, value) and finish(container)
+	template <typename Policy>
+	class value_builder final : public nlohmann::json_sax<nlohmann::json>
+	{
+	public:
+		using value_type = typename Policy::value_type;
+		using container_type = typename Policy::container_type;
+
+		explicit value_builder(Policy& policy, const size_t max_depth)
+			: policy_(policy)
+			, max_depth_(max_depth)
+		{
+		}
+
+		value_type take_result()
+		{
+			return std::move(this->result_);
+		}
+
+		bool null() override
+		{
+			return this->add(this->policy_.null());
+		}
+
+		bool boolean(const bool value) override
+		{
+			return this->add(this->policy_.boolean(value));
+		}
+
+		bool number_integer(const number_integer_t value) override
+		{
+			return this->add(this->policy_.integer(value));
+		}
+
+		bool number_unsigned(const number_unsigned_t value) override
+		{
+			return this->add(this->policy_.integer(static_cast<int64_t>(value)));
+		}
+
+		bool number_float(const number_float_t value, const string_t& /*text*/) override
+		{
+			return this->add(this->policy_.floating(value));
+		}
+
+		bool string(string_t& value) override
+		{
+			return this->add(this->policy_.string(value));
+		}
+
+		bool binary(binary_t& /*value*/) override
+		{
+			return this->add(this->policy_.null());
+		}
+
+		bool start_object(std::size_t /*elements*/) override
+		{
+			return this->push(true);
+		}
+
+		bool key(string_t& value) override
+		{
+			this->stack_.back().key = std::move(value);
+			return true;
+		}
+
+		bool end_object() override
+		{
+			return this->pop();
+		}
+
+		bool start_array(std::size_t /*elements*/) override
+		{
+			return this->push(false);
+		}
+
+		bool end_array() override
+		{
+			return this->pop();
+		}
+
+		bool parse_error(std::size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& ex) override
+		{
+			throw std::runtime_error(ex.what());
+		}
+
+	private:
+		struct frame
+		{
+			container_type container;
+			bool is_object;
+			std::string key;
+		};
+
+		Policy& policy_;
+		size_t max_depth_;
+		std::vector<frame> stack_;
+		value_type result_{};
+
+		bool add(value_type value)
+		{
+			if (this->stack_.empty())
+			{
+				this->result_ = std::move(value);
+				return true;
+			}
+
+			auto& current = this->stack_.back();
+			if (current.is_object)
+			{
+				this->policy_.set(current.container, current.key, std::move(value));
+			}
+			else
+			{
+				this->policy_.push(current.container, std::move(value));
+			}
+
+			return true;
+		}
+
+		bool push(const bool is_object)
+		{
+			if (this->stack_.size() >= this->max_depth_)
+			{
+				throw std::runtime_error(utils::string::va("json is nested deeper than %zu levels", this->max_depth_));
+			}
+
+			this->stack_.push_back({this->policy_.container(is_object), is_object, {}});
+			return true;
+		}
+
+		bool pop()
+		{
+			auto container = std::move(this->stack_.back().container);
+			this->stack_.pop_back();
+
+			return this->add(this->policy_.finish(std::move(container)));
+		}
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+namespace utils
+{
+	// Fixed capacity map that evicts the least recently used entry, not thread safe on its own
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class lru_cache
+	{
+	public:
+		explicit lru_cache(const std::size_t capacity)
+			: capacity_(capacity)
+		{
+		}
+
+		Value* find(const Key& key)
+		{
+			const auto itr = this->index_.find(key);
+			if (itr == this->index_.end())
+			{
+				return nullptr;
+			}
+
+			this->entries_.splice(this->entries_.begin(), this->entries_, itr->second);
+			return &itr->second->second;
+		}
+
+		std::optional<Value> get(const Key& key)
+		{
+			const auto* value = this->find(key);
+			if (!value)
+			{
+				return {};
+			}
+
+			return {*value};
+		}
+
+		Value& put(const Key& key, Value value)
+		{
+			if (auto* existing = this->find(key))
+			{
+				*existing = std::move(value);
+				return *existing;
+			}
+
+			if (this->capacity_ && this->entries_.size() >= this->capacity_)
+			{
+				this->index_.erase(this->entries_.back().first);
+				this->entries_.pop_back();
+			}
+
+			this->entries_.emplace_front(key, std::move(value));
+			this->index_[key] = this->entries_.begin();
+
+			return this->entries_.front().second;
+		}
+
+		bool erase(const Key& key)
+		{
+			const auto itr = this->index_.find(key);
+			if (itr == this->index_.end())
+			{
+				return false;
+			}
+
+			this->entries_.erase(itr->second);
+			this->index_.erase(itr);
+			return true;
+		}
+
+		void clear()
+		{
+			this->index_.clear();
+			this->entries_.clear();
+		}
+
+		std::size_t size() const
+		{
+			return this->entries_.size();
+		}
+
+		std::size_t capacity() const
+		{
+			return this->capacity_;
+		}
+
+	private:
+		using entry_list = std::list<std::pair<Key, Value>>;
+
+		std::size_t capacity_;
+		entry_list entries_;
+		std::unordered_map<Key, typename entry_list::iterator, Hash> index_;
+	};
+}
@@ -0,0 +1,256 @@
+#include "spatial_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+	namespace
+	{
+		float distance_to_plane(const spatial_grid::plane& plane, const float x, const float y, const float z)
+		{
+			return plane.normal[0] * x + plane.normal[1] * y + plane.normal[2] * z + plane.distance;
+		}
+
+		bool is_point_in_frustum(const spatial_grid::frustum& frustum, const float* origin, const float margin)
+		{
+			for (const auto& plane : frustum.planes)
+			{
+				if (distance_to_plane(plane, origin[0], origin[1], origin[2]) < -margin)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// the box is outside once its corner furthest along the normal is behind any plane
+		bool is_box_in_frustum(const spatial_grid::frustum& frustum, const float* mins, const float* maxs, const float margin)
+		{
+			for (const auto& plane : frustum.planes)
+			{
+				const auto x = plane.normal[0] >= 0.f ? maxs[0] : mins[0];
+				const auto y = plane.normal[1] >= 0.f ? maxs[1] : mins[1];
+				const auto z = plane.normal[2] >= 0.f ? maxs[2] : mins[2];
+
+				if (distance_to_plane(plane, x, y, z) < -margin)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	spatial_grid::spatial_grid(const float cell_size)
+		: cell_size_(std::max(cell_size, 1.f))
+		, inverse_cell_size_(1.f / this->cell_size_)
+	{
+	}
+
+	void spatial_grid::clear()
+	{
+		this->cells_.clear();
+		this->entries_.clear();
+		this->size_ = 0;
+	}
+
+	void spatial_grid::update(const uint32_t id, const float* origin)
+	{
+		if (id >= this->entries_.size())
+		{
+			this->entries_.resize(id + 1);
+		}
+
+		auto& entry = this->entries_[id];
+		const auto key = get_cell_key(this->get_coordinate(origin[0]), this->get_coordinate(origin[1]));
+
+		if (entry.valid && entry.cell_key != key)
+		{
+			this->remove_from_cell(entry);
+		}
+
+		entry.origin[0] = origin[0];
+		entry.origin[1] = origin[1];
+		entry.origin[2] = origin[2];
+
+		if (!entry.valid)
+		{
+			++this->size_;
+		}
+
+		const auto is_new = !entry.valid || entry.cell_key != key;
+		entry.valid = true;
+
+		auto& cell = this->cells_[key];
+		if (cell.ids.empty())
+		{
+			cell.min_z = origin[2];
+			cell.max_z = origin[2];
+		}
+		else
+		{
+			cell.min_z = std::min(cell.min_z, origin[2]);
+			cell.max_z = std::max(cell.max_z, origin[2]);
+		}
+
+		if (is_new)
+		{
+			entry.cell_key = key;
+			entry.index = static_cast<uint32_t>(cell.ids.size());
+			cell.ids.emplace_back(id);
+		}
+	}
+
+	void spatial_grid::remove(const uint32_t id)
+	{
+		if (id >= this->entries_.size() || !this->entries_[id].valid)
+		{
+			return;
+		}
+
+		auto& entry = this->entries_[id];
+		this->remove_from_cell(entry);
+
+		entry.valid = false;
+		--this->size_;
+	}
+
+	bool spatial_grid::contains(const uint32_t id) const
+	{
+		return id < this->entries_.size() && this->entries_[id].valid;
+	}
+
+	size_t spatial_grid::size() const
+	{
+		return this->size_;
+	}
+
+	void spatial_grid::query_radius(const float* center, const float radius, std::vector<uint32_t>& results) const
+	{
+		this->query(center, radius, [](const cell&, const float*)
+		{
+			return true;
+		}, [](const float*)
+		{
+			return true;
+		}, results);
+	}
+
+	void spatial_grid::query_frustum(const frustum& frustum, const float margin, const float* center, const float radius,
+		std::vector<uint32_t>& results) const
+	{
+		this->query(center, radius, [&](const cell& cell, const float* cell_mins)
+		{
+			const float mins[3] = {cell_mins[0], cell_mins[1], cell.min_z};
+			const float maxs[3] = {cell_mins[0] + this->cell_size_, cell_mins[1] + this->cell_size_, cell.max_z};
+
+			return is_box_in_frustum(frustum, mins, maxs, margin);
+		}, [&](const float* origin)
+		{
+			return is_point_in_frustum(frustum, origin, margin);
+		}, results);
+	}
+
+	int32_t spatial_grid::get_coordinate(const float value) const
+	{
+		return static_cast<int32_t>(std::floor(value * this->inverse_cell_size_));
+	}
+
+	uint64_t spatial_grid::get_cell_key(const int32_t x, const int32_t y)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+	}
+
+	void spatial_grid::remove_from_cell(entry& entry)
+	{
+		const auto itr = this->cells_.find(entry.cell_key);
+		if (itr == this->cells_.end())
+		{
+			return;
+		}
+
+		auto& ids = itr->second.ids;
+
+		// swap with the last id so removal doesn't shift the rest
+		const auto moved_id = ids.back();
+		ids[entry.index] = moved_id;
+		this->entries_[moved_id].index = entry.index;
+		ids.pop_back();
+
+		if (ids.empty())
+		{
+			this->cells_.erase(itr);
+		}
+	}
+
+	template <typename CellFilter, typename PointFilter>
+	void spatial_grid::query(const float* center, const float radius, CellFilter&& cell_filter, PointFilter&& point_filter,
+		std::vector<uint32_t>& results) const
+	{
+		if (!this->size_ || radius < 0.f)
+		{
+			return;
+		}
+
+		const auto min_x = this->get_coordinate(center[0] - radius);
+		const auto max_x = this->get_coordinate(center[0] + radius);
+		const auto min_y = this->get_coordinate(center[1] - radius);
+		const auto max_y = this->get_coordinate(center[1] + radius);
+
+		const auto radius_squared = radius * radius;
+
+		// a huge radius would visit lots of empty cells, walking the occupied ones is cheaper then
+		const auto cell_count = (static_cast<uint64_t>(max_x - min_x) + 1) * (static_cast<uint64_t>(max_y - min_y) + 1);
+
+		const auto visit_cell = [&](const cell& cell, const int32_t x, const int32_t y)
+		{
+			const float cell_mins[2] = {static_cast<float>(x) * this->cell_size_, static_cast<float>(y) * this->cell_size_};
+			if (!cell_filter(cell, cell_mins))
+			{
+				return;
+			}
+
+			for (const auto id : cell.ids)
+			{
+				const auto& origin = this->entries_[id].origin;
+				const auto dx = origin[0] - center[0];
+				const auto dy = origin[1] - center[1];
+
+				if (dx * dx + dy * dy < radius_squared && point_filter(origin))
+				{
+					results.emplace_back(id);
+				}
+			}
+		};
+
+		if (cell_count > this->cells_.size())
+		{
+			for (const auto& [key, cell] : this->cells_)
+			{
+				const auto x = static_cast<int32_t>(key >> 32);
+				const auto y = static_cast<int32_t>(key & 0xFFFFFFFF);
+
+				if (x >= min_x && x <= max_x && y >= min_y && y <= max_y)
+				{
+					visit_cell(cell, x, y);
+				}
+			}
+		}
+		else
+		{
+			for (auto x = min_x; x <= max_x; ++x)
+			{
+				for (auto y = min_y; y <= max_y; ++y)
+				{
+					if (const auto itr = this->cells_.find(get_cell_key(x, y)); itr != this->cells_.end())
+					{
+						visit_cell(itr->second, x, y);
+					}
+				}
+			}
+		}
+	}
+}
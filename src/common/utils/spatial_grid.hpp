@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace utils
+{
+	// Uniform grid over the xy plane for points identified by small integer ids.
+	// Ranges are measured in 2d like the debug overlays do, height only matters for frustum culling.
+	class spatial_grid
+	{
+	public:
+		// normalized plane, a point is inside if dot(normal, point) + distance >= 0
+		struct plane
+		{
+			float normal[3];
+			float distance;
+		};
+
+		struct frustum
+		{
+			plane planes[5];
+		};
+
+		explicit spatial_grid(float cell_size = 512.f);
+
+		void clear();
+		// inserts the id or moves it to its new position
+		void update(uint32_t id, const float* origin);
+		void remove(uint32_t id);
+
+		bool contains(uint32_t id) const;
+		size_t size() const;
+
+		// ids within radius of center on the xy plane, appended in no particular order
+		void query_radius(const float* center, float radius, std::vector<uint32_t>& results) const;
+		// like query_radius, additionally skips everything further than margin outside the frustum
+		void query_frustum(const frustum& frustum, float margin, const float* center, float radius,
+			std::vector<uint32_t>& results) const;
+
+	private:
+		struct cell
+		{
+			std::vector<uint32_t> ids;
+			// only grows until the cell is emptied, culling stays conservative
+			float min_z;
+			float max_z;
+		};
+
+		struct entry
+		{
+			float origin[3];
+			uint64_t cell_key;
+			uint32_t index;
+			bool valid;
+		};
+
+		float cell_size_;
+		float inverse_cell_size_;
+		size_t size_ = 0;
+
+		std::unordered_map<uint64_t, cell> cells_;
+		// indexed by id
+		std::vector<entry> entries_;
+
+		int32_t get_coordinate(float value) const;
+		static uint64_t get_cell_key(int32_t x, int32_t y);
+
+		void remove_from_cell(entry& entry);
+
+		template <typename CellFilter, typename PointFilter>
+		void query(const float* center, float radius, CellFilter&& cell_filter, PointFilter&& point_filter,
+			std::vector<uint32_t>& results) const;
+	};
+}
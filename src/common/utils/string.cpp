@@ -1,57 +1,261 @@
 #include "string.hpp"
-#include <sstream>
+#include <atomic>
 #include <cstdarg>
 #include <algorithm>
+#include <memory>
+
+#include <emmintrin.h>
 
 #include "nt.hpp"
 
 namespace utils::string
 {
+	namespace
+	{
+		struct va_slot
+		{
+			char inline_buffer[0x200];
+			std::unique_ptr<char[]> buffer;
+			size_t buffer_size;
+		};
+
+		struct va_arena
+		{
+			size_t current;
+			va_slot slots[8];
+		};
+
+		std::atomic_uint64_t va_grown{0};
+		std::atomic_uint64_t va_truncated{0};
+
+		const char* format_into(va_slot& slot, const char* format, va_list ap)
+		{
+			// once a slot grew its buffer is used for everything, long results are only formatted twice the first time
+			auto* target = slot.buffer ? slot.buffer.get() : slot.inline_buffer;
+			const auto target_size = slot.buffer ? slot.buffer_size : sizeof(slot.inline_buffer);
+
+			va_list copy;
+			va_copy(copy, ap);
+			const auto length = vsnprintf(target, target_size, format, copy);
+			va_end(copy);
+
+			if (length < 0)
+			{
+				target[0] = 0;
+				return target;
+			}
+
+			if (static_cast<size_t>(length) >= sizeof(slot.inline_buffer))
+			{
+				++va_grown;
+			}
+
+			const auto size = std::min(static_cast<size_t>(length) + 1, va_max_size);
+			if (size < static_cast<size_t>(length) + 1)
+			{
+				++va_truncated;
+			}
+
+			if (size <= target_size)
+			{
+				return target;
+			}
+
+			// kept for the next long result in this slot
+			slot.buffer = std::make_unique_for_overwrite<char[]>(size);
+			slot.buffer_size = size;
+
+			vsnprintf(slot.buffer.get(), size, format, ap);
+			return slot.buffer.get();
+		}
+
+		// 0x20 for every byte in A-Z (or a-z), 0 otherwise. Bytes above 0x7F are negative and never match.
+		__m128i get_case_mask(const __m128i chars, const char first, const char last)
+		{
+			const auto above_first = _mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(first - 1)));
+			const auto below_last = _mm_cmplt_epi8(chars, _mm_set1_epi8(static_cast<char>(last + 1)));
+
+			return _mm_and_si128(_mm_and_si128(above_first, below_last), _mm_set1_epi8(0x20));
+		}
+
+		__m128i fold_lower(const __m128i chars)
+		{
+			return _mm_or_si128(chars, get_case_mask(chars, 'A', 'Z'));
+		}
+
+		char fold_lower(const char c)
+		{
+			return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+		}
+
+		char fold_upper(const char c)
+		{
+			return (c >= 'a' && c <= 'z') ? static_cast<char>(c & ~0x20) : c;
+		}
+	}
+
 	const char* va(const char* fmt, ...)
 	{
-		static thread_local va_provider<8, 256> provider;
+		static thread_local va_arena arena{};
+
+		auto& slot = arena.slots[arena.current++ % std::size(arena.slots)];
 
 		va_list ap;
 		va_start(ap, fmt);
-
-		const char* result = provider.get(fmt, ap);
-
+		const auto* result = format_into(slot, fmt, ap);
 		va_end(ap);
+
 		return result;
 	}
 
+	va_stats get_va_stats()
+	{
+		return {va_grown.load(), va_truncated.load()};
+	}
+
+	tokenizer::tokenizer(const std::string_view text, const char delim)
+		: text_(text)
+		, delim_(delim)
+	{
+	}
+
+	bool tokenizer::next(std::string_view& token)
+	{
+		if (this->position_ >= this->text_.size())
+		{
+			return false;
+		}
+
+		const auto end = this->text_.find(this->delim_, this->position_);
+		if (end == std::string_view::npos)
+		{
+			token = this->text_.substr(this->position_);
+			this->position_ = this->text_.size();
+			return true;
+		}
+
+		token = this->text_.substr(this->position_, end - this->position_);
+		this->position_ = end + 1;
+		return true;
+	}
+
 	std::vector<std::string> split(const std::string& s, const char delim)
 	{
-		std::stringstream ss(s);
-		std::string item;
 		std::vector<std::string> elems;
+		elems.reserve(std::count(s.begin(), s.end(), delim) + 1);
 
-		while (std::getline(ss, item, delim))
+		tokenizer tokens(s, delim);
+		for (std::string_view token; tokens.next(token);)
 		{
-			elems.push_back(item); // elems.push_back(std::move(item)); // if C++11 (based on comment from @mchiasson)
+			elems.emplace_back(token);
 		}
 
 		return elems;
 	}
 
-	std::string to_lower(std::string text)
+	void to_lower_inplace(char* text, const size_t length)
 	{
-		std::transform(text.begin(), text.end(), text.begin(), [](const unsigned char input)
+		size_t i = 0;
+		for (; i + 16 <= length; i += 16)
 		{
-			return static_cast<char>(std::tolower(input));
-		});
+			const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(text + i), fold_lower(chars));
+		}
+
+		for (; i < length; ++i)
+		{
+			text[i] = fold_lower(text[i]);
+		}
+	}
 
+	void to_upper_inplace(char* text, const size_t length)
+	{
+		size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(text + i), _mm_xor_si128(chars, get_case_mask(chars, 'a', 'z')));
+		}
+
+		for (; i < length; ++i)
+		{
+			text[i] = fold_upper(text[i]);
+		}
+	}
+
+	std::string to_lower(std::string text)
+	{
+		to_lower_inplace(text.data(), text.size());
 		return text;
 	}
 
 	std::string to_upper(std::string text)
 	{
-		std::transform(text.begin(), text.end(), text.begin(), [](const unsigned char input)
+		to_upper_inplace(text.data(), text.size());
+		return text;
+	}
+
+	bool equals_ignore_case(const std::string_view a, const std::string_view b)
+	{
+		if (a.size() != b.size())
 		{
-			return static_cast<char>(std::toupper(input));
-		});
+			return false;
+		}
 
-		return text;
+		size_t i = 0;
+		for (; i + 16 <= a.size(); i += 16)
+		{
+			const auto chars_a = fold_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i)));
+			const auto chars_b = fold_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i)));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(chars_a, chars_b)) != 0xFFFF)
+			{
+				return false;
+			}
+		}
+
+		for (; i < a.size(); ++i)
+		{
+			if (fold_lower(a[i]) != fold_lower(b[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	size_t hash_ignore_case(const std::string_view text)
+	{
+		// FNV-1a over the lowered bytes, folded 16 at a time
+		uint64_t hash = 0xCBF29CE484222325;
+
+		alignas(16) char folded[16];
+
+		for (size_t i = 0; i < text.size(); i += sizeof(folded))
+		{
+			const auto count = std::min(text.size() - i, sizeof(folded));
+			if (count == sizeof(folded))
+			{
+				const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+				_mm_store_si128(reinterpret_cast<__m128i*>(folded), fold_lower(chars));
+			}
+			else
+			{
+				for (size_t j = 0; j < count; ++j)
+				{
+					folded[j] = fold_lower(text[i + j]);
+				}
+			}
+
+			for (size_t j = 0; j < count; ++j)
+			{
+				hash ^= static_cast<uint8_t>(folded[j]);
+				hash *= 0x100000001B3;
+			}
+		}
+
+		return static_cast<size_t>(hash);
 	}
 
 	bool starts_with(const std::string& text, const std::string& substring)
@@ -212,7 +416,12 @@ namespace utils::string
 
 	bool find_lower(const std::string& a, const std::string& b)
 	{
-		return to_lower(a).find(to_lower(b)) != std::string::npos;
+		const auto itr = std::search(a.begin(), a.end(), b.begin(), b.end(), [](const char x, const char y)
+		{
+			return fold_lower(x) == fold_lower(y);
+		});
+
+		return itr != a.end() || b.empty();
 	}
 
 	bool strstr_lower(const char* a, const char* b)
@@ -1,6 +1,9 @@
 #pragma once
 #include "memory.hpp"
 #include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #ifndef ARRAYSIZE
 template <class Type, size_t n>
@@ -9,81 +12,67 @@ size_t ARRAYSIZE(Type (&)[n]) { return n; }
 
 namespace utils::string
 {
-	template <size_t Buffers, size_t MinBufferSize>
-	class va_provider final
+	struct va_stats
+	{
+		// results that didn't fit into the inline storage of their slot
+		uint64_t grown;
+		// results cut off at va_max_size
+		uint64_t truncated;
+	};
+
+	// Every thread formats into a ring of 8 slots, a result stays valid for the next 7 calls on that thread.
+	// Longer results are truncated to va_max_size - 1 characters.
+	constexpr size_t va_max_size = 0x10000;
+
+	const char* va(const char* fmt, ...);
+	va_stats get_va_stats();
+
+	// Splits without allocating, an empty token after the last delimiter is dropped like std::getline does
+	class tokenizer final
 	{
 	public:
-		static_assert(Buffers != 0 && MinBufferSize != 0, "Buffers and MinBufferSize mustn't be 0");
+		tokenizer(std::string_view text, char delim);
 
-		va_provider() : current_buffer_(0)
-		{
-		}
+		bool next(std::string_view& token);
 
-		char* get(const char* format, const va_list ap)
-		{
-			++this->current_buffer_ %= ARRAYSIZE(this->string_pool_);
-			auto entry = &this->string_pool_[this->current_buffer_];
+	private:
+		std::string_view text_;
+		char delim_;
+		size_t position_ = 0;
+	};
 
-			if (!entry->size || !entry->buffer)
-			{
-				throw std::runtime_error("String pool not initialized");
-			}
+	std::vector<std::string> split(const std::string& s, char delim);
 
-			while (true)
-			{
-				const int res = vsnprintf_s(entry->buffer, entry->size, _TRUNCATE, format, ap);
-				if (res > 0) break; // Success
-				if (res == 0) return nullptr; // Error
+	// ASCII only, same as tolower/toupper in the C locale
+	void to_lower_inplace(char* text, size_t length);
+	void to_upper_inplace(char* text, size_t length);
+	std::string to_lower(std::string text);
+	std::string to_upper(std::string text);
 
-				entry->double_size();
-			}
+	bool equals_ignore_case(std::string_view a, std::string_view b);
+	size_t hash_ignore_case(std::string_view text);
 
-			return entry->buffer;
-		}
+	// for unordered containers keyed case-insensitively
+	struct hash_case_insensitive
+	{
+		using is_transparent = void;
 
-	private:
-		class entry final
+		size_t operator()(const std::string_view text) const
 		{
-		public:
-			explicit entry(const size_t _size = MinBufferSize) : size(_size), buffer(nullptr)
-			{
-				if (this->size < MinBufferSize) this->size = MinBufferSize;
-				this->allocate();
-			}
-
-			~entry()
-			{
-				if (this->buffer) memory::get_allocator()->free(this->buffer);
-				this->size = 0;
-				this->buffer = nullptr;
-			}
-
-			void allocate()
-			{
-				if (this->buffer) memory::get_allocator()->free(this->buffer);
-				this->buffer = memory::get_allocator()->allocate_array<char>(this->size + 1);
-			}
-
-			void double_size()
-			{
-				this->size *= 2;
-				this->allocate();
-			}
-
-			size_t size;
-			char* buffer;
-		};
-
-		size_t current_buffer_;
-		entry string_pool_[Buffers];
+			return hash_ignore_case(text);
+		}
 	};
 
-	const char* va(const char* fmt, ...);
+	struct equal_case_insensitive
+	{
+		using is_transparent = void;
 
-	std::vector<std::string> split(const std::string& s, char delim);
+		bool operator()(const std::string_view a, const std::string_view b) const
+		{
+			return equals_ignore_case(a, b);
+		}
+	};
 
-	std::string to_lower(std::string text);
-	std::string to_upper(std::string text);
 	bool starts_with(const std::string& text, const std::string& substring);
 	bool ends_with(const std::string& text, const std::string& substring);
 
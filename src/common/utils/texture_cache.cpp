@@ -0,0 +1,394 @@
+#include "texture_cache.hpp"
+#include "compression.hpp"
+#include "cryptography.hpp"
+#include "image.hpp"
+#include "io.hpp"
+
+#include <cstring>
+
+namespace utils
+{
+	namespace
+	{
+		constexpr uint32_t disk_magic = 0x31435854; // TXC1, zlib compressed pixels
+		constexpr auto disk_extension = ".txc";
+
+		struct disk_header
+		{
+			uint32_t magic;
+			int32_t width;
+			int32_t height;
+		};
+
+		std::string hash_data(const std::string& data)
+		{
+			return cryptography::sha1::compute(data, true);
+		}
+
+		size_t get_texture_size(const texture_cache::texture_ptr& texture)
+		{
+			return texture ? texture->pixels.size() : 0;
+		}
+	}
+
+	texture_cache::texture_cache(const size_t max_bytes, const size_t worker_count, std::string disk_directory,
+		const int max_persistent_dimension, const size_t max_disk_bytes)
+		: max_bytes_(max_bytes)
+		, disk_directory_(std::move(disk_directory))
+		, max_persistent_dimension_(max_persistent_dimension)
+	{
+		if (max_disk_bytes && !this->disk_directory_.empty() && io::directory_exists(this->disk_directory_))
+		{
+			io::prune_directory(this->disk_directory_, max_disk_bytes);
+		}
+
+		for (size_t i = 0; i < worker_count; ++i)
+		{
+			this->workers_.emplace_back([this]()
+			{
+				this->work();
+			});
+		}
+	}
+
+	texture_cache::~texture_cache()
+	{
+		this->stop();
+	}
+
+	void texture_cache::submit(const std::string& name, std::string data, const bool persistent)
+	{
+		auto hash = hash_data(data);
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+
+			auto& image = this->names_[name];
+			image.hash = hash;
+			image.data = std::make_shared<const std::string>(std::move(data));
+			image.persistent = persistent;
+
+			if (this->stopping_ || this->workers_.empty() || this->index_.contains(hash)
+				|| this->pending_.contains(hash) || this->failed_.contains(hash))
+			{
+				return;
+			}
+
+			this->pending_.emplace(hash);
+			this->jobs_.emplace_back(std::move(hash), image.data, persistent);
+		}
+
+		this->work_condition_.notify_one();
+	}
+
+	bool texture_cache::contains(const std::string& name)
+	{
+		std::lock_guard<std::mutex> _(this->mutex_);
+		return this->names_.contains(name);
+	}
+
+	texture_cache::texture_ptr texture_cache::get(const std::string& name)
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+
+		const auto image = this->names_.find(name);
+		if (image == this->names_.end())
+		{
+			return {};
+		}
+
+		const job job{image->second.hash, image->second.data, image->second.persistent};
+		return this->wait_or_load(lock, job);
+	}
+
+	texture_cache::texture_ptr texture_cache::get_or_decode(std::string data)
+	{
+		auto hash = hash_data(data);
+		const job job{std::move(hash), std::make_shared<const std::string>(std::move(data)), false};
+
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		return this->wait_or_load(lock, job);
+	}
+
+	void texture_cache::stop()
+	{
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->stopping_ = true;
+
+			// waiters decode these themselves
+			for (const auto& job : this->jobs_)
+			{
+				this->pending_.erase(job.hash);
+			}
+
+			this->jobs_.clear();
+		}
+
+		this->work_condition_.notify_all();
+		this->decoded_condition_.notify_all();
+
+		for (auto& worker : this->workers_)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+	}
+
+	size_t texture_cache::get_used_bytes()
+	{
+		std::lock_guard<std::mutex> _(this->mutex_);
+		return this->used_bytes_;
+	}
+
+	texture_cache::texture_ptr texture_cache::decode(const std::string& data, const int max_dimension)
+	{
+		const image decoded(data);
+
+		auto texture = std::make_shared<texture_cache::texture>();
+		texture->width = decoded.get_width();
+		texture->height = decoded.get_height();
+		texture->pixels = decoded.get_data();
+
+		if (max_dimension > 0 && (texture->width > max_dimension || texture->height > max_dimension))
+		{
+			return downscale(*texture, max_dimension);
+		}
+
+		return texture;
+	}
+
+	texture_cache::texture_ptr texture_cache::downscale(const texture& texture, const int max_dimension)
+	{
+		auto result = std::make_shared<texture_cache::texture>(texture);
+
+		// halve with a 2x2 box filter until it fits, odd edges reuse their last row/column
+		while (max_dimension > 0 && (result->width > max_dimension || result->height > max_dimension))
+		{
+			const auto width = std::max(result->width / 2, 1);
+			const auto height = std::max(result->height / 2, 1);
+
+			std::string pixels;
+			pixels.resize(static_cast<size_t>(width) * height * 4);
+
+			const auto* source = reinterpret_cast<const uint8_t*>(result->pixels.data());
+			auto* target = reinterpret_cast<uint8_t*>(pixels.data());
+
+			for (auto y = 0; y < height; ++y)
+			{
+				const auto y0 = std::min(y * 2, result->height - 1);
+				const auto y1 = std::min(y * 2 + 1, result->height - 1);
+
+				for (auto x = 0; x < width; ++x)
+				{
+					const auto x0 = std::min(x * 2, result->width - 1);
+					const auto x1 = std::min(x * 2 + 1, result->width - 1);
+
+					for (auto c = 0; c < 4; ++c)
+					{
+						const auto sum = source[(static_cast<size_t>(y0) * result->width + x0) * 4 + c]
+							+ source[(static_cast<size_t>(y0) * result->width + x1) * 4 + c]
+							+ source[(static_cast<size_t>(y1) * result->width + x0) * 4 + c]
+							+ source[(static_cast<size_t>(y1) * result->width + x1) * 4 + c];
+
+						target[(static_cast<size_t>(y) * width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+
+			result->width = width;
+			result->height = height;
+			result->pixels = std::move(pixels);
+		}
+
+		return result;
+	}
+
+	void texture_cache::work()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+
+		while (true)
+		{
+			this->work_condition_.wait(lock, [this]()
+			{
+				return this->stopping_ || !this->jobs_.empty();
+			});
+
+			if (this->stopping_)
+			{
+				return;
+			}
+
+			const auto job = std::move(this->jobs_.front());
+			this->jobs_.pop_front();
+
+			lock.unlock();
+			const auto texture = this->load(job);
+			lock.lock();
+
+			if (texture)
+			{
+				this->insert(job.hash, texture);
+			}
+			else
+			{
+				this->failed_.emplace(job.hash);
+			}
+
+			this->pending_.erase(job.hash);
+			this->decoded_condition_.notify_all();
+		}
+	}
+
+	texture_cache::texture_ptr texture_cache::load(const job& job)
+	{
+		const auto persistent = job.persistent && !this->disk_directory_.empty();
+		if (persistent)
+		{
+			if (auto texture = this->read_from_disk(job.hash))
+			{
+				return texture;
+			}
+		}
+
+		try
+		{
+			auto texture = decode(*job.data, persistent ? this->max_persistent_dimension_ : 0);
+			if (persistent)
+			{
+				this->write_to_disk(job.hash, *texture);
+			}
+
+			return texture;
+		}
+		catch (...)
+		{
+			return {};
+		}
+	}
+
+	texture_cache::texture_ptr texture_cache::wait_or_load(std::unique_lock<std::mutex>& lock, const job& job)
+	{
+		this->decoded_condition_.wait(lock, [&]()
+		{
+			return !this->pending_.contains(job.hash);
+		});
+
+		if (auto texture = this->find(job.hash))
+		{
+			return texture;
+		}
+
+		if (this->failed_.contains(job.hash))
+		{
+			return {};
+		}
+
+		// evicted or never submitted, decoding twice in parallel is cheaper than blocking here
+		lock.unlock();
+		auto texture = this->load(job);
+		lock.lock();
+
+		if (texture)
+		{
+			this->insert(job.hash, texture);
+		}
+		else
+		{
+			this->failed_.emplace(job.hash);
+		}
+
+		return texture;
+	}
+
+	texture_cache::texture_ptr texture_cache::find(const std::string& hash)
+	{
+		const auto itr = this->index_.find(hash);
+		if (itr == this->index_.end())
+		{
+			return {};
+		}
+
+		this->entries_.splice(this->entries_.begin(), this->entries_, itr->second);
+		return itr->second->second;
+	}
+
+	void texture_cache::insert(const std::string& hash, const texture_ptr& texture)
+	{
+		if (const auto itr = this->index_.find(hash); itr != this->index_.end())
+		{
+			this->used_bytes_ -= get_texture_size(itr->second->second);
+			this->entries_.erase(itr->second);
+			this->index_.erase(itr);
+		}
+
+		// the newest texture is always kept, even if it's bigger than the whole cache
+		const auto size = get_texture_size(texture);
+		while (!this->entries_.empty() && this->used_bytes_ + size > this->max_bytes_)
+		{
+			this->used_bytes_ -= get_texture_size(this->entries_.back().second);
+			this->index_.erase(this->entries_.back().first);
+			this->entries_.pop_back();
+		}
+
+		this->entries_.emplace_front(hash, texture);
+		this->index_[hash] = this->entries_.begin();
+		this->used_bytes_ += size;
+	}
+
+	std::string texture_cache::get_disk_path(const std::string& hash) const
+	{
+		return this->disk_directory_ + "/" + hash + disk_extension;
+	}
+
+	texture_cache::texture_ptr texture_cache::read_from_disk(const std::string& hash) const
+	{
+		const auto path = this->get_disk_path(hash);
+
+		std::string data;
+		if (!io::read_file(path, &data) || data.size() < sizeof(disk_header))
+		{
+			return {};
+		}
+
+		disk_header header{};
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		if (header.magic != disk_magic || header.width <= 0 || header.height <= 0)
+		{
+			return {};
+		}
+
+		auto pixels = compression::zlib::decompress(data.substr(sizeof(header)));
+		if (pixels.size() != static_cast<size_t>(header.width) * header.height * 4)
+		{
+			return {};
+		}
+
+		// keeps it from being pruned first
+		io::touch_file(path);
+
+		auto texture = std::make_shared<texture_cache::texture>();
+		texture->width = header.width;
+		texture->height = header.height;
+		texture->pixels = std::move(pixels);
+
+		return texture;
+	}
+
+	void texture_cache::write_to_disk(const std::string& hash, const texture& texture) const
+	{
+		const disk_header header{disk_magic, texture.width, texture.height};
+		const auto pixels = compression::zlib::compress(texture.pixels);
+
+		std::string data;
+		data.reserve(sizeof(header) + pixels.size());
+		data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+		data.append(pixels);
+
+		io::write_file_atomic(this->get_disk_path(hash), data);
+	}
+}
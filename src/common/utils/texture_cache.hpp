@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace utils
+{
+	// Decoded RGBA images keyed by the hash of their encoded data, bounded by the size of the pixels.
+	// Named images are decoded on worker threads as soon as they are submitted, so users only have to upload them.
+	class texture_cache final
+	{
+	public:
+		struct texture
+		{
+			int width;
+			int height;
+			std::string pixels;
+		};
+
+		using texture_ptr = std::shared_ptr<const texture>;
+
+		// Persistent images are shrunk to max_persistent_dimension and stored decoded and compressed in disk_directory.
+		// The least recently used ones are deleted on construction once the directory grows past max_disk_bytes.
+		texture_cache(size_t max_bytes, size_t worker_count, std::string disk_directory = {}, int max_persistent_dimension = 0,
+			size_t max_disk_bytes = 0);
+		~texture_cache();
+
+		texture_cache(texture_cache&&) = delete;
+		texture_cache(const texture_cache&) = delete;
+		texture_cache& operator=(texture_cache&&) = delete;
+		texture_cache& operator=(const texture_cache&) = delete;
+
+		// the name refers to the new data right away, decoding happens in the background
+		void submit(const std::string& name, std::string data, bool persistent = false);
+		bool contains(const std::string& name);
+
+		// waits for a pending decode, decodes on the calling thread if the image was evicted
+		// returns null for unknown names and data that can't be decoded
+		texture_ptr get(const std::string& name);
+
+		// for unnamed data, decodes on the calling thread unless the same data was decoded before
+		texture_ptr get_or_decode(std::string data);
+
+		// joins the workers, submitted images are decoded on first use from then on
+		void stop();
+
+		size_t get_used_bytes();
+
+		static texture_ptr decode(const std::string& data, int max_dimension = 0);
+		static texture_ptr downscale(const texture& texture, int max_dimension);
+
+	private:
+		struct named_image
+		{
+			std::string hash;
+			std::shared_ptr<const std::string> data;
+			bool persistent;
+		};
+
+		struct job
+		{
+			std::string hash;
+			std::shared_ptr<const std::string> data;
+			bool persistent;
+		};
+
+		using entry_list = std::list<std::pair<std::string, texture_ptr>>;
+
+		size_t max_bytes_;
+		std::string disk_directory_;
+		int max_persistent_dimension_;
+
+		std::mutex mutex_;
+		std::condition_variable work_condition_;
+		std::condition_variable decoded_condition_;
+
+		std::unordered_map<std::string, named_image> names_;
+		std::unordered_map<std::string, entry_list::iterator> index_;
+		entry_list entries_;
+		size_t used_bytes_ = 0;
+
+		std::unordered_set<std::string> pending_;
+		std::unordered_set<std::string> failed_;
+		std::deque<job> jobs_;
+		bool stopping_ = false;
+
+		std::vector<std::thread> workers_;
+
+		void work();
+		texture_ptr load(const job& job);
+		texture_ptr wait_or_load(std::unique_lock<std::mutex>& lock, const job& job);
+
+		texture_ptr find(const std::string& hash);
+		void insert(const std::string& hash, const texture_ptr& texture);
+
+		std::string get_disk_path(const std::string& hash) const;
+		texture_ptr read_from_disk(const std::string& hash) const;
+		void write_to_disk(const std::string& hash, const texture& texture) const;
+	};
+}
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <utils/delta.hpp>
+#include <utils/io.hpp>
+
+// Adds deltas from previous releases to an updater manifest.
+//
+// usage: manifest-tool <manifest.json> <new_dir> <out_dir> <old_manifest.json> <old_dir> [<old_manifest.json> <old_dir>...]
+//
+// Every file of the manifest that changed since one of the old releases gets a delta written to
+// <out_dir>/deltas/<name>.<old hash>.<new hash>.delta, the manifest with the delta entries is written to <out_dir>.
+// Deltas that don't save at least a quarter of the download are skipped.
+
+namespace
+{
+	struct old_release
+	{
+		nlohmann::json manifest;
+		std::filesystem::path directory;
+	};
+
+	nlohmann::json read_manifest(const std::string& file)
+	{
+		std::string data{};
+		if (!utils::io::read_file(file, &data))
+		{
+			throw std::runtime_error("Unable to read " + file);
+		}
+
+		auto manifest = nlohmann::json::parse(data);
+		if (!manifest.is_object() || !manifest["files"].is_array())
+		{
+			throw std::runtime_error("Invalid manifest " + file);
+		}
+
+		return manifest;
+	}
+
+	const nlohmann::json* find_file(const nlohmann::json& manifest, const std::string& name)
+	{
+		for (const auto& entry : manifest["files"])
+		{
+			if (entry.is_array() && entry.size() >= 3 && entry[0] == name)
+			{
+				return &entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void add_deltas(nlohmann::json& entry, const std::filesystem::path& new_directory,
+		const std::filesystem::path& out_directory, const std::vector<old_release>& old_releases)
+	{
+		const auto name = entry[0].get<std::string>();
+		const auto size = entry[1].get<uint64_t>();
+		const auto hash = entry[2].get<std::string>();
+
+		const utils::io::mapped_file target((new_directory / name).string());
+		if (!target.is_open() || target.size() != size)
+		{
+			throw std::runtime_error("Missing or outdated file " + name);
+		}
+
+		auto deltas = nlohmann::json::array();
+		std::unordered_set<std::string> added_hashes{};
+
+		for (const auto& release : old_releases)
+		{
+			const auto* old_entry = find_file(release.manifest, name);
+			if (!old_entry)
+			{
+				continue;
+			}
+
+			const auto old_hash = (*old_entry)[2].get<std::string>();
+			if (old_hash == hash || added_hashes.contains(old_hash))
+			{
+				continue;
+			}
+
+			const utils::io::mapped_file source((release.directory / name).string());
+			if (!source.is_open())
+			{
+				std::printf("Skipping %s from %s, the old file is missing\n", name.data(), old_hash.data());
+				continue;
+			}
+
+			const auto delta = utils::delta::create(source.view(), target.view());
+			if (delta.size() > size / 4 * 3)
+			{
+				std::printf("Skipping %s from %s, delta is %zu of %llu bytes\n", name.data(), old_hash.data(), delta.size(), size);
+				continue;
+			}
+
+			const auto delta_file = out_directory / "deltas" / (name + "." + old_hash + "." + hash + ".delta");
+			if (!utils::io::write_file(delta_file.string(), delta))
+			{
+				throw std::runtime_error("Unable to write " + delta_file.string());
+			}
+
+			std::printf("%s from %s: %zu of %llu bytes\n", name.data(), old_hash.data(), delta.size(), size);
+
+			deltas.push_back({old_hash, delta.size()});
+			added_hashes.emplace(old_hash);
+		}
+
+		while (entry.size() > 3)
+		{
+			entry.erase(entry.size() - 1);
+		}
+
+		if (!deltas.empty())
+		{
+			entry.push_back(std::move(deltas));
+		}
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	if (argc < 6 || (argc - 4) % 2)
+	{
+		std::printf("usage: %s <manifest.json> <new_dir> <out_dir> <old_manifest.json> <old_dir> [<old_manifest.json> <old_dir>...]\n", argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		auto manifest = read_manifest(argv[1]);
+		const std::filesystem::path new_directory = argv[2];
+		const std::filesystem::path out_directory = argv[3];
+
+		std::vector<old_release> old_releases{};
+		for (auto i = 4; i + 1 < argc; i += 2)
+		{
+			old_releases.emplace_back(read_manifest(argv[i]), argv[i + 1]);
+		}
+
+		for (auto& entry : manifest["files"])
+		{
+			if (entry.is_array() && entry.size() >= 3)
+			{
+				add_deltas(entry, new_directory, out_directory, old_releases);
+			}
+		}
+
+		const auto out_manifest = out_directory / std::filesystem::path(argv[1]).filename();
+		if (!utils::io::write_file(out_manifest.string(), manifest.dump()))
+		{
+			throw std::runtime_error("Unable to write " + out_manifest.string());
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::printf("Error: %s\n", e.what());
+		return 1;
+	}
+
+	return 0;
+}
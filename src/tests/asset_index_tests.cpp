@@ -0,0 +1,218 @@
+#include <std_include.hpp>
+
+#include "game/asset_index.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// a small stand-in for db_hashTable and g_assetEntryPool, slot 0 terminates the chains like in the game
+	class asset_table
+	{
+	public:
+		static constexpr std::size_t bucket_count = 7;
+
+		asset_table()
+			: pool_(256)
+		{
+		}
+
+		game::asset_index create_index()
+		{
+			return game::asset_index(this->buckets_.data(), bucket_count, this->pool_.data(), [](const game::XAsset* asset)
+			{
+				return static_cast<const char*>(asset->header.data);
+			});
+		}
+
+		// same as DB_LinkXAssetEntry: a new asset goes to the front of its bucket, an existing one
+		// gets overridden by putting the new entry into the chain and hanging the old one off of it
+		game::XAssetEntry* link(const game::XAssetType type, const char* name)
+		{
+			const auto index = this->allocate(type, name);
+			auto& bucket = this->buckets_[get_bucket(name)];
+
+			for (auto* next = &bucket; *next; next = &this->pool_[*next].nextHash)
+			{
+				auto& existing = this->pool_[*next];
+				if (existing.asset.type != type || std::strcmp(static_cast<const char*>(existing.asset.header.data), name))
+				{
+					continue;
+				}
+
+				this->pool_[index].nextHash = existing.nextHash;
+				this->pool_[index].nextOverride = *next;
+				existing.nextHash = 0;
+				*next = index;
+
+				return &this->pool_[index];
+			}
+
+			this->pool_[index].nextHash = bucket;
+			bucket = index;
+
+			return &this->pool_[index];
+		}
+
+		// the same asset loaded twice with the entry keeping its slot, the previous data is copied behind it
+		game::XAssetEntry* link_in_place(const game::XAssetType type, const char* name)
+		{
+			auto& bucket = this->buckets_[get_bucket(name)];
+
+			for (auto i = bucket; i; i = this->pool_[i].nextHash)
+			{
+				auto& existing = this->pool_[i];
+				if (existing.asset.type != type || std::strcmp(static_cast<const char*>(existing.asset.header.data), name))
+				{
+					continue;
+				}
+
+				const auto copy = this->allocate(type, name);
+				this->pool_[copy].nextOverride = existing.nextOverride;
+				existing.nextOverride = copy;
+
+				return &existing;
+			}
+
+			return this->link(type, name);
+		}
+
+		// drops every asset of the given name, what unloading its zone would do
+		void unlink(const char* name)
+		{
+			for (auto* next = &this->buckets_[get_bucket(name)]; *next;)
+			{
+				auto& existing = this->pool_[*next];
+				if (std::strcmp(static_cast<const char*>(existing.asset.header.data), name))
+				{
+					next = &existing.nextHash;
+					continue;
+				}
+
+				*next = existing.nextHash;
+			}
+		}
+
+	private:
+		std::array<unsigned int, bucket_count> buckets_{};
+		std::vector<game::XAssetEntry> pool_;
+		unsigned int next_free_ = 1;
+
+		static std::size_t get_bucket(const std::string_view name)
+		{
+			return std::hash<std::string_view>()(name) % bucket_count;
+		}
+
+		unsigned int allocate(const game::XAssetType type, const char* name)
+		{
+			const auto index = this->next_free_++;
+
+			auto& entry = this->pool_.at(index);
+			entry.asset.type = type;
+			entry.asset.header.data = const_cast<char*>(name);
+
+			return index;
+		}
+	};
+
+	std::vector<std::string> get_names(game::asset_index& index, const game::XAssetType type, const bool include_override)
+	{
+		std::vector<std::string> names;
+		index.enum_entries(type, [&](const game::XAssetEntry* entry)
+		{
+			names.emplace_back(static_cast<const char*>(entry->asset.header.data));
+		}, include_override);
+
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	std::size_t verify(game::asset_index& index)
+	{
+		std::vector<std::string> errors;
+		const auto mismatches = index.verify(&errors);
+
+		for (const auto& error : errors)
+		{
+			printf("  %s\n", error.data());
+		}
+
+		return mismatches;
+	}
+}
+
+TEST_CASE(asset_index_tracks_links)
+{
+	asset_table table;
+	auto index = table.create_index();
+
+	// builds the index from the table the first time it's used
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "maps/mp/a.gsc"));
+	REQUIRE(index.count(game::ASSET_TYPE_RAWFILE) == 1);
+
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "maps/mp/b.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "scripts/c.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_STRINGTABLE, "mp/table.csv"));
+
+	CHECK(verify(index) == 0);
+	CHECK(index.count(game::ASSET_TYPE_RAWFILE) == 3);
+	CHECK(index.count(game::ASSET_TYPE_STRINGTABLE) == 1);
+
+	std::vector<std::string> prefixed;
+	index.enum_entries(game::ASSET_TYPE_RAWFILE, "maps/", [&](const game::XAssetEntry* entry)
+	{
+		prefixed.emplace_back(static_cast<const char*>(entry->asset.header.data));
+	}, false);
+
+	std::sort(prefixed.begin(), prefixed.end());
+	CHECK(prefixed == std::vector<std::string>({"maps/mp/a.gsc", "maps/mp/b.gsc"}));
+}
+
+TEST_CASE(asset_index_overrides_are_not_listed)
+{
+	asset_table table;
+	auto index = table.create_index();
+	CHECK(index.count(game::ASSET_TYPE_RAWFILE) == 0);
+
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "a.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "b.gsc"));
+
+	// the old heads of a.gsc end up behind the new entry, they must not be enumerated on their own
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "a.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "a.gsc"));
+	index.on_link(table.link_in_place(game::ASSET_TYPE_RAWFILE, "b.gsc"));
+
+	CHECK(verify(index) == 0);
+	CHECK(index.count(game::ASSET_TYPE_RAWFILE) == 2);
+	CHECK(get_names(index, game::ASSET_TYPE_RAWFILE, false) == std::vector<std::string>({"a.gsc", "b.gsc"}));
+	CHECK(get_names(index, game::ASSET_TYPE_RAWFILE, true) == std::vector<std::string>({"a.gsc", "a.gsc", "a.gsc", "b.gsc", "b.gsc"}));
+
+	// the sorted names are rebuilt without the moved entries as well
+	auto prefixed = 0;
+	index.enum_entries(game::ASSET_TYPE_RAWFILE, "a", [&](const game::XAssetEntry*)
+	{
+		++prefixed;
+	}, false);
+
+	CHECK(prefixed == 1);
+}
+
+TEST_CASE(asset_index_rebuilds_after_invalidate)
+{
+	asset_table table;
+	auto index = table.create_index();
+
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "a.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "b.gsc"));
+	index.on_link(table.link(game::ASSET_TYPE_RAWFILE, "b.gsc"));
+	CHECK(index.count(game::ASSET_TYPE_RAWFILE) == 2);
+
+	table.unlink("b.gsc");
+
+	// nothing tells the index about the unlink until the zone unload invalidates it
+	CHECK(index.verify() > 0);
+
+	index.invalidate();
+	CHECK(verify(index) == 0);
+	CHECK(get_names(index, game::ASSET_TYPE_RAWFILE, true) == std::vector<std::string>({"a.gsc"}));
+}
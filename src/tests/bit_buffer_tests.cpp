@@ -0,0 +1,147 @@
+#include <std_include.hpp>
+
+#include "game/demonware/bit_buffer.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// the straightforward bit by bit layout the word based implementation has to match
+	class reference_bits
+	{
+	public:
+		void write(const unsigned int bits, const void* data)
+		{
+			const auto* bytes = static_cast<const unsigned char*>(data);
+			for (auto i = 0u; i < bits; ++i)
+			{
+				this->bits_.push_back((bytes[i >> 3] >> (i & 7)) & 1);
+			}
+		}
+
+		std::string get_buffer() const
+		{
+			std::string buffer((this->bits_.size() + 7) / 8, '\0');
+			for (std::size_t i = 0; i < this->bits_.size(); ++i)
+			{
+				if (this->bits_[i])
+				{
+					buffer[i >> 3] = static_cast<char>(buffer[i >> 3] | (1 << (i & 7)));
+				}
+			}
+
+			return buffer;
+		}
+
+	private:
+		std::vector<bool> bits_;
+	};
+
+	std::string make_data(const unsigned int bits, const unsigned int seed)
+	{
+		std::string data((bits + 7) / 8, '\0');
+		for (std::size_t i = 0; i < data.size(); ++i)
+		{
+			data[i] = static_cast<char>((seed + i) * 0x9E3779B1u >> 13);
+		}
+
+		return data;
+	}
+
+	// the bits of the value that were actually written, everything past them is zero
+	std::string truncate(std::string data, const unsigned int bits)
+	{
+		if (bits & 7)
+		{
+			data.back() = static_cast<char>(data.back() & ((1 << (bits & 7)) - 1));
+		}
+
+		return data;
+	}
+}
+
+TEST_CASE(bit_buffer_matches_reference_layout)
+{
+	// every width up to a few words, starting at every bit offset
+	std::vector<unsigned int> widths;
+	for (auto bits = 1u; bits <= 200; ++bits)
+	{
+		widths.push_back(bits);
+		widths.push_back(1 + bits % 7);
+	}
+
+	demonware::bit_buffer buffer;
+	buffer.set_use_data_types(false);
+	reference_bits reference;
+
+	for (auto i = 0u; i < widths.size(); ++i)
+	{
+		const auto data = make_data(widths[i], i);
+		REQUIRE(buffer.write(widths[i], data.data()));
+		reference.write(widths[i], data.data());
+	}
+
+	const auto written = buffer.get_buffer();
+	REQUIRE(written == reference.get_buffer());
+
+	demonware::bit_buffer reader(written);
+	reader.set_use_data_types(false);
+
+	for (auto i = 0u; i < widths.size(); ++i)
+	{
+		std::string output((widths[i] + 7) / 8, '\xFF');
+		REQUIRE(reader.read(widths[i], output.data()));
+		CHECK(output == truncate(make_data(widths[i], i), widths[i]));
+	}
+
+	// only the padding of the last byte is left
+	char overflow = 0;
+	CHECK(!reader.read(8, &overflow));
+}
+
+TEST_CASE(bit_buffer_typed_round_trip)
+{
+	demonware::bit_buffer buffer;
+	buffer.write_bool(true);
+	buffer.write_uint32(0xDEADBEEF);
+	buffer.write_bytes(5, "hello");
+	buffer.write_bool(false);
+	buffer.write_uint32(7);
+
+	demonware::bit_buffer reader(buffer.get_buffer());
+
+	bool flag = false;
+	unsigned int value = 0;
+	unsigned char bytes[5]{};
+
+	REQUIRE(reader.read_bool(&flag));
+	CHECK(flag);
+	REQUIRE(reader.read_uint32(&value));
+	CHECK(value == 0xDEADBEEF);
+	REQUIRE(reader.read_bytes(5, bytes));
+	CHECK(std::memcmp(bytes, "hello", 5) == 0);
+	REQUIRE(reader.read_bool(&flag));
+	CHECK(!flag);
+	REQUIRE(reader.read_uint32(&value));
+	CHECK(value == 7);
+
+	// a bool is read where a uint32 was written
+	demonware::bit_buffer mismatch(buffer.get_buffer());
+	CHECK(!mismatch.read_uint32(&value));
+}
+
+TEST_CASE(bit_buffer_overwrites_unaligned_tail)
+{
+	// bits past the write position keep their value when a chunk shares their word
+	demonware::bit_buffer buffer(std::string(16, '\xFF'));
+	buffer.set_use_data_types(false);
+
+	const unsigned char zero[2]{};
+	REQUIRE(buffer.write(3, zero));
+	REQUIRE(buffer.write(10, zero));
+
+	const auto& data = buffer.get_buffer();
+	REQUIRE(data.size() == 2);
+	CHECK(data[0] == 0);
+	CHECK(static_cast<unsigned char>(data[1]) == 0xE0);
+}
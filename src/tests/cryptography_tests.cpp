@@ -0,0 +1,94 @@
+#include <std_include.hpp>
+
+#include <utils/cryptography.hpp>
+#include <utils/string.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	std::string from_hex(const std::string_view hex)
+	{
+		std::string data;
+		for (std::size_t i = 0; i + 1 < hex.size(); i += 2)
+		{
+			data.push_back(static_cast<char>(std::stoi(std::string(hex.substr(i, 2)), nullptr, 16)));
+		}
+
+		return data;
+	}
+
+	std::string to_hex(const std::string& data)
+	{
+		return utils::string::dump_hex(data, "");
+	}
+
+	// NIST SP 800-38A F.2.1/F.2.2, CBC-AES128
+	const auto cbc_key = from_hex("2b7e151628aed2a6abf7158809cf4f3c");
+	const auto cbc_iv = from_hex("000102030405060708090a0b0c0d0e0f");
+	const auto cbc_plain = from_hex(
+		"6bc1bee22e409f96e93d7e117393172a"
+		"ae2d8a571e03ac9c9eb76fac45af8e51"
+		"30c81c46a35ce411e5fbc1191a0a52ef"
+		"f69f2445df4f9b17ad2b417be66c3710");
+	const auto cbc_cipher = from_hex(
+		"7649abac8119b246cee98e9b12e9197d"
+		"5086cb9b507219ee95db113a917678b2"
+		"73bed6b8e3c1743b7116e69e22229516"
+		"3ff1caa1681fac09120eca307586e1a7");
+}
+
+TEST_CASE(aes_cbc_known_answer)
+{
+	CHECK(utils::cryptography::aes::encrypt(cbc_plain, cbc_iv, cbc_key) == cbc_cipher);
+	CHECK(utils::cryptography::aes::decrypt(cbc_cipher, cbc_iv, cbc_key) == cbc_plain);
+
+	// every block on its own, chained through the previous ciphertext
+	for (auto i = 0u; i < 4; ++i)
+	{
+		const auto iv = i ? cbc_cipher.substr((i - 1) * 16, 16) : cbc_iv;
+		CHECK(utils::cryptography::aes::encrypt(cbc_plain.substr(i * 16, 16), iv, cbc_key) == cbc_cipher.substr(i * 16, 16));
+		CHECK(utils::cryptography::aes::decrypt(cbc_cipher.substr(i * 16, 16), iv, cbc_key) == cbc_plain.substr(i * 16, 16));
+	}
+}
+
+TEST_CASE(aes_cbc_round_trip)
+{
+	const utils::cryptography::aes::context context(cbc_key);
+	REQUIRE(context.is_valid());
+
+	// lengths around the four block interleaving of the decryption
+	for (auto blocks = 1u; blocks <= 9; ++blocks)
+	{
+		std::string plain;
+		for (auto i = 0u; i < blocks * 16; ++i)
+		{
+			plain.push_back(static_cast<char>(i * 31 + blocks));
+		}
+
+		const auto cipher = context.encrypt(plain, cbc_iv);
+		CHECK(cipher != plain);
+		CHECK(context.decrypt(cipher, cbc_iv) == plain);
+
+		auto in_place = plain;
+		REQUIRE(context.encrypt(reinterpret_cast<uint8_t*>(in_place.data()), in_place.size(), cbc_iv));
+		CHECK(in_place == cipher);
+	}
+}
+
+TEST_CASE(sha1_known_answer)
+{
+	// FIPS 180-2 appendix A
+	CHECK(to_hex(utils::cryptography::sha1::compute("abc")) == "A9993E364706816ABA3E25717850C26C9CD0D89D");
+	CHECK(to_hex(utils::cryptography::sha1::compute("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+		"84983E441C3BD26EBAAE4AA1F95129E5E54670F1");
+}
+
+TEST_CASE(hmac_sha1_known_answer)
+{
+	// RFC 2202 test cases 2 and 6, the second key is longer than a block and gets hashed first
+	CHECK(to_hex(utils::cryptography::hmac_sha1::compute("what do ya want for nothing?", "Jefe")) ==
+		"EFFCDF6AE5EB2FA2D27416D5F184DF9C259A7C79");
+	CHECK(to_hex(utils::cryptography::hmac_sha1::compute("Test Using Larger Than Block-Size Key - Hash Key First",
+		std::string(80, '\xAA'))) == "AA4AE5E15272D00E95705637CE8A3B55ED402112");
+}
@@ -0,0 +1,88 @@
+#include <random>
+#include <string>
+
+#include <utils/delta.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	std::string generate_data(const size_t size, const uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::string data(size, '\0');
+
+		for (auto& c : data)
+		{
+			c = static_cast<char>(random());
+		}
+
+		return data;
+	}
+
+	bool apply(const std::string& source, const std::string& delta, std::string* target)
+	{
+		target->clear();
+		return utils::delta::apply(source, delta, [&](const std::string_view data)
+		{
+			target->append(data);
+			return true;
+		});
+	}
+}
+
+TEST_CASE(delta_roundtrip)
+{
+	const auto source = generate_data(0x100000, 1);
+
+	// an insertion, a changed block and a removal, chunking has to resync after each of them
+	auto target = source;
+	target.insert(0x1000, "inserted");
+	target.replace(0x40000, 0x800, generate_data(0x800, 2));
+	target.erase(0x80000, 0x3000);
+
+	const auto delta = utils::delta::create(source, target);
+	CHECK(delta.size() < target.size() / 4);
+
+	std::string result;
+	CHECK(apply(source, delta, &result));
+	CHECK(result == target);
+}
+
+TEST_CASE(delta_edge_cases)
+{
+	const auto data = generate_data(0x10000, 3);
+	std::string result;
+
+	CHECK(apply("", utils::delta::create("", data), &result) && result == data);
+	CHECK(apply(data, utils::delta::create(data, ""), &result) && result.empty());
+	CHECK(apply(data, utils::delta::create(data, data), &result) && result == data);
+}
+
+TEST_CASE(delta_rejects_wrong_input)
+{
+	const auto source = generate_data(0x20000, 4);
+	auto target = source;
+	target[0x100] ^= 1;
+
+	const auto delta = utils::delta::create(source, target);
+	std::string result;
+
+	// applied to a different file
+	auto other_source = source;
+	other_source[0x8000] ^= 1;
+	CHECK(!apply(other_source, delta, &result));
+
+	// damaged and truncated deltas
+	auto damaged = delta;
+	damaged[damaged.size() / 2] ^= 0x55;
+	CHECK(!apply(source, damaged, &result));
+	CHECK(!apply(source, delta.substr(0, delta.size() / 2), &result));
+	CHECK(!apply(source, "", &result));
+
+	// the writer can abort
+	CHECK(!utils::delta::apply(source, delta, [](std::string_view)
+	{
+		return false;
+	}));
+}
@@ -0,0 +1,125 @@
+#include <std_include.hpp>
+
+#include "updater/delta_update.hpp"
+
+#include <utils/delta.hpp>
+#include <utils/io.hpp>
+
+#include "http_server.hpp"
+#include "test.hpp"
+
+namespace
+{
+	std::string make_version(const size_t size, const int version)
+	{
+		std::string data(size, '\0');
+		for (size_t i = 0; i < size; ++i)
+		{
+			data[i] = static_cast<char>(i * 31 + i / 7);
+		}
+
+		// a few edits spread over the file
+		for (auto i = 0; i < version; ++i)
+		{
+			data.replace(size / 4 * i + 100, 10, "0123456789");
+		}
+
+		return data;
+	}
+}
+
+TEST_CASE(delta_update_applies_from_server)
+{
+	const auto old_version = make_version(0x40000, 1);
+	const auto new_version = make_version(0x40000, 3);
+	const auto delta = utils::delta::create(old_version, new_version);
+
+	test::http_server server([&](const test::http_server::request& request)
+	{
+		if (request.path == "/file.delta")
+		{
+			return test::http_server::response{200, {}, delta};
+		}
+
+		return test::http_server::response{404};
+	});
+
+	const auto file = test::get_temp_directory() + "/file.bin";
+	REQUIRE(utils::io::write_file(file, old_version));
+
+	std::string verified{};
+	const auto result = updater::apply_delta(file, server.get_url("/file.delta"), delta.size(), [&](const std::string& patched_file)
+	{
+		verified = utils::io::read_file(patched_file);
+		return true;
+	});
+
+	CHECK(result == updater::delta_result::applied);
+	CHECK(verified == new_version);
+	CHECK(utils::io::read_file(file) == new_version);
+	CHECK(!utils::io::file_exists(file + ".delta"));
+}
+
+TEST_CASE(delta_update_keeps_the_file_on_failure)
+{
+	const auto old_version = make_version(0x40000, 1);
+	const auto new_version = make_version(0x40000, 3);
+	const auto delta = utils::delta::create(old_version, new_version);
+
+	test::http_server server([&](const test::http_server::request& request)
+	{
+		if (request.path == "/file.delta")
+		{
+			return test::http_server::response{200, {}, delta};
+		}
+
+		if (request.path == "/truncated.delta")
+		{
+			return test::http_server::response{200, {}, delta.substr(0, delta.size() / 2)};
+		}
+
+		return test::http_server::response{404};
+	});
+
+	const auto file = test::get_temp_directory() + "/file.bin";
+	const auto accept = [](const std::string&)
+	{
+		return true;
+	};
+
+	const auto check_untouched = [&](const std::string& expected)
+	{
+		CHECK(utils::io::read_file(file) == expected);
+		CHECK(!utils::io::file_exists(file + ".delta"));
+	};
+
+	REQUIRE(utils::io::write_file(file, old_version));
+
+	// missing on the server or a different size than the manifest says
+	CHECK(updater::apply_delta(file, server.get_url("/missing.delta"), delta.size(), accept) == updater::delta_result::download_failed);
+	CHECK(updater::apply_delta(file, server.get_url("/file.delta"), delta.size() + 1, accept) == updater::delta_result::download_failed);
+	check_untouched(old_version);
+
+	// the verification rejects the patched copy
+	CHECK(updater::apply_delta(file, server.get_url("/file.delta"), delta.size(), [](const std::string&)
+	{
+		return false;
+	}) == updater::delta_result::apply_failed);
+	check_untouched(old_version);
+
+	// a corrupt delta
+	CHECK(updater::apply_delta(file, server.get_url("/truncated.delta"), delta.size() / 2, accept) == updater::delta_result::apply_failed);
+	check_untouched(old_version);
+
+	// the local file isn't the version the delta was made for
+	const auto other_version = make_version(0x40000, 2);
+	REQUIRE(utils::io::write_file(file, other_version));
+	CHECK(updater::apply_delta(file, server.get_url("/file.delta"), delta.size(), accept) == updater::delta_result::apply_failed);
+	check_untouched(other_version);
+
+	// no local file at all
+	REQUIRE(utils::io::remove_file(file));
+	CHECK(updater::apply_delta(file, server.get_url("/file.delta"), delta.size(), accept) == updater::delta_result::apply_failed);
+	CHECK(!utils::io::file_exists(file));
+	CHECK(!utils::io::file_exists(file + ".delta"));
+}
@@ -0,0 +1,74 @@
+#include <std_include.hpp>
+
+#include "utils/display_name.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	const display_name::tag_icons icons{{"H2M", "^\x01@@\x02h2"}};
+}
+
+TEST_CASE(display_name_layout)
+{
+	CHECK(display_name::build({"player", "", "", 0}, icons) == "player");
+	CHECK(display_name::build({"player", "ABC", "", 0}, icons) == "[ABC]player");
+	// custom tags are swapped for their icon
+	CHECK(display_name::build({"player", "H2M", "", 0}, icons) == "[^\x01@@\x02h2]player");
+
+	// the elite tag wins when it's enabled or there is no clan tag, its style picks the color
+	CHECK(display_name::build({"player", "", "ELT", 0}, icons) == "player");
+	CHECK(display_name::build({"player", "ABC", "ELT", 1}, icons) == "[ELT]player");
+	CHECK(display_name::build({"player", "ABC", "ELT", 2}, icons) == "[^3ELT^7]player");
+	CHECK(display_name::build({"player", "ABC", "ELT", 3}, icons) == "[^1ELT^7]player");
+	CHECK(display_name::build({"player", "ABC", "ELT", 4}, icons) == "player");
+	CHECK(display_name::build({"player", "ABC", "", 2}, icons) == "player");
+}
+
+TEST_CASE(display_name_cache_invalidation)
+{
+	display_name::cache cache{2};
+
+	display_name::fields fields{"player", "ABC", "", 0};
+	CHECK(cache.get(0, fields, icons) == "[ABC]player");
+	CHECK(cache.get(0, fields, icons) == "[ABC]player");
+	CHECK(cache.get_stats().builds == 1);
+
+	// every field on its own invalidates the cached name
+	fields.name = "renamed";
+	CHECK(cache.get(0, fields, icons) == "[ABC]renamed");
+
+	fields.clan_abbrev = "H2M";
+	CHECK(cache.get(0, fields, icons) == "[^\x01@@\x02h2]renamed");
+
+	fields.elite_clan_tag_text = "ELT";
+	CHECK(cache.get(0, fields, icons) == "[^\x01@@\x02h2]renamed");
+
+	fields.use_elite_clan_tag = 2;
+	CHECK(cache.get(0, fields, icons) == "[^3ELT^7]renamed");
+
+	CHECK(cache.get_stats().builds == 5);
+
+	// clients are cached separately
+	CHECK(cache.get(1, {"other", "", "", 0}, icons) == "other");
+	CHECK(cache.get(0, fields, icons) == "[^3ELT^7]renamed");
+
+	const auto stats = cache.get_stats();
+	CHECK(stats.lookups == 8);
+	CHECK(stats.builds == 6);
+
+	cache.reset_stats();
+	CHECK(cache.get_stats().lookups == 0);
+}
+
+TEST_CASE(display_name_cache_copies_fields)
+{
+	display_name::cache cache{1};
+
+	// the game rewrites the clientInfo_t buffers in place, the cache must not keep views into them
+	char name[16] = "first";
+	CHECK(cache.get(0, {name, "", "", 0}, icons) == "first");
+
+	std::memcpy(name, "other", 6);
+	CHECK(cache.get(0, {name, "", "", 0}, icons) == "other");
+}
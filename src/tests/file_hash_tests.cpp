@@ -0,0 +1,180 @@
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include <utils/cryptography.hpp>
+#include <utils/file_hash.hpp>
+#include <utils/io.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	std::string make_data(const size_t size)
+	{
+		std::string data(size, '\0');
+		for (size_t i = 0; i < size; ++i)
+		{
+			data[i] = static_cast<char>(i * 31 + i / 7);
+		}
+
+		return data;
+	}
+}
+
+TEST_CASE(file_hash_matches_whole_file_hash)
+{
+	const auto directory = test::get_temp_directory();
+
+	// empty, smaller than a chunk, exactly two chunks and a partial last chunk
+	for (const auto size : {size_t(0), size_t(100), size_t(0x2000), size_t(0x2801)})
+	{
+		const auto file = directory + "/" + std::to_string(size) + ".bin";
+		const auto data = make_data(size);
+		REQUIRE(utils::io::write_file(file, data));
+
+		utils::file_hash::hasher hasher{{}, 0x1000};
+		const auto result = hasher.compute(file);
+
+		CHECK(result.success);
+		CHECK(!result.cached);
+		CHECK(result.size == size);
+		CHECK(result.hash == utils::cryptography::sha256::compute(data, true));
+	}
+
+	utils::file_hash::hasher hasher{};
+	CHECK(!hasher.compute(directory + "/missing.bin").success);
+	CHECK(!hasher.compute(directory).success);
+}
+
+TEST_CASE(file_hash_cache)
+{
+	const auto directory = test::get_temp_directory();
+	const auto cache_file = directory + "/hashes.json";
+	const auto file = directory + "/zone.ff";
+
+	REQUIRE(utils::io::write_file(file, make_data(0x5000)));
+
+	{
+		utils::file_hash::hasher hasher{cache_file};
+		CHECK(!hasher.compute(file).cached);
+		CHECK(hasher.compute(file).cached);
+		hasher.save_cache();
+	}
+
+	// loaded from disk by a new hasher
+	utils::file_hash::hasher hasher{cache_file};
+	const auto cached = hasher.compute(file);
+	CHECK(cached.cached);
+	CHECK(cached.hash == utils::cryptography::sha256::compute(make_data(0x5000), true));
+
+	// same size, only the modification time tells the change
+	auto data = make_data(0x5000);
+	data[0] ^= 1;
+	REQUIRE(utils::io::write_file(file, data));
+	std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + std::chrono::seconds(10));
+
+	const auto changed = hasher.compute(file);
+	CHECK(!changed.cached);
+	CHECK(changed.hash == utils::cryptography::sha256::compute(data, true));
+}
+
+TEST_CASE(file_hash_compute_many)
+{
+	const auto directory = test::get_temp_directory();
+
+	std::vector<std::string> files;
+	for (auto i = 0; i < 9; ++i)
+	{
+		files.emplace_back(directory + "/" + std::to_string(i) + ".bin");
+		REQUIRE(utils::io::write_file(files.back(), make_data(0x1000 * i + i)));
+	}
+
+	files.emplace_back(directory + "/missing.bin");
+
+	utils::file_hash::hasher hasher{};
+	const auto results = hasher.compute_many(files, 4);
+
+	// results stay in the order of the files
+	REQUIRE(results.size() == files.size());
+	for (auto i = 0; i < 9; ++i)
+	{
+		CHECK(results[i].success);
+		CHECK(results[i].hash == utils::cryptography::sha256::compute(make_data(0x1000 * i + i), true));
+	}
+
+	CHECK(!results.back().success);
+}
+
+TEST_CASE(file_hash_benchmark)
+{
+	// a zone folder in miniature, raise file_size for a multi-GB run
+	constexpr auto file_count = 4;
+	constexpr auto file_size = size_t(64) * 1024 * 1024;
+
+	const auto directory = test::get_temp_directory();
+
+	std::vector<std::string> files;
+	const auto data = make_data(file_size);
+	for (auto i = 0; i < file_count; ++i)
+	{
+		files.emplace_back(directory + "/" + std::to_string(i) + ".ff");
+		REQUIRE(utils::io::write_file(files.back(), data));
+	}
+
+	const auto expected = utils::cryptography::sha256::compute(data, true);
+	constexpr auto total_mb = static_cast<double>(file_count * file_size) / (1024 * 1024);
+
+	// the files were just written, this measures hashing with a warm page cache
+	const auto measure = [&](const char* label, const std::function<void()>& function)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		printf("  %-22s %6.0f MB/s\n", label, total_mb / seconds);
+	};
+
+	measure("read, then hash", [&]()
+	{
+		for (const auto& file : files)
+		{
+			CHECK(utils::cryptography::sha256::compute(utils::io::read_file(file), true) == expected);
+		}
+	});
+
+	utils::file_hash::hasher hasher{directory + "/hashes.json"};
+
+	measure("streamed", [&]()
+	{
+		for (const auto& file : files)
+		{
+			const auto result = hasher.compute(file);
+			CHECK(!result.cached);
+			CHECK(result.hash == expected);
+		}
+	});
+
+	utils::file_hash::hasher parallel_hasher{};
+
+	measure("streamed, 4 files", [&]()
+	{
+		for (const auto& result : parallel_hasher.compute_many(files, 4))
+		{
+			CHECK(result.hash == expected);
+		}
+	});
+
+	hasher.save_cache();
+	utils::file_hash::hasher cached_hasher{directory + "/hashes.json"};
+
+	measure("cached", [&]()
+	{
+		for (const auto& result : cached_hasher.compute_many(files, 4))
+		{
+			CHECK(result.cached);
+			CHECK(result.hash == expected);
+		}
+	});
+}
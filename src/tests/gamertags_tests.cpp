@@ -0,0 +1,125 @@
+#include <std_include.hpp>
+
+#include "utils/gamertags.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	struct row
+	{
+		std::string tag;
+		std::string discord_id;
+	};
+
+	// what the table looks like: most members have a single tag, a few staff ids hold the umbrella tags
+	std::vector<row> create_table(const std::size_t row_count)
+	{
+		constexpr const char* row_tags[] = {"SM2", "VER", "SM2", "H2M", "VER", "SM2", "VER", "HMW"};
+
+		std::vector<row> rows;
+		rows.reserve(row_count);
+
+		for (std::size_t i = 0; i < row_count; ++i)
+		{
+			rows.push_back({row_tags[i % std::size(row_tags)], std::to_string(100000000000000000ull + i * 7919)});
+		}
+
+		return rows;
+	}
+
+	// the per connect walk over every row the index replaced
+	bool scan_table(const std::vector<row>& rows, const std::string& tag, const std::string& discord_id)
+	{
+		for (const auto& row : rows)
+		{
+			if (row.discord_id == discord_id &&
+				(row.tag == "HMW" || (row.tag == "H2M" && tag != "HMW") || row.tag == tag))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+TEST_CASE(gamertags_rules)
+{
+	gamertags::index index;
+	index.add("SM2", "1");
+	index.add("VER", "1");
+	index.add("H2M", "2");
+	index.add("HMW", "3");
+
+	CHECK(index.size() == 3);
+
+	CHECK(index.is_allowed("SM2", "1"));
+	CHECK(index.is_allowed("VER", "1"));
+	CHECK(!index.is_allowed("H2M", "1"));
+
+	// H2M covers everything but HMW, HMW covers everything
+	CHECK(index.is_allowed("SM2", "2"));
+	CHECK(index.is_allowed("H2M", "2"));
+	CHECK(!index.is_allowed("HMW", "2"));
+	CHECK(index.is_allowed("HMW", "3"));
+
+	CHECK(!index.is_allowed("SM2", "4"));
+
+	index.clear();
+	CHECK(!index.is_allowed("SM2", "1"));
+}
+
+TEST_CASE(gamertags_large_table)
+{
+	const auto rows = create_table(100000);
+
+	const auto build_start = std::chrono::steady_clock::now();
+
+	gamertags::index index;
+	for (const auto& row : rows)
+	{
+		index.add(row.tag, row.discord_id);
+	}
+
+	const auto build_time = std::chrono::steady_clock::now() - build_start;
+	CHECK(index.size() == rows.size());
+
+	// ids spread over the table, plus ones that aren't in it
+	std::vector<std::string> ids;
+	for (std::size_t i = 0; i < rows.size(); i += 997)
+	{
+		ids.push_back(rows[i].discord_id);
+		ids.push_back(rows[i].discord_id + "0");
+	}
+
+	constexpr const char* checked_tags[] = {"SM2", "VER", "H2M", "HMW"};
+
+	auto index_time = std::chrono::steady_clock::duration{};
+	auto scan_time = std::chrono::steady_clock::duration{};
+
+	for (const auto& id : ids)
+	{
+		for (const auto* tag : checked_tags)
+		{
+			const auto index_start = std::chrono::steady_clock::now();
+			const auto allowed = index.is_allowed(tag, id);
+			index_time += std::chrono::steady_clock::now() - index_start;
+
+			const auto scan_start = std::chrono::steady_clock::now();
+			const auto expected = scan_table(rows, tag, id);
+			scan_time += std::chrono::steady_clock::now() - scan_start;
+
+			REQUIRE(allowed == expected);
+		}
+	}
+
+	const auto lookups = ids.size() * std::size(checked_tags);
+	const auto to_us = [](const std::chrono::steady_clock::duration duration)
+	{
+		return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	};
+
+	printf("  %zu rows indexed in %lld us, %zu lookups: index %lld us, scan %lld us\n", rows.size(), to_us(build_time),
+		lookups, to_us(index_time), to_us(scan_time));
+}
@@ -0,0 +1,195 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <utils/histogram.hpp>
+
+#include "test.hpp"
+
+TEST_CASE(histogram_exact_small_values)
+{
+	utils::histogram histogram;
+	CHECK(histogram.get_percentile(50) == 0);
+
+	for (uint64_t value = 0; value < 8; ++value)
+	{
+		histogram.record(value);
+	}
+
+	CHECK(histogram.get_count() == 8);
+	CHECK(histogram.get_sum() == 28);
+	CHECK(histogram.get_max() == 7);
+
+	CHECK(histogram.get_percentile(0) == 0);
+	CHECK(histogram.get_percentile(50) == 3);
+	CHECK(histogram.get_percentile(100) == 7);
+}
+
+TEST_CASE(histogram_percentile_error)
+{
+	utils::histogram histogram;
+
+	for (uint64_t value = 1; value <= 100000; ++value)
+	{
+		histogram.record(value);
+	}
+
+	// reported values are the upper bound of a bucket, at most 12.5% above the real percentile
+	for (const auto percentile : {1.0, 50.0, 90.0, 99.0, 99.9})
+	{
+		const auto expected = static_cast<uint64_t>(100000 * percentile / 100);
+		const auto reported = histogram.get_percentile(percentile);
+
+		CHECK(reported >= expected);
+		CHECK(reported <= expected + expected / 8);
+	}
+
+	CHECK(histogram.get_percentile(100) == 100000);
+
+	histogram.reset();
+	CHECK(histogram.get_count() == 0);
+	CHECK(histogram.get_max() == 0);
+	CHECK(histogram.get_percentile(99) == 0);
+}
+
+TEST_CASE(histogram_large_values)
+{
+	utils::histogram histogram;
+	histogram.record(UINT64_MAX);
+	histogram.record(1ull << 40);
+
+	CHECK(histogram.get_percentile(50) >= (1ull << 40));
+	CHECK(histogram.get_percentile(50) <= (1ull << 40) + (1ull << 37));
+	CHECK(histogram.get_percentile(100) == UINT64_MAX);
+}
+
+namespace
+{
+	using clock = std::chrono::high_resolution_clock;
+
+	struct scheduled_task
+	{
+		std::function<bool()> handler{};
+		std::chrono::milliseconds interval{};
+		clock::time_point last_call{};
+		utils::histogram* durations{};
+	};
+
+	// the task loop of scheduler::task_pipeline::execute before tasks were timed, a clock read per task
+	void execute_untimed(std::vector<scheduled_task>& tasks)
+	{
+		for (auto& task : tasks)
+		{
+			const auto now = clock::now();
+			if (now - task.last_call < task.interval)
+			{
+				continue;
+			}
+
+			task.last_call = now;
+			task.handler();
+		}
+	}
+
+	// and with per task and per tick histograms, the end of a task being the start of the next
+	void execute_timed(std::vector<scheduled_task>& tasks, utils::histogram& tick_durations,
+		const std::atomic_bool& trace_active, size_t& traced)
+	{
+		const auto start = clock::now();
+		auto now = start;
+
+		for (auto& task : tasks)
+		{
+			if (now - task.last_call < task.interval)
+			{
+				continue;
+			}
+
+			task.last_call = now;
+			task.handler();
+
+			const auto end = clock::now();
+			task.durations->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - now).count()));
+
+			if (trace_active.load())
+			{
+				++traced;
+			}
+
+			now = end;
+		}
+
+		tick_durations.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()));
+	}
+}
+
+TEST_CASE(histogram_scheduler_overhead)
+{
+	constexpr auto task_count = 50;
+	constexpr auto tick_count = 4000;
+
+	// tasks doing a microsecond or two of work, about what a game task does on a quiet tick
+	uint32_t state = 1;
+	const auto work = [&state]()
+	{
+		for (auto i = 0; i < 400; ++i)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+		}
+
+		return true;
+	};
+
+	std::vector<utils::histogram> task_durations(task_count);
+	utils::histogram tick_durations;
+	const std::atomic_bool trace_active{false};
+	size_t traced = 0;
+
+	std::vector<scheduled_task> tasks;
+	for (auto i = 0; i < task_count; ++i)
+	{
+		tasks.push_back({work, {}, {}, &task_durations[i]});
+	}
+
+	const auto measure = [&](const std::function<void()>& tick)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0; i < tick_count; ++i)
+		{
+			tick();
+		}
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (tick_count * task_count);
+	};
+
+	// interleaved, best of several rounds, the machine's noise is well above the difference otherwise
+	auto untimed = std::numeric_limits<double>::max();
+	auto timed = std::numeric_limits<double>::max();
+
+	for (auto round = 0; round < 7; ++round)
+	{
+		untimed = std::min(untimed, measure([&]()
+		{
+			execute_untimed(tasks);
+		}));
+
+		timed = std::min(timed, measure([&]()
+		{
+			execute_timed(tasks, tick_durations, trace_active, traced);
+		}));
+	}
+
+	const auto overhead = (timed - untimed) / untimed * 100.0;
+	printf("  %-20s %.1f ns/task\n", "untimed", untimed);
+	printf("  %-20s %.1f ns/task, %+.2f%%\n", "timed", timed, overhead);
+
+	CHECK(tick_durations.get_count() == 7 * tick_count);
+	CHECK(task_durations[0].get_count() == 7 * tick_count);
+	CHECK(overhead < 1.0);
+	CHECK(traced == 0);
+	CHECK(state != 0);
+}
@@ -0,0 +1,211 @@
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <utils/http_cache.hpp>
+#include <utils/io.hpp>
+
+#include "http_server.hpp"
+#include "test.hpp"
+
+TEST_CASE(http_cache_revalidates_with_etag)
+{
+	std::mutex mutex;
+	std::string etag = "\"v1\"";
+	std::string body = "first";
+	std::vector<std::string> conditions;
+
+	test::http_server server([&](const test::http_server::request& request)
+	{
+		std::lock_guard<std::mutex> _(mutex);
+
+		const auto condition = request.headers.find("if-none-match");
+		conditions.emplace_back(condition == request.headers.end() ? "" : condition->second);
+
+		if (condition != request.headers.end() && condition->second == etag)
+		{
+			return test::http_server::response{304};
+		}
+
+		return test::http_server::response{200, {{"ETag", etag}}, body};
+	});
+
+	utils::http::cache cache(test::get_temp_directory() + "/http");
+	const auto url = server.get_url("/image.png");
+
+	CHECK(cache.get(url) == "first");
+	// unchanged, the cached copy is served after a 304
+	CHECK(cache.get(url) == "first");
+
+	{
+		std::lock_guard<std::mutex> _(mutex);
+		etag = "\"v2\"";
+		body = "second";
+	}
+
+	CHECK(cache.get(url) == "second");
+	CHECK(cache.get(url) == "second");
+
+	REQUIRE(conditions.size() == 4);
+	CHECK(conditions[0].empty());
+	CHECK(conditions[1] == "\"v1\"");
+	CHECK(conditions[2] == "\"v1\"");
+	CHECK(conditions[3] == "\"v2\"");
+}
+
+TEST_CASE(http_cache_revalidates_with_last_modified)
+{
+	constexpr auto last_modified = "Wed, 21 Oct 2015 07:28:00 GMT";
+
+	test::http_server server([&](const test::http_server::request& request)
+	{
+		if (const auto condition = request.headers.find("if-modified-since");
+			condition != request.headers.end() && condition->second == last_modified)
+		{
+			return test::http_server::response{304};
+		}
+
+		return test::http_server::response{200, {{"Last-Modified", last_modified}}, "data"};
+	});
+
+	utils::http::cache cache(test::get_temp_directory() + "/http");
+	const auto url = server.get_url("/motd.json");
+
+	CHECK(cache.get(url) == "data");
+	CHECK(cache.get(url) == "data");
+	CHECK(server.get_request_count() == 2);
+}
+
+TEST_CASE(http_cache_offline)
+{
+	const auto directory = test::get_temp_directory() + "/http";
+	std::string cached_url;
+	std::string uncached_url;
+
+	{
+		test::http_server server([](const test::http_server::request& request)
+		{
+			if (request.path == "/plain")
+			{
+				// nothing to revalidate with, not stored
+				return test::http_server::response{200, {}, "plain"};
+			}
+
+			return test::http_server::response{200, {{"ETag", "\"1\""}}, "cached"};
+		});
+
+		cached_url = server.get_url("/cached");
+		uncached_url = server.get_url("/plain");
+
+		utils::http::cache cache(directory);
+		CHECK(cache.get(cached_url) == "cached");
+		CHECK(cache.get(uncached_url) == "plain");
+		CHECK(cache.get(uncached_url) == "plain");
+		CHECK(server.get_request_count() == 3);
+	}
+
+	// nothing listens on the port anymore
+	utils::http::cache cache(directory);
+	CHECK(cache.get(cached_url) == "cached");
+	CHECK(!cache.get(uncached_url));
+
+	// a corrupted copy isn't served
+	const auto files = utils::io::list_files(directory);
+	for (const auto& file : files)
+	{
+		if (file.ends_with(".data"))
+		{
+			REQUIRE(utils::io::write_file(file, "tampered"));
+		}
+	}
+
+	CHECK(!cache.get(cached_url));
+}
+
+TEST_CASE(http_cache_errors_and_cancel)
+{
+	test::http_server server([](const test::http_server::request& request)
+	{
+		if (request.path == "/missing")
+		{
+			return test::http_server::response{404, {}, "not found"};
+		}
+
+		return test::http_server::response{200, {{"ETag", "\"1\""}}, "found"};
+	});
+
+	utils::http::cache cache(test::get_temp_directory() + "/http");
+	CHECK(!cache.get(server.get_url("/missing")));
+	CHECK(cache.get(server.get_url("/found")) == "found");
+
+	// no requests after cancelling, cached copies are still served
+	cache.cancel();
+	CHECK(cache.get(server.get_url("/found")) == "found");
+	CHECK(!cache.get(server.get_url("/other")));
+	CHECK(server.get_request_count() == 2);
+}
+
+TEST_CASE(http_cache_get_many)
+{
+	test::http_server server([](const test::http_server::request& request)
+	{
+		if (request.path == "/missing")
+		{
+			return test::http_server::response{404};
+		}
+
+		return test::http_server::response{200, {{"ETag", "\"1\""}}, "body of " + request.path};
+	});
+
+	std::vector<std::string> urls;
+	for (auto i = 0; i < 8; ++i)
+	{
+		urls.emplace_back(server.get_url("/" + std::to_string(i)));
+	}
+
+	urls.emplace_back(server.get_url("/missing"));
+
+	utils::http::cache cache(test::get_temp_directory() + "/http");
+	const auto results = cache.get_many(urls, 4);
+
+	// results keep the order of the urls
+	REQUIRE(results.size() == urls.size());
+	for (auto i = 0; i < 8; ++i)
+	{
+		CHECK(results[i] == "body of /" + std::to_string(i));
+	}
+
+	CHECK(!results[8]);
+	CHECK(cache.get_many({}, 4).empty());
+}
+
+TEST_CASE(http_cache_stall_timeout)
+{
+	test::http_server server([](const test::http_server::request& request)
+	{
+		test::http_server::response response{200, {{"ETag", "\"1\""}}, std::string(2000, 'x')};
+		response.chunk_size = 100;
+
+		if (request.path == "/slow")
+		{
+			// 2 seconds in total, but never a full second without data
+			response.chunk_delay = std::chrono::milliseconds(100);
+		}
+		else
+		{
+			response.stall = std::chrono::seconds(4);
+		}
+
+		return response;
+	});
+
+	utils::http::cache cache(test::get_temp_directory() + "/http", 1);
+
+	const auto slow = cache.get(server.get_url("/slow"));
+	REQUIRE(slow);
+	CHECK(slow->size() == 2000);
+
+	const auto start = std::chrono::steady_clock::now();
+	CHECK(!cache.get(server.get_url("/stalled")));
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(3));
+}
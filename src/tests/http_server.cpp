@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cctype>
+
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+#include "http_server.hpp"
+
+#pragma comment(lib, "ws2_32.lib")
+
+namespace test
+{
+	namespace
+	{
+		const char* get_reason(const unsigned int status)
+		{
+			switch (status)
+			{
+			case 200:
+				return "OK";
+			case 304:
+				return "Not Modified";
+			case 404:
+				return "Not Found";
+			default:
+				return "Unknown";
+			}
+		}
+
+		bool send_all(const SOCKET socket, const std::string_view data)
+		{
+			size_t offset = 0;
+			while (offset < data.size())
+			{
+				const auto sent = ::send(socket, data.data() + offset, static_cast<int>(data.size() - offset), 0);
+				if (sent <= 0)
+				{
+					return false;
+				}
+
+				offset += static_cast<size_t>(sent);
+			}
+
+			return true;
+		}
+
+		std::string to_lower(std::string text)
+		{
+			std::transform(text.begin(), text.end(), text.begin(), [](const unsigned char c)
+			{
+				return static_cast<char>(std::tolower(c));
+			});
+
+			return text;
+		}
+
+		http_server::request parse_request(const std::string& data)
+		{
+			http_server::request request{};
+
+			const auto line_end = data.find("\r\n");
+			const auto path_start = data.find(' ');
+			const auto path_end = data.find(' ', path_start + 1);
+			if (path_start < line_end && path_end < line_end)
+			{
+				request.path = data.substr(path_start + 1, path_end - path_start - 1);
+			}
+
+			for (auto pos = line_end + 2; pos < data.size();)
+			{
+				const auto end = data.find("\r\n", pos);
+				if (end == std::string::npos || end == pos)
+				{
+					break;
+				}
+
+				const auto line = data.substr(pos, end - pos);
+				if (const auto colon = line.find(':'); colon != std::string::npos)
+				{
+					const auto value_start = line.find_first_not_of(' ', colon + 1);
+					request.headers[to_lower(line.substr(0, colon))] = value_start == std::string::npos ? "" : line.substr(value_start);
+				}
+
+				pos = end + 2;
+			}
+
+			return request;
+		}
+	}
+
+	http_server::http_server(handler handler)
+		: handler_(std::move(handler))
+	{
+		WSADATA data{};
+		WSAStartup(MAKEWORD(2, 2), &data);
+
+		const auto listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		this->socket_ = static_cast<uintptr_t>(listener);
+
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+
+		socklen_t length = sizeof(address);
+		if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+			|| ::listen(listener, SOMAXCONN) == SOCKET_ERROR
+			|| ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == SOCKET_ERROR)
+		{
+			throw std::runtime_error("unable to start the test http server");
+		}
+
+		this->port_ = ntohs(address.sin_port);
+		this->thread_ = std::thread([this]()
+		{
+			this->run();
+		});
+	}
+
+	http_server::~http_server()
+	{
+		this->stop();
+
+		// wakes up accept
+		const auto client = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(this->port_);
+		::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+		closesocket(client);
+
+		if (this->thread_.joinable())
+		{
+			this->thread_.join();
+		}
+
+		closesocket(static_cast<SOCKET>(this->socket_));
+		WSACleanup();
+	}
+
+	std::string http_server::get_url(const std::string& path) const
+	{
+		return "http://127.0.0.1:" + std::to_string(this->port_) + path;
+	}
+
+	size_t http_server::get_request_count() const
+	{
+		return this->request_count_;
+	}
+
+	void http_server::stop()
+	{
+		this->stopping_ = true;
+	}
+
+	void http_server::run()
+	{
+		while (true)
+		{
+			const auto client = ::accept(static_cast<SOCKET>(this->socket_), nullptr, nullptr);
+			if (client == INVALID_SOCKET)
+			{
+				return;
+			}
+
+			if (this->stopping_)
+			{
+				closesocket(client);
+				return;
+			}
+
+			this->serve(static_cast<uintptr_t>(client));
+			closesocket(client);
+		}
+	}
+
+	void http_server::serve(const uintptr_t client)
+	{
+		const auto socket = static_cast<SOCKET>(client);
+
+		std::string data;
+		char buffer[0x1000];
+
+		while (data.find("\r\n\r\n") == std::string::npos)
+		{
+			const auto received = ::recv(socket, buffer, sizeof(buffer), 0);
+			if (received <= 0)
+			{
+				return;
+			}
+
+			data.append(buffer, static_cast<size_t>(received));
+		}
+
+		++this->request_count_;
+		const auto response = this->handler_(parse_request(data));
+
+		std::string head = "HTTP/1.1 " + std::to_string(response.status) + " " + get_reason(response.status) + "\r\n";
+		for (const auto& [name, value] : response.headers)
+		{
+			head.append(name).append(": ").append(value).append("\r\n");
+		}
+
+		head.append("Content-Length: " + std::to_string(response.status == 304 ? 0 : response.body.size()) + "\r\n");
+		head.append("Connection: close\r\n\r\n");
+
+		if (!send_all(socket, head) || response.status == 304)
+		{
+			return;
+		}
+
+		std::this_thread::sleep_for(response.stall);
+
+		const auto chunk_size = response.chunk_size ? response.chunk_size : std::max<size_t>(response.body.size(), 1);
+		for (size_t offset = 0; offset < response.body.size(); offset += chunk_size)
+		{
+			if (offset)
+			{
+				std::this_thread::sleep_for(response.chunk_delay);
+			}
+
+			if (!send_all(socket, std::string_view(response.body).substr(offset, chunk_size)))
+			{
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace test
+{
+	// Minimal HTTP/1.1 server on a loopback port for exercising http clients, one request per connection
+	class http_server final
+	{
+	public:
+		struct request
+		{
+			std::string path;
+			// names are lowercase
+			std::unordered_map<std::string, std::string> headers;
+		};
+
+		struct response
+		{
+			response(const unsigned int status = 200, std::vector<std::pair<std::string, std::string>> headers = {},
+				std::string body = {})
+				: status(status), headers(std::move(headers)), body(std::move(body))
+			{
+			}
+
+			unsigned int status;
+			std::vector<std::pair<std::string, std::string>> headers;
+			std::string body;
+
+			// the body is sent in chunks of chunk_size bytes with chunk_delay in between,
+			// stall pauses between the headers and the body
+			size_t chunk_size = 0;
+			std::chrono::milliseconds chunk_delay{};
+			std::chrono::milliseconds stall{};
+		};
+
+		using handler = std::function<response(const request&)>;
+
+		explicit http_server(handler handler);
+		~http_server();
+
+		http_server(http_server&&) = delete;
+		http_server(const http_server&) = delete;
+		http_server& operator=(http_server&&) = delete;
+		http_server& operator=(const http_server&) = delete;
+
+		std::string get_url(const std::string& path) const;
+		size_t get_request_count() const;
+
+		// refuses connections from here on, the port stays reserved
+		void stop();
+
+	private:
+		handler handler_;
+		uintptr_t socket_;
+		unsigned short port_ = 0;
+		std::atomic_bool stopping_ = false;
+		std::atomic_size_t request_count_ = 0;
+		std::thread thread_;
+
+		void run();
+		void serve(uintptr_t client);
+	};
+}
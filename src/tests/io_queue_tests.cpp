@@ -0,0 +1,262 @@
+#include <std_include.hpp>
+
+#include <utils/io_queue.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	// files kept in memory, writes to a path can be held until the test releases them
+	class memory_backend
+	{
+	public:
+		utils::io::async_queue::backend get()
+		{
+			utils::io::async_queue::backend backend{};
+
+			backend.read = [this](const std::string& path, std::string* data)
+			{
+				std::lock_guard<std::mutex> _(this->mutex_);
+				const auto file = this->files_.find(path);
+				if (file == this->files_.end())
+				{
+					return false;
+				}
+
+				*data = file->second;
+				return true;
+			};
+
+			backend.write = [this](const std::string& path, const std::string& data, const bool append)
+			{
+				std::unique_lock<std::mutex> lock(this->mutex_);
+				++this->writes_;
+				this->condition_.notify_all();
+
+				this->condition_.wait(lock, [this]()
+				{
+					return !this->held_;
+				});
+
+				auto& file = this->files_[path];
+				file = append ? file + data : data;
+				return true;
+			};
+
+			backend.list = [this](const std::string& path, std::vector<std::string>* files)
+			{
+				std::lock_guard<std::mutex> _(this->mutex_);
+				for (const auto& [name, data] : this->files_)
+				{
+					if (name.starts_with(path + "/"))
+					{
+						files->emplace_back(name);
+					}
+				}
+
+				return !files->empty();
+			};
+
+			backend.size = [this](const std::string& path, size_t* size)
+			{
+				std::lock_guard<std::mutex> _(this->mutex_);
+				const auto file = this->files_.find(path);
+				if (file == this->files_.end())
+				{
+					return false;
+				}
+
+				*size = file->second.size();
+				return true;
+			};
+
+			backend.copy = [this](const std::string& source, const std::string& target)
+			{
+				std::lock_guard<std::mutex> _(this->mutex_);
+				std::vector<std::pair<std::string, std::string>> copies;
+				for (const auto& [name, data] : this->files_)
+				{
+					if (name.starts_with(source + "/"))
+					{
+						copies.emplace_back(target + name.substr(source.size()), data);
+					}
+				}
+
+				for (auto& [name, data] : copies)
+				{
+					this->files_[name] = std::move(data);
+				}
+
+				return !copies.empty();
+			};
+
+			return backend;
+		}
+
+		void hold()
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->held_ = true;
+		}
+
+		void release()
+		{
+			{
+				std::lock_guard<std::mutex> _(this->mutex_);
+				this->held_ = false;
+			}
+
+			this->condition_.notify_all();
+		}
+
+		// blocks until the given amount of writes reached the backend
+		void wait_for_writes(const size_t count)
+		{
+			std::unique_lock<std::mutex> lock(this->mutex_);
+			this->condition_.wait(lock, [&]()
+			{
+				return this->writes_ >= count;
+			});
+		}
+
+		size_t get_writes()
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			return this->writes_;
+		}
+
+		std::string get_file(const std::string& path)
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			return this->files_[path];
+		}
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::map<std::string, std::string> files_;
+		size_t writes_ = 0;
+		bool held_ = false;
+	};
+
+	std::vector<utils::io::async_queue::result> poll_all(utils::io::async_queue& queue)
+	{
+		queue.wait_idle();
+		return queue.poll(std::numeric_limits<size_t>::max());
+	}
+}
+
+TEST_CASE(io_queue_coalesces_writes)
+{
+	memory_backend backend;
+	utils::io::async_queue queue(2, backend.get());
+
+	// the first write is executing, everything behind it is merged into a single write
+	backend.hold();
+	const auto first = queue.write("scores.txt", "a", false);
+	backend.wait_for_writes(1);
+
+	std::vector<uint64_t> ids;
+	ids.emplace_back(queue.write("scores.txt", "b", false));
+	ids.emplace_back(queue.write("scores.txt", "c", true));
+	ids.emplace_back(queue.write("scores.txt", "d", true));
+	ids.emplace_back(queue.write("scores.txt", "e", false));
+	ids.emplace_back(queue.write("scores.txt", "f", true));
+
+	backend.release();
+	const auto results = poll_all(queue);
+
+	CHECK(backend.get_writes() == 2);
+	CHECK(backend.get_file("scores.txt") == "ef");
+
+	// every request still completes, in the order it was made
+	REQUIRE(results.size() == 6);
+	CHECK(results[0].id == first);
+	for (auto i = 0u; i < ids.size(); ++i)
+	{
+		CHECK(results[i + 1].id == ids[i]);
+		CHECK(results[i + 1].success);
+		CHECK(results[i + 1].type == utils::io::async_queue::operation_type::write);
+	}
+}
+
+TEST_CASE(io_queue_keeps_order_per_path)
+{
+	memory_backend backend;
+	utils::io::async_queue queue(2, backend.get());
+
+	// a read between two writes separates them, it sees the first one only
+	backend.hold();
+	queue.write("a.txt", "1", false);
+	backend.wait_for_writes(1);
+
+	const auto read = queue.read("a.txt");
+	queue.write("a.txt", "2", true);
+	const auto size = queue.size("a.txt");
+	const auto other = queue.write("b.txt", "x", false);
+
+	backend.release();
+	const auto results = poll_all(queue);
+
+	REQUIRE(results.size() == 5);
+	CHECK(backend.get_writes() == 3);
+
+	for (const auto& result : results)
+	{
+		CHECK(result.success);
+
+		if (result.id == read)
+		{
+			CHECK(result.type == utils::io::async_queue::operation_type::read);
+			CHECK(result.data == "1");
+		}
+		else if (result.id == size)
+		{
+			CHECK(result.type == utils::io::async_queue::operation_type::size);
+			CHECK(result.size == 2);
+		}
+	}
+
+	CHECK(std::any_of(results.begin(), results.end(), [&](const auto& result)
+	{
+		return result.id == other;
+	}));
+}
+
+TEST_CASE(io_queue_copy_and_list)
+{
+	memory_backend backend;
+	utils::io::async_queue queue(1, backend.get());
+
+	queue.write("saves/1.txt", "one", false);
+	queue.write("saves/2.txt", "two", false);
+	queue.wait_idle();
+
+	const auto copy = queue.copy("saves", "backup");
+	const auto missing = queue.copy("nothing", "backup");
+	const auto list = queue.list("backup");
+	const auto missing_size = queue.size("backup/3.txt");
+
+	const auto results = poll_all(queue);
+	REQUIRE(results.size() == 6);
+
+	for (const auto& result : results)
+	{
+		if (result.id == copy)
+		{
+			CHECK(result.type == utils::io::async_queue::operation_type::copy);
+			CHECK(result.success);
+		}
+		else if (result.id == missing || result.id == missing_size)
+		{
+			CHECK(!result.success);
+		}
+		else if (result.id == list)
+		{
+			// the list is queued behind both copies on the target path
+			CHECK(result.files == std::vector<std::string>({"backup/1.txt", "backup/2.txt"}));
+		}
+	}
+
+	CHECK(backend.get_file("backup/2.txt") == "two");
+}
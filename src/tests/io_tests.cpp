@@ -0,0 +1,117 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <utils/io.hpp>
+#include <utils/io_native.hpp>
+
+#include "test.hpp"
+
+TEST_CASE(io_write_file_atomic)
+{
+	const auto file = test::get_temp_directory() + "/nested/directory/file.txt";
+
+	// creates the missing directories
+	REQUIRE(utils::io::write_file_atomic(file, "first"));
+	REQUIRE(utils::io::write_file_atomic(file, "second"));
+
+	CHECK(utils::io::read_file(file) == "second");
+	CHECK(!utils::io::file_exists(file + ".tmp"));
+
+	// the directory is recreated even though it was created before
+	std::filesystem::remove_all(test::get_temp_directory() + "/nested");
+	REQUIRE(utils::io::write_file_atomic(file, "third"));
+	CHECK(utils::io::read_file(file) == "third");
+}
+
+TEST_CASE(io_move_and_remove)
+{
+	const auto directory = test::get_temp_directory();
+	const auto a = directory + "/a.txt";
+	const auto b = directory + "/b.txt";
+
+	REQUIRE(utils::io::write_file(a, "a"));
+	REQUIRE(utils::io::write_file(b, "b"));
+
+	// never replaces an existing file
+	CHECK(!utils::io::move_file(a, b));
+	CHECK(utils::io::read_file(b) == "b");
+
+	CHECK(utils::io::remove_file(b));
+	CHECK(utils::io::move_file(a, b));
+	CHECK(!utils::io::file_exists(a));
+	CHECK(utils::io::read_file(b) == "a");
+
+	CHECK(utils::io::remove_file(b));
+	CHECK(!utils::io::remove_file(b));
+}
+
+TEST_CASE(io_ranges_and_mapping)
+{
+	const auto file = test::get_temp_directory() + "/data.bin";
+	REQUIRE(utils::io::write_file(file, "0123456789"));
+
+	std::string data;
+	CHECK(utils::io::read_file_range(file, 2, 3, &data) && data == "234");
+	// cut short at the end of the file
+	CHECK(utils::io::read_file_range(file, 8, 10, &data) && data == "89");
+
+	std::string chunks;
+	CHECK(utils::io::read_file_chunked(file, [&](const std::string_view chunk)
+	{
+		chunks.append(chunk).append("|");
+		return true;
+	}, 4));
+	CHECK(chunks == "0123|4567|89|");
+
+	{
+		const utils::io::mapped_file mapped{file};
+		REQUIRE(mapped.is_open());
+		CHECK(mapped.view() == "0123456789");
+	}
+
+	// only a hint, the contents stay the same
+	const auto handle = utils::io::native::open_for_reading(file, false);
+	REQUIRE(handle != utils::io::native::invalid_handle);
+	utils::io::native::prefetch(handle, 0, 10);
+	utils::io::native::close(handle);
+
+	CHECK(utils::io::read_file(file) == "0123456789");
+}
+
+TEST_CASE(io_prune_directory)
+{
+	const auto directory = test::get_temp_directory() + "/cache";
+	const auto now = std::filesystem::file_time_type::clock::now();
+
+	// five entries of 200 bytes, a .data/.meta pair each, entry 0 is the oldest
+	for (auto i = 0; i < 5; ++i)
+	{
+		for (const auto* extension : {".data", ".meta"})
+		{
+			const auto file = directory + "/" + std::to_string(i) + extension;
+			REQUIRE(utils::io::write_file(file, std::string(100, 'x')));
+			std::filesystem::last_write_time(file, now - std::chrono::hours(10 - i));
+		}
+	}
+
+	// using an entry keeps it around
+	CHECK(utils::io::touch_file(directory + "/0.data"));
+
+	CHECK(utils::io::prune_directory(directory, 600) == 2);
+	CHECK(utils::io::file_exists(directory + "/0.meta"));
+	CHECK(!utils::io::file_exists(directory + "/1.data"));
+	CHECK(!utils::io::file_exists(directory + "/1.meta"));
+	CHECK(!utils::io::file_exists(directory + "/2.data"));
+	CHECK(utils::io::file_exists(directory + "/3.data"));
+
+	// entry 3 is 7 hours old
+	CHECK(utils::io::prune_directory(directory, 0x100000, std::chrono::hours(6) + std::chrono::minutes(30)) == 1);
+	CHECK(!utils::io::file_exists(directory + "/3.meta"));
+	CHECK(utils::io::file_exists(directory + "/4.meta"));
+
+	CHECK(utils::io::prune_directory(directory, 0) == 2);
+	CHECK(utils::io::list_files(directory).empty());
+
+	CHECK(utils::io::prune_directory(directory + "/missing", 0) == 0);
+}
@@ -0,0 +1,660 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <utils/json_stream.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	// stands in for script values, with the same conversions json.cpp applies
+	struct value
+	{
+		enum class kind
+		{
+			undefined,
+			integer,
+			floating,
+			string,
+			array,
+			object,
+		};
+
+		value() = default;
+
+		explicit value(const kind container)
+			: type(container)
+		{
+		}
+
+		explicit value(const int number)
+			: type(kind::integer)
+			, integer(number)
+		{
+		}
+
+		explicit value(const float number)
+			: type(kind::floating)
+			, floating(number)
+		{
+		}
+
+		explicit value(std::string text)
+			: type(kind::string)
+			, string(std::move(text))
+		{
+		}
+
+		kind type = kind::undefined;
+		int integer = 0;
+		float floating = 0.f;
+		std::string string;
+		std::vector<value> elements;
+		// in the order they were assigned, like script array keys
+		std::vector<std::pair<std::string, value>> members;
+
+		bool operator==(const value&) const = default;
+	};
+
+	struct test_values
+	{
+		using value_type = value;
+		using container_type = value;
+
+		value null()
+		{
+			return {};
+		}
+
+		value boolean(bool)
+		{
+			return {};
+		}
+
+		value integer(const int64_t number)
+		{
+			return value(static_cast<int>(number));
+		}
+
+		value floating(const double number)
+		{
+			return value(static_cast<float>(number));
+		}
+
+		value string(const std::string& text)
+		{
+			return value(text);
+		}
+
+		value container(const bool is_object)
+		{
+			return value(is_object ? value::kind::object : value::kind::array);
+		}
+
+		// assigning an existing key replaces its value
+		void set(value& object, const std::string& key, value member)
+		{
+			const auto existing = std::ranges::find(object.members, key, &std::pair<std::string, value>::first);
+			if (existing != object.members.end())
+			{
+				existing->second = std::move(member);
+				return;
+			}
+
+			object.members.emplace_back(key, std::move(member));
+		}
+
+		void push(value& array, value element)
+		{
+			array.elements.emplace_back(std::move(element));
+		}
+
+		value finish(value container)
+		{
+			return container;
+		}
+	};
+
+	value parse_streaming(const std::string& json, const size_t max_depth = 64)
+	{
+		test_values values;
+		utils::json::value_builder builder(values, max_depth);
+		nlohmann::json::sax_parse(json, &builder);
+
+		return builder.take_result();
+	}
+
+	// what jsonparse did before it streamed, the conversion of json_to_gsc
+	value from_tree(const nlohmann::json& json)
+	{
+		switch (json.type())
+		{
+		case nlohmann::json::value_t::number_integer:
+		case nlohmann::json::value_t::number_unsigned:
+			return value(json.get<int>());
+		case nlohmann::json::value_t::number_float:
+			return value(json.get<float>());
+		case nlohmann::json::value_t::string:
+			return value(json.get<std::string>());
+		case nlohmann::json::value_t::array:
+		{
+			value array(value::kind::array);
+			for (const auto& element : json)
+			{
+				array.elements.emplace_back(from_tree(element));
+			}
+
+			return array;
+		}
+		case nlohmann::json::value_t::object:
+		{
+			value object(value::kind::object);
+			for (const auto& [key, member] : json.items())
+			{
+				object.members.emplace_back(key, from_tree(member));
+			}
+
+			return object;
+		}
+		default:
+			return {};
+		}
+	}
+
+	value parse_tree(const std::string& json)
+	{
+		return from_tree(nlohmann::json::parse(json));
+	}
+
+	// what jsonserialize did before, the conversion of gsc_to_json followed by dump
+	nlohmann::json to_tree(const value& value)
+	{
+		switch (value.type)
+		{
+		case value::kind::integer:
+			return value.integer;
+		case value::kind::floating:
+			return value.floating;
+		case value::kind::string:
+			return value.string;
+		case value::kind::array:
+		{
+			nlohmann::json array;
+			for (const auto& element : value.elements)
+			{
+				array.push_back(to_tree(element));
+			}
+
+			return array;
+		}
+		case value::kind::object:
+		{
+			nlohmann::json object;
+			for (const auto& [key, member] : value.members)
+			{
+				object[key] = to_tree(member);
+			}
+
+			return object;
+		}
+		default:
+			return {};
+		}
+	}
+
+	// the walk of json.cpp's json_writer, objects are sorted by key and empty containers become null
+	void write_value(utils::json::writer& writer, const value& value)
+	{
+		switch (value.type)
+		{
+		case value::kind::integer:
+			writer.integer(value.integer);
+			break;
+		case value::kind::floating:
+			writer.floating(value.floating);
+			break;
+		case value::kind::string:
+			writer.string(value.string);
+			break;
+		case value::kind::array:
+			if (value.elements.empty())
+			{
+				writer.null();
+				break;
+			}
+
+			writer.begin_array();
+			for (const auto& element : value.elements)
+			{
+				write_value(writer, element);
+			}
+
+			writer.end_array();
+			break;
+		case value::kind::object:
+		{
+			if (value.members.empty())
+			{
+				writer.null();
+				break;
+			}
+
+			std::vector<const std::pair<std::string, ::value>*> members;
+			for (const auto& member : value.members)
+			{
+				members.push_back(&member);
+			}
+
+			std::ranges::sort(members, {}, [](const auto* member)
+			{
+				return member->first;
+			});
+
+			writer.begin_object();
+			for (const auto* member : members)
+			{
+				writer.key(member->first);
+				write_value(writer, member->second);
+			}
+
+			writer.end_object();
+			break;
+		}
+		default:
+			writer.null();
+			break;
+		}
+	}
+
+	std::string serialize_streaming(const value& value, const int indent)
+	{
+		std::string buffer;
+		utils::json::writer writer(buffer, indent);
+		write_value(writer, value);
+
+		return buffer;
+	}
+
+	// documents don't carry a key order, the tree path hands them out sorted
+	void sort_members(value& value)
+	{
+		std::ranges::sort(value.members, {}, &std::pair<std::string, ::value>::first);
+
+		for (auto& element : value.elements)
+		{
+			sort_members(element);
+		}
+
+		for (auto& member : value.members)
+		{
+			sort_members(member.second);
+		}
+	}
+
+	class document_generator
+	{
+	public:
+		explicit document_generator(const uint32_t seed)
+			: random_(seed)
+		{
+		}
+
+		nlohmann::json generate(const int depth, const size_t width)
+		{
+			const auto kind = depth > 0 ? this->next(8) : this->next(6);
+
+			switch (kind)
+			{
+			case 0:
+				return nullptr;
+			case 1:
+				return this->next(2) == 0;
+			case 2:
+				return static_cast<int>(this->random_()) / static_cast<int>(this->next(1000) + 1);
+			case 3:
+				return static_cast<double>(static_cast<int>(this->random_())) / 65536.0;
+			case 4:
+			case 5:
+				return this->generate_string();
+			case 6:
+			{
+				auto array = nlohmann::json::array();
+				const auto count = this->next(width + 1);
+				for (size_t i = 0; i < count; ++i)
+				{
+					array.push_back(this->generate(depth - 1, width));
+				}
+
+				return array;
+			}
+			default:
+			{
+				auto object = nlohmann::json::object();
+				const auto count = this->next(width + 1);
+				for (size_t i = 0; i < count; ++i)
+				{
+					object[this->generate_string()] = this->generate(depth - 1, width);
+				}
+
+				return object;
+			}
+			}
+		}
+
+	private:
+		std::mt19937 random_;
+
+		size_t next(const size_t bound)
+		{
+			return this->random_() % bound;
+		}
+
+		std::string generate_string()
+		{
+			// plain text with the characters that need escaping and multi byte sequences mixed in
+			static const std::vector<std::string> pieces =
+			{
+				"name", "mp_rust", " ", "\"", "\\", "/", "\n", "\t", "\b", "\f", "\r", "\x01", "\x1f", "\x7f",
+				"\xC3\xA4", "\xE2\x82\xAC", "\xF0\x9F\x98\x80",
+			};
+
+			std::string text;
+			const auto count = this->next(6);
+			for (size_t i = 0; i < count; ++i)
+			{
+				text.append(pieces[this->next(pieces.size())]);
+			}
+
+			return text;
+		}
+	};
+
+	// tree path and streaming path agree on values without empty containers, those became null before as well
+	bool has_empty_container(const nlohmann::json& json)
+	{
+		if (json.is_structured())
+		{
+			if (json.empty())
+			{
+				return true;
+			}
+
+			for (const auto& element : json)
+			{
+				if (has_empty_container(element))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+TEST_CASE(json_stream_writer_matches_dump)
+{
+	document_generator generator(1);
+
+	for (auto i = 0; i < 300; ++i)
+	{
+		const auto document = generator.generate(5, 6);
+
+		for (const auto indent : {-1, 0, 1, 4})
+		{
+			std::string buffer;
+			utils::json::writer writer(buffer, indent);
+
+			// nlohmann's iteration order, objects come out sorted like dump writes them
+			const std::function<void(const nlohmann::json&)> write = [&](const nlohmann::json& json)
+			{
+				switch (json.type())
+				{
+				case nlohmann::json::value_t::object:
+					writer.begin_object();
+					for (const auto& [key, member] : json.items())
+					{
+						writer.key(key);
+						write(member);
+					}
+
+					writer.end_object();
+					break;
+				case nlohmann::json::value_t::array:
+					writer.begin_array();
+					for (const auto& element : json)
+					{
+						write(element);
+					}
+
+					writer.end_array();
+					break;
+				case nlohmann::json::value_t::number_integer:
+				case nlohmann::json::value_t::number_unsigned:
+					writer.integer(json.get<int64_t>());
+					break;
+				case nlohmann::json::value_t::number_float:
+					writer.floating(json.get<double>());
+					break;
+				case nlohmann::json::value_t::string:
+					writer.string(json.get_ref<const std::string&>());
+					break;
+				default:
+					// booleans have no script representation
+					writer.null();
+					break;
+				}
+			};
+
+			auto without_booleans = document;
+			const std::function<void(nlohmann::json&)> strip = [&](nlohmann::json& json)
+			{
+				if (json.is_boolean())
+				{
+					json = nullptr;
+				}
+
+				if (!json.is_structured())
+				{
+					return;
+				}
+
+				for (auto& element : json)
+				{
+					strip(element);
+				}
+			};
+
+			strip(without_booleans);
+			write(without_booleans);
+
+			CHECK(buffer == without_booleans.dump(indent));
+		}
+	}
+
+	// both reject invalid UTF-8
+	for (const auto* text : {"\xC3", "a\xFF", "\xED\xA0\x80", "\xF0\x9F\x98"})
+	{
+		std::string buffer;
+		utils::json::writer writer(buffer);
+
+		auto threw = false;
+		auto dump_threw = false;
+
+		try
+		{
+			writer.string(text);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+
+		try
+		{
+			(void)nlohmann::json(text).dump();
+		}
+		catch (const nlohmann::json::type_error&)
+		{
+			dump_threw = true;
+		}
+
+		CHECK(threw);
+		CHECK(dump_threw);
+	}
+
+	std::string special;
+	utils::json::writer writer(special);
+	writer.begin_array();
+	writer.floating(std::numeric_limits<double>::quiet_NaN());
+	writer.floating(1.0);
+	writer.floating(0.1f);
+	writer.end_array();
+	CHECK(special == nlohmann::json({nullptr, 1.0, 0.1f}).dump());
+}
+
+TEST_CASE(json_stream_parse_matches_tree)
+{
+	document_generator generator(2);
+
+	for (auto i = 0; i < 300; ++i)
+	{
+		const auto text = generator.generate(5, 6).dump();
+
+		auto streamed = parse_streaming(text);
+		sort_members(streamed);
+
+		CHECK(streamed == parse_tree(text));
+	}
+
+	// a repeated key keeps the last value like the tree did
+	CHECK(parse_streaming(R"({"a":1,"b":2,"a":3})") == parse_tree(R"({"a":1,"b":2,"a":3})"));
+
+	// keys are assigned in document order, the tree handed them out sorted
+	const auto ordered = parse_streaming(R"({"b":1,"a":2})");
+	REQUIRE(ordered.members.size() == 2);
+	CHECK(ordered.members[0].first == "b");
+
+	for (const auto* invalid : {"", "{", "[1,]", "{\"a\" 1}", "nul"})
+	{
+		auto threw = false;
+		try
+		{
+			parse_streaming(invalid);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+
+		CHECK(threw);
+	}
+
+	const auto nested = [](const int depth)
+	{
+		return std::string(depth, '[') + std::string(depth, ']');
+	};
+
+	CHECK(parse_streaming(nested(64)).type == value::kind::array);
+
+	auto threw = false;
+	try
+	{
+		parse_streaming(nested(65));
+	}
+	catch (const std::runtime_error&)
+	{
+		threw = true;
+	}
+
+	CHECK(threw);
+}
+
+TEST_CASE(json_stream_round_trip)
+{
+	document_generator generator(3);
+
+	for (auto i = 0; i < 300; ++i)
+	{
+		const auto document = generator.generate(5, 6);
+		if (has_empty_container(document))
+		{
+			continue;
+		}
+
+		const auto values = parse_streaming(document.dump());
+
+		for (const auto indent : {-1, 2})
+		{
+			CHECK(serialize_streaming(values, indent) == to_tree(values).dump(indent));
+		}
+	}
+}
+
+TEST_CASE(json_stream_benchmark)
+{
+	// a few MB of nested objects, about what a large stats or map vote payload looks like in bulk
+	document_generator generator(4);
+	auto document = nlohmann::json::array();
+	while (document.dump().size() < 4 * 1024 * 1024)
+	{
+		for (auto i = 0; i < 64; ++i)
+		{
+			document.push_back(generator.generate(4, 6));
+		}
+	}
+
+	const auto text = document.dump();
+	const auto megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+
+	const auto measure = [&](const char* label, const std::function<void()>& function)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		printf("  %-20s %.1f MB/s\n", label, megabytes / duration.count());
+		return duration;
+	};
+
+	printf("  %.1f MB\n", megabytes);
+
+	value streamed;
+	value tree;
+
+	const auto sax = measure("parse, sax", [&]()
+	{
+		streamed = parse_streaming(text);
+	});
+
+	const auto dom = measure("parse, dom", [&]()
+	{
+		tree = parse_tree(text);
+	});
+
+	sort_members(streamed);
+	CHECK(streamed == tree);
+	CHECK(sax < dom);
+
+	std::string written;
+	std::string dumped;
+
+	const auto writer = measure("serialize, writer", [&]()
+	{
+		written = serialize_streaming(tree, -1);
+	});
+
+	const auto dump = measure("serialize, dom", [&]()
+	{
+		dumped = to_tree(tree).dump();
+	});
+
+	CHECK(written.size() > 0);
+	CHECK(writer < dump);
+}
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+// Unit tests for the utilities that don't need the game.
+//
+// usage: tests [filter]
+//
+// Only tests whose name contains the filter are run, the exit code is the number of failed tests.
+
+namespace test
+{
+	namespace
+	{
+		struct test_entry
+		{
+			const char* name;
+			test_function function;
+		};
+
+		struct require_failure : std::exception
+		{
+		};
+
+		// registrars run during static initialization, a function local keeps the order of construction right
+		std::vector<test_entry>& get_tests()
+		{
+			static std::vector<test_entry> tests;
+			return tests;
+		}
+
+		int current_failures = 0;
+
+		std::filesystem::path get_temp_path()
+		{
+			return std::filesystem::temp_directory_path() / "hmw-mod-tests";
+		}
+	}
+
+	void add(const char* name, const test_function function)
+	{
+		get_tests().push_back({name, function});
+	}
+
+	void check(const bool result, const char* expression, const char* file, const int line)
+	{
+		if (!result)
+		{
+			++current_failures;
+			printf("  %s(%d): check failed: %s\n", file, line, expression);
+		}
+	}
+
+	void require(const bool result, const char* expression, const char* file, const int line)
+	{
+		check(result, expression, file, line);
+
+		if (!result)
+		{
+			throw require_failure{};
+		}
+	}
+
+	std::string get_temp_directory()
+	{
+		return get_temp_path().generic_string();
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const auto* filter = argc > 1 ? argv[1] : "";
+
+	auto passed = 0;
+	auto failed = 0;
+
+	for (const auto& [name, function] : test::get_tests())
+	{
+		if (!std::strstr(name, filter))
+		{
+			continue;
+		}
+
+		printf("%s\n", name);
+
+		std::error_code ec{};
+		std::filesystem::remove_all(test::get_temp_path(), ec);
+		std::filesystem::create_directories(test::get_temp_path(), ec);
+
+		test::current_failures = 0;
+
+		try
+		{
+			function();
+		}
+		catch (const test::require_failure&)
+		{
+		}
+		catch (const std::exception& ex)
+		{
+			++test::current_failures;
+			printf("  unexpected exception: %s\n", ex.what());
+		}
+
+		if (test::current_failures)
+		{
+			++failed;
+		}
+		else
+		{
+			++passed;
+		}
+	}
+
+	std::error_code ec{};
+	std::filesystem::remove_all(test::get_temp_path(), ec);
+
+	printf("\n%d passed, %d failed\n", passed, failed);
+	return failed;
+}
@@ -0,0 +1,202 @@
+#include <std_include.hpp>
+
+#include "component/map_rotation.hpp"
+#include "utils/map_prefetch.hpp"
+
+#include <utils/io.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	// a usermap folder per map, like hmw-usermaps
+	class fake_usermaps
+	{
+	public:
+		fake_usermaps()
+			: directory_(test::get_temp_directory() + "/usermaps")
+		{
+		}
+
+		void add_map(const std::string& mapname, const size_t size)
+		{
+			for (const auto& file : this->get_files(mapname))
+			{
+				REQUIRE(utils::io::write_file(file, std::string(size, static_cast<char>(mapname.back()))));
+			}
+		}
+
+		std::vector<std::string> get_files(const std::string& mapname) const
+		{
+			const auto base = this->directory_ + "/" + mapname + "/" + mapname;
+			return {base + ".ff", base + ".pak"};
+		}
+
+	private:
+		std::string directory_;
+	};
+
+	// stands in for utils::hash::get_file_hash, the test holds the gate to keep a prefetch running
+	struct fake_hash
+	{
+		std::mutex gate;
+		std::atomic_int calls{0};
+
+		static std::string compute(const std::string& file)
+		{
+			std::string data;
+			if (!utils::io::read_file(file, &data))
+			{
+				return {};
+			}
+
+			return std::to_string(std::hash<std::string>{}(data));
+		}
+
+		map_prefetch::prefetcher::hash_function get_function()
+		{
+			return [this](const std::string& file)
+			{
+				std::lock_guard<std::mutex> _(this->gate);
+				++this->calls;
+				return compute(file);
+			};
+		}
+	};
+
+	// what perform_map_rotation does with the rotation, gametypes are skipped over until the next map
+	std::string rotate(map_rotation::rotation_data& rotation)
+	{
+		while (true)
+		{
+			const auto& entry = rotation.get_next_entry();
+			if (entry.first == "map")
+			{
+				return entry.second;
+			}
+		}
+	}
+}
+
+TEST_CASE(map_prefetch_follows_rotation)
+{
+	fake_usermaps usermaps;
+	usermaps.add_map("mp_a", 0x10000);
+	usermaps.add_map("mp_b", 0x20000);
+
+	map_rotation::rotation_data rotation;
+	rotation.parse("gametype war map mp_a gametype dom map mp_b map mp_missing");
+
+	fake_hash hash;
+	map_prefetch::prefetcher prefetcher(hash.get_function());
+
+	// the server is on the first map, the check runs while it is being played
+	CHECK(rotate(rotation) == "mp_a");
+	CHECK(rotation.peek_next_map() == "mp_b");
+
+	{
+		std::unique_lock<std::mutex> gate(hash.gate);
+		CHECK(prefetcher.prefetch("mp_b", usermaps.get_files("mp_b")));
+
+		// still hashing, a later check doesn't start another prefetch
+		CHECK(!prefetcher.prefetch("mp_missing", usermaps.get_files("mp_missing")));
+	}
+
+	prefetcher.wait();
+	CHECK(hash.calls == 2);
+
+	// the same map isn't hashed again on the next check
+	CHECK(!prefetcher.prefetch("mp_b", usermaps.get_files("mp_b")));
+	CHECK(hash.calls == 2);
+
+	// the switch picks up the prefetched hashes instead of hashing
+	CHECK(rotate(rotation) == "mp_b");
+	prefetcher.forget_map();
+
+	const auto files = usermaps.get_files("mp_b");
+	CHECK(prefetcher.take_hash(files[0]) == fake_hash::compute(files[0]));
+	CHECK(prefetcher.take_hash(files[1]) == fake_hash::compute(files[1]));
+	CHECK(prefetcher.take_saved_seconds() > 0.0);
+	CHECK(prefetcher.take_saved_seconds() == 0.0);
+
+	// handed out once, get_file_hash caches them from there
+	CHECK(!prefetcher.take_hash(files[0]));
+
+	// a map without files prefetches nothing
+	CHECK(rotation.peek_next_map() == "mp_missing");
+	CHECK(prefetcher.prefetch("mp_missing", usermaps.get_files("mp_missing")));
+	prefetcher.wait();
+	CHECK(hash.calls == 2);
+	CHECK(!prefetcher.take_hash(usermaps.get_files("mp_missing")[0]));
+
+	// the rotation wraps around
+	CHECK(rotate(rotation) == "mp_missing");
+	prefetcher.forget_map();
+	CHECK(rotation.peek_next_map() == "mp_a");
+	CHECK(prefetcher.prefetch("mp_a", usermaps.get_files("mp_a")));
+	prefetcher.wait();
+	CHECK(hash.calls == 4);
+	CHECK(prefetcher.take_hash(usermaps.get_files("mp_a")[0]));
+}
+
+TEST_CASE(map_prefetch_changed_files)
+{
+	fake_usermaps usermaps;
+	usermaps.add_map("mp_a", 0x1000);
+
+	fake_hash hash;
+	map_prefetch::prefetcher prefetcher(hash.get_function());
+
+	CHECK(prefetcher.prefetch("mp_a", usermaps.get_files("mp_a")));
+	prefetcher.wait();
+
+	// a map update got downloaded between the prefetch and the switch
+	const auto files = usermaps.get_files("mp_a");
+	REQUIRE(utils::io::write_file(files[1], "updated"));
+
+	CHECK(prefetcher.take_hash(files[0]) == fake_hash::compute(files[0]));
+	CHECK(!prefetcher.take_hash(files[1]));
+
+	// only the upcoming map is kept
+	usermaps.add_map("mp_b", 0x1000);
+	CHECK(prefetcher.prefetch("mp_b", usermaps.get_files("mp_b")));
+	prefetcher.wait();
+
+	usermaps.add_map("mp_a", 0x1000);
+	CHECK(prefetcher.prefetch("mp_a", usermaps.get_files("mp_a")));
+	prefetcher.wait();
+	CHECK(!prefetcher.take_hash(usermaps.get_files("mp_b")[0]));
+	CHECK(prefetcher.take_hash(usermaps.get_files("mp_a")[0]));
+}
+
+TEST_CASE(map_prefetch_random_rotation)
+{
+	map_rotation::rotation_data rotation;
+	rotation.parse("map mp_a map mp_b map mp_c map mp_d");
+	rotation.randomize();
+
+	// the predicted map is the one that gets loaded, also after shuffling
+	for (auto i = 0; i < 8; ++i)
+	{
+		const auto predicted = rotation.peek_next_map();
+		REQUIRE(predicted);
+		CHECK(rotate(rotation) == *predicted);
+	}
+
+	map_rotation::rotation_data gametypes_only;
+	gametypes_only.parse("gametype war gametype dom");
+	CHECK(!gametypes_only.peek_next_map());
+
+	auto threw = false;
+	try
+	{
+		gametypes_only.parse("map");
+		gametypes_only.parse("maps mp_a");
+	}
+	catch (const map_rotation::parse_rotation_error&)
+	{
+		threw = true;
+	}
+
+	CHECK(threw);
+}
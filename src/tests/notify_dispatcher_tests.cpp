@@ -0,0 +1,317 @@
+#include <std_include.hpp>
+
+#include <cstdlib>
+#include <new>
+
+#include "game/scripting/notify_dispatcher.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// only read around the replay, every other test allocates freely
+	std::atomic_size_t allocation_count = 0;
+
+	struct value
+	{
+		int type;
+		uint64_t data;
+	};
+
+	using dispatcher = scripting::notify_dispatcher<value, 4>;
+
+	struct recorded_notify
+	{
+		unsigned int entity_id;
+		unsigned int name;
+		unsigned int argument_count;
+	};
+
+	// a server with bots mostly sends a handful of frequent notifies, the rest are spread over many names
+	std::vector<recorded_notify> record_stream(const size_t count, const unsigned int name_count)
+	{
+		std::vector<recorded_notify> stream;
+		stream.reserve(count);
+
+		uint32_t state = 0x12345678;
+		const auto next = [&]()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto frequent = next() % 4 != 0;
+			const auto name = frequent ? next() % 16 : next() % name_count;
+			stream.push_back({next() % 64, name + 1, next() % 6});
+		}
+
+		return stream;
+	}
+
+	size_t capture_arguments(const recorded_notify& notify, value* arguments, const size_t capacity)
+	{
+		for (size_t i = 0; i < notify.argument_count && i < capacity; ++i)
+		{
+			arguments[i] = {1, notify.name * 100 + i};
+		}
+
+		return notify.argument_count;
+	}
+}
+
+void* operator new(const size_t size)
+{
+	++allocation_count;
+	if (auto* memory = std::malloc(size ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+TEST_CASE(notify_dispatcher_listeners)
+{
+	dispatcher notifies;
+	CHECK(!notifies.has_listeners(5));
+
+	std::vector<std::pair<unsigned int, size_t>> received;
+	const auto handle = notifies.add("damage", 5, [&](const dispatcher::event& event)
+	{
+		received.emplace_back(event.entity_id, event.arguments.size());
+		CHECK(!event.truncated);
+		CHECK(event.arguments[0].data == 42);
+	});
+
+	CHECK(notifies.has_listeners(5));
+	CHECK(!notifies.has_listeners(6));
+	CHECK(!notifies.has_listeners(5 + 64));
+
+	auto captures = 0;
+	const auto capture = [&](value* arguments, const size_t)
+	{
+		++captures;
+		arguments[0] = {1, 42};
+		return size_t(1);
+	};
+
+	// arguments are only captured for notifies somebody listens to
+	notifies.dispatch(1, 6, capture);
+	notifies.dispatch(1, 5, capture);
+	notifies.dispatch(2, 5, capture);
+
+	CHECK(captures == 2);
+	REQUIRE(received.size() == 2);
+	CHECK(received[1].first == 2);
+	CHECK(received[1].second == 1);
+
+	CHECK(notifies.remove(handle));
+	CHECK(!notifies.remove(handle));
+	CHECK(!notifies.has_listeners(5));
+
+	notifies.dispatch(1, 5, capture);
+	CHECK(captures == 2);
+}
+
+TEST_CASE(notify_dispatcher_truncates_arguments)
+{
+	dispatcher notifies;
+
+	size_t received = 0;
+	auto truncated = false;
+	notifies.add("spam", 1, [&](const dispatcher::event& event)
+	{
+		received = event.arguments.size();
+		truncated = event.truncated;
+	});
+
+	notifies.dispatch(0, 1, [](value* arguments, const size_t capacity)
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			arguments[i] = {1, i};
+		}
+
+		return capacity + 3;
+	});
+
+	CHECK(received == 4);
+	CHECK(truncated);
+}
+
+TEST_CASE(notify_dispatcher_changes_while_dispatching)
+{
+	dispatcher notifies;
+
+	auto first_calls = 0;
+	auto second_calls = 0;
+	auto added_calls = 0;
+	uint64_t first = 0;
+
+	first = notifies.add("death", 3, [&](const dispatcher::event&)
+	{
+		++first_calls;
+
+		// removes itself and adds a listener that only sees the next notify
+		notifies.remove(first);
+		notifies.add("death", 3, [&](const dispatcher::event&)
+		{
+			++added_calls;
+		});
+	});
+
+	notifies.add("death", 3, [&](const dispatcher::event&)
+	{
+		++second_calls;
+	});
+
+	const auto capture = [](value*, size_t)
+	{
+		return size_t(0);
+	};
+
+	notifies.dispatch(0, 3, capture);
+	CHECK(first_calls == 1);
+	CHECK(second_calls == 1);
+	CHECK(added_calls == 0);
+
+	notifies.dispatch(0, 3, capture);
+	CHECK(first_calls == 1);
+	CHECK(second_calls == 2);
+	CHECK(added_calls == 1);
+}
+
+TEST_CASE(notify_dispatcher_rebind)
+{
+	dispatcher notifies;
+
+	auto calls = 0;
+	notifies.add("spawned", 10, [&](const dispatcher::event& event)
+	{
+		CHECK(event.name == 200);
+		++calls;
+	});
+
+	// string ids of a new level
+	notifies.rebind([](const std::string& name)
+	{
+		return name == "spawned" ? 200u : 0u;
+	});
+
+	CHECK(!notifies.has_listeners(10));
+	CHECK(notifies.has_listeners(200));
+
+	notifies.dispatch(0, 200, [](value*, size_t)
+	{
+		return size_t(0);
+	});
+
+	CHECK(calls == 1);
+}
+
+TEST_CASE(notify_dispatcher_replay)
+{
+	constexpr auto name_count = 2000u;
+	const auto stream = record_stream(1000000, name_count);
+
+	// what vm_notify_stub used to do for every notify, a name and a copy of the arguments
+	std::unordered_map<unsigned int, std::string> names;
+	for (auto i = 1u; i <= name_count; ++i)
+	{
+		names[i] = "notify_" + std::to_string(i);
+	}
+
+	const auto replay_events = [&]()
+	{
+		size_t checksum = 0;
+		for (const auto& notify : stream)
+		{
+			std::string name = names[notify.name];
+			std::vector<value> arguments(notify.argument_count);
+			capture_arguments(notify, arguments.data(), arguments.size());
+			checksum += name.size() + arguments.size();
+		}
+
+		return checksum;
+	};
+
+	const auto replay = [&](dispatcher& notifies)
+	{
+		for (const auto& notify : stream)
+		{
+			notifies.dispatch(notify.entity_id, notify.name, [&](value* arguments, const size_t capacity)
+			{
+				return capture_arguments(notify, arguments, capacity);
+			});
+		}
+	};
+
+	const auto measure = [&](const char* label, const std::function<void()>& function)
+	{
+		const auto allocations = allocation_count.load();
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		const auto allocated = allocation_count.load() - allocations;
+
+		printf("  %-20s %.1f ns/notify, %zu allocations\n", label, static_cast<double>(duration.count()) / stream.size(),
+			allocated);
+
+		return allocated;
+	};
+
+	measure("events", [&]()
+	{
+		CHECK(replay_events() > 0);
+	});
+
+	dispatcher idle;
+	CHECK(measure("no listeners", [&]()
+	{
+		replay(idle);
+	}) == 0);
+
+	// listeners on a few frequent and a few rare notifies
+	dispatcher listening;
+	size_t received = 0;
+	size_t arguments = 0;
+	for (const auto name : {1u, 3u, 7u, 500u, 1500u})
+	{
+		listening.add("notify_" + std::to_string(name), name, [&](const dispatcher::event& event)
+		{
+			++received;
+			arguments += event.arguments.size();
+		});
+	}
+
+	CHECK(measure("5 listeners", [&]()
+	{
+		replay(listening);
+	}) == 0);
+
+	size_t expected = 0;
+	for (const auto& notify : stream)
+	{
+		if (notify.name == 1 || notify.name == 3 || notify.name == 7 || notify.name == 500 || notify.name == 1500)
+		{
+			++expected;
+		}
+	}
+
+	CHECK(received == expected);
+	CHECK(arguments > 0);
+}
@@ -0,0 +1,185 @@
+#include <std_include.hpp>
+
+#include "utils/packet_dispatch.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// the oob commands the client and server register
+	const std::vector<std::string> commands
+	{
+		"getInfo", "infoResponse", "getStatus", "statusResponse", "rcon", "print", "connect",
+		"connectResponse", "getServers", "getServersResponse", "heartbeat", "disconnect",
+	};
+}
+
+TEST_CASE(packet_dispatch_lookup)
+{
+	packet_dispatch::command_table table;
+	CHECK(!table.find("getInfo"));
+
+	std::vector<size_t> indices;
+	for (const auto& command : commands)
+	{
+		indices.emplace_back(table.add(command));
+	}
+
+	REQUIRE(table.size() == commands.size());
+
+	for (size_t i = 0; i < commands.size(); ++i)
+	{
+		auto upper = commands[i];
+		std::transform(upper.begin(), upper.end(), upper.begin(), toupper);
+
+		CHECK(table.find(commands[i]) == indices[i]);
+		CHECK(table.find(upper) == indices[i]);
+
+		// adding it again hands out the existing index
+		CHECK(table.add(upper) == indices[i]);
+	}
+
+	CHECK(table.size() == commands.size());
+	CHECK(table.get_name(indices[0]) == "getinfo");
+
+	CHECK(!table.find("unknownCommand"));
+	CHECK(!table.find("getInf"));
+	CHECK(!table.find("getInfoo"));
+	CHECK(!table.find(""));
+}
+
+TEST_CASE(packet_dispatch_indices_stay_valid)
+{
+	packet_dispatch::command_table table;
+	const auto first = table.add("first");
+
+	// every add rebuilds the hash, earlier indices must not move
+	for (auto i = 0; i < 500; ++i)
+	{
+		CHECK(table.add("command" + std::to_string(i)) == static_cast<size_t>(i + 1));
+	}
+
+	CHECK(table.find("FIRST") == first);
+
+	for (auto i = 0; i < 500; ++i)
+	{
+		CHECK(table.find("Command" + std::to_string(i)) == static_cast<size_t>(i + 1));
+	}
+}
+
+TEST_CASE(packet_dispatch_rate_limit)
+{
+	packet_dispatch::rate_limiter limiter;
+	const packet_dispatch::rate_limit limit{3, 100ms};
+	const auto start = packet_dispatch::rate_limiter::clock::time_point{} + 1h;
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		CHECK(!limiter.is_limited(1, 0, limit, start));
+	}
+
+	CHECK(limiter.is_limited(1, 0, limit, start));
+
+	// other addresses and other commands have their own bucket
+	CHECK(!limiter.is_limited(2, 0, limit, start));
+	CHECK(!limiter.is_limited(1, 1, limit, start));
+
+	// one token per interval comes back, never more than the burst
+	CHECK(!limiter.is_limited(1, 0, limit, start + 150ms));
+	CHECK(limiter.is_limited(1, 0, limit, start + 150ms));
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		CHECK(!limiter.is_limited(1, 0, limit, start + 10s));
+	}
+
+	CHECK(limiter.is_limited(1, 0, limit, start + 10s));
+
+	// no limit
+	for (auto i = 0; i < 100; ++i)
+	{
+		CHECK(!limiter.is_limited(1, 2, {}, start));
+	}
+}
+
+TEST_CASE(packet_dispatch_forgets_quiet_addresses)
+{
+	packet_dispatch::rate_limiter limiter;
+	const packet_dispatch::rate_limit limit{1, 1s};
+	const auto start = packet_dispatch::rate_limiter::clock::time_point{} + 1h;
+
+	for (uint32_t ip = 0; ip < 5000; ++ip)
+	{
+		limiter.is_limited(ip, 0, limit, start);
+	}
+
+	CHECK(limiter.size() == 5000);
+
+	// once over the cap, a new address drops everything that went quiet
+	limiter.is_limited(5000, 0, limit, start + 1min);
+	CHECK(limiter.size() == 1);
+}
+
+TEST_CASE(packet_dispatch_flood)
+{
+	packet_dispatch::command_table table;
+	for (const auto& command : commands)
+	{
+		table.add(command);
+	}
+
+	// synthetic packets from a few thousand spoofed addresses with mixed case and unknown commands,
+	// this measures the lookup and the limiter that run for every packet before any handler
+	std::vector<std::string> names;
+	for (const auto& command : commands)
+	{
+		auto upper = command;
+		std::transform(upper.begin(), upper.end(), upper.begin(), toupper);
+		names.emplace_back(command);
+		names.emplace_back(std::move(upper));
+	}
+
+	names.emplace_back("unknownCommand");
+
+	packet_dispatch::rate_limiter limiter;
+	const packet_dispatch::rate_limit limit{20, 100ms};
+
+	// a multiple of the name count, so every name is sent equally often
+	constexpr auto packets = 2000000u;
+	auto dispatched = 0u;
+	auto limited = 0u;
+	auto unknown = 0u;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (auto i = 0u; i < packets; ++i)
+	{
+		const auto index = table.find(names[i % names.size()]);
+		if (!index)
+		{
+			++unknown;
+			continue;
+		}
+
+		if (limiter.is_limited(0x0A000000u | (i & 0xFFF), *index, limit, start))
+		{
+			++limited;
+		}
+		else
+		{
+			++dispatched;
+		}
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+	CHECK(dispatched + limited + unknown == packets);
+	CHECK(unknown == packets / names.size());
+	// every address/command pair gets its burst through, the rest of the flood is dropped
+	CHECK(limited > 0);
+	CHECK(dispatched <= 0x1000u * commands.size() * limit.burst);
+
+	printf("  %u packets in %lld us (%.1f ns/packet), %u dispatched, %u rate limited, %u unknown\n", packets,
+		static_cast<long long>(duration.count() / 1000), static_cast<double>(duration.count()) / packets, dispatched,
+		limited, unknown);
+}
@@ -0,0 +1,105 @@
+#include <std_include.hpp>
+
+#include "game/demonware/keys.hpp"
+#include "game/demonware/reply.hpp"
+
+#include <utils/cryptography.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	void derive_test_keys()
+	{
+		demonware::set_session_key(std::string(24, '\x42'));
+		demonware::queue_packet_to_hash("reply test");
+		demonware::derive_keys_s1();
+	}
+
+	template <typename T>
+	T read_value(const std::string& data, const std::size_t offset)
+	{
+		T value{};
+		std::memcpy(&value, data.data() + offset, sizeof(value));
+		return value;
+	}
+}
+
+TEST_CASE(reply_unencrypted_framing)
+{
+	demonware::byte_buffer payload;
+	payload.write_string("payload");
+
+	demonware::unencrypted_reply reply(7, &payload);
+	const auto data = reply.data();
+
+	REQUIRE(data.size() == 6 + payload.size());
+	CHECK(read_value<int>(data, 0) == static_cast<int>(payload.size()) + 2);
+	CHECK(data[4] == 0);
+	CHECK(data[5] == 7);
+	CHECK(data.substr(6) == payload.get_buffer());
+}
+
+TEST_CASE(reply_encrypted_framing)
+{
+	derive_test_keys();
+
+	const std::string seed("\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED\x5E\xED", 16);
+	auto previous_count = 0;
+
+	// payload sizes around the 16 byte padding boundary
+	for (auto size = 0u; size < 40; ++size)
+	{
+		demonware::byte_buffer payload;
+		payload.set_use_data_types(false);
+		for (auto i = 0u; i < size; ++i)
+		{
+			payload.write_ubyte(static_cast<unsigned char>(i * 13));
+		}
+
+		demonware::encrypted_reply reply(1, &payload);
+		const auto data = reply.data();
+
+		const auto enc_size = (size + 5 + 15) & ~15u;
+		REQUIRE(data.size() == 34 + enc_size);
+
+		CHECK(read_value<int>(data, 0) == static_cast<int>(data.size()) - 4);
+		CHECK(static_cast<unsigned char>(data[4]) == 0xAB);
+		CHECK(static_cast<unsigned char>(data[5]) == 0x85);
+
+		const auto count = read_value<int>(data, 6);
+		CHECK(!previous_count || count == previous_count + 1);
+		previous_count = count;
+
+		CHECK(data.substr(10, 16) == seed);
+
+		const auto hash = utils::cryptography::hmac_sha1::compute(data.substr(0, data.size() - 8), demonware::get_hmac_key());
+		CHECK(data.substr(data.size() - 8) == hash.substr(0, 8));
+
+		const auto plain = utils::cryptography::aes::decrypt(data.substr(26, enc_size), seed, demonware::get_encrypt_key());
+		CHECK(read_value<unsigned int>(plain, 0) == size);
+		CHECK(plain[4] == 1);
+		CHECK(plain.substr(5, size) == payload.get_buffer());
+		CHECK(plain.find_first_not_of('\0', 5 + size) == std::string::npos);
+	}
+}
+
+TEST_CASE(aes_in_place_matches_copy)
+{
+	const std::string key("0123456789abcdef");
+	const std::string iv("fedcba9876543210");
+
+	std::string data;
+	for (auto i = 0; i < 96; ++i)
+	{
+		data.push_back(static_cast<char>(i * 7));
+	}
+
+	const auto expected = utils::cryptography::aes::encrypt(data, iv, key);
+
+	auto in_place = data;
+	REQUIRE(utils::cryptography::aes::encrypt(reinterpret_cast<uint8_t*>(in_place.data()), in_place.size(), iv, key));
+	CHECK(in_place == expected);
+
+	CHECK(!utils::cryptography::aes::encrypt(reinterpret_cast<uint8_t*>(in_place.data()), 15, iv, key));
+}
@@ -0,0 +1,111 @@
+#include <std_include.hpp>
+
+#include "component/gsc/script_profiler.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// two scripts with a gap between them, functions registered out of order
+	char bytecode[200];
+	char* script_a = bytecode;
+	char* script_b = bytecode + 150;
+
+	const gsc::profiler::function_table_t functions
+	{
+		{"a", {{"main", script_a + 40}, {"init", script_a}, {"__end__", script_a + 100}}},
+		{"b", {{"think", script_b}, {"__end__", script_b + 50}}},
+	};
+
+	gsc::profiler::sample_t make_sample(const std::uint64_t time, const std::initializer_list<const char*> frames)
+	{
+		gsc::profiler::sample_t sample{};
+		sample.time = time;
+
+		for (const auto* frame : frames)
+		{
+			sample.frames[sample.depth++] = frame;
+		}
+
+		return sample;
+	}
+}
+
+TEST_CASE(script_profiler_resolver)
+{
+	const auto resolver = gsc::profiler::create_resolver(functions);
+
+	const auto name_at = [&](const char* pos) -> std::string
+	{
+		const auto info = resolver(pos);
+		return info.has_value() ? info->file + "::" + info->function : "unknown";
+	};
+
+	CHECK(name_at(script_a) == "a::init");
+	CHECK(name_at(script_a + 39) == "a::init");
+	CHECK(name_at(script_a + 40) == "a::main");
+	// the last function of a script runs up to the end of its bytecode
+	CHECK(name_at(script_a + 99) == "a::main");
+	CHECK(name_at(script_b + 49) == "b::think");
+
+	CHECK(name_at(script_a + 100) == "unknown");
+	CHECK(name_at(script_b + 50) == "unknown");
+}
+
+TEST_CASE(script_profiler_aggregate)
+{
+	const auto resolver = gsc::profiler::create_resolver(functions);
+
+	const std::vector samples
+	{
+		make_sample(0, {script_a + 50, script_a + 10}),
+		make_sample(1000, {script_a + 50, script_a + 10}),
+		make_sample(2000, {script_a + 50, script_b + 5}),
+		// recursion only counts once towards the total
+		make_sample(3000, {script_a + 50, script_a + 60}),
+		gsc::profiler::sample_t{},
+	};
+
+	const auto profile = gsc::profiler::aggregate(samples, resolver);
+	CHECK(profile.sample_count == 4);
+
+	const auto& main = profile.functions.at("a::main");
+	CHECK(main.total_samples == 4);
+	CHECK(main.self_samples == 1);
+
+	const auto& init = profile.functions.at("a::init");
+	CHECK(init.total_samples == 2);
+	CHECK(init.self_samples == 2);
+
+	CHECK(profile.functions.at("b::think").self_samples == 1);
+
+	CHECK(gsc::profiler::export_collapsed(profile) ==
+		"a::main;a::init 2\n"
+		"a::main;a::main 1\n"
+		"a::main;b::think 1\n");
+}
+
+TEST_CASE(script_profiler_chrome_trace)
+{
+	const auto resolver = gsc::profiler::create_resolver(functions);
+
+	const std::vector samples
+	{
+		make_sample(0, {script_a + 50, script_a + 10}),
+		make_sample(1000, {script_a + 50, script_a + 10}),
+		make_sample(2000, {script_a + 50, script_b + 5}),
+	};
+
+	const auto trace = nlohmann::json::parse(gsc::profiler::export_chrome_trace(samples, resolver));
+	const auto& events = trace["traceEvents"];
+
+	// identical consecutive stacks are merged, main stays open for the whole trace
+	std::vector<std::string> sequence;
+	for (const auto& event : events)
+	{
+		sequence.push_back(event["ph"].get<std::string>() + " " + event["name"].get<std::string>());
+	}
+
+	CHECK((sequence == std::vector<std::string>{"B a::main", "B a::init", "E a::init", "B b::think", "E b::think", "E a::main"}));
+	CHECK(events.back()["ts"] == 2000);
+}
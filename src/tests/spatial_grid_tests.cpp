@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <utils/spatial_grid.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	struct point
+	{
+		float origin[3];
+		bool present;
+	};
+
+	std::vector<uint32_t> query_radius(const utils::spatial_grid& grid, const float* center, const float radius)
+	{
+		std::vector<uint32_t> results;
+		grid.query_radius(center, radius, results);
+		std::ranges::sort(results);
+		return results;
+	}
+
+	std::vector<uint32_t> brute_force(const std::vector<point>& points, const float* center, const float radius)
+	{
+		std::vector<uint32_t> results;
+
+		for (uint32_t id = 0; id < points.size(); ++id)
+		{
+			const auto& point = points[id];
+			const auto dx = point.origin[0] - center[0];
+			const auto dy = point.origin[1] - center[1];
+
+			if (point.present && dx * dx + dy * dy < radius * radius)
+			{
+				results.push_back(id);
+			}
+		}
+
+		return results;
+	}
+}
+
+TEST_CASE(spatial_grid_matches_brute_force)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(-8000.f, 8000.f);
+
+	utils::spatial_grid grid{512.f};
+	std::vector<point> points(2000);
+
+	for (uint32_t id = 0; id < points.size(); ++id)
+	{
+		auto& point = points[id];
+		point = {{coordinate(random), coordinate(random), coordinate(random)}, true};
+		grid.update(id, point.origin);
+	}
+
+	// moves across cells, removals and reinsertions
+	for (uint32_t id = 0; id < points.size(); id += 3)
+	{
+		auto& point = points[id];
+		point.origin[0] = coordinate(random);
+		point.origin[1] = coordinate(random);
+		grid.update(id, point.origin);
+	}
+
+	for (uint32_t id = 1; id < points.size(); id += 5)
+	{
+		points[id].present = false;
+		grid.remove(id);
+	}
+
+	const auto present = std::ranges::count_if(points, [](const point& point)
+	{
+		return point.present;
+	});
+
+	CHECK(grid.size() == static_cast<size_t>(present));
+	CHECK(grid.contains(0));
+	CHECK(!grid.contains(1));
+
+	for (auto i = 0; i < 50; ++i)
+	{
+		const float center[3] = {coordinate(random), coordinate(random), 0.f};
+		const auto radius = std::uniform_real_distribution<float>(0.f, 3000.f)(random);
+
+		CHECK(query_radius(grid, center, radius) == brute_force(points, center, radius));
+	}
+}
+
+TEST_CASE(spatial_grid_negative_coordinates_and_borders)
+{
+	utils::spatial_grid grid{100.f};
+
+	const float a[3] = {-0.5f, -0.5f, 0.f};
+	const float b[3] = {0.f, 0.f, 0.f};
+	const float c[3] = {-100.f, 100.f, 0.f};
+
+	grid.update(1, a);
+	grid.update(2, b);
+	grid.update(3, c);
+
+	CHECK(query_radius(grid, b, 1.f) == (std::vector<uint32_t>{1, 2}));
+	CHECK(query_radius(grid, c, 1.f) == std::vector<uint32_t>{3});
+	// the radius itself is excluded
+	CHECK(query_radius(grid, c, 0.f).empty());
+	CHECK(query_radius(grid, b, 200.f) == (std::vector<uint32_t>{1, 2, 3}));
+
+	grid.clear();
+	CHECK(grid.size() == 0);
+	CHECK(query_radius(grid, b, 1000.f).empty());
+}
+
+TEST_CASE(spatial_grid_frustum)
+{
+	utils::spatial_grid grid{256.f};
+
+	const float ahead[3] = {1000.f, 0.f, 0.f};
+	const float behind[3] = {-1000.f, 0.f, 0.f};
+	const float near_plane[3] = {-10.f, 0.f, 0.f};
+
+	grid.update(1, ahead);
+	grid.update(2, behind);
+	grid.update(3, near_plane);
+
+	// only the plane facing +x matters, the others accept everything
+	utils::spatial_grid::frustum frustum{};
+	frustum.planes[0] = {{1.f, 0.f, 0.f}, 0.f};
+	for (auto i = 1; i < 5; ++i)
+	{
+		frustum.planes[i] = {{0.f, 0.f, 1.f}, 100000.f};
+	}
+
+	const float center[3] = {};
+
+	std::vector<uint32_t> results;
+	grid.query_frustum(frustum, 0.f, center, 5000.f, results);
+	std::ranges::sort(results);
+	CHECK(results == std::vector<uint32_t>{1});
+
+	// the margin keeps points just outside
+	results.clear();
+	grid.query_frustum(frustum, 50.f, center, 5000.f, results);
+	std::ranges::sort(results);
+	CHECK(results == (std::vector<uint32_t>{1, 3}));
+}
+
+TEST_CASE(spatial_grid_benchmark)
+{
+	// a large synthetic map, pathnodes are denser than this on real ones but spread similarly
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> coordinate(-8000.f, 8000.f);
+
+	utils::spatial_grid grid{512.f};
+	std::vector<point> points(10000);
+
+	for (uint32_t id = 0; id < points.size(); ++id)
+	{
+		auto& point = points[id];
+		point = {{coordinate(random), coordinate(random), coordinate(random)}, true};
+		grid.update(id, point.origin);
+	}
+
+	std::vector<std::array<float, 3>> centers(1000);
+	for (auto& center : centers)
+	{
+		center = {coordinate(random), coordinate(random), 0.f};
+	}
+
+	const auto measure = [&](const char* label, const float radius, const auto& query)
+	{
+		size_t found = 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		for (const auto& center : centers)
+		{
+			found += query(center.data(), radius).size();
+		}
+
+		const auto duration = std::chrono::steady_clock::now() - start;
+		printf("  %-20s %.2f us/query, %.1f results\n", label,
+			std::chrono::duration<double, std::micro>(duration).count() / centers.size(),
+			static_cast<double>(found) / centers.size());
+
+		return duration;
+	};
+
+	for (const auto radius : {500.f, 2000.f})
+	{
+		printf("  radius %.0f\n", radius);
+
+		const auto indexed = measure("grid", radius, [&](const float* center, const float range)
+		{
+			std::vector<uint32_t> results;
+			grid.query_radius(center, range, results);
+			return results;
+		});
+
+		const auto linear = measure("linear scan", radius, [&](const float* center, const float range)
+		{
+			return brute_force(points, center, range);
+		});
+
+		CHECK(indexed < linear);
+	}
+
+	for (auto i = 0; i < 20; ++i)
+	{
+		CHECK(query_radius(grid, centers[i].data(), 500.f) == brute_force(points, centers[i].data(), 500.f));
+	}
+
+	// entities move every frame, a frame of moving all of them once
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t id = 0; id < points.size(); ++id)
+	{
+		auto& point = points[id];
+		point.origin[0] += 20.f;
+		point.origin[1] -= 20.f;
+		grid.update(id, point.origin);
+	}
+
+	printf("  %-20s %.1f ns/update\n", "update",
+		std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / points.size());
+
+	CHECK(query_radius(grid, centers[0].data(), 2000.f) == brute_force(points, centers[0].data(), 2000.f));
+}
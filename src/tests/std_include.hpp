@@ -0,0 +1,36 @@
+#pragma once
+
+// Stands in for the client's precompiled header when client sources are built into the tests,
+// only the standard library, json and the windows headers the game structs need are available there
+
+#define WIN32_LEAN_AND_MEAN
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csetjmp>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Windows.h>
+#include <WinSock2.h>
+
+#include <json.hpp>
+
+using namespace std::literals;
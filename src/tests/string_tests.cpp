@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <utils/string.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	// the implementations the string helpers replaced, kept here to compare against
+
+	const char* old_va(const char* fmt, ...)
+	{
+		// 8 buffers from the mutex guarded allocator, doubled until the result fits
+		struct entry
+		{
+			size_t size = 256;
+			std::unique_ptr<char[]> buffer = std::make_unique<char[]>(256);
+		};
+
+		static std::mutex allocator_mutex;
+		static thread_local entry entries[8];
+		static thread_local size_t current = 0;
+
+		auto& entry = entries[++current %= 8];
+
+		while (true)
+		{
+			va_list ap;
+			va_start(ap, fmt);
+			const auto length = vsnprintf(entry.buffer.get(), entry.size, fmt, ap);
+			va_end(ap);
+
+			if (length >= 0 && static_cast<size_t>(length) < entry.size)
+			{
+				return entry.buffer.get();
+			}
+
+			std::lock_guard<std::mutex> _(allocator_mutex);
+			entry.size *= 2;
+			entry.buffer = std::make_unique<char[]>(entry.size);
+		}
+	}
+
+	std::vector<std::string> old_split(const std::string& s, const char delim)
+	{
+		std::stringstream ss(s);
+		std::string item;
+		std::vector<std::string> elems;
+
+		while (std::getline(ss, item, delim))
+		{
+			elems.push_back(item);
+		}
+
+		return elems;
+	}
+
+	std::string old_to_lower(std::string text)
+	{
+		std::transform(text.begin(), text.end(), text.begin(), [](const unsigned char input)
+		{
+			return static_cast<char>(std::tolower(input));
+		});
+
+		return text;
+	}
+
+	double measure(const char* label, const size_t iterations, const std::function<size_t()>& function)
+	{
+		size_t checksum = 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			checksum += function();
+		}
+
+		const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+		printf("  %-20s %.1f ns/op\n", label, ns);
+
+		CHECK(checksum > 0);
+		return ns;
+	}
+}
+
+TEST_CASE(string_split_matches_getline)
+{
+	using list = std::vector<std::string>;
+
+	CHECK(utils::string::split("", ',') == list{});
+	CHECK(utils::string::split("a", ',') == list{"a"});
+	CHECK(utils::string::split("a,b", ',') == (list{"a", "b"}));
+	CHECK(utils::string::split("a,,b", ',') == (list{"a", "", "b"}));
+	CHECK(utils::string::split(",a", ',') == (list{"", "a"}));
+	// a trailing delimiter doesn't start another token
+	CHECK(utils::string::split("a,", ',') == list{"a"});
+	CHECK(utils::string::split("a,,", ',') == (list{"a", ""}));
+}
+
+TEST_CASE(string_tokenizer)
+{
+	utils::string::tokenizer tokens("map mp_rust gametype war", ' ');
+
+	std::vector<std::string_view> result;
+	for (std::string_view token; tokens.next(token);)
+	{
+		result.emplace_back(token);
+	}
+
+	REQUIRE(result.size() == 4);
+	CHECK(result[0] == "map");
+	CHECK(result[1] == "mp_rust");
+	CHECK(result[2] == "gametype");
+	CHECK(result[3] == "war");
+
+	std::string_view token;
+	CHECK(!tokens.next(token));
+}
+
+TEST_CASE(string_case_folding)
+{
+	// longer than one sse2 block, with characters right next to the letter ranges
+	const std::string mixed = "@AZ[`az{ Hello World 0123456789 MP_Rust_Night \xC4\xE4";
+
+	CHECK(utils::string::to_lower(mixed) == "@az[`az{ hello world 0123456789 mp_rust_night \xC4\xE4");
+	CHECK(utils::string::to_upper(mixed) == "@AZ[`AZ{ HELLO WORLD 0123456789 MP_RUST_NIGHT \xC4\xE4");
+
+	CHECK(utils::string::equals_ignore_case("MP_Rust", "mp_rust"));
+	CHECK(!utils::string::equals_ignore_case("mp_rust", "mp_rus"));
+	CHECK(!utils::string::equals_ignore_case("[", "{"));
+
+	CHECK(utils::string::hash_ignore_case("G_Speed") == utils::string::hash_ignore_case("g_speed"));
+
+	std::unordered_map<std::string, int, utils::string::hash_case_insensitive, utils::string::equal_case_insensitive> map;
+	map["sv_hostname"] = 1;
+
+	CHECK(map.contains(std::string_view("SV_HostName")));
+	CHECK(!map.contains(std::string_view("sv_host")));
+}
+
+TEST_CASE(string_find_lower)
+{
+	CHECK(utils::string::find_lower("Terminal Night", "NIGHT"));
+	CHECK(utils::string::find_lower("Terminal", ""));
+	CHECK(!utils::string::find_lower("Terminal", "nights"));
+}
+
+TEST_CASE(string_va_ring)
+{
+	// a result stays valid for the next 7 calls on the same thread
+	const auto* first = utils::string::va("%d", 1);
+	for (auto i = 2; i <= 8; ++i)
+	{
+		utils::string::va("%d", i);
+	}
+
+	CHECK(std::string(first) == "1");
+
+	const auto before = utils::string::get_va_stats();
+
+	const std::string large(1000, 'x');
+	CHECK(utils::string::va("%s", large.data()) == large);
+	CHECK(utils::string::get_va_stats().grown == before.grown + 1);
+
+	const std::string huge(utils::string::va_max_size + 10, 'y');
+	CHECK(std::string(utils::string::va("%s", huge.data())).size() == utils::string::va_max_size - 1);
+	CHECK(utils::string::get_va_stats().truncated == before.truncated + 1);
+}
+
+TEST_CASE(string_matches_old_implementations)
+{
+	const std::string config = "seta sv_hostname \"Night Terminal\",,seta g_speed 190,bind F1 vote yes,";
+	CHECK(utils::string::split(config, ',') == old_split(config, ','));
+	CHECK(utils::string::split(config, ' ') == old_split(config, ' '));
+
+	std::string bytes;
+	for (auto i = 0; i < 256; ++i)
+	{
+		bytes.push_back(static_cast<char>(i));
+	}
+
+	CHECK(utils::string::to_lower(bytes) == old_to_lower(bytes));
+
+	for (const auto size : {10, 600, 5000})
+	{
+		const std::string text(size, 'v');
+		CHECK(std::string(utils::string::va("%s %d", text.data(), size)) == old_va("%s %d", text.data(), size));
+	}
+}
+
+TEST_CASE(string_benchmark)
+{
+	constexpr size_t iterations = 200000;
+
+	// the kind of text these see at their hot call sites, dvar names, status lines and config strings
+	std::string line;
+	for (auto i = 0; i < 64; ++i)
+	{
+		line.append("Token_").append(std::to_string(i)).push_back(' ');
+	}
+
+	const std::string long_text(2000, 'x');
+	auto counter = 0;
+
+	printf("  va, short\n");
+	measure("old", iterations, [&]()
+	{
+		return std::strlen(old_va("%s:%d", "mp_rust", ++counter));
+	});
+	measure("new", iterations, [&]()
+	{
+		return std::strlen(utils::string::va("%s:%d", "mp_rust", ++counter));
+	});
+
+	printf("  va, 2000 characters\n");
+	measure("old", iterations / 10, [&]()
+	{
+		return std::strlen(old_va("%s", long_text.data()));
+	});
+	measure("new", iterations / 10, [&]()
+	{
+		return std::strlen(utils::string::va("%s", long_text.data()));
+	});
+
+	printf("  split, 64 tokens\n");
+	const auto old_split_ns = measure("old", iterations / 20, [&]()
+	{
+		return old_split(line, ' ').size();
+	});
+	const auto split_ns = measure("new", iterations / 20, [&]()
+	{
+		return utils::string::split(line, ' ').size();
+	});
+	measure("tokenizer", iterations / 20, [&]()
+	{
+		size_t count = 0;
+		utils::string::tokenizer tokens(line, ' ');
+		for (std::string_view token; tokens.next(token);)
+		{
+			++count;
+		}
+
+		return count;
+	});
+
+	printf("  to_lower, %zu characters\n", line.size());
+	const auto old_lower_ns = measure("old", iterations, [&]()
+	{
+		return old_to_lower(line).size();
+	});
+	const auto lower_ns = measure("new", iterations, [&]()
+	{
+		return utils::string::to_lower(line).size();
+	});
+
+	CHECK(split_ns < old_split_ns);
+	CHECK(lower_ns < old_lower_ns);
+}
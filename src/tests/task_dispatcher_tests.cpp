@@ -0,0 +1,176 @@
+#include <std_include.hpp>
+
+#include "game/demonware/service.hpp"
+#include "game/demonware/task_dispatcher.hpp"
+
+#include "test.hpp"
+
+namespace
+{
+	// answers every task with its payload and records whether two of its tasks ever ran at the same time
+	class replay_service final : public demonware::service
+	{
+	public:
+		explicit replay_service(const uint8_t id)
+			: service(id, "replay")
+		{
+		}
+
+		void exec_task(demonware::service_server*, const std::string& data) override
+		{
+			if (this->running_.exchange(true))
+			{
+				this->overlapped_ = true;
+			}
+
+			// roughly the cost of building a small reply
+			auto hash = 0u;
+			for (auto i = 0; i < 2000; ++i)
+			{
+				hash = hash * 31 + static_cast<unsigned char>(data[i % data.size()]);
+			}
+
+			this->sink_ += hash;
+
+			std::unique_ptr<demonware::reply> reply = std::make_unique<demonware::raw_reply>(data);
+			demonware::task_dispatcher::capture(reply);
+
+			this->running_ = false;
+		}
+
+		bool overlapped() const
+		{
+			return this->overlapped_;
+		}
+
+	private:
+		std::atomic_bool running_{};
+		std::atomic_bool overlapped_{};
+		std::atomic<unsigned int> sink_{};
+	};
+
+	struct replay_result
+	{
+		std::vector<std::string> emitted;
+		std::chrono::microseconds duration;
+	};
+
+	// a login burst: most traffic goes to a few services, storage and stats tasks queue up behind each other
+	std::vector<std::pair<uint8_t, std::string>> record_session(const std::size_t task_count)
+	{
+		constexpr uint8_t service_ids[] = {10, 10, 10, 19, 19, 4, 4, 6, 7, 12, 26, 28};
+
+		std::vector<std::pair<uint8_t, std::string>> session;
+		session.reserve(task_count);
+
+		for (std::size_t i = 0; i < task_count; ++i)
+		{
+			session.emplace_back(service_ids[(i * 7) % std::size(service_ids)], "task " + std::to_string(i));
+		}
+
+		return session;
+	}
+
+	replay_result replay(const std::vector<std::pair<uint8_t, std::string>>& session,
+		std::unordered_map<uint8_t, std::unique_ptr<replay_service>>& services, const std::size_t worker_count)
+	{
+		replay_result result{};
+		result.emitted.reserve(session.size());
+
+		std::mutex mutex;
+		std::condition_variable condition;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		{
+			demonware::task_dispatcher dispatcher(worker_count, [&](demonware::reply* reply)
+			{
+				std::lock_guard<std::mutex> _(mutex);
+				result.emitted.emplace_back(reply->data());
+				condition.notify_one();
+			});
+
+			for (const auto& [id, data] : session)
+			{
+				auto& service = services[id];
+				if (!service)
+				{
+					service = std::make_unique<replay_service>(id);
+				}
+
+				dispatcher.dispatch(service.get(), nullptr, data);
+			}
+
+			// the dispatcher drops queued tasks when it's destroyed
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]()
+			{
+				return result.emitted.size() == session.size();
+			});
+		}
+
+		result.duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		return result;
+	}
+}
+
+TEST_CASE(task_dispatcher_replay)
+{
+	const auto session = record_session(20000);
+
+	for (const auto worker_count : {1u, 3u})
+	{
+		std::unordered_map<uint8_t, std::unique_ptr<replay_service>> services;
+		const auto result = replay(session, services, worker_count);
+
+		// replies leave in dispatch order whatever order the services finished in
+		REQUIRE(result.emitted.size() == session.size());
+		for (std::size_t i = 0; i < session.size(); ++i)
+		{
+			REQUIRE(result.emitted[i] == session[i].second);
+		}
+
+		for (const auto& [id, service] : services)
+		{
+			CHECK(!service->overlapped());
+		}
+
+		printf("  %u workers: %zu tasks in %lld us\n", worker_count, session.size(), static_cast<long long>(result.duration.count()));
+	}
+}
+
+TEST_CASE(task_dispatcher_post_keeps_order)
+{
+	std::vector<std::string> emitted;
+	std::mutex mutex;
+	std::condition_variable condition;
+
+	replay_service service{1};
+
+	{
+		demonware::task_dispatcher dispatcher(3, [&](demonware::reply* reply)
+		{
+			std::lock_guard<std::mutex> _(mutex);
+			emitted.emplace_back(reply->data());
+			condition.notify_one();
+		});
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			dispatcher.dispatch(&service, nullptr, "task " + std::to_string(i));
+			dispatcher.post(std::make_unique<demonware::raw_reply>("post " + std::to_string(i)));
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [&]()
+		{
+			return emitted.size() == 200;
+		});
+	}
+
+	for (auto i = 0; i < 100; ++i)
+	{
+		CHECK(emitted[i * 2] == "task " + std::to_string(i));
+		CHECK(emitted[i * 2 + 1] == "post " + std::to_string(i));
+	}
+}
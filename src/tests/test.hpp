@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+// Minimal self registering tests, a failed check reports and keeps going, a failed require ends the test
+namespace test
+{
+	using test_function = void(*)();
+
+	void add(const char* name, test_function function);
+
+	void check(bool result, const char* expression, const char* file, int line);
+	void require(bool result, const char* expression, const char* file, int line);
+
+	// scratch directory for tests touching the disk, emptied before every test
+	std::string get_temp_directory();
+
+	struct registrar
+	{
+		registrar(const char* name, const test_function function)
+		{
+			add(name, function);
+		}
+	};
+}
+
+#define TEST_CASE(name)                                                  \
+	static void test_##name();                                           \
+	static const test::registrar registrar_##name{#name, test_##name};   \
+	static void test_##name()
+
+#define CHECK(expression) test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+#define REQUIRE(expression) test::require(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
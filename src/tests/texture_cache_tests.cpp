@@ -0,0 +1,226 @@
+#include <string>
+
+#include <utils/compression.hpp>
+#include <utils/io.hpp>
+#include <utils/texture_cache.hpp>
+
+#include "test.hpp"
+
+namespace
+{
+	// uncompressed 32 bit tga, stored top down, every pixel derived from its position and the seed
+	std::string make_image(const int width, const int height, const int seed = 0)
+	{
+		std::string data(18, '\0');
+		data[2] = 2;
+		data[12] = static_cast<char>(width & 0xFF);
+		data[13] = static_cast<char>(width >> 8);
+		data[14] = static_cast<char>(height & 0xFF);
+		data[15] = static_cast<char>(height >> 8);
+		data[16] = 32;
+		data[17] = 0x28;
+
+		for (auto y = 0; y < height; ++y)
+		{
+			for (auto x = 0; x < width; ++x)
+			{
+				// bgra
+				data.push_back(static_cast<char>(x * 4 + seed));
+				data.push_back(static_cast<char>(y * 4));
+				data.push_back(static_cast<char>(x + y));
+				data.push_back(static_cast<char>(255 - seed));
+			}
+		}
+
+		return data;
+	}
+
+	uint8_t get_channel(const utils::texture_cache::texture& texture, const int x, const int y, const int channel)
+	{
+		return static_cast<uint8_t>(texture.pixels[(static_cast<size_t>(y) * texture.width + x) * 4 + channel]);
+	}
+}
+
+TEST_CASE(texture_cache_decode)
+{
+	const auto texture = utils::texture_cache::decode(make_image(8, 4));
+	REQUIRE(texture);
+	CHECK(texture->width == 8);
+	CHECK(texture->height == 4);
+	REQUIRE(texture->pixels.size() == 8 * 4 * 4);
+
+	// rgba
+	CHECK(get_channel(*texture, 3, 2, 0) == 5);
+	CHECK(get_channel(*texture, 3, 2, 1) == 8);
+	CHECK(get_channel(*texture, 3, 2, 2) == 12);
+	CHECK(get_channel(*texture, 3, 2, 3) == 255);
+
+	// shrunk to fit, keeping the aspect ratio
+	const auto small = utils::texture_cache::decode(make_image(8, 4), 2);
+	REQUIRE(small);
+	CHECK(small->width == 2);
+	CHECK(small->height == 1);
+
+	auto threw = false;
+	try
+	{
+		utils::texture_cache::decode("not an image");
+	}
+	catch (...)
+	{
+		threw = true;
+	}
+
+	CHECK(threw);
+}
+
+TEST_CASE(texture_cache_downscale)
+{
+	utils::texture_cache::texture texture{3, 1, {}};
+	for (const auto value : {10, 20, 40})
+	{
+		texture.pixels.append(4, static_cast<char>(value));
+	}
+
+	// 2x2 box filter, the odd last column is reused
+	const auto half = utils::texture_cache::downscale(texture, 2);
+	REQUIRE(half);
+	CHECK(half->width == 1);
+	CHECK(half->height == 1);
+	REQUIRE(half->pixels.size() == 4);
+	CHECK(static_cast<uint8_t>(half->pixels[0]) == 15);
+
+	const auto same = utils::texture_cache::downscale(texture, 4);
+	CHECK(same->width == 3);
+	CHECK(same->pixels == texture.pixels);
+}
+
+TEST_CASE(texture_cache_submit_and_get)
+{
+	utils::texture_cache cache(0x100000, 2);
+
+	cache.submit("a", make_image(16, 16, 1));
+	cache.submit("b", make_image(16, 16, 1));
+	cache.submit("broken", "not an image");
+
+	CHECK(cache.contains("a"));
+	CHECK(!cache.contains("c"));
+	CHECK(!cache.get("c"));
+	CHECK(!cache.get("broken"));
+
+	const auto a = cache.get("a");
+	REQUIRE(a);
+	CHECK(a->width == 16);
+
+	// same data under another name and unnamed lookups share the decoded pixels
+	CHECK(cache.get("b") == a);
+	CHECK(cache.get_or_decode(make_image(16, 16, 1)) == a);
+	CHECK(cache.get_used_bytes() == 16 * 16 * 4);
+
+	// the name follows the newest data
+	cache.submit("a", make_image(8, 8, 2));
+	const auto replaced = cache.get("a");
+	REQUIRE(replaced);
+	CHECK(replaced->width == 8);
+	CHECK(cache.get("b") == a);
+
+	CHECK(!cache.get_or_decode("still not an image"));
+}
+
+TEST_CASE(texture_cache_eviction)
+{
+	// room for two 16x16 images
+	utils::texture_cache cache(16 * 16 * 4 * 2, 1);
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		cache.submit(std::to_string(i), make_image(16, 16, i));
+		CHECK(cache.get(std::to_string(i)));
+	}
+
+	CHECK(cache.get_used_bytes() == 16 * 16 * 4 * 2);
+
+	// evicted images are decoded again from their data
+	const auto first = cache.get("0");
+	REQUIRE(first);
+	CHECK(get_channel(*first, 0, 0, 2) == 0);
+	CHECK(cache.get_used_bytes() == 16 * 16 * 4 * 2);
+
+	// the newest one is kept even if it doesn't fit
+	cache.submit("big", make_image(64, 64));
+	CHECK(cache.get("big"));
+	CHECK(cache.get_used_bytes() == 64 * 64 * 4);
+}
+
+TEST_CASE(texture_cache_stop)
+{
+	utils::texture_cache cache(0x100000, 1);
+	cache.stop();
+
+	// without workers images are decoded by whoever needs them
+	cache.submit("a", make_image(4, 4));
+	const auto texture = cache.get("a");
+	REQUIRE(texture);
+	CHECK(texture->width == 4);
+}
+
+TEST_CASE(texture_cache_persistent)
+{
+	const auto directory = test::get_temp_directory() + "/images";
+	const auto image = make_image(32, 16, 3);
+
+	{
+		utils::texture_cache cache(0x100000, 1, directory, 16);
+		cache.submit("motd", image, true);
+		cache.submit("volatile", make_image(4, 4), false);
+
+		const auto texture = cache.get("motd");
+		REQUIRE(texture);
+		CHECK(texture->width == 16);
+		CHECK(texture->height == 8);
+		CHECK(cache.get("volatile"));
+	}
+
+	const auto files = utils::io::list_files(directory);
+	REQUIRE(files.size() == 1);
+	CHECK(files[0].ends_with(".txc"));
+
+	// a later run reads the pixels back instead of decoding, swap in a different image to tell them apart
+	std::string stored;
+	REQUIRE(utils::io::read_file(files[0], &stored));
+
+	auto replacement = stored.substr(0, 4);
+	replacement.append("\x01\0\0\0\x01\0\0\0", 8);
+	replacement.append(utils::compression::zlib::compress("\x01\x02\x03\x04"));
+	REQUIRE(utils::io::write_file(files[0], replacement));
+
+	{
+		utils::texture_cache cache(0x100000, 1, directory, 16);
+		cache.submit("motd", image, true);
+
+		const auto texture = cache.get("motd");
+		REQUIRE(texture);
+		CHECK(texture->width == 1);
+		CHECK(texture->pixels == "\x01\x02\x03\x04");
+	}
+
+	// a corrupt file is decoded again and replaced
+	REQUIRE(utils::io::write_file(files[0], stored.substr(0, stored.size() / 2)));
+
+	{
+		utils::texture_cache cache(0x100000, 1, directory, 16);
+		cache.submit("motd", image, true);
+		CHECK(cache.get("motd"));
+	}
+
+	std::string rewritten;
+	REQUIRE(utils::io::read_file(files[0], &rewritten));
+	CHECK(rewritten == stored);
+
+	// the directory is pruned on construction
+	{
+		utils::texture_cache cache(0x100000, 1, directory, 16, 1);
+	}
+
+	CHECK(utils::io::list_files(directory).empty());
+}
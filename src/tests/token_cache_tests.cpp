@@ -0,0 +1,78 @@
+#include <string>
+
+#include "game/scripting/token_cache.hpp"
+
+#include "test.hpp"
+
+TEST_CASE(string_interner)
+{
+	scripting::string_interner strings;
+
+	const auto first = strings.intern("maps/mp/gametypes/_damage");
+	const auto second = strings.intern("player_damaged");
+
+	CHECK(first != second);
+	CHECK(strings.intern(std::string("maps/mp/gametypes/_damage")) == first);
+	CHECK(strings.size() == 2);
+
+	CHECK(strings.find("player_damaged") == second);
+	CHECK(strings.find("unknown") == scripting::string_interner::invalid_index);
+	CHECK(strings.get(first) == "maps/mp/gametypes/_damage");
+	CHECK(strings.get(scripting::string_interner::invalid_index).empty());
+
+	// views handed out earlier stay valid while more strings are added
+	const auto view = strings.get(first);
+	for (auto i = 0; i < 10000; ++i)
+	{
+		strings.intern(std::to_string(i));
+	}
+
+	CHECK(view == "maps/mp/gametypes/_damage");
+}
+
+TEST_CASE(token_table_flat_and_sparse_ids)
+{
+	scripting::string_interner strings;
+	scripting::token_table tokens{strings};
+
+	CHECK(tokens.set(5, "origin") == "origin");
+	CHECK(tokens.set(0x3FFFF, "last_flat") == "last_flat");
+	// past the flat array, these used to grow it up to the id and were never found again
+	CHECK(tokens.set(0x40000, "first_sparse") == "first_sparse");
+	CHECK(tokens.set(0x7FFFFFFF, "far_sparse") == "far_sparse");
+
+	CHECK(tokens.find(5) == "origin");
+	CHECK(tokens.find(0x3FFFF) == "last_flat");
+	CHECK(tokens.find(0x40000) == "first_sparse");
+	CHECK(tokens.find(0x7FFFFFFF) == "far_sparse");
+
+	CHECK(!tokens.find(6).has_value());
+	CHECK(!tokens.find(0x40001).has_value());
+
+	// a new name for an id replaces the old one, both stay interned
+	tokens.set(5, "angles");
+	CHECK(tokens.find(5) == "angles");
+	CHECK(strings.find("origin") != scripting::string_interner::invalid_index);
+
+	const auto stats = tokens.get_stats();
+	CHECK(stats.hits == 5);
+	CHECK(stats.misses == 2);
+
+	tokens.clear();
+	CHECK(!tokens.find(5).has_value());
+	CHECK(!tokens.find(0x40000).has_value());
+}
+
+TEST_CASE(token_table_shared_interner)
+{
+	scripting::string_interner strings;
+	scripting::token_table canonical{strings};
+	scripting::token_table gsc{strings};
+
+	const auto a = canonical.set(1, "main");
+	const auto b = gsc.set(900000, "main");
+
+	// both tables point at the single interned copy
+	CHECK(a.data() == b.data());
+	CHECK(strings.size() == 1);
+}
@@ -0,0 +1,114 @@
+#include <std_include.hpp>
+
+#include "game/demonware/user_files.hpp"
+
+#include <utils/io.hpp>
+
+#include "test.hpp"
+
+// the store is global, every test works on its own file names
+
+TEST_CASE(user_files_write_behind)
+{
+	const auto file = test::get_temp_directory() + "/write_behind/stats.bin";
+	REQUIRE(utils::io::write_file(file, "old"));
+
+	demonware::user_files::write(file, "new");
+
+	std::string data;
+	CHECK(demonware::user_files::read(file, &data) && data == "new");
+
+	// whatever is on disk before the flush is one whole version, never a mix
+	const auto on_disk = utils::io::read_file(file);
+	CHECK((on_disk == "old" || on_disk == "new"));
+
+	demonware::user_files::flush();
+	CHECK(utils::io::read_file(file) == "new");
+	CHECK(!utils::io::file_exists(file + ".tmp"));
+}
+
+TEST_CASE(user_files_coalesced_writes_keep_the_last)
+{
+	const auto file = test::get_temp_directory() + "/coalesce/loadouts.bin";
+
+	for (auto i = 0; i < 100; ++i)
+	{
+		demonware::user_files::write(file, "version " + std::to_string(i));
+	}
+
+	demonware::user_files::flush();
+	CHECK(utils::io::read_file(file) == "version 99");
+}
+
+TEST_CASE(user_files_crash_leftovers)
+{
+	// a crash in the middle of a write leaves the temporary file behind, the target stays intact
+	const auto file = test::get_temp_directory() + "/leftovers/class.bin";
+	REQUIRE(utils::io::write_file(file, "complete"));
+	REQUIRE(utils::io::write_file(file + ".tmp", "parti"));
+
+	std::string data;
+	CHECK(demonware::user_files::read(file, &data) && data == "complete");
+
+	demonware::user_files::write(file, "replaced");
+	demonware::user_files::flush();
+
+	CHECK(utils::io::read_file(file) == "replaced");
+	CHECK(!utils::io::file_exists(file + ".tmp"));
+}
+
+TEST_CASE(user_files_failed_writes_are_retried)
+{
+	// a file where the directory should be makes the write fail
+	const auto directory = test::get_temp_directory() + "/retry";
+	const auto file = directory + "/profile.bin";
+	REQUIRE(utils::io::write_file(directory, "blocker"));
+
+	demonware::user_files::write(file, "data");
+	demonware::user_files::flush();
+	CHECK(!utils::io::file_exists(file));
+
+	// still served from memory while it couldn't be written
+	std::string data;
+	CHECK(demonware::user_files::read(file, &data) && data == "data");
+
+	REQUIRE(utils::io::remove_file(directory));
+	demonware::user_files::flush();
+	CHECK(utils::io::read_file(file) == "data");
+}
+
+TEST_CASE(user_files_cache_is_bounded)
+{
+	const auto directory = test::get_temp_directory() + "/bounded";
+	constexpr auto file_count = 40;
+	const std::string payload(1024 * 1024, 'x');
+
+	for (auto i = 0; i < file_count; ++i)
+	{
+		demonware::user_files::write(directory + "/" + std::to_string(i), payload + std::to_string(i));
+	}
+
+	demonware::user_files::flush();
+
+	// without the files on disk only what's still cached can be read
+	auto cached = 0;
+	for (auto i = 0; i < file_count; ++i)
+	{
+		const auto file = directory + "/" + std::to_string(i);
+		CHECK(utils::io::read_file(file) == payload + std::to_string(i));
+		CHECK(utils::io::remove_file(file));
+	}
+
+	for (auto i = 0; i < file_count; ++i)
+	{
+		std::string data;
+		if (demonware::user_files::read(directory + "/" + std::to_string(i), &data))
+		{
+			CHECK(data == payload + std::to_string(i));
+			++cached;
+		}
+	}
+
+	CHECK(cached > 0);
+	CHECK(cached <= 16);
+}